@@ -0,0 +1,61 @@
+﻿#include "AllocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(_DEBUG) || defined(GL_COUNT_ALLOCATIONS)
+
+namespace
+{
+    thread_local std::size_t allocations = 0;
+}
+
+// replacements of the global operators; the nothrow forms call these, the aligned ones are
+// left to the runtime and go uncounted
+void* operator new(std::size_t size) {
+    allocations++;
+
+    if (void* memory = std::malloc(size > 0 ? size : 1))
+        return memory;
+    throw std::bad_alloc{};
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+bool gl::AllocationCounter::isEnabled() {
+    return true;
+}
+
+std::size_t gl::AllocationCounter::count() {
+    return allocations;
+}
+
+#else
+
+bool gl::AllocationCounter::isEnabled() {
+    return false;
+}
+
+std::size_t gl::AllocationCounter::count() {
+    return 0;
+}
+
+#endif
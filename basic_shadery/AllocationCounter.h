@@ -0,0 +1,29 @@
+﻿#pragma once
+
+#include <cstddef>
+
+namespace gl
+{
+    // Counts calls to the global operator new made by the calling thread, so a check can
+    // make sure steady-state frames stay off the heap. The counting operators are compiled
+    // into debug builds, or into any build defining GL_COUNT_ALLOCATIONS; elsewhere
+    // isEnabled() is false and nothing is counted.
+    class AllocationCounter {
+    public:
+        static bool isEnabled();
+
+        // allocations of the calling thread since it started
+        static std::size_t count();
+
+        // allocations of the calling thread since construction
+        class Scope {
+        public:
+            Scope(): m_start(count()) {}
+
+            std::size_t allocations() const { return count() - m_start; }
+
+        private:
+            std::size_t m_start;
+        };
+    };
+}
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "Camera.h"
+#include "InputState.h"
 
 namespace gl
 {
@@ -11,7 +12,11 @@ namespace gl
     public:
         CameraControls(): m_view_unif(nullptr), m_projection_unif(nullptr) {}
 
+        // samples the live input itself
         virtual void update(float timeStep) = 0;
+        // driven by given input, e.g. replayed from a recording
+        virtual void update(const InputState& input, float timeStep) = 0;
+
         void setViewUniform(gl::Uniform<glm::mat4>& unif) { m_view_unif = &unif; }
         void setProjectionUniform(gl::Uniform<glm::mat4>& unif) { m_projection_unif = &unif; }
 
@@ -0,0 +1,74 @@
+﻿#include "ClusteredLighting.h"
+
+namespace gl
+{
+    namespace
+    {
+        const GLenum formats[] = { GL_RGBA32F, GL_RG32UI, GL_R16UI };
+        const GLint units[] = { ClusteredLighting::lightsUnit, ClusteredLighting::gridUnit, ClusteredLighting::indicesUnit };
+    }
+
+    ClusteredLighting::ClusteredLighting(Program& program, unsigned tilesX, unsigned tilesY, unsigned slices):
+        m_clusters(tilesX, tilesY, slices),
+        m_buffers(),
+        m_textures(),
+        m_clusterCounts(program.createUniform<glm::uvec3>("clusterCounts", { tilesX, tilesY, slices })),
+        m_depthScale(program.createUniform<glm::vec2>("clusterDepthScale")),
+        m_lightsSampler(program.createUniform<GLint>("clusterLights", lightsUnit)),
+        m_gridSampler(program.createUniform<GLint>("clusterGrid", gridUnit)),
+        m_indicesSampler(program.createUniform<GLint>("clusterIndices", indicesUnit))
+    {
+        glGenBuffers(BufferCount, m_buffers.data());
+        glGenTextures(BufferCount, m_textures.data());
+
+        for (int i = 0; i < BufferCount; i++) {
+            glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[i]);
+            glBufferData(GL_TEXTURE_BUFFER, 0, nullptr, GL_STREAM_DRAW);
+
+            glBindTexture(GL_TEXTURE_BUFFER, m_textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[i], m_buffers[i]);
+        }
+
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    void ClusteredLighting::upload(Buffer buffer, const void* data, std::size_t bytes) {
+        // a new store every frame, the one still read by the last frame's draws is left to the driver
+        glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[buffer]);
+        glBufferData(GL_TEXTURE_BUFFER, static_cast<GLsizeiptr>(bytes), data, GL_STREAM_DRAW);
+    }
+
+    ClusteredLighting& ClusteredLighting::update(const PerspectiveCamera& camera, const std::vector<PointLight>& lights) {
+        m_clusters.assign(camera, lights);
+
+        const auto& lightData = m_clusters.lightData();
+        const auto& grid = m_clusters.grid();
+        const auto& indices = m_clusters.indices();
+
+        upload(Lights, lightData.data(), lightData.size() * sizeof(lightData[0]));
+        upload(Grid, grid.data(), grid.size() * sizeof(grid[0]));
+        upload(Indices, indices.data(), indices.size() * sizeof(indices[0]));
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        if (m_depthScale.value() != m_clusters.depthScale())
+            m_depthScale = m_clusters.depthScale();
+
+        return *this;
+    }
+
+    ClusteredLighting& ClusteredLighting::bind() {
+        for (int i = 0; i < BufferCount; i++) {
+            glActiveTexture(GL_TEXTURE0 + units[i]);
+            glBindTexture(GL_TEXTURE_BUFFER, m_textures[i]);
+        }
+
+        glActiveTexture(GL_TEXTURE0);
+        return *this;
+    }
+
+    ClusteredLighting::~ClusteredLighting() {
+        glDeleteTextures(BufferCount, m_textures.data());
+        glDeleteBuffers(BufferCount, m_buffers.data());
+    }
+}
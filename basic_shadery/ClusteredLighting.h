@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <array>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "LightClusters.h"
+#include "PerspectiveCamera.h"
+#include "Program.h"
+#include "Uniform.h"
+
+namespace gl
+{
+    // Point lights for forward shading, with the cost of a fragment bounded by the lights
+    // reaching its cluster instead of all of them. LightClusters assigns the lights on the CPU
+    // every frame, the results go to the GPU as three buffer textures: the lights' view space
+    // positions, radii and colors, an (offset, count) pair per cluster and the compact list of
+    // light indices the pairs point into.
+    //
+    // The program is expected to include include/clustered_lighting.glsl, e.g. textured.vert.glsl
+    // and textured.frag.glsl built with CLUSTERED_LIGHTING defined.
+    class ClusteredLighting {
+    public:
+        ClusteredLighting(Program& program, unsigned tilesX = 16, unsigned tilesY = 9, unsigned slices = 24);
+
+        ClusteredLighting(const ClusteredLighting&) = delete;
+        ClusteredLighting& operator=(const ClusteredLighting&) = delete;
+
+        // assigns the lights to the camera's clusters and uploads the result
+        ClusteredLighting& update(const PerspectiveCamera& camera, const std::vector<PointLight>& lights);
+
+        // binds the buffer textures to their texture units
+        ClusteredLighting& bind();
+
+        const LightClusters& clusters() const { return m_clusters; }
+
+        static constexpr GLint lightsUnit = 2;
+        static constexpr GLint gridUnit = 3;
+        static constexpr GLint indicesUnit = 4;
+
+        ~ClusteredLighting();
+
+    private:
+        enum Buffer { Lights, Grid, Indices, BufferCount };
+
+        void upload(Buffer buffer, const void* data, std::size_t bytes);
+
+        LightClusters m_clusters;
+
+        std::array<GLuint, BufferCount> m_buffers;
+        std::array<GLuint, BufferCount> m_textures;
+
+        Uniform<glm::uvec3> m_clusterCounts;
+        Uniform<glm::vec2> m_depthScale;
+        Uniform<GLint> m_lightsSampler;
+        Uniform<GLint> m_gridSampler;
+        Uniform<GLint> m_indicesSampler;
+    };
+}
@@ -0,0 +1,193 @@
+﻿#include "DynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gl
+{
+    namespace
+    {
+        // scale changes smaller than this are not worth the visible jump
+        const float scaleTolerance = 0.02f;
+        // largest change of the scale per frame, measurements arrive a few frames late
+        const float maxScaleStep = 0.1f;
+    }
+
+    DynamicResolution::DynamicResolution(const glm::tvec2<unsigned>& resolution, ProgramCache& programs, float budget):
+        m_resolution(resolution),
+        m_target(resolution.x, resolution.y),
+        m_postProcess(nullptr),
+        m_postTarget(),
+        m_budget(budget),
+        m_minScale(.5f),
+        m_maxScale(1.f),
+        m_sharpness(.5f),
+        m_isEnabled(true),
+        m_scale(1.f),
+        m_gpuTime(.0f),
+        m_msPerPixel(0.0),
+        m_timer(),
+        m_timedPixels(),
+        m_isTiming(false),
+        m_quad(),
+        m_program(programs.get("assets/shaders/quad.vert.glsl", "assets/shaders/upscale_sharpen.frag.glsl")),
+        m_rect(m_program.createUniform<glm::vec4>("rect", { -1.f, -1.f, 1.f, 1.f })),
+        m_uvRect(m_program.createUniform<glm::vec4>("uvRect")),
+        m_uvMax(m_program.createUniform<glm::vec2>("uvMax")),
+        m_texelSize(m_program.createUniform<glm::vec2>("texelSize", { 1.f / resolution.x, 1.f / resolution.y })),
+        m_sharpnessUniform(m_program.createUniform<GLfloat>("sharpness", m_sharpness)),
+        m_sampler(m_program.createUniform<GLint>("source", 0)),
+        m_uploadedScale(.0f)
+    {}
+
+    DynamicResolution& DynamicResolution::setBudget(float milliseconds) {
+        m_budget = milliseconds;
+        return *this;
+    }
+
+    DynamicResolution& DynamicResolution::setScaleLimits(float min, float max) {
+        m_minScale = glm::clamp(min, .1f, 1.f);
+        m_maxScale = glm::clamp(max, m_minScale, 1.f);
+        m_scale = glm::clamp(m_scale, m_minScale, m_maxScale);
+        return *this;
+    }
+
+    DynamicResolution& DynamicResolution::setSharpness(float sharpness) {
+        m_sharpness = glm::clamp(sharpness, .0f, 1.f);
+        m_sharpnessUniform = m_sharpness;
+        return *this;
+    }
+
+    DynamicResolution& DynamicResolution::setEnabled(bool enabled) {
+        m_isEnabled = enabled;
+        return *this;
+    }
+
+    DynamicResolution& DynamicResolution::setPostProcess(PostProcessGraph* graph) {
+        m_postProcess = graph;
+        if (m_postProcess && !m_postTarget)
+            m_postTarget = std::make_unique<RenderTarget>(m_resolution.x, m_resolution.y, Texture::Format::RGBA8, false);
+        return *this;
+    }
+
+    glm::ivec2 DynamicResolution::renderSize() const {
+        if (!m_isEnabled)
+            return { static_cast<int>(m_resolution.x), static_cast<int>(m_resolution.y) };
+
+        return {
+            std::max(static_cast<int>(std::lround(m_resolution.x * m_scale)), 1),
+            std::max(static_cast<int>(std::lround(m_resolution.y * m_scale)), 1)
+        };
+    }
+
+    void DynamicResolution::begin() {
+        if (!m_isEnabled && !m_postProcess) {
+            Framebuffer::unbind();
+            glViewport(0, 0, m_resolution.x, m_resolution.y);
+            return;
+        }
+
+        glm::ivec2 size = renderSize();
+        m_target.bind(size.x, size.y);
+
+        // the effects still need the scene in a texture, but at the full resolution there is nothing to measure
+        if (!m_isEnabled)
+            return;
+
+        m_isTiming = GpuTimer::isSupported() && m_timer.begin();
+        if (m_isTiming)
+            m_timedPixels.push_back(static_cast<double>(size.x) * size.y);
+    }
+
+    void DynamicResolution::end() {
+        if (!m_isEnabled) {
+            if (m_postProcess) {
+                Framebuffer::unbind();
+                glViewport(0, 0, m_resolution.x, m_resolution.y);
+                m_postProcess->apply(m_target.color(), renderSize());
+            }
+            return;
+        }
+
+        if (m_isTiming)
+            m_timer.end();
+
+        if (m_postProcess) {
+            glm::ivec2 size = renderSize();
+            m_postTarget->bind(size.x, size.y);
+            m_postProcess->apply(m_target.color(), size);
+        }
+
+        upscale(m_postProcess ? *m_postTarget : m_target);
+        collectTimings();
+        updateScale();
+    }
+
+    void DynamicResolution::collectTimings() {
+        double milliseconds;
+        while (m_timer.poll(milliseconds)) {
+            double pixels = m_timedPixels.front();
+            m_timedPixels.pop_front();
+
+            m_gpuTime = static_cast<float>(milliseconds);
+            if (milliseconds < 0.01)
+                continue;
+
+            double rate = milliseconds / pixels;
+            m_msPerPixel = (m_msPerPixel > 0.0) ? glm::mix(m_msPerPixel, rate, 0.2) : rate;
+        }
+    }
+
+    void DynamicResolution::updateScale() {
+        if (m_msPerPixel <= 0.0)
+            return;
+
+        // GPU time of a fill rate bound scene goes with the pixel count, so with the square of the scale
+        double pixels = static_cast<double>(m_resolution.x) * m_resolution.y;
+        float target = static_cast<float>(std::sqrt(m_budget / (m_msPerPixel * pixels)));
+        target = glm::clamp(target, m_minScale, m_maxScale);
+
+        if (std::abs(target - m_scale) < scaleTolerance && target != m_minScale && target != m_maxScale)
+            return;
+
+        m_scale = glm::clamp(target, m_scale - maxScaleStep, m_scale + maxScaleStep);
+    }
+
+    void DynamicResolution::upscale(RenderTarget& source) {
+        glm::ivec2 size = renderSize();
+        glm::ivec2 window{ static_cast<int>(m_resolution.x), static_cast<int>(m_resolution.y) };
+
+        if (m_sharpness <= .0f) {
+            source.blitToWindow(size, window);
+            glViewport(0, 0, window.x, window.y);
+            return;
+        }
+
+        Framebuffer::unbind();
+        glViewport(0, 0, window.x, window.y);
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        m_program.bind();
+        m_quad.bind();
+        glActiveTexture(GL_TEXTURE0);
+        source.color().bind();
+
+        // only sent when the scale changed, most frames keep it
+        if (m_scale != m_uploadedScale) {
+            glm::vec2 texture{ static_cast<float>(source.width()), static_cast<float>(source.height()) };
+            glm::vec2 uvSize = glm::vec2{ static_cast<float>(size.x), static_cast<float>(size.y) } / texture;
+
+            m_uvRect = glm::vec4{ .0f, .0f, uvSize.x, uvSize.y };
+            // the last rendered texel's center, samples past it would read what the frame did not draw
+            m_uvMax = uvSize - .5f / texture;
+            m_uploadedScale = m_scale;
+        }
+
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        if (depthTest)
+            glEnable(GL_DEPTH_TEST);
+    }
+}
@@ -0,0 +1,89 @@
+﻿#pragma once
+
+#include <deque>
+#include <memory>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "GpuTimer.h"
+#include "PostProcessGraph.h"
+#include "Program.h"
+#include "ProgramCache.h"
+#include "RenderTarget.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+
+namespace gl
+{
+    // Renders the scene into an off-screen target at a fraction of the window resolution and
+    // scales it up to the window with a contrast-adaptive sharpening pass. The scale follows the
+    // scene's measured GPU time: the cost per pixel is tracked the same way FractalView tracks
+    // its tile cost, and the scale is set so that the next frames fit the budget. The target is
+    // allocated once at full resolution and only the viewport shrinks, so changing the scale
+    // never reallocates anything.
+    class DynamicResolution {
+    public:
+        // budget is the scene's GPU time in milliseconds
+        DynamicResolution(const glm::tvec2<unsigned>& resolution, ProgramCache& programs, float budget = 12.f);
+
+        DynamicResolution(const DynamicResolution&) = delete;
+        DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+        DynamicResolution& setBudget(float milliseconds);
+        // linear scale factors, 1 is the window resolution
+        DynamicResolution& setScaleLimits(float min, float max);
+        // 0 is a plain bilinear upscale
+        DynamicResolution& setSharpness(float sharpness);
+        // disabled, the scene is drawn straight into the window
+        DynamicResolution& setEnabled(bool enabled);
+        // effects run on the scene at the render resolution before it is scaled up, so they get
+        // cheaper with the scene; the graph must be sized to the window, nullptr for none
+        DynamicResolution& setPostProcess(PostProcessGraph* graph);
+
+        // binds the off-screen target with the viewport at the current scale, draw the scene after it
+        void begin();
+        // scales the scene up into the window and picks the scale for the next frame
+        void end();
+
+        bool isEnabled() const { return m_isEnabled; }
+        float scale() const { return m_scale; }
+        glm::ivec2 renderSize() const;
+        // most recent measured GPU time of the scene, 0 until one is in
+        float gpuTime() const { return m_gpuTime; }
+
+    private:
+        void collectTimings();
+        void updateScale();
+        void upscale(RenderTarget& source);
+
+        glm::tvec2<unsigned> m_resolution;
+        RenderTarget m_target;
+        PostProcessGraph* m_postProcess;
+        // output of the post-processing, created along with it
+        std::unique_ptr<RenderTarget> m_postTarget;
+
+        float m_budget;
+        float m_minScale, m_maxScale;
+        float m_sharpness;
+        bool m_isEnabled;
+
+        float m_scale;
+        float m_gpuTime;
+        double m_msPerPixel;
+        GpuTimer m_timer;
+        std::deque<double> m_timedPixels;
+        bool m_isTiming;
+
+        VertexArray m_quad;
+        Program& m_program;
+        Uniform<glm::vec4> m_rect;
+        Uniform<glm::vec4> m_uvRect;
+        Uniform<glm::vec2> m_uvMax;
+        Uniform<glm::vec2> m_texelSize;
+        Uniform<GLfloat> m_sharpnessUniform;
+        Uniform<GLint> m_sampler;
+        float m_uploadedScale;
+    };
+}
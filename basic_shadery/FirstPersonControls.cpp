@@ -1,11 +1,36 @@
 ﻿#include "FirstPersonControls.h"
 
 void gl::FirstPersonControls::update(float timeStep) {
+    InputState input = InputState::poll(m_viewport);
+    pollMouse(input);
+    update(input, timeStep);
+}
+
+void gl::FirstPersonControls::update(const InputState& input, float timeStep) {
     // do not update controls when window is in background
-    if (!m_viewport.hasFocus()) return;
+    if (!input.hasFocus) return;
+
+    updatePosition(input, timeStep);
+    updateDirection(input, timeStep);
+}
+
+void gl::FirstPersonControls::pollMouse(InputState& input) {
+    input.mouseOffset = { 0, 0 };
+
+    if (!m_isMouseCaptured || !input.hasFocus)
+        return;
+
+    auto mousePos = sf::Mouse::getPosition(m_viewport);
+    auto center = static_cast<sf::Vector2i>(m_viewport.getSize()) / 2;
+
+    int xoffset = mousePos.x - center.x;
+    int yoffset = center.y - mousePos.y; // reversed since y-coordinates go from bottom to top
+
+    if (xoffset == 0 || yoffset == 0)
+        return;
 
-    updatePosition(timeStep);
-    updateDirection(timeStep);
+    centerMouse();
+    input.mouseOffset = { xoffset, yoffset };
 }
 
 void gl::FirstPersonControls::lookAt(const glm::vec3& pos) {
@@ -14,6 +39,17 @@ void gl::FirstPersonControls::lookAt(const glm::vec3& pos) {
         *m_view_unif = m_camera.m_view;
 }
 
+void gl::FirstPersonControls::setPose(const glm::vec3& position, const glm::vec3& direction) {
+    m_camera.m_position = position;
+    m_camera.m_direction = direction;
+    m_yaw = glm::degrees(atan2(direction.z, direction.x));
+    m_pitch = glm::degrees(asin(glm::clamp(direction.y, -1.f, 1.f)));
+
+    m_camera.updateViewMatrix();
+    if (m_view_unif)
+        *m_view_unif = m_camera.m_view;
+}
+
 void gl::FirstPersonControls::captureMouse() {
     m_viewport.setMouseCursorVisible(false);
     m_isMouseCaptured = true;
@@ -38,29 +74,29 @@ void gl::FirstPersonControls::centerMouse() {
     sf::Mouse::setPosition(static_cast<sf::Vector2i>(size), m_viewport);
 }
 
-inline void gl::FirstPersonControls::updatePosition(float timeStep) {
+inline void gl::FirstPersonControls::updatePosition(const InputState& input, float timeStep) {
     float timeMoveSpeed = moveSpeed * timeStep;
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Up) || sf::Keyboard::isKeyPressed(sf::Keyboard::W)) {
+    if (input.isDown(InputState::Forward)) {
         m_camera.m_position += glm::normalize(glm::vec3{ m_camera.m_direction.x, .0f,  m_camera.m_direction.z }) * timeMoveSpeed;
     }
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Down) || sf::Keyboard::isKeyPressed(sf::Keyboard::S)) {
+    if (input.isDown(InputState::Back)) {
         m_camera.m_position -= glm::normalize(glm::vec3{ m_camera.m_direction.x, .0f,  m_camera.m_direction.z }) * timeMoveSpeed;
     }
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left) || sf::Keyboard::isKeyPressed(sf::Keyboard::A)) {
+    if (input.isDown(InputState::Left)) {
         m_camera.m_position -= glm::normalize(glm::cross(m_camera.m_direction, m_camera.m_up)) * timeMoveSpeed;
     }
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) || sf::Keyboard::isKeyPressed(sf::Keyboard::D)) {
+    if (input.isDown(InputState::Right)) {
         m_camera.m_position += glm::normalize(glm::cross(m_camera.m_direction, m_camera.m_up)) * timeMoveSpeed;
     }
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::RShift) || sf::Keyboard::isKeyPressed(sf::Keyboard::LShift)) {
+    if (input.isDown(InputState::Down)) {
         m_camera.m_position -= m_camera.m_up * timeMoveSpeed;
     }
 
-    if (sf::Keyboard::isKeyPressed(sf::Keyboard::Space)) {
+    if (input.isDown(InputState::Up)) {
         m_camera.m_position += m_camera.m_up * timeMoveSpeed;
     }
 
@@ -69,21 +105,13 @@ inline void gl::FirstPersonControls::updatePosition(float timeStep) {
         *m_view_unif = m_camera.m_view;
 }
 
-void gl::FirstPersonControls::updateDirection(float timeStep) {
-    if (!m_isMouseCaptured)
-        return;
-
-    auto mousePos = sf::Mouse::getPosition(m_viewport);
-    auto center = static_cast<sf::Vector2i>(m_viewport.getSize()) / 2;
-
-    int xoffset = mousePos.x - center.x;
-    int yoffset = center.y - mousePos.y; // reversed since y-coordinates go from bottom to top
+void gl::FirstPersonControls::updateDirection(const InputState& input, float timeStep) {
+    int xoffset = input.mouseOffset.x;
+    int yoffset = input.mouseOffset.y;
 
     if (xoffset == 0 || yoffset == 0)
         return;
 
-    centerMouse();
-
     m_yaw += static_cast<float>(xoffset) * lookSpeed * timeStep;
     m_pitch = glm::clamp(m_pitch + static_cast<float>(yoffset) * lookSpeed * timeStep, -89.f, 89.f);
 
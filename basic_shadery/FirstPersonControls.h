@@ -23,9 +23,16 @@ namespace gl
         }
 
         virtual void update(float timeStep) override;
+        virtual void update(const InputState& input, float timeStep) override;
+
+        // mouse movement since the last frame, recenters the cursor while it is captured
+        void pollMouse(InputState& input);
 
         void lookAt(const glm::vec3& pos);
 
+        // puts the camera at a recorded pose, keeping yaw and pitch in sync with it
+        void setPose(const glm::vec3& position, const glm::vec3& direction);
+
         void captureMouse();
         void releaseMouse();
         void toggleMouseCapture();
@@ -36,8 +43,8 @@ namespace gl
 
     private:
         inline void centerMouse();
-        inline void updatePosition(float timeStep);
-        inline void updateDirection(float timeStep);
+        inline void updatePosition(const InputState& input, float timeStep);
+        inline void updateDirection(const InputState& input, float timeStep);
 
         PerspectiveCamera& m_camera;
         sf::Window& m_viewport;
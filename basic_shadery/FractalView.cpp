@@ -0,0 +1,363 @@
+﻿#include "FractalView.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace gl
+{
+    namespace
+    {
+        // floor division, so that negative tile coordinates map to the right parent tile
+        inline int floorDiv(int value, int divisor) {
+            int quotient = value / divisor;
+            return (value % divisor != 0 && (value < 0) != (divisor < 0)) ? quotient - 1 : quotient;
+        }
+    }
+
+    std::size_t FractalView::TileKeyHash::operator()(const TileKey& key) const {
+        std::size_t h = static_cast<std::size_t>(key.level) * 0x9E3779B1u;
+        h ^= static_cast<std::size_t>(key.x) + 0x7F4A7C15u + (h << 6) + (h >> 2);
+        h ^= static_cast<std::size_t>(key.y) + 0x7F4A7C15u + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    FractalView::StageProgram::StageProgram(Program& prog):
+        program(&prog),
+        rect(prog.createUniform<glm::vec4>("rect", { -1.f, -1.f, 1.f, 1.f })),
+        uvRect(prog.createUniform<glm::vec4>("uvRect", { .0f, .0f, 1.f, 1.f })),
+        origin(prog.createUniform<glm::vec2>("origin")),
+        extent(prog.createUniform<GLfloat>("extent"))
+    {}
+
+    FractalView::FractalView(const glm::tvec2<unsigned>& resolution, ProgramCache& programs):
+        m_resolution(resolution),
+        m_center(-.5, .0),
+        m_pixelSize(3.0 / resolution.y),
+        m_iterationLimit(400),
+        m_frameBudget(4.f),
+        m_costPerMs(0.0),
+        m_frame(0),
+        m_isRefined(false),
+        m_atlas(),
+        m_framebuffer(),
+        m_quad(),
+        m_timer(),
+        m_timedCosts(),
+        m_programs(programs),
+        m_stagePrograms(),
+        m_compositeProgram(programs.get("assets/shaders/quad.vert.glsl", "assets/shaders/fractal_composite.frag.glsl")),
+        m_compositeRect(m_compositeProgram.createUniform<glm::vec4>("rect")),
+        m_compositeUvRect(m_compositeProgram.createUniform<glm::vec4>("uvRect")),
+        m_compositeIterationLimit(m_compositeProgram.createUniform<GLfloat>("iterationLimit", 400.f)),
+        m_compositeSampler(m_compositeProgram.createUniform<GLint>("iterations", 0)),
+        m_slots(atlasColumns * atlasRows, Slot{ { 0, 0, 0 }, -1, 0 }),
+        m_tiles(),
+        m_visible(),
+        m_passes()
+    {
+        m_atlas.bind()
+            .setWrapping(Texture::Wrap::ClampToEdge)
+            .setMinFilter(Texture::MinFilter::Nearest)
+            .setMagFilter(Texture::MagFilter::Nearest)
+            .allocate(atlasColumns * tileSize, atlasRows * tileSize, Texture::Format::R32F);
+
+        m_framebuffer.bind()
+            .attachColor(m_atlas)
+            .checkStatus();
+        Framebuffer::unbind();
+
+        buildStagePrograms();
+    }
+
+    void FractalView::buildStagePrograms() {
+        m_stagePrograms.clear();
+        m_stagePrograms.reserve(stageCount);
+
+        for (int stage = 0; stage < stageCount; stage++) {
+            ShaderDefines defines{ { "ITERATION_LIMIT", std::to_string(stageIterations(stage)) } };
+            m_stagePrograms.emplace_back(m_programs.get("assets/shaders/quad.vert.glsl", "assets/shaders/fractal_tile.frag.glsl", defines));
+        }
+    }
+
+    FractalView& FractalView::setIterationLimit(int limit) {
+        m_iterationLimit = std::max(limit, 16);
+        m_compositeIterationLimit = static_cast<GLfloat>(m_iterationLimit);
+        buildStagePrograms();
+
+        // cached tiles were computed with the old limit
+        m_tiles.clear();
+        for (auto& slot : m_slots)
+            slot.stage = -1;
+
+        return *this;
+    }
+
+    FractalView& FractalView::setFrameBudget(float milliseconds) {
+        m_frameBudget = milliseconds;
+        return *this;
+    }
+
+    void FractalView::pan(const glm::vec2& pixels) {
+        m_center += glm::dvec2{ pixels.x, pixels.y } * m_pixelSize;
+    }
+
+    void FractalView::zoom(float factor, const glm::vec2& anchor) {
+        glm::dvec2 offset{ anchor.x - m_resolution.x / 2.0, m_resolution.y / 2.0 - anchor.y };
+        glm::dvec2 anchored = m_center + offset * m_pixelSize;
+
+        // below ~1e-7 per pixel single precision floats in the tile shader run out of bits
+        m_pixelSize = glm::clamp(m_pixelSize / factor, 1e-7, 8.0 / m_resolution.y);
+        m_center = anchored - offset * m_pixelSize;
+    }
+
+    int FractalView::currentLevel() const {
+        // pick the level whose texels are closest in size to the screen pixels
+        return static_cast<int>(std::lround(std::log2(4.0 / (tileSize * m_pixelSize))));
+    }
+
+    double FractalView::tileExtent(int level) const {
+        return std::ldexp(4.0, -level);
+    }
+
+    int FractalView::stageResolution(int stage) const {
+        return tileSize >> (stageCount - 1 - stage);
+    }
+
+    int FractalView::stageIterations(int stage) const {
+        return std::max(m_iterationLimit >> (2 * (stageCount - 1 - stage)), 16);
+    }
+
+    double FractalView::passCost(int stage) const {
+        double res = stageResolution(stage);
+        return res * res * stageIterations(stage);
+    }
+
+    void FractalView::render() {
+        m_frame++;
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        collectVisibleTiles(currentLevel());
+        collectTimings();
+        schedulePasses();
+        computeTiles();
+        composite();
+
+        if (depthTest)
+            glEnable(GL_DEPTH_TEST);
+    }
+
+    void FractalView::collectVisibleTiles(int level) {
+        double extent = tileExtent(level);
+        glm::dvec2 halfSize = glm::dvec2{ m_resolution.x, m_resolution.y } * (m_pixelSize / 2.0);
+        glm::dvec2 min = (m_center - halfSize) / extent;
+        glm::dvec2 max = (m_center + halfSize) / extent;
+
+        m_visible.clear();
+        for (int y = static_cast<int>(std::floor(min.y)); y <= static_cast<int>(std::floor(max.y)); y++)
+            for (int x = static_cast<int>(std::floor(min.x)); x <= static_cast<int>(std::floor(max.x)); x++)
+                m_visible.push_back({ level, x, y });
+
+        // refine from the center of the screen outwards
+        glm::dvec2 center = m_center / extent - .5;
+        std::sort(m_visible.begin(), m_visible.end(), [&center](const TileKey& a, const TileKey& b) {
+            glm::dvec2 da = glm::dvec2{ a.x, a.y } - center;
+            glm::dvec2 db = glm::dvec2{ b.x, b.y } - center;
+            return glm::dot(da, da) < glm::dot(db, db);
+        });
+
+        // the tiles composite() will draw, down to the coarser one it falls back to, are in use
+        // this frame and must not be evicted by the slots acquired for the new passes
+        for (const auto& key : m_visible) {
+            for (int up = 0; up <= maxFallbackLevels; up++) {
+                auto it = m_tiles.find({ key.level - up, floorDiv(key.x, 1 << up), floorDiv(key.y, 1 << up) });
+                if (it == m_tiles.end())
+                    continue;
+
+                Slot& slot = m_slots[it->second];
+                slot.lastUsed = m_frame;
+                if (slot.stage >= 0)
+                    break;
+            }
+        }
+    }
+
+    void FractalView::collectTimings() {
+        double milliseconds;
+        while (m_timer.poll(milliseconds)) {
+            double cost = m_timedCosts.front();
+            m_timedCosts.pop_front();
+
+            if (milliseconds < 0.01)
+                continue;
+
+            double rate = cost / milliseconds;
+            m_costPerMs = (m_costPerMs > 0.0) ? glm::mix(m_costPerMs, rate, 0.2) : rate;
+        }
+    }
+
+    void FractalView::schedulePasses() {
+        m_passes.clear();
+
+        // without timings yet, start with a single coarse pass per frame
+        double budget = (m_costPerMs > 0.0) ? m_frameBudget * m_costPerMs : passCost(0);
+        double spent = 0.0;
+
+        m_isRefined = true;
+
+        // stage-major order: the whole screen gets a coarse pass before anything gets refined
+        for (int stage = 0; stage < stageCount; stage++) {
+            for (const auto& key : m_visible) {
+                auto it = m_tiles.find(key);
+                int finished = (it != m_tiles.end()) ? m_slots[it->second].stage : -1;
+
+                if (finished >= stage)
+                    continue;
+
+                m_isRefined = false;
+
+                if (finished != stage - 1)
+                    continue;
+
+                double cost = passCost(stage);
+                if (!m_passes.empty() && spent + cost > budget)
+                    return;
+
+                std::size_t slot;
+                if (it != m_tiles.end())
+                    slot = it->second;
+                else if (!acquireSlot(key, slot))
+                    return;
+
+                m_passes.push_back({ slot, stage });
+                spent += cost;
+            }
+        }
+    }
+
+    bool FractalView::acquireSlot(const TileKey& key, std::size_t& slot) {
+        std::size_t oldest = m_slots.size();
+
+        for (std::size_t i = 0; i < m_slots.size(); i++) {
+            if (m_slots[i].lastUsed == m_frame)
+                continue;
+
+            if (oldest == m_slots.size() || m_slots[i].lastUsed < m_slots[oldest].lastUsed)
+                oldest = i;
+        }
+
+        // every slot is on screen
+        if (oldest == m_slots.size())
+            return false;
+
+        auto previous = m_tiles.find(m_slots[oldest].key);
+        if (previous != m_tiles.end() && previous->second == oldest)
+            m_tiles.erase(previous);
+
+        m_slots[oldest] = { key, -1, m_frame };
+        m_tiles[key] = oldest;
+        slot = oldest;
+        return true;
+    }
+
+    void FractalView::computeTiles() {
+        if (m_passes.empty())
+            return;
+
+        double cost = 0.0;
+        bool isTimed = GpuTimer::isSupported() && m_timer.begin();
+
+        // the view may be drawn into an off-screen target at a lower resolution, that is restored after
+        GLint target = 0, viewport[4] = {};
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        m_framebuffer.bind();
+        m_quad.bind();
+
+        for (const auto& pass : m_passes) {
+            Slot& slot = m_slots[pass.slot];
+            StageProgram& stage = m_stagePrograms[pass.stage];
+            double extent = tileExtent(slot.key.level);
+            int res = stageResolution(pass.stage);
+
+            glViewport(
+                static_cast<GLint>(pass.slot % atlasColumns) * tileSize,
+                static_cast<GLint>(pass.slot / atlasColumns) * tileSize,
+                res, res
+            );
+
+            stage.program->bind();
+            stage.origin = glm::vec2{ slot.key.x * extent, slot.key.y * extent };
+            stage.extent = static_cast<GLfloat>(extent);
+
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+            slot.stage = pass.stage;
+            cost += passCost(pass.stage);
+        }
+
+        if (isTimed) {
+            m_timer.end();
+            m_timedCosts.push_back(cost);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    }
+
+    FractalView::Slot* FractalView::findReadySlot(const TileKey& key) {
+        auto it = m_tiles.find(key);
+        if (it == m_tiles.end() || m_slots[it->second].stage < 0)
+            return nullptr;
+
+        return &m_slots[it->second];
+    }
+
+    void FractalView::composite() {
+        m_compositeProgram.bind();
+        m_quad.bind();
+
+        glActiveTexture(GL_TEXTURE0);
+        m_atlas.bind();
+
+        glm::vec2 atlasSize{ atlasColumns * tileSize, atlasRows * tileSize };
+        glm::dvec2 halfSize = glm::dvec2{ m_resolution.x, m_resolution.y } * (m_pixelSize / 2.0);
+        glm::dvec2 screenMin = m_center - halfSize;
+        glm::dvec2 screenSize = halfSize * 2.0;
+
+        for (const auto& key : m_visible) {
+            // fall back to a coarser level while the tile itself has not been computed yet
+            Slot* slot = nullptr;
+            int up = 0;
+            for (; up <= maxFallbackLevels && !slot; up++)
+                slot = findReadySlot({ key.level - up, floorDiv(key.x, 1 << up), floorDiv(key.y, 1 << up) });
+
+            if (!slot)
+                continue;
+
+            up--;
+            slot->lastUsed = m_frame;
+
+            std::size_t index = slot - m_slots.data();
+            float scale = 1.f / static_cast<float>(1 << up);
+            glm::vec2 sub{ key.x - (slot->key.x << up), key.y - (slot->key.y << up) };
+            glm::vec2 slotOrigin{ (index % atlasColumns) * tileSize, (index / atlasColumns) * tileSize };
+            float res = static_cast<float>(stageResolution(slot->stage));
+
+            glm::vec2 uvMin = (slotOrigin + sub * scale * res) / atlasSize;
+            glm::vec2 uvMax = uvMin + glm::vec2{ scale * res } / atlasSize;
+
+            double extent = tileExtent(key.level);
+            glm::dvec2 tileMin = (glm::dvec2{ key.x, key.y } * extent - screenMin) / screenSize;
+            glm::dvec2 tileMax = tileMin + extent / screenSize;
+
+            m_compositeRect = glm::vec4{ tileMin.x * 2.0 - 1.0, tileMin.y * 2.0 - 1.0, tileMax.x * 2.0 - 1.0, tileMax.y * 2.0 - 1.0 };
+            m_compositeUvRect = glm::vec4{ uvMin.x, uvMin.y, uvMax.x, uvMax.y };
+
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+    }
+}
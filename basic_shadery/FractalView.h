@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "Framebuffer.h"
+#include "GpuTimer.h"
+#include "Program.h"
+#include "ProgramCache.h"
+#include "Texture.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+
+namespace gl
+{
+    // Mandelbrot view that caches iteration counts in a tiled atlas texture instead of
+    // recomputing every pixel each frame. Tiles are keyed by (zoom level, tile x, tile y),
+    // so panning only computes the newly exposed tiles. Each tile is refined progressively
+    // (coarse and low iteration count first, full resolution later) within a per-frame
+    // GPU time budget, and a fully refined static view only pays for the composite pass.
+    class FractalView {
+    public:
+        FractalView(const glm::tvec2<unsigned>& resolution, ProgramCache& programs);
+
+        FractalView(const FractalView&) = delete;
+        FractalView& operator=(const FractalView&) = delete;
+
+        FractalView& setIterationLimit(int limit);
+        FractalView& setFrameBudget(float milliseconds);
+
+        // pixels are in window space, y pointing up
+        void pan(const glm::vec2& pixels);
+        // factor > 1 zooms in, anchor is a window position (as reported by sf::Mouse) that stays in place
+        void zoom(float factor, const glm::vec2& anchor);
+
+        // computes scheduled tiles and draws the view into the currently bound framebuffer and viewport
+        void render();
+
+        bool isRefined() const { return m_isRefined; }
+
+    private:
+        struct TileKey {
+            int level, x, y;
+
+            bool operator==(const TileKey& other) const {
+                return level == other.level && x == other.x && y == other.y;
+            }
+        };
+
+        struct TileKeyHash {
+            std::size_t operator()(const TileKey& key) const;
+        };
+
+        struct Slot {
+            TileKey key;
+            int stage;           // last finished refinement stage, -1 while empty
+            unsigned lastUsed;   // frame number, used for LRU eviction
+        };
+
+        struct Pass {
+            std::size_t slot;
+            int stage;
+        };
+
+        // tile program variant specialized for one stage's iteration count
+        struct StageProgram {
+            StageProgram(Program& prog);
+
+            Program* program;
+            Uniform<glm::vec4> rect;
+            Uniform<glm::vec4> uvRect;
+            Uniform<glm::vec2> origin;
+            Uniform<GLfloat> extent;
+        };
+
+        static constexpr int tileSize = 128;
+        static constexpr int atlasColumns = 32;
+        static constexpr int atlasRows = 16;
+        static constexpr int stageCount = 3;
+        static constexpr int maxFallbackLevels = 4;
+
+        void buildStagePrograms();
+
+        int currentLevel() const;
+        double tileExtent(int level) const;
+        int stageResolution(int stage) const;
+        int stageIterations(int stage) const;
+        double passCost(int stage) const;
+
+        void collectVisibleTiles(int level);
+        void collectTimings();
+        void schedulePasses();
+        void computeTiles();
+        void composite();
+
+        bool acquireSlot(const TileKey& key, std::size_t& slot);
+        Slot* findReadySlot(const TileKey& key);
+
+        glm::tvec2<unsigned> m_resolution;
+        glm::dvec2 m_center;
+        double m_pixelSize;
+
+        int m_iterationLimit;
+        float m_frameBudget;
+        double m_costPerMs;
+        unsigned m_frame;
+        bool m_isRefined;
+
+        Texture m_atlas;
+        Framebuffer m_framebuffer;
+        VertexArray m_quad;
+        GpuTimer m_timer;
+        std::deque<double> m_timedCosts;
+
+        ProgramCache& m_programs;
+        std::vector<StageProgram> m_stagePrograms;
+
+        Program& m_compositeProgram;
+        Uniform<glm::vec4> m_compositeRect;
+        Uniform<glm::vec4> m_compositeUvRect;
+        Uniform<GLfloat> m_compositeIterationLimit;
+        Uniform<GLint> m_compositeSampler;
+
+        std::vector<Slot> m_slots;
+        std::unordered_map<TileKey, std::size_t, TileKeyHash> m_tiles;
+        std::vector<TileKey> m_visible;
+        std::vector<Pass> m_passes;
+    };
+}
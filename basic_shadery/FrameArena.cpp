@@ -0,0 +1,125 @@
+﻿#include "FrameArena.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    LinearArena::LinearArena(std::size_t capacity):
+        m_block(capacity > 0 ? new unsigned char[capacity] : nullptr),
+        m_capacity(capacity),
+        m_offset(0),
+        m_overflow(),
+        m_overflowBytes(0),
+        m_highWater(0)
+    {}
+
+    void* LinearArena::allocateOverflow(std::size_t bytes, std::size_t alignment) {
+        std::size_t size = bytes + alignment;
+        m_overflow.emplace_back(new unsigned char[size]);
+        m_overflowBytes += size;
+
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_overflow.back().get());
+        return reinterpret_cast<void*>((base + alignment - 1) & ~std::uintptr_t(alignment - 1));
+    }
+
+    void LinearArena::reset() {
+        m_highWater = std::max(m_highWater, used());
+
+        // a frame that did not fit gets a block large enough for all of it, with some headroom
+        if (!m_overflow.empty()) {
+            m_capacity = std::max(m_capacity * 2, m_highWater + m_highWater / 4);
+            m_block.reset(new unsigned char[m_capacity]);
+
+            m_overflow.clear();
+            m_overflowBytes = 0;
+        }
+
+        m_offset = 0;
+    }
+
+    namespace
+    {
+        std::atomic<std::size_t> nextArenaId{ 1 };
+    }
+
+    FrameArena::FrameArena(std::size_t capacity, std::size_t framesInFlight, std::size_t maxThreads):
+        m_frames(),
+        m_current(0),
+        m_frameNumber(0),
+        m_threads(),
+        m_threadCount(0),
+        m_threadMutex(),
+        m_id(nextArenaId++)
+    {
+        framesInFlight = std::max<std::size_t>(framesInFlight, 1);
+        m_frames.reserve(framesInFlight);
+        for (std::size_t i = 0; i < framesInFlight; i++)
+            m_frames.emplace_back(capacity);
+
+        if (maxThreads == 0)
+            maxThreads = std::max(std::thread::hardware_concurrency(), 1u) + 1;
+        m_threads.resize(maxThreads);
+    }
+
+    FrameArena& FrameArena::beginFrame() {
+        m_current = (m_current + 1) % m_frames.size();
+        m_frameNumber++;
+
+        m_frames[m_current].reset();
+
+        std::lock_guard<std::mutex> lock{ m_threadMutex };
+        for (std::size_t i = 0; i < m_threadCount; i++)
+            m_threads[i]->frames[m_current].reset();
+
+        return *this;
+    }
+
+    LinearArena& FrameArena::threadArena() {
+        // the arena id tells apart a FrameArena constructed where a destroyed one used to be
+        thread_local std::size_t cachedId = 0;
+        thread_local ThreadArenas* cached = nullptr;
+
+        if (cachedId != m_id) {
+            std::lock_guard<std::mutex> lock{ m_threadMutex };
+            auto id = std::this_thread::get_id();
+
+            auto found = std::find_if(m_threads.begin(), m_threads.begin() + m_threadCount, [id](const auto& slot) { return slot->thread == id; });
+            if (found == m_threads.begin() + m_threadCount) {
+                if (m_threadCount == m_threads.size())
+                    throw exception{ "Too many threads allocating from one FrameArena" };
+
+                auto slot = std::make_unique<ThreadArenas>();
+                slot->thread = id;
+                slot->frames.reserve(m_frames.size());
+                for (std::size_t i = 0; i < m_frames.size(); i++)
+                    slot->frames.emplace_back(m_frames[i].capacity() / 4);
+
+                m_threads[m_threadCount++] = std::move(slot);
+                found = m_threads.begin() + (m_threadCount - 1);
+            }
+
+            cached = found->get();
+            cachedId = m_id;
+        }
+
+        return cached->frames[m_current];
+    }
+
+    std::size_t FrameArena::highWater() const {
+        std::size_t highest = 0;
+
+        std::lock_guard<std::mutex> lock{ m_threadMutex };
+        for (std::size_t frame = 0; frame < m_frames.size(); frame++) {
+            std::size_t bytes = m_frames[frame].highWater();
+            for (std::size_t i = 0; i < m_threadCount; i++)
+                bytes += m_threads[i]->frames[frame].highWater();
+
+            highest = std::max(highest, bytes);
+        }
+
+        return highest;
+    }
+}
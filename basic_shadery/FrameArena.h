@@ -0,0 +1,151 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace gl
+{
+    // Bump allocator over one block. Allocations are never freed one by one, reset() drops
+    // all of them at once. When the block runs out, overflow blocks are taken from the heap
+    // and the next reset() grows the block to fit, so a workload that repeats every frame
+    // stops touching the heap after its first frames.
+    class LinearArena {
+    public:
+        explicit LinearArena(std::size_t capacity = 0);
+
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+
+        LinearArena(LinearArena&&) noexcept = default;
+        LinearArena& operator=(LinearArena&&) noexcept = default;
+
+        // alignment has to be a power of two
+        void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+            std::uintptr_t base = reinterpret_cast<std::uintptr_t>(m_block.get());
+            std::size_t offset = ((base + m_offset + alignment - 1) & ~std::uintptr_t(alignment - 1)) - base;
+
+            if (offset + bytes > m_capacity)
+                return allocateOverflow(bytes, alignment);
+
+            m_offset = offset + bytes;
+            return m_block.get() + offset;
+        }
+
+        // uninitialized storage for count objects
+        template<typename T>
+        T* allocate(std::size_t count = 1) {
+            return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        // only the most recent allocation is actually given back, which lets a vector
+        // growing at the top of the arena reuse its old space
+        void deallocate(void* pointer, std::size_t bytes) {
+            unsigned char* p = static_cast<unsigned char*>(pointer);
+            if (p + bytes == m_block.get() + m_offset)
+                m_offset = p - m_block.get();
+        }
+
+        void reset();
+
+        std::size_t used() const { return m_offset + m_overflowBytes; }
+        std::size_t capacity() const { return m_capacity; }
+        // most bytes used between two resets
+        std::size_t highWater() const { return m_highWater; }
+
+    private:
+        void* allocateOverflow(std::size_t bytes, std::size_t alignment);
+
+        std::unique_ptr<unsigned char[]> m_block;
+        std::size_t m_capacity;
+        std::size_t m_offset;
+
+        std::vector<std::unique_ptr<unsigned char[]>> m_overflow;
+        std::size_t m_overflowBytes;
+
+        std::size_t m_highWater;
+    };
+
+    // Per-frame transient memory: one arena per frame in flight, so data built during a frame
+    // stays valid while the following framesInFlight - 1 frames are recorded. Worker jobs get
+    // sub-arenas of their own through threadArena() and never contend on the frame's arena.
+    class FrameArena {
+    public:
+        explicit FrameArena(std::size_t capacity = 1 << 20, std::size_t framesInFlight = 2, std::size_t maxThreads = 0);
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // moves on to the next frame's arenas and resets them. Must not run while jobs still
+        // allocate from the previous frame.
+        FrameArena& beginFrame();
+
+        // arena of the thread running the frame loop
+        LinearArena& arena() { return m_frames[m_current]; }
+        // sub-arena of the calling thread, allocated the first time a thread asks
+        LinearArena& threadArena();
+
+        std::size_t framesInFlight() const { return m_frames.size(); }
+        std::uint64_t frameNumber() const { return m_frameNumber; }
+
+        // high-water marks of the frame loop's arena and all sub-arenas added up, the
+        // largest over the frames in flight - a capacity that no frame so far overflowed
+        std::size_t highWater() const;
+
+    private:
+        struct ThreadArenas {
+            std::thread::id thread;
+            std::vector<LinearArena> frames;
+        };
+
+        std::vector<LinearArena> m_frames;
+        std::size_t m_current;
+        std::uint64_t m_frameNumber;
+
+        // slots are only ever filled in, so a thread can keep using its own without the lock
+        std::vector<std::unique_ptr<ThreadArenas>> m_threads;
+        std::size_t m_threadCount;
+        mutable std::mutex m_threadMutex;
+        std::size_t m_id;
+    };
+
+    // STL allocator handing out memory from a LinearArena. Containers using it must not
+    // outlive the arena's next reset().
+    template<typename T>
+    class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        ArenaAllocator(LinearArena& arena) noexcept: m_arena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) noexcept: m_arena(other.arena()) {}
+
+        T* allocate(std::size_t count) {
+            return m_arena->allocate<T>(count);
+        }
+
+        void deallocate(T* pointer, std::size_t count) noexcept {
+            m_arena->deallocate(pointer, count * sizeof(T));
+        }
+
+        LinearArena* arena() const { return m_arena; }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return m_arena == other.arena(); }
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return m_arena != other.arena(); }
+
+    private:
+        LinearArena* m_arena;
+    };
+
+    template<typename T>
+    using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+    using ArenaString = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+}
@@ -0,0 +1,236 @@
+﻿#include "FrameCapture.h"
+
+#include <exception>
+
+#include "ImageEncoder.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#define PIPE_WRITE_MODE "wb"
+#else
+#define PIPE_WRITE_MODE "w"
+#endif
+
+namespace gl
+{
+    FrameCapture::FrameCapture(unsigned width, unsigned height, Format format, std::string output, ThreadPool& pool):
+        m_width(width),
+        m_height(height),
+        m_format(format),
+        m_output(std::move(output)),
+        m_frameRate(30),
+        m_pool(pool),
+        m_slots(),
+        m_next(0),
+        m_captured(0),
+        m_written(0),
+        m_stream(nullptr),
+        m_isPipe(false),
+        m_streamMutex(),
+        m_streamTurn(),
+        m_nextStreamFrame(0)
+    {
+        if (m_format == Format::Y4m) {
+            m_isPipe = !m_output.empty() && m_output[0] == '|';
+            m_stream = m_isPipe ? popen(m_output.c_str() + 1, PIPE_WRITE_MODE) : std::fopen(m_output.c_str(), "wb");
+
+            if (!m_stream)
+                throw capture_exception{ "Could not open the capture output " + m_output };
+        }
+
+        GLint previous = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previous);
+
+        for (auto& slot : m_slots) {
+            glGenBuffers(1, &slot.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(m_width) * m_height * 4, nullptr, GL_STREAM_READ);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, previous);
+    }
+
+    FrameCapture& FrameCapture::capture() {
+        // hand every finished readback to the workers, oldest first so they get them in frame order
+        for (std::size_t i = 0; i < ringSize; i++) {
+            Slot& slot = m_slots[(m_next + i) % ringSize];
+            if (slot.state != SlotState::Reading)
+                continue;
+
+            GLenum status = glClientWaitSync(slot.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+
+            startEncoding(slot);
+        }
+
+        Slot& slot = m_slots[m_next];
+        if (slot.state == SlotState::Reading) {
+            waitForFence(slot);
+            startEncoding(slot);
+        }
+        if (slot.state == SlotState::Encoding)
+            release(slot);
+
+        GLint previous = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previous);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glReadPixels(0, 0, GLsizei(m_width), GLsizei(m_height), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, previous);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.frame = m_captured++;
+        slot.state = SlotState::Reading;
+
+        m_next = (m_next + 1) % ringSize;
+        return *this;
+    }
+
+    FrameCapture& FrameCapture::finish() {
+        for (std::size_t i = 0; i < ringSize; i++) {
+            Slot& slot = m_slots[(m_next + i) % ringSize];
+            if (slot.state == SlotState::Reading) {
+                waitForFence(slot);
+                startEncoding(slot);
+            }
+        }
+
+        for (std::size_t i = 0; i < ringSize; i++) {
+            Slot& slot = m_slots[(m_next + i) % ringSize];
+            if (slot.state == SlotState::Encoding)
+                release(slot);
+        }
+
+        if (m_stream)
+            std::fflush(m_stream);
+
+        return *this;
+    }
+
+    void FrameCapture::waitForFence(Slot& slot) {
+        for (;;) {
+            GLenum status = glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+
+            if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+                return;
+            if (status == GL_WAIT_FAILED)
+                throw capture_exception{ "Waiting for a frame readback failed" };
+        }
+    }
+
+    void FrameCapture::startEncoding(Slot& slot) {
+        glDeleteSync(slot.fence);
+        slot.fence = nullptr;
+
+        GLint previous = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previous);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        const auto* pixels = static_cast<const std::uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(m_width) * m_height * 4, GL_MAP_READ_BIT));
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, previous);
+
+        // a failed mapping still goes to the workers: in a stream it has to take its turn,
+        // or every later frame would wait for it forever
+        slot.state = SlotState::Encoding;
+        slot.encoding = m_pool.submit([this, frame = slot.frame, pixels]() { encode(frame, pixels); });
+    }
+
+    void FrameCapture::release(Slot& slot) {
+        std::exception_ptr error;
+        try {
+            slot.encoding.get();
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        GLint previous = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previous);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, previous);
+
+        slot.state = SlotState::Free;
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    void FrameCapture::encode(std::size_t frame, const std::uint8_t* pixels) {
+        if (m_format != Format::Y4m) {
+            if (!pixels)
+                throw capture_exception{ "Could not map the pixels of frame " + std::to_string(frame) };
+
+            std::vector<char> path(m_output.size() + 32);
+            std::snprintf(path.data(), path.size(), m_output.c_str(), unsigned(frame));
+
+            writeFile(path.data(), m_format == Format::Png ? ImageEncoder::encodePng(pixels, m_width, m_height) : ImageEncoder::encodePpm(pixels, m_width, m_height));
+            m_written++;
+            return;
+        }
+
+        // conversion runs in parallel, only the write itself is serialized
+        std::vector<std::uint8_t> data;
+        if (frame == 0)
+            data = ImageEncoder::y4mHeader(m_width, m_height, m_frameRate);
+        if (pixels)
+            ImageEncoder::encodeY4mFrame(pixels, m_width, m_height, data);
+
+        std::unique_lock<std::mutex> lock{ m_streamMutex };
+        m_streamTurn.wait(lock, [&]() { return m_nextStreamFrame == frame; });
+
+        bool isWritten = pixels && std::fwrite(data.data(), 1, data.size(), m_stream) == data.size();
+
+        m_nextStreamFrame++;
+        lock.unlock();
+        m_streamTurn.notify_all();
+
+        if (!isWritten)
+            throw capture_exception{ "Could not write frame " + std::to_string(frame) + " to " + m_output };
+
+        m_written++;
+    }
+
+    void FrameCapture::writeFile(const std::string& path, const std::vector<std::uint8_t>& data) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file)
+            throw capture_exception{ "Could not open " + path };
+
+        bool isWritten = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+        isWritten = std::fclose(file) == 0 && isWritten;
+
+        if (!isWritten)
+            throw capture_exception{ "Could not write " + path };
+    }
+
+    FrameCapture::~FrameCapture() {
+        try {
+            finish();
+        } catch (...) {
+            // nowhere to report it from a destructor, call finish() first to see the errors
+        }
+
+        for (auto& slot : m_slots) {
+            if (slot.state == SlotState::Encoding) {
+                slot.encoding.wait();
+
+                glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            }
+
+            if (slot.fence)
+                glDeleteSync(slot.fence);
+
+            glDeleteBuffers(1, &slot.buffer);
+        }
+
+        if (m_stream) {
+            if (m_isPipe)
+                pclose(m_stream);
+            else
+                std::fclose(m_stream);
+        }
+    }
+}
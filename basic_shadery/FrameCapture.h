@@ -0,0 +1,119 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GlDispatch.h"
+
+#include "ThreadPool.h"
+#include "exceptions.h"
+
+namespace gl
+{
+    class capture_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        capture_exception(): message(), super() {}
+        capture_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Writes rendered frames out without stalling the GL pipeline.
+    //
+    // capture() only queues a glReadPixels into one of a ring of pixel pack buffers and
+    // drops a fence after it. Once the GPU has passed the fence, the buffer is mapped and
+    // the worker pool encodes straight out of the mapping; the buffer is unmapped and reused
+    // when the ring comes around to it again. The render thread only ever waits when every
+    // buffer is still in flight, i.e. when the encoders cannot keep up.
+    //
+    // Png and Ppm write one file per frame, `output` being a printf pattern for the frame
+    // number ("frames/%05u.png"). Y4m writes one raw 4:2:0 stream to the `output` file,
+    // or into a program's stdin when it starts with '|' ("|ffmpeg -i - out.mp4").
+    class FrameCapture {
+    public:
+        enum class Format {
+            Png,
+            Ppm,
+            Y4m
+        };
+
+        static constexpr std::size_t ringSize = 4;
+
+        FrameCapture(unsigned width, unsigned height, Format format, std::string output, ThreadPool& pool = ThreadPool::shared());
+
+        FrameCapture(const FrameCapture&) = delete;
+        FrameCapture& operator=(const FrameCapture&) = delete;
+
+        // y4m only, has to be set before the first frame is written
+        FrameCapture& setFrameRate(unsigned framesPerSecond) {
+            m_frameRate = framesPerSecond;
+            return *this;
+        }
+
+        // reads the lower left width x height pixels of the bound read framebuffer.
+        // Encoding errors of earlier frames are rethrown from here.
+        FrameCapture& capture();
+
+        // blocks until every captured frame is written
+        FrameCapture& finish();
+
+        std::size_t capturedCount() const { return m_captured; }
+        std::size_t writtenCount() const { return m_written; }
+
+        static bool isSupported() { return GLEW_VERSION_3_2 || GLEW_ARB_sync; }
+
+        ~FrameCapture();
+
+    private:
+        enum class SlotState {
+            Free,
+            Reading,    // glReadPixels queued, waiting for the fence
+            Encoding    // mapped, a worker is reading it
+        };
+
+        struct Slot {
+            GLuint buffer = 0;
+            GLsync fence = nullptr;
+            std::size_t frame = 0;
+            SlotState state = SlotState::Free;
+            std::future<void> encoding;
+        };
+
+        void waitForFence(Slot& slot);
+        void startEncoding(Slot& slot);
+        void release(Slot& slot);
+
+        void encode(std::size_t frame, const std::uint8_t* pixels);
+        void writeFile(const std::string& path, const std::vector<std::uint8_t>& data);
+
+        unsigned m_width, m_height;
+        Format m_format;
+        std::string m_output;
+        unsigned m_frameRate;
+        ThreadPool& m_pool;
+
+        std::array<Slot, ringSize> m_slots;
+        std::size_t m_next;
+        std::size_t m_captured;
+        std::atomic<std::size_t> m_written;
+
+        // the y4m stream is written by whichever worker finishes, but strictly in frame order
+        std::FILE* m_stream;
+        bool m_isPipe;
+        std::mutex m_streamMutex;
+        std::condition_variable m_streamTurn;
+        std::size_t m_nextStreamFrame;
+    };
+}
@@ -0,0 +1,121 @@
+﻿#include "FrameTimingLog.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    namespace
+    {
+        void printStats(std::ostream& out, const char* name, std::vector<double> times) {
+            if (times.empty())
+                return;
+
+            std::sort(times.begin(), times.end());
+            auto percentile = [&](double p) { return times[std::min(times.size() - 1, std::size_t(p * times.size()))]; };
+
+            out << name << " ms: mean " << std::accumulate(times.begin(), times.end(), .0) / times.size()
+                << ", p50 " << percentile(.5)
+                << ", p95 " << percentile(.95)
+                << ", p99 " << percentile(.99)
+                << ", max " << times.back() << "\n";
+        }
+    }
+
+    FrameTimingLog::FrameTimingLog(const std::string& path):
+        m_file(),
+        m_gpuTimer(GpuTimer::isSupported() ? std::make_unique<GpuTimer>() : nullptr),
+        m_frameStart(),
+        m_timeStep(.0f),
+        m_isGpuMeasured(false),
+        m_pending(),
+        m_cpuTimes(),
+        m_gpuTimes()
+    {
+        if (path.empty())
+            return;
+
+        m_file.open(path, std::ios::trunc);
+        if (!m_file)
+            throw exception{ ("Could not create " + path).c_str() };
+
+        m_file << "frame,timestep_us,cpu_ms,gpu_ms\n";
+    }
+
+    void FrameTimingLog::beginFrame(float timeStep) {
+        m_timeStep = timeStep;
+        m_isGpuMeasured = m_gpuTimer && m_gpuTimer->begin();
+        m_frameStart = std::chrono::steady_clock::now();
+    }
+
+    void FrameTimingLog::endFrame() {
+        double cpu = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_frameStart).count();
+
+        if (m_isGpuMeasured)
+            m_gpuTimer->end();
+
+        m_pending.push_back({ m_cpuTimes.size(), m_timeStep, cpu, .0, m_isGpuMeasured, false });
+        m_cpuTimes.push_back(cpu);
+
+        pollGpu(false);
+        writeRows();
+    }
+
+    void FrameTimingLog::pollGpu(bool wait) {
+        if (!m_gpuTimer)
+            return;
+
+        auto awaiting = [this]() {
+            return std::find_if(m_pending.begin(), m_pending.end(), [](const Row& row) { return row.isGpuMeasured && !row.isGpuDone; });
+        };
+
+        // results come back in submission order, the same order the measured rows are in
+        for (auto row = awaiting(); row != m_pending.end(); row = awaiting()) {
+            double milliseconds;
+            if (!m_gpuTimer->poll(milliseconds)) {
+                if (!wait)
+                    break;
+                continue;
+            }
+
+            row->gpuMilliseconds = milliseconds;
+            row->isGpuDone = true;
+        }
+    }
+
+    void FrameTimingLog::writeRows() {
+        while (!m_pending.empty() && (!m_pending.front().isGpuMeasured || m_pending.front().isGpuDone)) {
+            const Row& row = m_pending.front();
+
+            if (row.isGpuDone)
+                m_gpuTimes.push_back(row.gpuMilliseconds);
+
+            if (m_file.is_open()) {
+                m_file << row.frame << "," << row.timeStep << "," << row.cpuMilliseconds << ",";
+                if (row.isGpuDone)
+                    m_file << row.gpuMilliseconds;
+                m_file << "\n";
+            }
+
+            m_pending.pop_front();
+        }
+    }
+
+    void FrameTimingLog::printSummary(std::ostream& out) const {
+        out << m_cpuTimes.size() << " frames\n";
+        printStats(out, "CPU", m_cpuTimes);
+        printStats(out, "GPU", m_gpuTimes);
+    }
+
+    FrameTimingLog& FrameTimingLog::finish() {
+        pollGpu(true);
+        writeRows();
+        return *this;
+    }
+
+    FrameTimingLog::~FrameTimingLog() {
+        finish();
+    }
+}
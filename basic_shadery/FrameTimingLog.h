@@ -0,0 +1,65 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "GpuTimer.h"
+
+namespace gl
+{
+    // Per-frame timings as CSV (frame, timestep_us, cpu_ms, gpu_ms), for comparing two
+    // builds frame by frame on the same replayed camera path. CPU time is wall clock from
+    // beginFrame() to endFrame(); GPU time comes from a GpuTimer when the context has one,
+    // so rows are written a few frames late, once their query result is in.
+    class FrameTimingLog {
+    public:
+        // empty path: nothing is written, only the summary is kept
+        explicit FrameTimingLog(const std::string& path = "");
+
+        FrameTimingLog(const FrameTimingLog&) = delete;
+        FrameTimingLog& operator=(const FrameTimingLog&) = delete;
+
+        void beginFrame(float timeStep);
+        void endFrame();
+
+        // waits for the outstanding GPU results and writes their rows
+        FrameTimingLog& finish();
+
+        std::size_t frameCount() const { return m_cpuTimes.size(); }
+
+        // mean and percentiles of the CPU (and GPU) frame times written so far
+        void printSummary(std::ostream& out) const;
+
+        ~FrameTimingLog();
+
+    private:
+        struct Row {
+            std::size_t frame;
+            float timeStep;
+            double cpuMilliseconds;
+            double gpuMilliseconds;
+            bool isGpuMeasured;
+            bool isGpuDone;
+        };
+
+        void pollGpu(bool wait);
+        void writeRows();
+
+        std::ofstream m_file;
+        std::unique_ptr<GpuTimer> m_gpuTimer;
+
+        std::chrono::steady_clock::time_point m_frameStart;
+        float m_timeStep;
+        bool m_isGpuMeasured;
+
+        std::deque<Row> m_pending;
+        std::vector<double> m_cpuTimes;
+        std::vector<double> m_gpuTimes;
+    };
+}
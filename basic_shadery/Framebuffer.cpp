@@ -0,0 +1,28 @@
+﻿#include "Framebuffer.h"
+
+namespace gl
+{
+    Framebuffer& Framebuffer::checkStatus() {
+        switch (glCheckFramebufferStatus(GL_FRAMEBUFFER)) {
+        case GL_FRAMEBUFFER_COMPLETE:
+            return *this;
+        case GL_FRAMEBUFFER_INCOMPLETE_ATTACHMENT:
+            throw framebuffer_exception{ "Framebuffer has an incomplete attachment" };
+        case GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT:
+            throw framebuffer_exception{ "Framebuffer has no attachments" };
+        case GL_FRAMEBUFFER_UNSUPPORTED:
+            throw framebuffer_exception{ "Framebuffer attachment formats are not supported" };
+        default:
+            throw framebuffer_exception{ "Framebuffer is not complete" };
+        }
+    }
+
+    const Framebuffer& Framebuffer::blit(GLuint target, const glm::ivec4& source, const glm::ivec4& destination, GLbitfield mask, GLenum filter) const {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_fboId);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        glBlitFramebuffer(source.x, source.y, source.z, source.w, destination.x, destination.y, destination.z, destination.w, mask, filter);
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+
+        return *this;
+    }
+}
@@ -0,0 +1,78 @@
+﻿#pragma once
+
+#include <utility>
+
+#include "GlDispatch.h"
+#include <glm/vec4.hpp>
+
+#include "Texture.h"
+#include "exceptions.h"
+
+namespace gl
+{
+    class framebuffer_exception : public exception {
+        using super = exception;
+    public:
+        framebuffer_exception(): super() {}
+        framebuffer_exception(const char* message): super(message) {}
+        framebuffer_exception(const char* message, int code): super(message, code) {}
+    };
+
+    class Framebuffer {
+    public:
+        Framebuffer(): m_fboId(0) {
+            glGenFramebuffers(1, &m_fboId);
+        }
+
+        Framebuffer(const Framebuffer&) = delete;
+        Framebuffer& operator=(const Framebuffer&) = delete;
+
+        Framebuffer(Framebuffer&& other) noexcept: m_fboId(0) {
+            std::swap(m_fboId, other.m_fboId);
+        }
+        Framebuffer& operator=(Framebuffer&& other) noexcept {
+            if (this != &other) {
+                std::swap(m_fboId, other.m_fboId);
+            }
+            return *this;
+        }
+
+        Framebuffer& bind() {
+            glBindFramebuffer(GL_FRAMEBUFFER, m_fboId);
+            return *this;
+        };
+
+        // binds the window's default framebuffer back
+        static void unbind() {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+        // expects the framebuffer to be bound
+        Framebuffer& attachColor(const Texture& texture, GLuint colorNr = 0) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + colorNr, GL_TEXTURE_2D, texture.getId(), 0);
+            return *this;
+        };
+
+        // expects the framebuffer to be bound, the texture allocated with Texture::Format::Depth24
+        Framebuffer& attachDepth(const Texture& texture) {
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, texture.getId(), 0);
+            return *this;
+        };
+
+        Framebuffer& checkStatus();
+
+        // copies the source rectangle of this framebuffer into the target one of the framebuffer
+        // with id target (0 is the window), scaling with the filter if the sizes differ.
+        // Rectangles hold the min corner in xy and the max corner in zw. Leaves target bound.
+        const Framebuffer& blit(GLuint target, const glm::ivec4& source, const glm::ivec4& destination, GLbitfield mask = GL_COLOR_BUFFER_BIT, GLenum filter = GL_LINEAR) const;
+
+        GLuint getId() const { return m_fboId; }
+
+        ~Framebuffer() {
+            glDeleteFramebuffers(1, &m_fboId);
+        };
+
+    private:
+        GLuint m_fboId;
+    };
+}
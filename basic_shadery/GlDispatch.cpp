@@ -0,0 +1,309 @@
+﻿// the capture helpers query GL state themselves, which must not end up in the capture
+#define GL_DISPATCH_DISABLED
+#include "GlDispatch.h"
+
+#include <iomanip>
+#include <memory>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    namespace
+    {
+        const char captureMagic[8] = { 'G', 'R', 'A', 'F', 'G', 'L', 'C', '\0' };
+        const std::uint32_t captureVersion = 1;
+
+        // large uploads are written out as they come instead of piling up until the frame ends
+        const std::size_t flushThreshold = 4 << 20;
+
+        std::unique_ptr<GlCaptureWriter> captureWriter;
+
+        std::size_t componentCount(GLenum format) {
+            switch (format) {
+            case GL_RG:
+            case GL_RG_INTEGER:
+            case GL_DEPTH_STENCIL:
+                return 2;
+            case GL_RGB:
+            case GL_BGR:
+            case GL_RGB_INTEGER:
+            case GL_BGR_INTEGER:
+                return 3;
+            case GL_RGBA:
+            case GL_BGRA:
+            case GL_RGBA_INTEGER:
+            case GL_BGRA_INTEGER:
+                return 4;
+            default:
+                return 1;
+            }
+        }
+
+        // size of a pixel, for packed types all components together are one value
+        std::size_t pixelSize(GLenum format, GLenum type) {
+            switch (type) {
+            case GL_UNSIGNED_BYTE_3_3_2:
+            case GL_UNSIGNED_BYTE_2_3_3_REV:
+                return 1;
+            case GL_UNSIGNED_SHORT_5_6_5:
+            case GL_UNSIGNED_SHORT_5_6_5_REV:
+            case GL_UNSIGNED_SHORT_4_4_4_4:
+            case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+            case GL_UNSIGNED_SHORT_5_5_5_1:
+            case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+                return 2;
+            case GL_UNSIGNED_INT_8_8_8_8:
+            case GL_UNSIGNED_INT_8_8_8_8_REV:
+            case GL_UNSIGNED_INT_10_10_10_2:
+            case GL_UNSIGNED_INT_2_10_10_10_REV:
+            case GL_UNSIGNED_INT_24_8:
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+            case GL_UNSIGNED_INT_5_9_9_9_REV:
+                return 4;
+            case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+                return 8;
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                return componentCount(format);
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+            case GL_HALF_FLOAT:
+                return componentCount(format) * 2;
+            default:
+                return componentCount(format) * 4;
+            }
+        }
+
+        std::size_t indexSize(GLenum type) {
+            switch (type) {
+            case GL_UNSIGNED_BYTE:
+                return 1;
+            case GL_UNSIGNED_SHORT:
+                return 2;
+            default:
+                return 4;
+            }
+        }
+    }
+
+    std::uint64_t GlStats::totalCalls() const {
+        std::uint64_t total = 0;
+        for (auto count : calls)
+            total += count;
+        return total;
+    }
+
+    GlStats& GlStats::operator+=(const GlStats& other) {
+        for (std::size_t i = 0; i < static_cast<std::size_t>(GlCategory::Count); i++)
+            calls[i] += other.calls[i];
+
+        bufferBytes += other.bufferBytes;
+        textureBytes += other.textureBytes;
+        uniformBytes += other.uniformBytes;
+        return *this;
+    }
+
+    std::size_t imageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type, GLint alignment) {
+        if (width <= 0 || height <= 0)
+            return 0;
+
+        // GL_[UN]PACK_ROW_LENGTH and the skip parameters are not used by the project and not accounted for
+        std::size_t row = width * pixelSize(format, type);
+        std::size_t stride = (row + alignment - 1) / alignment * alignment;
+        return stride * (height - 1) + row;
+    }
+
+    GlCaptureWriter::GlCaptureWriter(const std::string& path, GLint width, GLint height):
+        m_file(path, std::ios::binary),
+        m_buffer(),
+        m_frames(0)
+    {
+        if (!m_file.is_open())
+            throw exception{ ("Could not open GL capture file " + path).c_str() };
+
+        m_file.write(captureMagic, sizeof(captureMagic));
+        put(captureVersion).put(width).put(height);
+    }
+
+    GlCaptureWriter& GlCaptureWriter::putBytes(const void* data, std::size_t size) {
+        put(std::uint8_t(data != nullptr));
+        if (!data)
+            return *this;
+
+        put(std::uint64_t(size));
+
+        std::size_t offset = m_buffer.size();
+        m_buffer.resize(offset + size);
+        std::memcpy(m_buffer.data() + offset, data, size);
+
+        if (m_buffer.size() > flushThreshold)
+            flush();
+        return *this;
+    }
+
+    GlCaptureWriter& GlCaptureWriter::putString(const char* str, GLint length) {
+        std::uint32_t size = length < 0 ? static_cast<std::uint32_t>(std::strlen(str)) : length;
+        put(size);
+
+        std::size_t offset = m_buffer.size();
+        m_buffer.resize(offset + size);
+        std::memcpy(m_buffer.data() + offset, str, size);
+        return *this;
+    }
+
+    void GlCaptureWriter::endFrame() {
+        begin(GlCall::EndFrame);
+        flush();
+        m_file.flush();
+        m_frames++;
+    }
+
+    void GlCaptureWriter::flush() {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+        m_buffer.clear();
+    }
+
+    GlCaptureWriter::~GlCaptureWriter() {
+        flush();
+    }
+
+    void GlDispatch::setCounting(bool enabled) {
+        s_isCounting = enabled;
+        s_frame = {};
+        updateActive();
+    }
+
+    void GlDispatch::startCapture(const std::string& path) {
+        stopCapture();
+
+        GLint viewport[4] = {};
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        captureWriter = std::make_unique<GlCaptureWriter>(path, viewport[2], viewport[3]);
+        s_capture = captureWriter.get();
+        updateActive();
+    }
+
+    void GlDispatch::stopCapture() {
+        s_capture = nullptr;
+        captureWriter.reset();
+        updateActive();
+    }
+
+    void GlDispatch::endFrame() {
+        if (s_capture)
+            s_capture->endFrame();
+
+        if (s_isCounting) {
+            s_lastFrame = s_frame;
+            s_total += s_frame;
+            s_frames++;
+            s_frame = {};
+        }
+    }
+
+    void GlDispatch::printSummary(std::ostream& out) {
+        if (s_frames == 0)
+            return;
+
+        const char* names[] = { "draw", "bind", "uniform", "transfer", "state", "object", "query" };
+        static_assert(sizeof(names) / sizeof(*names) == static_cast<std::size_t>(GlCategory::Count), "every category needs a name");
+
+        double frames = static_cast<double>(s_frames);
+        out << std::fixed << std::setprecision(1)
+            << "GL calls per frame over " << s_frames << " frames: " << s_total.totalCalls() / frames << "\n";
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(GlCategory::Count); i++)
+            out << "  " << std::setw(9) << std::left << names[i] << std::right << std::setw(10) << s_total.calls[i] / frames << "\n";
+
+        out << "  buffer uploads  " << s_total.bufferBytes / frames / 1024 << " KiB/frame\n"
+            << "  texture uploads " << s_total.textureBytes / frames / 1024 << " KiB/frame\n"
+            << "  uniform uploads " << s_total.uniformBytes / frames << " B/frame\n";
+    }
+
+    void GlApi::captureDrawElements(GlCaptureWriter& capture, GLenum mode, GLsizei count, GLenum type, const void* indices) {
+        GLint elementBuffer = 0;
+        glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &elementBuffer);
+
+        capture.begin(GlCall::DrawElements).put(mode).put(count).put(type).put(std::uint8_t(elementBuffer != 0));
+
+        // without an element buffer the indices live in client memory and go into the capture
+        if (elementBuffer)
+            capture.put(std::uint64_t(reinterpret_cast<std::uintptr_t>(indices)));
+        else
+            capture.putBytes(indices, count * indexSize(type));
+    }
+
+    void GlApi::captureReadPixels(GlCaptureWriter& capture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels) {
+        GLint packBuffer = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &packBuffer);
+
+        capture.begin(GlCall::ReadPixels).put(x).put(y).put(width).put(height).put(format).put(type).put(std::uint8_t(packBuffer != 0));
+
+        // into client memory the replayer reads into a scratch buffer, only the offset matters for a buffer
+        if (packBuffer)
+            capture.put(std::uint64_t(reinterpret_cast<std::uintptr_t>(pixels)));
+    }
+
+    void GlApi::captureTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+        GLint unpackBuffer = 0, alignment = 4;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+
+        std::size_t bytes = imageBytes(width, height, format, type, alignment);
+        countBytes(&GlStats::textureBytes, pixels || unpackBuffer ? bytes : 0);
+
+        auto* capture = interceptCall(GlCategory::Transfer);
+        if (!capture)
+            return;
+
+        capture->begin(GlCall::TexImage2D).put(target).put(level).put(internalFormat).put(width).put(height).put(border).put(format).put(type).put(std::uint8_t(unpackBuffer != 0));
+
+        if (unpackBuffer)
+            capture->put(std::uint64_t(reinterpret_cast<std::uintptr_t>(pixels)));
+        else
+            capture->putBytes(pixels, bytes);
+    }
+
+    void GlApi::captureTexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels) {
+        GLint unpackBuffer = 0, alignment = 4;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+
+        // the layers follow each other, each one padded like a 2D image
+        std::size_t bytes = imageBytes(width, height, format, type, alignment) * depth;
+        countBytes(&GlStats::textureBytes, pixels || unpackBuffer ? bytes : 0);
+
+        auto* capture = interceptCall(GlCategory::Transfer);
+        if (!capture)
+            return;
+
+        capture->begin(GlCall::TexImage3D).put(target).put(level).put(internalFormat).put(width).put(height).put(depth).put(border).put(format).put(type).put(std::uint8_t(unpackBuffer != 0));
+
+        if (unpackBuffer)
+            capture->put(std::uint64_t(reinterpret_cast<std::uintptr_t>(pixels)));
+        else
+            capture->putBytes(pixels, bytes);
+    }
+
+    void GlApi::captureTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) {
+        GLint unpackBuffer = 0, alignment = 4;
+        glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &unpackBuffer);
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+
+        std::size_t bytes = imageBytes(width, height, format, type, alignment);
+        countBytes(&GlStats::textureBytes, bytes);
+
+        auto* capture = interceptCall(GlCategory::Transfer);
+        if (!capture)
+            return;
+
+        capture->begin(GlCall::TexSubImage2D).put(target).put(level).put(xoffset).put(yoffset).put(width).put(height).put(format).put(type).put(std::uint8_t(unpackBuffer != 0));
+
+        if (unpackBuffer)
+            capture->put(std::uint64_t(reinterpret_cast<std::uintptr_t>(pixels)));
+        else
+            capture->putBytes(pixels, bytes);
+    }
+}
@@ -0,0 +1,1132 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <GL/glew.h>
+
+namespace gl
+{
+    // what an intercepted GL call is counted as
+    enum class GlCategory : std::uint8_t {
+        Draw,
+        Bind,
+        Uniform,
+        Transfer,   // buffer and texture uploads, readbacks, mapping
+        State,
+        Object,     // creating, deleting, compiling and linking objects
+        Query,      // queries, fences and glGet*
+        Count
+    };
+
+    struct GlStats {
+        std::uint64_t calls[static_cast<std::size_t>(GlCategory::Count)] = {};
+        std::uint64_t bufferBytes = 0;
+        std::uint64_t textureBytes = 0;
+        std::uint64_t uniformBytes = 0;
+
+        std::uint64_t count(GlCategory category) const { return calls[static_cast<std::size_t>(category)]; }
+        std::uint64_t totalCalls() const;
+
+        GlStats& operator+=(const GlStats& other);
+    };
+
+    // Calls as stored in capture files. New calls go at the end, the values are the file format.
+    enum class GlCall : std::uint16_t {
+        EndFrame,
+        ActiveTexture,
+        AttachShader,
+        BindBuffer,
+        BindFragDataLocation,
+        BindFramebuffer,
+        BindTexture,
+        BindVertexArray,
+        BufferData,
+        CheckFramebufferStatus,
+        Clear,
+        ClearColor,
+        ClientWaitSync,
+        CompileShader,
+        CreateProgram,
+        CreateShader,
+        DeleteBuffers,
+        DeleteFramebuffers,
+        DeleteProgram,
+        DeleteQueries,
+        DeleteShader,
+        DeleteSync,
+        DeleteTextures,
+        DeleteVertexArrays,
+        Disable,
+        DrawArrays,
+        DrawElements,
+        Enable,
+        EnableVertexAttribArray,
+        FenceSync,
+        FramebufferTexture2D,
+        GenBuffers,
+        GenFramebuffers,
+        GenQueries,
+        GenTextures,
+        GenVertexArrays,
+        GenerateMipmap,
+        GetAttribLocation,
+        GetIntegerv,
+        GetProgramInfoLog,
+        GetProgramiv,
+        GetQueryObjectiv,
+        GetQueryObjectui64v,
+        GetShaderInfoLog,
+        GetShaderiv,
+        GetUniformLocation,
+        IsEnabled,
+        LinkProgram,
+        MapBufferRange,
+        PixelStorei,
+        ProgramUniform1f,
+        ProgramUniform1i,
+        ProgramUniform1ui,
+        ProgramUniform2f,
+        ProgramUniform2i,
+        ProgramUniform2ui,
+        ProgramUniform3f,
+        ProgramUniform3i,
+        ProgramUniform3ui,
+        ProgramUniform4f,
+        ProgramUniform4i,
+        ProgramUniform4ui,
+        ProgramUniformMatrix2fv,
+        ProgramUniformMatrix2x3fv,
+        ProgramUniformMatrix2x4fv,
+        ProgramUniformMatrix3fv,
+        ProgramUniformMatrix3x2fv,
+        ProgramUniformMatrix3x4fv,
+        ProgramUniformMatrix4fv,
+        ProgramUniformMatrix4x2fv,
+        ProgramUniformMatrix4x3fv,
+        QueryCounter,
+        ReadPixels,
+        ShaderSource,
+        TexImage2D,
+        TextureParameteri,
+        TextureParameteriv,
+        UnmapBuffer,
+        UseProgram,
+        VertexAttribPointer,
+        Viewport,
+        BlitFramebuffer,
+        GetActiveAttrib,
+        GetActiveUniform,
+        GetActiveUniformBlockName,
+        GetActiveUniformBlockiv,
+        TexSubImage2D,
+        Flush,
+        WaitSync,
+        BeginQuery,
+        BeginTransformFeedback,
+        BindBufferBase,
+        BindTransformFeedback,
+        BlendFunc,
+        DeleteTransformFeedbacks,
+        DepthMask,
+        DrawTransformFeedback,
+        EndQuery,
+        EndTransformFeedback,
+        GenTransformFeedbacks,
+        TransformFeedbackVaryings,
+        TexBuffer,
+        FramebufferTexture,
+        TexImage3D
+    };
+
+    // Appends intercepted calls to a capture file: a header with the viewport size the capture
+    // was started with, then per call its GlCall id
+    // followed by the arguments in order. Names returned by GL (glGen*, glCreate*, fences)
+    // and uniform locations are written after the call, so the replayer can map them to
+    // its own. Data behind pointers is written as a size followed by the bytes.
+    class GlCaptureWriter {
+    public:
+        GlCaptureWriter(const std::string& path, GLint width, GLint height);
+
+        GlCaptureWriter(const GlCaptureWriter&) = delete;
+        GlCaptureWriter& operator=(const GlCaptureWriter&) = delete;
+
+        GlCaptureWriter& begin(GlCall call) {
+            return put(call);
+        }
+
+        template<typename T>
+        GlCaptureWriter& put(const T& value) {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values can be captured");
+
+            std::size_t size = m_buffer.size();
+            m_buffer.resize(size + sizeof(T));
+            std::memcpy(m_buffer.data() + size, &value, sizeof(T));
+            return *this;
+        }
+
+        // nullptr is kept apart from an empty block
+        GlCaptureWriter& putBytes(const void* data, std::size_t size);
+        GlCaptureWriter& putString(const char* str, GLint length = -1);
+
+        void endFrame();
+
+        std::uint64_t frameCount() const { return m_frames; }
+
+        ~GlCaptureWriter();
+
+    private:
+        void flush();
+
+        std::ofstream m_file;
+        std::vector<unsigned char> m_buffer;
+        std::uint64_t m_frames;
+    };
+
+    // Every GL function the project calls goes through a GlApi wrapper: the glXxx names are
+    // redefined below to point at them. With nothing enabled a wrapper costs one predictable
+    // branch before the real call; defining GL_DISPATCH_DISABLED drops the redefinitions and
+    // with them any overhead. Counters and capture cover the thread that enabled them, the one
+    // owning the window's context; calls from GL worker threads are neither counted nor captured.
+    class GlDispatch {
+    public:
+        static void setCounting(bool enabled);
+        static bool isCounting() { return s_isCounting; }
+
+        // a capture can be replayed only if it was started before the first GL object was
+        // created, the replayer does not know about anything older
+        static void startCapture(const std::string& path);
+        static void stopCapture();
+        static bool isCapturing() { return s_capture != nullptr; }
+
+        // at buffer swap: closes the frame's counters and marks the frame end in the capture
+        static void endFrame();
+
+        const static GlStats& lastFrame() { return s_lastFrame; }
+        const static GlStats& total() { return s_total; }
+        static std::uint64_t frameCount() { return s_frames; }
+
+        // per-frame averages of the counters since counting was enabled
+        static void printSummary(std::ostream& out);
+
+        // state for the inline wrappers
+
+        static inline thread_local bool s_isActive = false;  // counting or capturing, on this thread
+        static inline bool s_isCounting = false;
+        static inline GlStats s_frame;
+        static inline GlCaptureWriter* s_capture = nullptr;
+
+    private:
+        static void updateActive() { s_isActive = s_isCounting || s_capture; }
+
+        static inline GlStats s_lastFrame;
+        static inline GlStats s_total;
+        static inline std::uint64_t s_frames = 0;
+    };
+
+    // counts the call, returns the writer when a capture is running
+    inline GlCaptureWriter* interceptCall(GlCategory category) {
+        if (!GlDispatch::s_isActive)
+            return nullptr;
+
+        if (GlDispatch::s_isCounting)
+            GlDispatch::s_frame.calls[static_cast<std::size_t>(category)]++;
+        return GlDispatch::s_capture;
+    }
+
+    inline void countBytes(std::uint64_t GlStats::* counter, std::uint64_t bytes) {
+        if (GlDispatch::s_isCounting)
+            GlDispatch::s_frame.*counter += bytes;
+    }
+
+    // bytes glTexImage2D/glReadPixels read or write for an image, given the pack/unpack alignment
+    std::size_t imageBytes(GLsizei width, GLsizei height, GLenum format, GLenum type, GLint alignment);
+
+    // values taken by glTextureParameteriv for a parameter
+    inline std::size_t textureParameterCount(GLenum pname) {
+        return pname == GL_TEXTURE_SWIZZLE_RGBA || pname == GL_TEXTURE_BORDER_COLOR ? 4 : 1;
+    }
+
+    struct GlApi {
+        static void activeTexture(GLenum texture) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::ActiveTexture).put(texture);
+            glActiveTexture(texture);
+        }
+
+        static void attachShader(GLuint program, GLuint shader) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::AttachShader).put(program).put(shader);
+            glAttachShader(program, shader);
+        }
+
+        static void beginQuery(GLenum target, GLuint id) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::BeginQuery).put(target).put(id);
+            glBeginQuery(target, id);
+        }
+
+        static void beginTransformFeedback(GLenum primitiveMode) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::BeginTransformFeedback).put(primitiveMode);
+            glBeginTransformFeedback(primitiveMode);
+        }
+
+        static void bindBuffer(GLenum target, GLuint buffer) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::BindBuffer).put(target).put(buffer);
+            glBindBuffer(target, buffer);
+        }
+
+        static void bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::BindBufferBase).put(target).put(index).put(buffer);
+            glBindBufferBase(target, index, buffer);
+        }
+
+        static void bindFragDataLocation(GLuint program, GLuint color, const GLchar* name) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::BindFragDataLocation).put(program).put(color).putString(name);
+            glBindFragDataLocation(program, color, name);
+        }
+
+        static void bindFramebuffer(GLenum target, GLuint framebuffer) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::BindFramebuffer).put(target).put(framebuffer);
+            glBindFramebuffer(target, framebuffer);
+        }
+
+        static void bindTexture(GLenum target, GLuint texture) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::BindTexture).put(target).put(texture);
+            glBindTexture(target, texture);
+        }
+
+        static void bindTransformFeedback(GLenum target, GLuint id) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::BindTransformFeedback).put(target).put(id);
+            glBindTransformFeedback(target, id);
+        }
+
+        static void blitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter) {
+            if (auto* capture = interceptCall(GlCategory::Draw))
+                capture->begin(GlCall::BlitFramebuffer).put(srcX0).put(srcY0).put(srcX1).put(srcY1).put(dstX0).put(dstY0).put(dstX1).put(dstY1).put(mask).put(filter);
+            glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
+        }
+
+        static void bindVertexArray(GLuint array) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::BindVertexArray).put(array);
+            glBindVertexArray(array);
+        }
+
+        static void blendFunc(GLenum sfactor, GLenum dfactor) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::BlendFunc).put(sfactor).put(dfactor);
+            glBlendFunc(sfactor, dfactor);
+        }
+
+        static void bufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+            if (GlDispatch::s_isActive) {
+                countBytes(&GlStats::bufferBytes, std::uint64_t(size));
+                if (auto* capture = interceptCall(GlCategory::Transfer))
+                    capture->begin(GlCall::BufferData).put(target).put(std::int64_t(size)).putBytes(data, std::size_t(size)).put(usage);
+            }
+            glBufferData(target, size, data, usage);
+        }
+
+        static GLenum checkFramebufferStatus(GLenum target) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::CheckFramebufferStatus).put(target);
+            return glCheckFramebufferStatus(target);
+        }
+
+        static void clear(GLbitfield mask) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::Clear).put(mask);
+            glClear(mask);
+        }
+
+        static void clearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::ClearColor).put(red).put(green).put(blue).put(alpha);
+            glClearColor(red, green, blue, alpha);
+        }
+
+        static GLenum clientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::ClientWaitSync).put(std::uint64_t(reinterpret_cast<std::uintptr_t>(sync))).put(flags).put(timeout);
+            return glClientWaitSync(sync, flags, timeout);
+        }
+
+        static void compileShader(GLuint shader) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::CompileShader).put(shader);
+            glCompileShader(shader);
+        }
+
+        static GLuint createProgram() {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            GLuint program = glCreateProgram();
+            if (capture)
+                capture->begin(GlCall::CreateProgram).put(program);
+            return program;
+        }
+
+        static GLuint createShader(GLenum type) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            GLuint shader = glCreateShader(type);
+            if (capture)
+                capture->begin(GlCall::CreateShader).put(type).put(shader);
+            return shader;
+        }
+
+        static void deleteBuffers(GLsizei n, const GLuint* buffers) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteBuffers).putBytes(buffers, n * sizeof(GLuint));
+            glDeleteBuffers(n, buffers);
+        }
+
+        static void deleteFramebuffers(GLsizei n, const GLuint* framebuffers) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteFramebuffers).putBytes(framebuffers, n * sizeof(GLuint));
+            glDeleteFramebuffers(n, framebuffers);
+        }
+
+        static void deleteProgram(GLuint program) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteProgram).put(program);
+            glDeleteProgram(program);
+        }
+
+        static void deleteQueries(GLsizei n, const GLuint* ids) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteQueries).putBytes(ids, n * sizeof(GLuint));
+            glDeleteQueries(n, ids);
+        }
+
+        static void deleteShader(GLuint shader) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteShader).put(shader);
+            glDeleteShader(shader);
+        }
+
+        static void deleteSync(GLsync sync) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::DeleteSync).put(std::uint64_t(reinterpret_cast<std::uintptr_t>(sync)));
+            glDeleteSync(sync);
+        }
+
+        static void deleteTextures(GLsizei n, const GLuint* textures) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteTextures).putBytes(textures, n * sizeof(GLuint));
+            glDeleteTextures(n, textures);
+        }
+
+        static void deleteTransformFeedbacks(GLsizei n, const GLuint* ids) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteTransformFeedbacks).putBytes(ids, n * sizeof(GLuint));
+            glDeleteTransformFeedbacks(n, ids);
+        }
+
+        static void deleteVertexArrays(GLsizei n, const GLuint* arrays) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::DeleteVertexArrays).putBytes(arrays, n * sizeof(GLuint));
+            glDeleteVertexArrays(n, arrays);
+        }
+
+        static void depthMask(GLboolean flag) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::DepthMask).put(flag);
+            glDepthMask(flag);
+        }
+
+        static void disable(GLenum cap) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::Disable).put(cap);
+            glDisable(cap);
+        }
+
+        static void drawArrays(GLenum mode, GLint first, GLsizei count) {
+            if (auto* capture = interceptCall(GlCategory::Draw))
+                capture->begin(GlCall::DrawArrays).put(mode).put(first).put(count);
+            glDrawArrays(mode, first, count);
+        }
+
+        static void drawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) {
+            if (auto* capture = interceptCall(GlCategory::Draw))
+                captureDrawElements(*capture, mode, count, type, indices);
+            glDrawElements(mode, count, type, indices);
+        }
+
+        static void drawTransformFeedback(GLenum mode, GLuint id) {
+            if (auto* capture = interceptCall(GlCategory::Draw))
+                capture->begin(GlCall::DrawTransformFeedback).put(mode).put(id);
+            glDrawTransformFeedback(mode, id);
+        }
+
+        static void enable(GLenum cap) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::Enable).put(cap);
+            glEnable(cap);
+        }
+
+        static void enableVertexAttribArray(GLuint index) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::EnableVertexAttribArray).put(index);
+            glEnableVertexAttribArray(index);
+        }
+
+        static void endQuery(GLenum target) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::EndQuery).put(target);
+            glEndQuery(target);
+        }
+
+        static void endTransformFeedback() {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::EndTransformFeedback);
+            glEndTransformFeedback();
+        }
+
+        static GLsync fenceSync(GLenum condition, GLbitfield flags) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Query);
+            GLsync sync = glFenceSync(condition, flags);
+            if (capture)
+                capture->begin(GlCall::FenceSync).put(condition).put(flags).put(std::uint64_t(reinterpret_cast<std::uintptr_t>(sync)));
+            return sync;
+        }
+
+        static void flush() {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::Flush);
+            glFlush();
+        }
+
+        static void framebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::FramebufferTexture).put(target).put(attachment).put(texture).put(level);
+            glFramebufferTexture(target, attachment, texture, level);
+        }
+
+        static void framebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::FramebufferTexture2D).put(target).put(attachment).put(textarget).put(texture).put(level);
+            glFramebufferTexture2D(target, attachment, textarget, texture, level);
+        }
+
+        static void genBuffers(GLsizei n, GLuint* buffers) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            glGenBuffers(n, buffers);
+            if (capture)
+                capture->begin(GlCall::GenBuffers).putBytes(buffers, n * sizeof(GLuint));
+        }
+
+        static void genFramebuffers(GLsizei n, GLuint* framebuffers) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            glGenFramebuffers(n, framebuffers);
+            if (capture)
+                capture->begin(GlCall::GenFramebuffers).putBytes(framebuffers, n * sizeof(GLuint));
+        }
+
+        static void genQueries(GLsizei n, GLuint* ids) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            glGenQueries(n, ids);
+            if (capture)
+                capture->begin(GlCall::GenQueries).putBytes(ids, n * sizeof(GLuint));
+        }
+
+        static void genTextures(GLsizei n, GLuint* textures) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            glGenTextures(n, textures);
+            if (capture)
+                capture->begin(GlCall::GenTextures).putBytes(textures, n * sizeof(GLuint));
+        }
+
+        static void genTransformFeedbacks(GLsizei n, GLuint* ids) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            glGenTransformFeedbacks(n, ids);
+            if (capture)
+                capture->begin(GlCall::GenTransformFeedbacks).putBytes(ids, n * sizeof(GLuint));
+        }
+
+        static void genVertexArrays(GLsizei n, GLuint* arrays) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            glGenVertexArrays(n, arrays);
+            if (capture)
+                capture->begin(GlCall::GenVertexArrays).putBytes(arrays, n * sizeof(GLuint));
+        }
+
+        static void generateMipmap(GLenum target) {
+            if (auto* capture = interceptCall(GlCategory::Transfer))
+                capture->begin(GlCall::GenerateMipmap).put(target);
+            glGenerateMipmap(target);
+        }
+
+        static void getActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetActiveAttrib).put(program).put(index).put(bufSize);
+            glGetActiveAttrib(program, index, bufSize, length, size, type, name);
+        }
+
+        static void getActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetActiveUniform).put(program).put(index).put(bufSize);
+            glGetActiveUniform(program, index, bufSize, length, size, type, name);
+        }
+
+        static void getActiveUniformBlockName(GLuint program, GLuint uniformBlockIndex, GLsizei bufSize, GLsizei* length, GLchar* uniformBlockName) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetActiveUniformBlockName).put(program).put(uniformBlockIndex).put(bufSize);
+            glGetActiveUniformBlockName(program, uniformBlockIndex, bufSize, length, uniformBlockName);
+        }
+
+        static void getActiveUniformBlockiv(GLuint program, GLuint uniformBlockIndex, GLenum pname, GLint* params) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetActiveUniformBlockiv).put(program).put(uniformBlockIndex).put(pname);
+            glGetActiveUniformBlockiv(program, uniformBlockIndex, pname, params);
+        }
+
+        static GLint getAttribLocation(GLuint program, const GLchar* name) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            GLint location = glGetAttribLocation(program, name);
+            if (capture)
+                capture->begin(GlCall::GetAttribLocation).put(program).putString(name).put(location);
+            return location;
+        }
+
+        static void getIntegerv(GLenum pname, GLint* params) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::GetIntegerv).put(pname);
+            glGetIntegerv(pname, params);
+        }
+
+        static void getProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetProgramInfoLog).put(program).put(bufSize);
+            glGetProgramInfoLog(program, bufSize, length, infoLog);
+        }
+
+        static void getProgramiv(GLuint program, GLenum pname, GLint* param) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetProgramiv).put(program).put(pname);
+            glGetProgramiv(program, pname, param);
+        }
+
+        static void getQueryObjectiv(GLuint id, GLenum pname, GLint* params) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::GetQueryObjectiv).put(id).put(pname);
+            glGetQueryObjectiv(id, pname, params);
+        }
+
+        static void getQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::GetQueryObjectui64v).put(id).put(pname);
+            glGetQueryObjectui64v(id, pname, params);
+        }
+
+        static void getShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetShaderInfoLog).put(shader).put(bufSize);
+            glGetShaderInfoLog(shader, bufSize, length, infoLog);
+        }
+
+        static void getShaderiv(GLuint shader, GLenum pname, GLint* param) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::GetShaderiv).put(shader).put(pname);
+            glGetShaderiv(shader, pname, param);
+        }
+
+        static GLint getUniformLocation(GLuint program, const GLchar* name) {
+            GlCaptureWriter* capture = interceptCall(GlCategory::Object);
+            GLint location = glGetUniformLocation(program, name);
+            if (capture)
+                capture->begin(GlCall::GetUniformLocation).put(program).putString(name).put(location);
+            return location;
+        }
+
+        static GLboolean isEnabled(GLenum cap) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::IsEnabled).put(cap);
+            return glIsEnabled(cap);
+        }
+
+        static void linkProgram(GLuint program) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::LinkProgram).put(program);
+            glLinkProgram(program);
+        }
+
+        static void* mapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+            if (auto* capture = interceptCall(GlCategory::Transfer))
+                capture->begin(GlCall::MapBufferRange).put(target).put(std::int64_t(offset)).put(std::int64_t(length)).put(access);
+            return glMapBufferRange(target, offset, length, access);
+        }
+
+        static void pixelStorei(GLenum pname, GLint param) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::PixelStorei).put(pname).put(param);
+            glPixelStorei(pname, param);
+        }
+
+        template<typename T, typename... Values>
+        static void programUniform(GlCall call, GLuint program, GLint location, Values... values) {
+            countBytes(&GlStats::uniformBytes, sizeof(T) * sizeof...(Values));
+            if (auto* capture = interceptCall(GlCategory::Uniform)) {
+                capture->begin(call).put(program).put(location);
+                (capture->put(T(values)), ...);
+            }
+        }
+
+        static void programUniform1f(GLuint program, GLint location, GLfloat x) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLfloat>(GlCall::ProgramUniform1f, program, location, x);
+            glProgramUniform1f(program, location, x);
+        }
+
+        static void programUniform1i(GLuint program, GLint location, GLint x) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLint>(GlCall::ProgramUniform1i, program, location, x);
+            glProgramUniform1i(program, location, x);
+        }
+
+        static void programUniform1ui(GLuint program, GLint location, GLuint x) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLuint>(GlCall::ProgramUniform1ui, program, location, x);
+            glProgramUniform1ui(program, location, x);
+        }
+
+        static void programUniform2f(GLuint program, GLint location, GLfloat x, GLfloat y) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLfloat>(GlCall::ProgramUniform2f, program, location, x, y);
+            glProgramUniform2f(program, location, x, y);
+        }
+
+        static void programUniform2i(GLuint program, GLint location, GLint x, GLint y) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLint>(GlCall::ProgramUniform2i, program, location, x, y);
+            glProgramUniform2i(program, location, x, y);
+        }
+
+        static void programUniform2ui(GLuint program, GLint location, GLuint x, GLuint y) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLuint>(GlCall::ProgramUniform2ui, program, location, x, y);
+            glProgramUniform2ui(program, location, x, y);
+        }
+
+        static void programUniform3f(GLuint program, GLint location, GLfloat x, GLfloat y, GLfloat z) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLfloat>(GlCall::ProgramUniform3f, program, location, x, y, z);
+            glProgramUniform3f(program, location, x, y, z);
+        }
+
+        static void programUniform3i(GLuint program, GLint location, GLint x, GLint y, GLint z) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLint>(GlCall::ProgramUniform3i, program, location, x, y, z);
+            glProgramUniform3i(program, location, x, y, z);
+        }
+
+        static void programUniform3ui(GLuint program, GLint location, GLuint x, GLuint y, GLuint z) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLuint>(GlCall::ProgramUniform3ui, program, location, x, y, z);
+            glProgramUniform3ui(program, location, x, y, z);
+        }
+
+        static void programUniform4f(GLuint program, GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLfloat>(GlCall::ProgramUniform4f, program, location, x, y, z, w);
+            glProgramUniform4f(program, location, x, y, z, w);
+        }
+
+        static void programUniform4i(GLuint program, GLint location, GLint x, GLint y, GLint z, GLint w) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLint>(GlCall::ProgramUniform4i, program, location, x, y, z, w);
+            glProgramUniform4i(program, location, x, y, z, w);
+        }
+
+        static void programUniform4ui(GLuint program, GLint location, GLuint x, GLuint y, GLuint z, GLuint w) {
+            if (GlDispatch::s_isActive)
+                programUniform<GLuint>(GlCall::ProgramUniform4ui, program, location, x, y, z, w);
+            glProgramUniform4ui(program, location, x, y, z, w);
+        }
+
+        static void programUniformMatrix(GlCall call, GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value, std::size_t size) {
+            if (!GlDispatch::s_isActive)
+                return;
+
+            countBytes(&GlStats::uniformBytes, count * size * sizeof(GLfloat));
+            if (auto* capture = interceptCall(GlCategory::Uniform))
+                capture->begin(call).put(program).put(location).put(count).put(transpose).putBytes(value, count * size * sizeof(GLfloat));
+        }
+
+        static void programUniformMatrix2fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix2fv, program, location, count, transpose, value, 4);
+            glProgramUniformMatrix2fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix2x3fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix2x3fv, program, location, count, transpose, value, 6);
+            glProgramUniformMatrix2x3fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix2x4fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix2x4fv, program, location, count, transpose, value, 8);
+            glProgramUniformMatrix2x4fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix3fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix3fv, program, location, count, transpose, value, 9);
+            glProgramUniformMatrix3fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix3x2fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix3x2fv, program, location, count, transpose, value, 6);
+            glProgramUniformMatrix3x2fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix3x4fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix3x4fv, program, location, count, transpose, value, 12);
+            glProgramUniformMatrix3x4fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix4fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix4fv, program, location, count, transpose, value, 16);
+            glProgramUniformMatrix4fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix4x2fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix4x2fv, program, location, count, transpose, value, 8);
+            glProgramUniformMatrix4x2fv(program, location, count, transpose, value);
+        }
+
+        static void programUniformMatrix4x3fv(GLuint program, GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+            programUniformMatrix(GlCall::ProgramUniformMatrix4x3fv, program, location, count, transpose, value, 12);
+            glProgramUniformMatrix4x3fv(program, location, count, transpose, value);
+        }
+
+        static void queryCounter(GLuint id, GLenum target) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::QueryCounter).put(id).put(target);
+            glQueryCounter(id, target);
+        }
+
+        static void readPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels) {
+            if (auto* capture = interceptCall(GlCategory::Transfer))
+                captureReadPixels(*capture, x, y, width, height, format, type, pixels);
+            glReadPixels(x, y, width, height, format, type, pixels);
+        }
+
+        static void shaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {
+            if (auto* capture = interceptCall(GlCategory::Object)) {
+                capture->begin(GlCall::ShaderSource).put(shader).put(count);
+                for (GLsizei i = 0; i < count; i++)
+                    capture->putString(string[i], length ? length[i] : -1);
+            }
+            glShaderSource(shader, count, string, length);
+        }
+
+        static void texBuffer(GLenum target, GLenum internalFormat, GLuint buffer) {
+            if (auto* capture = interceptCall(GlCategory::Object))
+                capture->begin(GlCall::TexBuffer).put(target).put(internalFormat).put(buffer);
+            glTexBuffer(target, internalFormat, buffer);
+        }
+
+        static void texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+            if (GlDispatch::s_isActive)
+                captureTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+            glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+        }
+
+        static void texImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels) {
+            if (GlDispatch::s_isActive)
+                captureTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, pixels);
+            glTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, pixels);
+        }
+
+        static void texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) {
+            if (GlDispatch::s_isActive)
+                captureTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+            glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+        }
+
+        static void textureParameteri(GLuint texture, GLenum pname, GLint param) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::TextureParameteri).put(texture).put(pname).put(param);
+            glTextureParameteri(texture, pname, param);
+        }
+
+        static void textureParameteriv(GLuint texture, GLenum pname, const GLint* params) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::TextureParameteriv).put(texture).put(pname).putBytes(params, textureParameterCount(pname) * sizeof(GLint));
+            glTextureParameteriv(texture, pname, params);
+        }
+
+        static void transformFeedbackVaryings(GLuint program, GLsizei count, const GLchar* const* varyings, GLenum bufferMode) {
+            if (auto* capture = interceptCall(GlCategory::Object)) {
+                capture->begin(GlCall::TransformFeedbackVaryings).put(program).put(count);
+                for (GLsizei i = 0; i < count; i++)
+                    capture->putString(varyings[i]);
+                capture->put(bufferMode);
+            }
+            glTransformFeedbackVaryings(program, count, varyings, bufferMode);
+        }
+
+        static GLboolean unmapBuffer(GLenum target) {
+            if (auto* capture = interceptCall(GlCategory::Transfer))
+                capture->begin(GlCall::UnmapBuffer).put(target);
+            return glUnmapBuffer(target);
+        }
+
+        static void useProgram(GLuint program) {
+            if (auto* capture = interceptCall(GlCategory::Bind))
+                capture->begin(GlCall::UseProgram).put(program);
+            glUseProgram(program);
+        }
+
+        static void vertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+            // always an offset into the bound array buffer, client-side arrays are not captured
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::VertexAttribPointer).put(index).put(size).put(type).put(normalized).put(stride).put(std::uint64_t(reinterpret_cast<std::uintptr_t>(pointer)));
+            glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+        }
+
+        static void viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+            if (auto* capture = interceptCall(GlCategory::State))
+                capture->begin(GlCall::Viewport).put(x).put(y).put(width).put(height);
+            glViewport(x, y, width, height);
+        }
+
+        static void waitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+            if (auto* capture = interceptCall(GlCategory::Query))
+                capture->begin(GlCall::WaitSync).put(std::uint64_t(reinterpret_cast<std::uintptr_t>(sync))).put(flags).put(timeout);
+            glWaitSync(sync, flags, timeout);
+        }
+
+    private:
+        // these look up bindings to tell offsets from client memory, out of line since
+        // they only run while capturing
+        static void captureDrawElements(GlCaptureWriter& capture, GLenum mode, GLsizei count, GLenum type, const void* indices);
+        static void captureReadPixels(GlCaptureWriter& capture, GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+        static void captureTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+        static void captureTexImage3D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels);
+        static void captureTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+    };
+}
+
+#ifndef GL_DISPATCH_DISABLED
+
+#undef glActiveTexture
+#undef glAttachShader
+#undef glBeginQuery
+#undef glBeginTransformFeedback
+#undef glBindBuffer
+#undef glBindBufferBase
+#undef glBindFragDataLocation
+#undef glBindFramebuffer
+#undef glBindTexture
+#undef glBindTransformFeedback
+#undef glBindVertexArray
+#undef glBlendFunc
+#undef glBlitFramebuffer
+#undef glBufferData
+#undef glCheckFramebufferStatus
+#undef glClear
+#undef glClearColor
+#undef glClientWaitSync
+#undef glCompileShader
+#undef glCreateProgram
+#undef glCreateShader
+#undef glDeleteBuffers
+#undef glDeleteFramebuffers
+#undef glDeleteProgram
+#undef glDeleteQueries
+#undef glDeleteShader
+#undef glDeleteSync
+#undef glDeleteTextures
+#undef glDeleteTransformFeedbacks
+#undef glDeleteVertexArrays
+#undef glDepthMask
+#undef glDisable
+#undef glDrawArrays
+#undef glDrawElements
+#undef glDrawTransformFeedback
+#undef glEnable
+#undef glEnableVertexAttribArray
+#undef glEndQuery
+#undef glEndTransformFeedback
+#undef glFenceSync
+#undef glFlush
+#undef glFramebufferTexture
+#undef glFramebufferTexture2D
+#undef glGenBuffers
+#undef glGenFramebuffers
+#undef glGenQueries
+#undef glGenTextures
+#undef glGenTransformFeedbacks
+#undef glGenVertexArrays
+#undef glGenerateMipmap
+#undef glGetActiveAttrib
+#undef glGetActiveUniform
+#undef glGetActiveUniformBlockName
+#undef glGetActiveUniformBlockiv
+#undef glGetAttribLocation
+#undef glGetIntegerv
+#undef glGetProgramInfoLog
+#undef glGetProgramiv
+#undef glGetQueryObjectiv
+#undef glGetQueryObjectui64v
+#undef glGetShaderInfoLog
+#undef glGetShaderiv
+#undef glGetUniformLocation
+#undef glIsEnabled
+#undef glLinkProgram
+#undef glMapBufferRange
+#undef glPixelStorei
+#undef glProgramUniform1f
+#undef glProgramUniform1i
+#undef glProgramUniform1ui
+#undef glProgramUniform2f
+#undef glProgramUniform2i
+#undef glProgramUniform2ui
+#undef glProgramUniform3f
+#undef glProgramUniform3i
+#undef glProgramUniform3ui
+#undef glProgramUniform4f
+#undef glProgramUniform4i
+#undef glProgramUniform4ui
+#undef glProgramUniformMatrix2fv
+#undef glProgramUniformMatrix2x3fv
+#undef glProgramUniformMatrix2x4fv
+#undef glProgramUniformMatrix3fv
+#undef glProgramUniformMatrix3x2fv
+#undef glProgramUniformMatrix3x4fv
+#undef glProgramUniformMatrix4fv
+#undef glProgramUniformMatrix4x2fv
+#undef glProgramUniformMatrix4x3fv
+#undef glQueryCounter
+#undef glReadPixels
+#undef glShaderSource
+#undef glTexBuffer
+#undef glTexImage2D
+#undef glTexImage3D
+#undef glTexSubImage2D
+#undef glTextureParameteri
+#undef glTextureParameteriv
+#undef glTransformFeedbackVaryings
+#undef glUnmapBuffer
+#undef glUseProgram
+#undef glVertexAttribPointer
+#undef glViewport
+#undef glWaitSync
+
+#define glActiveTexture ::gl::GlApi::activeTexture
+#define glAttachShader ::gl::GlApi::attachShader
+#define glBeginQuery ::gl::GlApi::beginQuery
+#define glBeginTransformFeedback ::gl::GlApi::beginTransformFeedback
+#define glBindBuffer ::gl::GlApi::bindBuffer
+#define glBindBufferBase ::gl::GlApi::bindBufferBase
+#define glBindFragDataLocation ::gl::GlApi::bindFragDataLocation
+#define glBindFramebuffer ::gl::GlApi::bindFramebuffer
+#define glBindTexture ::gl::GlApi::bindTexture
+#define glBindTransformFeedback ::gl::GlApi::bindTransformFeedback
+#define glBindVertexArray ::gl::GlApi::bindVertexArray
+#define glBlendFunc ::gl::GlApi::blendFunc
+#define glBlitFramebuffer ::gl::GlApi::blitFramebuffer
+#define glBufferData ::gl::GlApi::bufferData
+#define glCheckFramebufferStatus ::gl::GlApi::checkFramebufferStatus
+#define glClear ::gl::GlApi::clear
+#define glClearColor ::gl::GlApi::clearColor
+#define glClientWaitSync ::gl::GlApi::clientWaitSync
+#define glCompileShader ::gl::GlApi::compileShader
+#define glCreateProgram ::gl::GlApi::createProgram
+#define glCreateShader ::gl::GlApi::createShader
+#define glDeleteBuffers ::gl::GlApi::deleteBuffers
+#define glDeleteFramebuffers ::gl::GlApi::deleteFramebuffers
+#define glDeleteProgram ::gl::GlApi::deleteProgram
+#define glDeleteQueries ::gl::GlApi::deleteQueries
+#define glDeleteShader ::gl::GlApi::deleteShader
+#define glDeleteSync ::gl::GlApi::deleteSync
+#define glDeleteTextures ::gl::GlApi::deleteTextures
+#define glDeleteTransformFeedbacks ::gl::GlApi::deleteTransformFeedbacks
+#define glDeleteVertexArrays ::gl::GlApi::deleteVertexArrays
+#define glDepthMask ::gl::GlApi::depthMask
+#define glDisable ::gl::GlApi::disable
+#define glDrawArrays ::gl::GlApi::drawArrays
+#define glDrawElements ::gl::GlApi::drawElements
+#define glDrawTransformFeedback ::gl::GlApi::drawTransformFeedback
+#define glEnable ::gl::GlApi::enable
+#define glEnableVertexAttribArray ::gl::GlApi::enableVertexAttribArray
+#define glEndQuery ::gl::GlApi::endQuery
+#define glEndTransformFeedback ::gl::GlApi::endTransformFeedback
+#define glFenceSync ::gl::GlApi::fenceSync
+#define glFlush ::gl::GlApi::flush
+#define glFramebufferTexture ::gl::GlApi::framebufferTexture
+#define glFramebufferTexture2D ::gl::GlApi::framebufferTexture2D
+#define glGenBuffers ::gl::GlApi::genBuffers
+#define glGenFramebuffers ::gl::GlApi::genFramebuffers
+#define glGenQueries ::gl::GlApi::genQueries
+#define glGenTextures ::gl::GlApi::genTextures
+#define glGenTransformFeedbacks ::gl::GlApi::genTransformFeedbacks
+#define glGenVertexArrays ::gl::GlApi::genVertexArrays
+#define glGenerateMipmap ::gl::GlApi::generateMipmap
+#define glGetActiveAttrib ::gl::GlApi::getActiveAttrib
+#define glGetActiveUniform ::gl::GlApi::getActiveUniform
+#define glGetActiveUniformBlockName ::gl::GlApi::getActiveUniformBlockName
+#define glGetActiveUniformBlockiv ::gl::GlApi::getActiveUniformBlockiv
+#define glGetAttribLocation ::gl::GlApi::getAttribLocation
+#define glGetIntegerv ::gl::GlApi::getIntegerv
+#define glGetProgramInfoLog ::gl::GlApi::getProgramInfoLog
+#define glGetProgramiv ::gl::GlApi::getProgramiv
+#define glGetQueryObjectiv ::gl::GlApi::getQueryObjectiv
+#define glGetQueryObjectui64v ::gl::GlApi::getQueryObjectui64v
+#define glGetShaderInfoLog ::gl::GlApi::getShaderInfoLog
+#define glGetShaderiv ::gl::GlApi::getShaderiv
+#define glGetUniformLocation ::gl::GlApi::getUniformLocation
+#define glIsEnabled ::gl::GlApi::isEnabled
+#define glLinkProgram ::gl::GlApi::linkProgram
+#define glMapBufferRange ::gl::GlApi::mapBufferRange
+#define glPixelStorei ::gl::GlApi::pixelStorei
+#define glProgramUniform1f ::gl::GlApi::programUniform1f
+#define glProgramUniform1i ::gl::GlApi::programUniform1i
+#define glProgramUniform1ui ::gl::GlApi::programUniform1ui
+#define glProgramUniform2f ::gl::GlApi::programUniform2f
+#define glProgramUniform2i ::gl::GlApi::programUniform2i
+#define glProgramUniform2ui ::gl::GlApi::programUniform2ui
+#define glProgramUniform3f ::gl::GlApi::programUniform3f
+#define glProgramUniform3i ::gl::GlApi::programUniform3i
+#define glProgramUniform3ui ::gl::GlApi::programUniform3ui
+#define glProgramUniform4f ::gl::GlApi::programUniform4f
+#define glProgramUniform4i ::gl::GlApi::programUniform4i
+#define glProgramUniform4ui ::gl::GlApi::programUniform4ui
+#define glProgramUniformMatrix2fv ::gl::GlApi::programUniformMatrix2fv
+#define glProgramUniformMatrix2x3fv ::gl::GlApi::programUniformMatrix2x3fv
+#define glProgramUniformMatrix2x4fv ::gl::GlApi::programUniformMatrix2x4fv
+#define glProgramUniformMatrix3fv ::gl::GlApi::programUniformMatrix3fv
+#define glProgramUniformMatrix3x2fv ::gl::GlApi::programUniformMatrix3x2fv
+#define glProgramUniformMatrix3x4fv ::gl::GlApi::programUniformMatrix3x4fv
+#define glProgramUniformMatrix4fv ::gl::GlApi::programUniformMatrix4fv
+#define glProgramUniformMatrix4x2fv ::gl::GlApi::programUniformMatrix4x2fv
+#define glProgramUniformMatrix4x3fv ::gl::GlApi::programUniformMatrix4x3fv
+#define glQueryCounter ::gl::GlApi::queryCounter
+#define glReadPixels ::gl::GlApi::readPixels
+#define glShaderSource ::gl::GlApi::shaderSource
+#define glTexBuffer ::gl::GlApi::texBuffer
+#define glTexImage2D ::gl::GlApi::texImage2D
+#define glTexImage3D ::gl::GlApi::texImage3D
+#define glTexSubImage2D ::gl::GlApi::texSubImage2D
+#define glTextureParameteri ::gl::GlApi::textureParameteri
+#define glTextureParameteriv ::gl::GlApi::textureParameteriv
+#define glTransformFeedbackVaryings ::gl::GlApi::transformFeedbackVaryings
+#define glUnmapBuffer ::gl::GlApi::unmapBuffer
+#define glUseProgram ::gl::GlApi::useProgram
+#define glVertexAttribPointer ::gl::GlApi::vertexAttribPointer
+#define glViewport ::gl::GlApi::viewport
+#define glWaitSync ::gl::GlApi::waitSync
+
+#endif
@@ -0,0 +1,884 @@
+﻿// the replay calls GL directly, it is what is being measured
+#define GL_DISPATCH_DISABLED
+#include "GlReplayer.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    namespace
+    {
+        const char captureMagic[8] = { 'G', 'R', 'A', 'F', 'G', 'L', 'C', '\0' };
+        const std::uint32_t captureVersion = 1;
+
+        std::uint64_t locationKey(GLuint program, GLint location) {
+            return std::uint64_t(program) << 32 | static_cast<std::uint32_t>(location);
+        }
+
+        const void* offsetPointer(std::uint64_t offset) {
+            return reinterpret_cast<const void*>(static_cast<std::uintptr_t>(offset));
+        }
+    }
+
+    GlReplayer::GlReplayer(const std::string& path):
+        m_data(),
+        m_start(0),
+        m_position(0),
+        m_frame(0),
+        m_width(0),
+        m_height(0)
+    {
+        std::ifstream file{ path, std::ios::binary };
+        if (!file.is_open())
+            throw exception{ ("Could not open GL capture file " + path).c_str() };
+
+        m_data.assign(std::istreambuf_iterator<char>{ file }, std::istreambuf_iterator<char>{});
+
+        if (m_data.size() < sizeof(captureMagic) || std::memcmp(m_data.data(), captureMagic, sizeof(captureMagic)) != 0)
+            throw exception{ (path + " is not a GL capture").c_str() };
+        m_position = sizeof(captureMagic);
+
+        if (get<std::uint32_t>() != captureVersion)
+            throw exception{ (path + " was captured by an incompatible version").c_str() };
+
+        m_width = get<GLint>();
+        m_height = get<GLint>();
+        m_start = m_position;
+    }
+
+    template<typename T>
+    T GlReplayer::get() {
+        if (m_data.size() - m_position < sizeof(T))
+            throw exception{ "GL capture ends in the middle of a call" };
+
+        T value;
+        std::memcpy(&value, m_data.data() + m_position, sizeof(T));
+        m_position += sizeof(T);
+        return value;
+    }
+
+    const unsigned char* GlReplayer::getBytes(std::size_t& size) {
+        size = 0;
+        if (!get<std::uint8_t>())
+            return nullptr;
+
+        size = static_cast<std::size_t>(get<std::uint64_t>());
+        if (m_data.size() - m_position < size)
+            throw exception{ "GL capture ends in the middle of a call" };
+
+        const unsigned char* bytes = m_data.data() + m_position;
+        m_position += size;
+        return bytes;
+    }
+
+    std::string GlReplayer::getString() {
+        std::size_t size = get<std::uint32_t>();
+        if (m_data.size() - m_position < size)
+            throw exception{ "GL capture ends in the middle of a call" };
+
+        std::string str{ reinterpret_cast<const char*>(m_data.data() + m_position), size };
+        m_position += size;
+        return str;
+    }
+
+    GLuint GlReplayer::name(const NameMap& names, GLuint captured) const {
+        auto found = names.find(captured);
+        return found != names.end() ? found->second : captured;
+    }
+
+    GLint GlReplayer::uniformLocation(GLuint capturedProgram, GLint captured) const {
+        auto found = m_uniformLocations.find(locationKey(capturedProgram, captured));
+        return found != m_uniformLocations.end() ? found->second : captured;
+    }
+
+    GLsync GlReplayer::sync(std::uint64_t captured) const {
+        auto found = m_syncs.find(captured);
+        return found != m_syncs.end() ? found->second : nullptr;
+    }
+
+    bool GlReplayer::replayFrame() {
+        while (!isAtEnd()) {
+            GlCall call = get<GlCall>();
+            if (call == GlCall::EndFrame) {
+                m_frame++;
+                return true;
+            }
+
+            replayCall(call);
+        }
+
+        return false;
+    }
+
+    template<typename Function>
+    void GlReplayer::genNames(NameMap& names, Function gen) {
+        std::size_t size;
+        const unsigned char* captured = getBytes(size);
+
+        GLsizei count = static_cast<GLsizei>(size / sizeof(GLuint));
+        m_names.resize(count);
+        gen(count, m_names.data());
+
+        for (GLsizei i = 0; i < count; i++) {
+            GLuint capturedName;
+            std::memcpy(&capturedName, captured + i * sizeof(GLuint), sizeof(GLuint));
+            names[capturedName] = m_names[i];
+        }
+    }
+
+    template<typename Function>
+    void GlReplayer::deleteNames(NameMap& names, Function del) {
+        std::size_t size;
+        const unsigned char* captured = getBytes(size);
+
+        GLsizei count = static_cast<GLsizei>(size / sizeof(GLuint));
+        m_names.resize(count);
+        for (GLsizei i = 0; i < count; i++) {
+            GLuint capturedName;
+            std::memcpy(&capturedName, captured + i * sizeof(GLuint), sizeof(GLuint));
+            m_names[i] = name(names, capturedName);
+            names.erase(capturedName);
+        }
+
+        del(count, m_names.data());
+    }
+
+    template<typename T, typename Function, std::size_t... Indices>
+    void GlReplayer::programUniform(Function function, std::index_sequence<Indices...>) {
+        GLuint program = get<GLuint>();
+        GLint location = get<GLint>();
+
+        std::array<T, sizeof...(Indices)> values;
+        for (auto& value : values)
+            value = get<T>();
+
+        function(name(m_programs, program), uniformLocation(program, location), values[Indices]...);
+    }
+
+    template<typename Function>
+    void GlReplayer::programUniformMatrix(Function function, std::size_t size) {
+        GLuint program = get<GLuint>();
+        GLint location = get<GLint>();
+        GLsizei count = get<GLsizei>();
+        GLboolean transpose = get<GLboolean>();
+
+        std::size_t bytes;
+        const unsigned char* values = getBytes(bytes);
+
+        // copied out, the capture does not keep the floats aligned
+        m_floats.resize(count * size);
+        if (values)
+            std::memcpy(m_floats.data(), values, std::min(bytes, m_floats.size() * sizeof(GLfloat)));
+
+        function(name(m_programs, program), uniformLocation(program, location), count, transpose, m_floats.data());
+    }
+
+    void GlReplayer::replayCall(GlCall call) {
+        // arguments are read into locals first, their order of evaluation in a call is unspecified
+        switch (call) {
+        case GlCall::ActiveTexture: {
+            GLenum texture = get<GLenum>();
+            glActiveTexture(texture);
+            break;
+        }
+        case GlCall::AttachShader: {
+            GLuint program = get<GLuint>();
+            GLuint shader = get<GLuint>();
+            glAttachShader(name(m_programs, program), name(m_shaders, shader));
+            break;
+        }
+        case GlCall::BeginQuery: {
+            GLenum target = get<GLenum>();
+            GLuint id = get<GLuint>();
+            glBeginQuery(target, name(m_queries, id));
+            break;
+        }
+        case GlCall::BeginTransformFeedback: {
+            GLenum primitiveMode = get<GLenum>();
+            glBeginTransformFeedback(primitiveMode);
+            break;
+        }
+        case GlCall::BindBuffer: {
+            GLenum target = get<GLenum>();
+            GLuint buffer = get<GLuint>();
+            glBindBuffer(target, name(m_buffers, buffer));
+            break;
+        }
+        case GlCall::BindBufferBase: {
+            GLenum target = get<GLenum>();
+            GLuint index = get<GLuint>();
+            GLuint buffer = get<GLuint>();
+            glBindBufferBase(target, index, name(m_buffers, buffer));
+            break;
+        }
+        case GlCall::BindFragDataLocation: {
+            GLuint program = get<GLuint>();
+            GLuint color = get<GLuint>();
+            std::string location = getString();
+            glBindFragDataLocation(name(m_programs, program), color, location.c_str());
+            break;
+        }
+        case GlCall::BindFramebuffer: {
+            GLenum target = get<GLenum>();
+            GLuint framebuffer = get<GLuint>();
+            glBindFramebuffer(target, name(m_framebuffers, framebuffer));
+            break;
+        }
+        case GlCall::BindTexture: {
+            GLenum target = get<GLenum>();
+            GLuint texture = get<GLuint>();
+            glBindTexture(target, name(m_textures, texture));
+            break;
+        }
+        case GlCall::BindTransformFeedback: {
+            GLenum target = get<GLenum>();
+            GLuint id = get<GLuint>();
+            glBindTransformFeedback(target, name(m_transformFeedbacks, id));
+            break;
+        }
+        case GlCall::BlitFramebuffer: {
+            GLint src[4], dst[4];
+            for (auto& value : src)
+                value = get<GLint>();
+            for (auto& value : dst)
+                value = get<GLint>();
+            GLbitfield mask = get<GLbitfield>();
+            GLenum filter = get<GLenum>();
+            glBlitFramebuffer(src[0], src[1], src[2], src[3], dst[0], dst[1], dst[2], dst[3], mask, filter);
+            break;
+        }
+        case GlCall::BindVertexArray: {
+            GLuint array = get<GLuint>();
+            glBindVertexArray(name(m_vertexArrays, array));
+            break;
+        }
+        case GlCall::BlendFunc: {
+            GLenum sfactor = get<GLenum>();
+            GLenum dfactor = get<GLenum>();
+            glBlendFunc(sfactor, dfactor);
+            break;
+        }
+        case GlCall::BufferData: {
+            GLenum target = get<GLenum>();
+            GLsizeiptr size = static_cast<GLsizeiptr>(get<std::int64_t>());
+            std::size_t bytes;
+            const unsigned char* data = getBytes(bytes);
+            GLenum usage = get<GLenum>();
+            glBufferData(target, size, data, usage);
+            break;
+        }
+        case GlCall::CheckFramebufferStatus: {
+            GLenum target = get<GLenum>();
+            glCheckFramebufferStatus(target);
+            break;
+        }
+        case GlCall::Clear: {
+            GLbitfield mask = get<GLbitfield>();
+            glClear(mask);
+            break;
+        }
+        case GlCall::ClearColor: {
+            GLclampf red = get<GLclampf>();
+            GLclampf green = get<GLclampf>();
+            GLclampf blue = get<GLclampf>();
+            GLclampf alpha = get<GLclampf>();
+            glClearColor(red, green, blue, alpha);
+            break;
+        }
+        case GlCall::ClientWaitSync: {
+            std::uint64_t handle = get<std::uint64_t>();
+            GLbitfield flags = get<GLbitfield>();
+            GLuint64 timeout = get<GLuint64>();
+            if (GLsync fence = sync(handle))
+                glClientWaitSync(fence, flags, timeout);
+            break;
+        }
+        case GlCall::CompileShader: {
+            GLuint shader = get<GLuint>();
+            glCompileShader(name(m_shaders, shader));
+            break;
+        }
+        case GlCall::CreateProgram: {
+            GLuint program = get<GLuint>();
+            m_programs[program] = glCreateProgram();
+            break;
+        }
+        case GlCall::CreateShader: {
+            GLenum type = get<GLenum>();
+            GLuint shader = get<GLuint>();
+            m_shaders[shader] = glCreateShader(type);
+            break;
+        }
+        case GlCall::DeleteBuffers:
+            deleteNames(m_buffers, glDeleteBuffers);
+            break;
+        case GlCall::DeleteFramebuffers:
+            deleteNames(m_framebuffers, glDeleteFramebuffers);
+            break;
+        case GlCall::DeleteProgram: {
+            GLuint program = get<GLuint>();
+            glDeleteProgram(name(m_programs, program));
+            m_programs.erase(program);
+            break;
+        }
+        case GlCall::DeleteQueries:
+            deleteNames(m_queries, glDeleteQueries);
+            break;
+        case GlCall::DeleteShader: {
+            GLuint shader = get<GLuint>();
+            glDeleteShader(name(m_shaders, shader));
+            m_shaders.erase(shader);
+            break;
+        }
+        case GlCall::DeleteSync: {
+            std::uint64_t handle = get<std::uint64_t>();
+            if (GLsync fence = sync(handle))
+                glDeleteSync(fence);
+            m_syncs.erase(handle);
+            break;
+        }
+        case GlCall::DeleteTextures:
+            deleteNames(m_textures, glDeleteTextures);
+            break;
+        case GlCall::DeleteTransformFeedbacks:
+            deleteNames(m_transformFeedbacks, glDeleteTransformFeedbacks);
+            break;
+        case GlCall::DeleteVertexArrays:
+            deleteNames(m_vertexArrays, glDeleteVertexArrays);
+            break;
+        case GlCall::DepthMask: {
+            GLboolean flag = get<GLboolean>();
+            glDepthMask(flag);
+            break;
+        }
+        case GlCall::Disable: {
+            GLenum cap = get<GLenum>();
+            glDisable(cap);
+            break;
+        }
+        case GlCall::DrawArrays: {
+            GLenum mode = get<GLenum>();
+            GLint first = get<GLint>();
+            GLsizei count = get<GLsizei>();
+            glDrawArrays(mode, first, count);
+            break;
+        }
+        case GlCall::DrawElements: {
+            GLenum mode = get<GLenum>();
+            GLsizei count = get<GLsizei>();
+            GLenum type = get<GLenum>();
+
+            const void* indices;
+            if (get<std::uint8_t>()) {
+                indices = offsetPointer(get<std::uint64_t>());
+            } else {
+                std::size_t bytes;
+                indices = getBytes(bytes);
+            }
+
+            glDrawElements(mode, count, type, indices);
+            break;
+        }
+        case GlCall::DrawTransformFeedback: {
+            GLenum mode = get<GLenum>();
+            GLuint id = get<GLuint>();
+            glDrawTransformFeedback(mode, name(m_transformFeedbacks, id));
+            break;
+        }
+        case GlCall::Enable: {
+            GLenum cap = get<GLenum>();
+            glEnable(cap);
+            break;
+        }
+        case GlCall::EnableVertexAttribArray: {
+            GLuint index = get<GLuint>();
+            glEnableVertexAttribArray(index);
+            break;
+        }
+        case GlCall::EndQuery: {
+            GLenum target = get<GLenum>();
+            glEndQuery(target);
+            break;
+        }
+        case GlCall::EndTransformFeedback:
+            glEndTransformFeedback();
+            break;
+        case GlCall::FenceSync: {
+            GLenum condition = get<GLenum>();
+            GLbitfield flags = get<GLbitfield>();
+            std::uint64_t handle = get<std::uint64_t>();
+            m_syncs[handle] = glFenceSync(condition, flags);
+            break;
+        }
+        case GlCall::Flush:
+            glFlush();
+            break;
+        case GlCall::FramebufferTexture: {
+            GLenum target = get<GLenum>();
+            GLenum attachment = get<GLenum>();
+            GLuint texture = get<GLuint>();
+            GLint level = get<GLint>();
+            glFramebufferTexture(target, attachment, name(m_textures, texture), level);
+            break;
+        }
+        case GlCall::FramebufferTexture2D: {
+            GLenum target = get<GLenum>();
+            GLenum attachment = get<GLenum>();
+            GLenum textarget = get<GLenum>();
+            GLuint texture = get<GLuint>();
+            GLint level = get<GLint>();
+            glFramebufferTexture2D(target, attachment, textarget, name(m_textures, texture), level);
+            break;
+        }
+        case GlCall::GenBuffers:
+            genNames(m_buffers, glGenBuffers);
+            break;
+        case GlCall::GenFramebuffers:
+            genNames(m_framebuffers, glGenFramebuffers);
+            break;
+        case GlCall::GenQueries:
+            genNames(m_queries, glGenQueries);
+            break;
+        case GlCall::GenTextures:
+            genNames(m_textures, glGenTextures);
+            break;
+        case GlCall::GenTransformFeedbacks:
+            genNames(m_transformFeedbacks, glGenTransformFeedbacks);
+            break;
+        case GlCall::GenVertexArrays:
+            genNames(m_vertexArrays, glGenVertexArrays);
+            break;
+        case GlCall::GenerateMipmap: {
+            GLenum target = get<GLenum>();
+            glGenerateMipmap(target);
+            break;
+        }
+        case GlCall::GetActiveAttrib:
+        case GlCall::GetActiveUniform: {
+            GLuint program = get<GLuint>();
+            GLuint index = get<GLuint>();
+            GLsizei bufSize = get<GLsizei>();
+            GLint size;
+            GLenum type;
+            m_scratch.resize(std::max<GLsizei>(bufSize, 1));
+
+            auto* getActive = call == GlCall::GetActiveAttrib ? glGetActiveAttrib : glGetActiveUniform;
+            getActive(name(m_programs, program), index, bufSize, nullptr, &size, &type, reinterpret_cast<GLchar*>(m_scratch.data()));
+            break;
+        }
+        case GlCall::GetActiveUniformBlockName: {
+            GLuint program = get<GLuint>();
+            GLuint index = get<GLuint>();
+            GLsizei bufSize = get<GLsizei>();
+            m_scratch.resize(std::max<GLsizei>(bufSize, 1));
+            glGetActiveUniformBlockName(name(m_programs, program), index, bufSize, nullptr, reinterpret_cast<GLchar*>(m_scratch.data()));
+            break;
+        }
+        case GlCall::GetActiveUniformBlockiv: {
+            GLuint program = get<GLuint>();
+            GLuint index = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            // GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES writes one value per uniform of the block
+            m_scratch.resize(256 * sizeof(GLint));
+            glGetActiveUniformBlockiv(name(m_programs, program), index, pname, reinterpret_cast<GLint*>(m_scratch.data()));
+            break;
+        }
+        case GlCall::GetAttribLocation: {
+            GLuint program = get<GLuint>();
+            std::string attribute = getString();
+            get<GLint>();
+            glGetAttribLocation(name(m_programs, program), attribute.c_str());
+            break;
+        }
+        case GlCall::GetIntegerv: {
+            GLenum pname = get<GLenum>();
+            // big enough for any state the project reads
+            m_scratch.resize(16 * sizeof(GLint));
+            glGetIntegerv(pname, reinterpret_cast<GLint*>(m_scratch.data()));
+            break;
+        }
+        case GlCall::GetProgramInfoLog: {
+            GLuint program = get<GLuint>();
+            GLsizei bufSize = get<GLsizei>();
+            m_scratch.resize(std::max<GLsizei>(bufSize, 1));
+            glGetProgramInfoLog(name(m_programs, program), bufSize, nullptr, reinterpret_cast<GLchar*>(m_scratch.data()));
+            break;
+        }
+        case GlCall::GetProgramiv: {
+            GLuint program = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            GLint param;
+            glGetProgramiv(name(m_programs, program), pname, &param);
+            break;
+        }
+        case GlCall::GetQueryObjectiv: {
+            GLuint id = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            GLint param;
+            glGetQueryObjectiv(name(m_queries, id), pname, &param);
+            break;
+        }
+        case GlCall::GetQueryObjectui64v: {
+            GLuint id = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            GLuint64 param;
+            glGetQueryObjectui64v(name(m_queries, id), pname, &param);
+            break;
+        }
+        case GlCall::GetShaderInfoLog: {
+            GLuint shader = get<GLuint>();
+            GLsizei bufSize = get<GLsizei>();
+            m_scratch.resize(std::max<GLsizei>(bufSize, 1));
+            glGetShaderInfoLog(name(m_shaders, shader), bufSize, nullptr, reinterpret_cast<GLchar*>(m_scratch.data()));
+            break;
+        }
+        case GlCall::GetShaderiv: {
+            GLuint shader = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            GLint param;
+            glGetShaderiv(name(m_shaders, shader), pname, &param);
+            break;
+        }
+        case GlCall::GetUniformLocation: {
+            GLuint program = get<GLuint>();
+            std::string uniform = getString();
+            GLint location = get<GLint>();
+            m_uniformLocations[locationKey(program, location)] = glGetUniformLocation(name(m_programs, program), uniform.c_str());
+            break;
+        }
+        case GlCall::IsEnabled: {
+            GLenum cap = get<GLenum>();
+            glIsEnabled(cap);
+            break;
+        }
+        case GlCall::LinkProgram: {
+            GLuint program = get<GLuint>();
+            glLinkProgram(name(m_programs, program));
+            break;
+        }
+        case GlCall::MapBufferRange: {
+            GLenum target = get<GLenum>();
+            GLintptr offset = static_cast<GLintptr>(get<std::int64_t>());
+            GLsizeiptr length = static_cast<GLsizeiptr>(get<std::int64_t>());
+            GLbitfield access = get<GLbitfield>();
+            glMapBufferRange(target, offset, length, access);
+            break;
+        }
+        case GlCall::PixelStorei: {
+            GLenum pname = get<GLenum>();
+            GLint param = get<GLint>();
+            glPixelStorei(pname, param);
+            break;
+        }
+        case GlCall::ProgramUniform1f:
+            programUniform<GLfloat>(glProgramUniform1f, std::make_index_sequence<1>{});
+            break;
+        case GlCall::ProgramUniform1i:
+            programUniform<GLint>(glProgramUniform1i, std::make_index_sequence<1>{});
+            break;
+        case GlCall::ProgramUniform1ui:
+            programUniform<GLuint>(glProgramUniform1ui, std::make_index_sequence<1>{});
+            break;
+        case GlCall::ProgramUniform2f:
+            programUniform<GLfloat>(glProgramUniform2f, std::make_index_sequence<2>{});
+            break;
+        case GlCall::ProgramUniform2i:
+            programUniform<GLint>(glProgramUniform2i, std::make_index_sequence<2>{});
+            break;
+        case GlCall::ProgramUniform2ui:
+            programUniform<GLuint>(glProgramUniform2ui, std::make_index_sequence<2>{});
+            break;
+        case GlCall::ProgramUniform3f:
+            programUniform<GLfloat>(glProgramUniform3f, std::make_index_sequence<3>{});
+            break;
+        case GlCall::ProgramUniform3i:
+            programUniform<GLint>(glProgramUniform3i, std::make_index_sequence<3>{});
+            break;
+        case GlCall::ProgramUniform3ui:
+            programUniform<GLuint>(glProgramUniform3ui, std::make_index_sequence<3>{});
+            break;
+        case GlCall::ProgramUniform4f:
+            programUniform<GLfloat>(glProgramUniform4f, std::make_index_sequence<4>{});
+            break;
+        case GlCall::ProgramUniform4i:
+            programUniform<GLint>(glProgramUniform4i, std::make_index_sequence<4>{});
+            break;
+        case GlCall::ProgramUniform4ui:
+            programUniform<GLuint>(glProgramUniform4ui, std::make_index_sequence<4>{});
+            break;
+        case GlCall::ProgramUniformMatrix2fv:
+            programUniformMatrix(glProgramUniformMatrix2fv, 4);
+            break;
+        case GlCall::ProgramUniformMatrix2x3fv:
+            programUniformMatrix(glProgramUniformMatrix2x3fv, 6);
+            break;
+        case GlCall::ProgramUniformMatrix2x4fv:
+            programUniformMatrix(glProgramUniformMatrix2x4fv, 8);
+            break;
+        case GlCall::ProgramUniformMatrix3fv:
+            programUniformMatrix(glProgramUniformMatrix3fv, 9);
+            break;
+        case GlCall::ProgramUniformMatrix3x2fv:
+            programUniformMatrix(glProgramUniformMatrix3x2fv, 6);
+            break;
+        case GlCall::ProgramUniformMatrix3x4fv:
+            programUniformMatrix(glProgramUniformMatrix3x4fv, 12);
+            break;
+        case GlCall::ProgramUniformMatrix4fv:
+            programUniformMatrix(glProgramUniformMatrix4fv, 16);
+            break;
+        case GlCall::ProgramUniformMatrix4x2fv:
+            programUniformMatrix(glProgramUniformMatrix4x2fv, 8);
+            break;
+        case GlCall::ProgramUniformMatrix4x3fv:
+            programUniformMatrix(glProgramUniformMatrix4x3fv, 12);
+            break;
+        case GlCall::QueryCounter: {
+            GLuint id = get<GLuint>();
+            GLenum target = get<GLenum>();
+            glQueryCounter(name(m_queries, id), target);
+            break;
+        }
+        case GlCall::ReadPixels: {
+            GLint x = get<GLint>();
+            GLint y = get<GLint>();
+            GLsizei width = get<GLsizei>();
+            GLsizei height = get<GLsizei>();
+            GLenum format = get<GLenum>();
+            GLenum type = get<GLenum>();
+
+            void* pixels;
+            if (get<std::uint8_t>()) {
+                pixels = const_cast<void*>(offsetPointer(get<std::uint64_t>()));
+            } else {
+                GLint alignment = 4;
+                glGetIntegerv(GL_PACK_ALIGNMENT, &alignment);
+                m_scratch.resize(imageBytes(width, height, format, type, alignment));
+                pixels = m_scratch.data();
+            }
+
+            glReadPixels(x, y, width, height, format, type, pixels);
+            break;
+        }
+        case GlCall::ShaderSource: {
+            GLuint shader = get<GLuint>();
+            GLsizei count = get<GLsizei>();
+
+            std::vector<std::string> sources;
+            for (GLsizei i = 0; i < count; i++)
+                sources.push_back(getString());
+
+            std::vector<const GLchar*> strings;
+            std::vector<GLint> lengths;
+            for (const auto& source : sources) {
+                strings.push_back(source.c_str());
+                lengths.push_back(static_cast<GLint>(source.size()));
+            }
+
+            glShaderSource(name(m_shaders, shader), count, strings.data(), lengths.data());
+            break;
+        }
+        case GlCall::TexBuffer: {
+            GLenum target = get<GLenum>();
+            GLenum internalFormat = get<GLenum>();
+            GLuint buffer = get<GLuint>();
+            glTexBuffer(target, internalFormat, name(m_buffers, buffer));
+            break;
+        }
+        case GlCall::TexImage2D: {
+            GLenum target = get<GLenum>();
+            GLint level = get<GLint>();
+            GLint internalFormat = get<GLint>();
+            GLsizei width = get<GLsizei>();
+            GLsizei height = get<GLsizei>();
+            GLint border = get<GLint>();
+            GLenum format = get<GLenum>();
+            GLenum type = get<GLenum>();
+
+            const void* pixels;
+            if (get<std::uint8_t>()) {
+                pixels = offsetPointer(get<std::uint64_t>());
+            } else {
+                std::size_t bytes;
+                pixels = getBytes(bytes);
+            }
+
+            glTexImage2D(target, level, internalFormat, width, height, border, format, type, pixels);
+            break;
+        }
+        case GlCall::TexImage3D: {
+            GLenum target = get<GLenum>();
+            GLint level = get<GLint>();
+            GLint internalFormat = get<GLint>();
+            GLsizei width = get<GLsizei>();
+            GLsizei height = get<GLsizei>();
+            GLsizei depth = get<GLsizei>();
+            GLint border = get<GLint>();
+            GLenum format = get<GLenum>();
+            GLenum type = get<GLenum>();
+
+            const void* pixels;
+            if (get<std::uint8_t>()) {
+                pixels = offsetPointer(get<std::uint64_t>());
+            } else {
+                std::size_t bytes;
+                pixels = getBytes(bytes);
+            }
+
+            glTexImage3D(target, level, internalFormat, width, height, depth, border, format, type, pixels);
+            break;
+        }
+        case GlCall::TexSubImage2D: {
+            GLenum target = get<GLenum>();
+            GLint level = get<GLint>();
+            GLint xoffset = get<GLint>();
+            GLint yoffset = get<GLint>();
+            GLsizei width = get<GLsizei>();
+            GLsizei height = get<GLsizei>();
+            GLenum format = get<GLenum>();
+            GLenum type = get<GLenum>();
+
+            const void* pixels;
+            if (get<std::uint8_t>()) {
+                pixels = offsetPointer(get<std::uint64_t>());
+            } else {
+                std::size_t bytes;
+                pixels = getBytes(bytes);
+            }
+
+            glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+            break;
+        }
+        case GlCall::TextureParameteri: {
+            GLuint texture = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            GLint param = get<GLint>();
+            glTextureParameteri(name(m_textures, texture), pname, param);
+            break;
+        }
+        case GlCall::TextureParameteriv: {
+            GLuint texture = get<GLuint>();
+            GLenum pname = get<GLenum>();
+            std::size_t bytes;
+            const unsigned char* data = getBytes(bytes);
+
+            GLint params[4] = {};
+            std::memcpy(params, data, std::min(bytes, sizeof(params)));
+            glTextureParameteriv(name(m_textures, texture), pname, params);
+            break;
+        }
+        case GlCall::TransformFeedbackVaryings: {
+            GLuint program = get<GLuint>();
+            GLsizei count = get<GLsizei>();
+
+            std::vector<std::string> varyings;
+            for (GLsizei i = 0; i < count; i++)
+                varyings.push_back(getString());
+
+            std::vector<const GLchar*> strings;
+            for (const auto& varying : varyings)
+                strings.push_back(varying.c_str());
+
+            GLenum bufferMode = get<GLenum>();
+            glTransformFeedbackVaryings(name(m_programs, program), count, strings.data(), bufferMode);
+            break;
+        }
+        case GlCall::UnmapBuffer: {
+            GLenum target = get<GLenum>();
+            glUnmapBuffer(target);
+            break;
+        }
+        case GlCall::UseProgram: {
+            GLuint program = get<GLuint>();
+            glUseProgram(name(m_programs, program));
+            break;
+        }
+        case GlCall::VertexAttribPointer: {
+            GLuint index = get<GLuint>();
+            GLint size = get<GLint>();
+            GLenum type = get<GLenum>();
+            GLboolean normalized = get<GLboolean>();
+            GLsizei stride = get<GLsizei>();
+            std::uint64_t offset = get<std::uint64_t>();
+            glVertexAttribPointer(index, size, type, normalized, stride, offsetPointer(offset));
+            break;
+        }
+        case GlCall::Viewport: {
+            GLint x = get<GLint>();
+            GLint y = get<GLint>();
+            GLsizei width = get<GLsizei>();
+            GLsizei height = get<GLsizei>();
+            glViewport(x, y, width, height);
+            break;
+        }
+        case GlCall::WaitSync: {
+            std::uint64_t handle = get<std::uint64_t>();
+            GLbitfield flags = get<GLbitfield>();
+            GLuint64 timeout = get<GLuint64>();
+            if (GLsync fence = sync(handle))
+                glWaitSync(fence, flags, timeout);
+            break;
+        }
+        default:
+            throw exception{ "Unknown call in GL capture" };
+        }
+    }
+
+    void GlReplayer::deleteAll() {
+        glUseProgram(0);
+        glBindVertexArray(0);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+
+        auto names = [this](NameMap& map) -> std::vector<GLuint>& {
+            m_names.clear();
+            for (const auto& [captured, replayed] : map)
+                m_names.push_back(replayed);
+            map.clear();
+            return m_names;
+        };
+
+        auto& buffers = names(m_buffers);
+        glDeleteBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+        auto& textures = names(m_textures);
+        glDeleteTextures(static_cast<GLsizei>(textures.size()), textures.data());
+        auto& vertexArrays = names(m_vertexArrays);
+        glDeleteVertexArrays(static_cast<GLsizei>(vertexArrays.size()), vertexArrays.data());
+        auto& framebuffers = names(m_framebuffers);
+        glDeleteFramebuffers(static_cast<GLsizei>(framebuffers.size()), framebuffers.data());
+        auto& queries = names(m_queries);
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        auto& transformFeedbacks = names(m_transformFeedbacks);
+        glDeleteTransformFeedbacks(static_cast<GLsizei>(transformFeedbacks.size()), transformFeedbacks.data());
+
+        for (const auto& [captured, shader] : m_shaders)
+            glDeleteShader(shader);
+        for (const auto& [captured, program] : m_programs)
+            glDeleteProgram(program);
+        for (const auto& [captured, fence] : m_syncs)
+            glDeleteSync(fence);
+
+        m_shaders.clear();
+        m_programs.clear();
+        m_syncs.clear();
+        m_uniformLocations.clear();
+    }
+
+    GlReplayer& GlReplayer::rewind() {
+        deleteAll();
+
+        m_position = m_start;
+        m_frame = 0;
+        return *this;
+    }
+
+    GlReplayer::~GlReplayer() {
+        deleteAll();
+    }
+}
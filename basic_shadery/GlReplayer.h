@@ -0,0 +1,94 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "GlDispatch.h"
+
+namespace gl
+{
+    // Re-executes a capture written by GlDispatch::startCapture() on the current context, one
+    // frame at a time. The whole file is read up front, so replaying measures the driver and
+    // the GPU without any of the application's own work or file reads.
+    //
+    // Objects created by the capture get new names, which are mapped back on every later use,
+    // and uniform locations are looked up again. Attribute locations are taken as they were
+    // captured, same as fragment data locations. Data written through glMapBufferRange is not
+    // part of a capture.
+    class GlReplayer {
+    public:
+        explicit GlReplayer(const std::string& path);
+
+        GlReplayer(const GlReplayer&) = delete;
+        GlReplayer& operator=(const GlReplayer&) = delete;
+
+        // replays the calls up to the next frame end, returns false at the end of the capture
+        bool replayFrame();
+        bool isAtEnd() const { return m_position == m_data.size(); }
+
+        // deletes everything the replay created, the next frame is the capture's first again
+        GlReplayer& rewind();
+
+        std::uint64_t frameNumber() const { return m_frame; }
+        GLint width() const { return m_width; }
+        GLint height() const { return m_height; }
+
+        ~GlReplayer();
+
+    private:
+        using NameMap = std::unordered_map<GLuint, GLuint>;
+
+        template<typename T>
+        T get();
+        // nullptr for a null pointer in the capture
+        const unsigned char* getBytes(std::size_t& size);
+        std::string getString();
+
+        // names read from the capture, translated when the replay created them under another name
+        GLuint name(const NameMap& names, GLuint captured) const;
+        GLint uniformLocation(GLuint capturedProgram, GLint captured) const;
+        GLsync sync(std::uint64_t captured) const;
+
+        void replayCall(GlCall call);
+
+        // the functions are GL entry points, taken as templates for their calling convention
+        template<typename Function>
+        void genNames(NameMap& names, Function gen);
+        template<typename Function>
+        void deleteNames(NameMap& names, Function del);
+        template<typename T, typename Function, std::size_t... Indices>
+        void programUniform(Function function, std::index_sequence<Indices...>);
+        template<typename Function>
+        void programUniformMatrix(Function function, std::size_t size);
+
+        void deleteAll();
+
+        std::vector<unsigned char> m_data;
+        std::size_t m_start;
+        std::size_t m_position;
+        std::uint64_t m_frame;
+        GLint m_width;
+        GLint m_height;
+
+        NameMap m_buffers;
+        NameMap m_textures;
+        NameMap m_vertexArrays;
+        NameMap m_framebuffers;
+        NameMap m_queries;
+        NameMap m_transformFeedbacks;
+        NameMap m_shaders;
+        NameMap m_programs;
+        std::unordered_map<std::uint64_t, GLsync> m_syncs;
+        // (captured program, captured location) to the replayed location
+        std::unordered_map<std::uint64_t, GLint> m_uniformLocations;
+
+        // output of glGet* calls and client-side glReadPixels
+        std::vector<unsigned char> m_scratch;
+        std::vector<GLuint> m_names;
+        std::vector<GLfloat> m_floats;
+    };
+}
@@ -0,0 +1,53 @@
+﻿#include "GlWorkerPool.h"
+
+#include <SFML/Window/Context.hpp>
+
+namespace gl
+{
+    GlWorkerPool::GlWorkerPool(std::size_t threadCount): m_workers(), m_jobs(), m_mutex(), m_hasJobs(), m_isStopping(false) {
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; i++)
+            m_workers.emplace_back(&GlWorkerPool::work, this);
+    }
+
+    void GlWorkerPool::push(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_jobs.push(std::move(job));
+        }
+        m_hasJobs.notify_one();
+    }
+
+    void GlWorkerPool::work() {
+        // SFML makes every context share objects with its internal one, and so with the window's
+        sf::Context context;
+
+        for (;;) {
+            std::function<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_hasJobs.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+
+                if (m_jobs.empty())
+                    return;
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop();
+            }
+
+            job();
+        }
+    }
+
+    GlWorkerPool::~GlWorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_isStopping = true;
+        }
+        m_hasJobs.notify_all();
+
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+}
@@ -0,0 +1,140 @@
+﻿#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "GlDispatch.h"
+
+namespace gl
+{
+    // Result of a job run on a GlWorkerPool: the value the job returned (usually the GL objects it
+    // made) and a fence placed after its GL commands.
+    template<typename T>
+    class GlJob {
+    public:
+        GlJob(): m_result() {}
+
+        GlJob(const GlJob&) = delete;
+        GlJob& operator=(const GlJob&) = delete;
+
+        GlJob(GlJob&& other) noexcept: m_result(std::move(other.m_result)) {}
+        GlJob& operator=(GlJob&& other) noexcept {
+            if (this != &other) {
+                discard();
+                m_result = std::move(other.m_result);
+            }
+            return *this;
+        }
+
+        // false for a default constructed job and once get() took the result
+        bool isValid() const { return m_result.valid(); }
+        // the worker is done with the job, get() will not block
+        bool isReady() const { return isValid() && m_result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        // blocks until the worker is done with the job, without waiting for its GL commands
+        void wait() const {
+            if (isValid())
+                m_result.wait();
+        }
+
+        // call once, before the first use of the objects on this thread: waits for the worker if it
+        // is not done yet and makes the GL commands issued here from now on wait for the job's ones
+        // (glWaitSync, the CPU does not wait for the GPU). Rethrows what the job threw.
+        T get() {
+            Done done = m_result.get();
+            glWaitSync(done.fence, 0, GL_TIMEOUT_IGNORED);
+            glDeleteSync(done.fence);
+            return std::move(done.value);
+        }
+
+        // a result not taken is waited for, so that its fence can be deleted
+        ~GlJob() {
+            discard();
+        }
+
+    private:
+        struct Done {
+            T value;
+            GLsync fence;
+        };
+
+        explicit GlJob(std::future<Done> result): m_result(std::move(result)) {}
+
+        void discard() {
+            if (!isValid())
+                return;
+
+            try {
+                glDeleteSync(m_result.get().fence);
+            } catch (...) {
+                // the job failed and made no fence
+            }
+        }
+
+        std::future<Done> m_result;
+
+        friend class GlWorkerPool;
+    };
+
+    // Threads with GL contexts of their own, sharing objects with the window's context, for uploads
+    // and shader compiles that would otherwise stall the frame they happen in. Buffers, textures,
+    // shaders and programs made by a job can be used on the render thread once GlJob::get() returned;
+    // vertex arrays and framebuffers are never shared between contexts and have to be made there.
+    //
+    // Calls made on the workers are neither counted nor captured by GlDispatch, so a GL capture
+    // only replays when nothing was made on a worker.
+    class GlWorkerPool {
+    public:
+        explicit GlWorkerPool(std::size_t threadCount = 1);
+
+        GlWorkerPool(const GlWorkerPool&) = delete;
+        GlWorkerPool& operator=(const GlWorkerPool&) = delete;
+
+        // runs fn on one of the workers, in FIFO order; fn has to return a (movable) value
+        template<typename Fn>
+        GlJob<std::invoke_result_t<Fn&>> submit(Fn&& fn);
+
+        std::size_t size() const { return m_workers.size(); }
+
+        // finishes the jobs already submitted
+        ~GlWorkerPool();
+
+    private:
+        void push(std::function<void()> job);
+        void work();
+
+        std::vector<std::thread> m_workers;
+        std::queue<std::function<void()>> m_jobs;
+        std::mutex m_mutex;
+        std::condition_variable m_hasJobs;
+        bool m_isStopping;
+    };
+
+    template<typename Fn>
+    GlJob<std::invoke_result_t<Fn&>> GlWorkerPool::submit(Fn&& fn) {
+        using T = std::invoke_result_t<Fn&>;
+        using Done = typename GlJob<T>::Done;
+
+        auto task = std::make_shared<std::packaged_task<Done()>>([fn = std::forward<Fn>(fn)]() mutable {
+            T value = fn();
+
+            // flushed, or the fence might never reach the GPU and the render thread would wait forever
+            GLsync fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            return Done{ std::move(value), fence };
+        });
+
+        GlJob<T> job{ task->get_future() };
+        push([task]() { (*task)(); });
+        return job;
+    }
+}
@@ -0,0 +1,53 @@
+﻿#include "GpuTimer.h"
+
+namespace gl
+{
+    GpuTimer::GpuTimer(): m_queries(), m_first(0), m_count(0), m_isRunning(false) {
+        glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+    }
+
+    bool GpuTimer::begin() {
+        if (m_count == depth)
+            return false;
+
+        glQueryCounter(m_queries[(m_first + m_count) % depth * 2], GL_TIMESTAMP);
+        m_isRunning = true;
+        return true;
+    }
+
+    void GpuTimer::end() {
+        if (!m_isRunning)
+            return;
+
+        glQueryCounter(m_queries[(m_first + m_count) % depth * 2 + 1], GL_TIMESTAMP);
+        m_isRunning = false;
+        m_count++;
+    }
+
+    bool GpuTimer::poll(double& milliseconds) {
+        if (m_count == 0)
+            return false;
+
+        GLuint start = m_queries[m_first * 2], end = m_queries[m_first * 2 + 1];
+
+        // the end timestamp is written last, once it is in the start one is too
+        GLint isAvailable = GL_FALSE;
+        glGetQueryObjectiv(end, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+
+        if (!isAvailable)
+            return false;
+
+        GLuint64 startNanoseconds = 0, endNanoseconds = 0;
+        glGetQueryObjectui64v(start, GL_QUERY_RESULT, &startNanoseconds);
+        glGetQueryObjectui64v(end, GL_QUERY_RESULT, &endNanoseconds);
+
+        milliseconds = static_cast<double>(endNanoseconds - startNanoseconds) / 1e6;
+        m_first = (m_first + 1) % depth;
+        m_count--;
+        return true;
+    }
+
+    GpuTimer::~GpuTimer() {
+        glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+    }
+}
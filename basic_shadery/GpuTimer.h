@@ -0,0 +1,37 @@
+﻿#pragma once
+
+#include <array>
+
+#include "GlDispatch.h"
+
+namespace gl
+{
+    // Measures GPU time of a block of commands with a pair of GL_TIMESTAMP queries, so
+    // timers can be nested (GL_TIME_ELAPSED queries cannot). Results are read back a few
+    // frames later, so reading them never stalls the pipeline.
+    class GpuTimer {
+    public:
+        GpuTimer();
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        // returns false when every query is still in flight - the block will not be measured then
+        bool begin();
+        void end();
+
+        // pops the oldest finished measurement, in submission order
+        bool poll(double& milliseconds);
+
+        static bool isSupported() { return GLEW_VERSION_3_3 || GLEW_ARB_timer_query; }
+
+        ~GpuTimer();
+
+    private:
+        static constexpr std::size_t depth = 4;
+
+        std::array<GLuint, depth * 2> m_queries;   // start and end of every measurement
+        std::size_t m_first, m_count;
+        bool m_isRunning;
+    };
+}
@@ -0,0 +1,294 @@
+﻿#include "ImageEncoder.h"
+
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace gl
+{
+    namespace
+    {
+        void appendString(std::vector<std::uint8_t>& out, const std::string& text) {
+            out.insert(out.end(), text.begin(), text.end());
+        }
+
+        void appendBigEndian(std::vector<std::uint8_t>& out, std::uint32_t value) {
+            out.insert(out.end(), { std::uint8_t(value >> 24), std::uint8_t(value >> 16), std::uint8_t(value >> 8), std::uint8_t(value) });
+        }
+
+        const std::array<std::uint32_t, 256>& crcTable() {
+            static const auto table = []() {
+                std::array<std::uint32_t, 256> t{};
+                for (std::uint32_t n = 0; n < 256; n++) {
+                    std::uint32_t c = n;
+                    for (int k = 0; k < 8; k++)
+                        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    t[n] = c;
+                }
+                return t;
+            }();
+            return table;
+        }
+
+        void appendChunk(std::vector<std::uint8_t>& out, const char* type, const std::vector<std::uint8_t>& data) {
+            appendBigEndian(out, static_cast<std::uint32_t>(data.size()));
+
+            std::size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+
+            const auto& table = crcTable();
+            std::uint32_t crc = 0xFFFFFFFFu;
+            for (std::size_t i = start; i < out.size(); i++)
+                crc = table[(crc ^ out[i]) & 0xFF] ^ (crc >> 8);
+
+            appendBigEndian(out, crc ^ 0xFFFFFFFFu);
+        }
+
+        // deflate writes bits starting from the least significant one, Huffman codes most significant bit first
+        class BitWriter {
+        public:
+            explicit BitWriter(std::vector<std::uint8_t>& out): m_out(out), m_bits(0), m_count(0) {}
+
+            void put(std::uint32_t value, unsigned bits) {
+                m_bits |= std::uint64_t(value) << m_count;
+                m_count += bits;
+
+                while (m_count >= 8) {
+                    m_out.push_back(std::uint8_t(m_bits));
+                    m_bits >>= 8;
+                    m_count -= 8;
+                }
+            }
+
+            void flush() {
+                if (m_count > 0)
+                    m_out.push_back(std::uint8_t(m_bits));
+
+                m_bits = 0;
+                m_count = 0;
+            }
+
+        private:
+            std::vector<std::uint8_t>& m_out;
+            std::uint64_t m_bits;
+            unsigned m_count;
+        };
+
+        std::uint32_t reverseBits(std::uint32_t code, unsigned length) {
+            std::uint32_t result = 0;
+            for (unsigned i = 0; i < length; i++, code >>= 1)
+                result = (result << 1) | (code & 1);
+            return result;
+        }
+
+        // the fixed literal/length code of RFC 1951 3.2.6, already bit-reversed
+        struct FixedCodes {
+            std::array<std::uint16_t, 288> literal;
+            std::array<std::uint8_t, 288> literalLength;
+            std::array<std::uint8_t, 30> distance;
+
+            FixedCodes() {
+                for (std::uint32_t v = 0; v < 288; v++) {
+                    if (v < 144) { literal[v] = std::uint16_t(reverseBits(0x30 + v, 8)); literalLength[v] = 8; }
+                    else if (v < 256) { literal[v] = std::uint16_t(reverseBits(0x190 + v - 144, 9)); literalLength[v] = 9; }
+                    else if (v < 280) { literal[v] = std::uint16_t(reverseBits(v - 256, 7)); literalLength[v] = 7; }
+                    else { literal[v] = std::uint16_t(reverseBits(0xC0 + v - 280, 8)); literalLength[v] = 8; }
+                }
+
+                for (std::uint32_t d = 0; d < 30; d++)
+                    distance[d] = std::uint8_t(reverseBits(d, 5));
+            }
+        };
+
+        constexpr std::uint16_t lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        constexpr std::uint8_t lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        constexpr std::uint16_t distanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+        constexpr std::uint8_t distanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        // greedy LZ77 with one hash probe per position, everything in one fixed-Huffman block
+        void deflate(const std::uint8_t* data, std::size_t size, std::vector<std::uint8_t>& out) {
+            static const FixedCodes codes;
+            constexpr unsigned hashBits = 15;
+            constexpr std::size_t window = 32768, maxMatch = 258;
+
+            std::vector<std::int64_t> head(std::size_t(1) << hashBits, -1);
+            BitWriter writer{ out };
+
+            writer.put(1, 1);   // final block
+            writer.put(1, 2);   // fixed Huffman codes
+
+            auto literal = [&](std::uint32_t value) { writer.put(codes.literal[value], codes.literalLength[value]); };
+
+            std::size_t i = 0;
+            while (i < size) {
+                std::size_t matchLength = 0, matchDistance = 0;
+
+                if (i + 3 <= size) {
+                    std::uint32_t key = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+                    std::uint32_t hash = (key * 2654435761u) >> (32 - hashBits);
+                    std::int64_t candidate = head[hash];
+                    head[hash] = std::int64_t(i);
+
+                    if (candidate >= 0 && i - std::size_t(candidate) <= window) {
+                        const std::uint8_t* a = data + candidate;
+                        const std::uint8_t* b = data + i;
+                        std::size_t limit = std::min(maxMatch, size - i);
+
+                        std::size_t length = 0;
+                        while (length < limit && a[length] == b[length])
+                            length++;
+
+                        if (length >= 3) {
+                            matchLength = length;
+                            matchDistance = i - std::size_t(candidate);
+                        }
+                    }
+                }
+
+                if (matchLength == 0) {
+                    literal(data[i++]);
+                    continue;
+                }
+
+                std::size_t l = std::upper_bound(std::begin(lengthBase), std::end(lengthBase), matchLength) - std::begin(lengthBase) - 1;
+                literal(257 + std::uint32_t(l));
+                writer.put(std::uint32_t(matchLength - lengthBase[l]), lengthExtra[l]);
+
+                std::size_t d = std::upper_bound(std::begin(distanceBase), std::end(distanceBase), matchDistance) - std::begin(distanceBase) - 1;
+                writer.put(codes.distance[d], 5);
+                writer.put(std::uint32_t(matchDistance - distanceBase[d]), distanceExtra[d]);
+
+                i += matchLength;
+            }
+
+            literal(256);   // end of block
+            writer.flush();
+        }
+
+        std::uint32_t adler32(const std::uint8_t* data, std::size_t size) {
+            std::uint32_t a = 1, b = 0;
+
+            // 5552 is the longest run before b can overflow
+            while (size > 0) {
+                std::size_t run = std::min<std::size_t>(size, 5552);
+                size -= run;
+
+                for (; run > 0; run--) {
+                    a += *data++;
+                    b += a;
+                }
+
+                a %= 65521;
+                b %= 65521;
+            }
+
+            return (b << 16) | a;
+        }
+    }
+
+    std::vector<std::uint8_t> ImageEncoder::encodePpm(const std::uint8_t* rgba, unsigned width, unsigned height) {
+        std::vector<std::uint8_t> out;
+        appendString(out, "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n");
+        std::size_t header = out.size();
+        out.resize(header + std::size_t(width) * height * 3);
+
+        std::uint8_t* pixel = out.data() + header;
+        for (unsigned y = height; y-- > 0;) {
+            const std::uint8_t* row = rgba + std::size_t(y) * width * 4;
+            for (unsigned x = 0; x < width; x++, pixel += 3) {
+                pixel[0] = row[x * 4];
+                pixel[1] = row[x * 4 + 1];
+                pixel[2] = row[x * 4 + 2];
+            }
+        }
+
+        return out;
+    }
+
+    std::vector<std::uint8_t> ImageEncoder::encodePng(const std::uint8_t* rgba, unsigned width, unsigned height) {
+        const std::size_t stride = std::size_t(width) * 3 + 1;
+
+        // every row starts with its filter type, Sub (1) stores the difference to the pixel on the left
+        std::vector<std::uint8_t> filtered(stride * height);
+        for (unsigned y = 0; y < height; y++) {
+            const std::uint8_t* row = rgba + std::size_t(height - 1 - y) * width * 4;
+            std::uint8_t* out = filtered.data() + y * stride;
+
+            *out++ = 1;
+            std::uint8_t left[3] = { 0, 0, 0 };
+
+            for (unsigned x = 0; x < width; x++) {
+                for (int c = 0; c < 3; c++) {
+                    std::uint8_t value = row[x * 4 + c];
+                    *out++ = std::uint8_t(value - left[c]);
+                    left[c] = value;
+                }
+            }
+        }
+
+        std::vector<std::uint8_t> header;
+        appendBigEndian(header, width);
+        appendBigEndian(header, height);
+        header.insert(header.end(), { 8, 2, 0, 0, 0 });     // 8 bit RGB, deflate, adaptive filtering, no interlacing
+
+        std::vector<std::uint8_t> compressed = { 0x78, 0x01 };
+        compressed.reserve(filtered.size() / 2);
+        deflate(filtered.data(), filtered.size(), compressed);
+        appendBigEndian(compressed, adler32(filtered.data(), filtered.size()));
+
+        std::vector<std::uint8_t> out = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        appendChunk(out, "IHDR", header);
+        appendChunk(out, "IDAT", compressed);
+        appendChunk(out, "IEND", {});
+        return out;
+    }
+
+    std::vector<std::uint8_t> ImageEncoder::y4mHeader(unsigned width, unsigned height, unsigned frameRate) {
+        std::vector<std::uint8_t> out;
+        appendString(out, "YUV4MPEG2 W" + std::to_string(width) + " H" + std::to_string(height) + " F" + std::to_string(frameRate) + ":1 Ip A1:1 C420jpeg XCOLORRANGE=FULL\n");
+        return out;
+    }
+
+    void ImageEncoder::encodeY4mFrame(const std::uint8_t* rgba, unsigned width, unsigned height, std::vector<std::uint8_t>& out) {
+        const unsigned chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+
+        appendString(out, "FRAME\n");
+        std::size_t luma = out.size();
+        out.resize(luma + std::size_t(width) * height + std::size_t(chromaWidth) * chromaHeight * 2);
+
+        std::uint8_t* yPlane = out.data() + luma;
+        std::uint8_t* uPlane = yPlane + std::size_t(width) * height;
+        std::uint8_t* vPlane = uPlane + std::size_t(chromaWidth) * chromaHeight;
+
+        // BT.601 full range in 8.8 fixed point
+        for (unsigned y = 0; y < height; y++) {
+            const std::uint8_t* row = rgba + std::size_t(height - 1 - y) * width * 4;
+            std::uint8_t* out = yPlane + std::size_t(y) * width;
+
+            for (unsigned x = 0; x < width; x++)
+                out[x] = std::uint8_t((77 * row[x * 4] + 150 * row[x * 4 + 1] + 29 * row[x * 4 + 2] + 128) >> 8);
+        }
+
+        for (unsigned cy = 0; cy < chromaHeight; cy++) {
+            unsigned y0 = cy * 2, y1 = std::min(cy * 2 + 1, height - 1);
+            const std::uint8_t* row0 = rgba + std::size_t(height - 1 - y0) * width * 4;
+            const std::uint8_t* row1 = rgba + std::size_t(height - 1 - y1) * width * 4;
+
+            for (unsigned cx = 0; cx < chromaWidth; cx++) {
+                unsigned x0 = cx * 2 * 4, x1 = std::min(cx * 2 + 1, width - 1) * 4;
+
+                int r = row0[x0] + row0[x1] + row1[x0] + row1[x1];
+                int g = row0[x0 + 1] + row0[x1 + 1] + row1[x0 + 1] + row1[x1 + 1];
+                int b = row0[x0 + 2] + row0[x1 + 2] + row1[x0 + 2] + row1[x1 + 2];
+
+                // sums of four pixels, hence the extra shift by 2; offset keeps the shifted value non-negative
+                int u = (-43 * r - 85 * g + 128 * b + (128 << 10) + 512) >> 10;
+                int v = (128 * r - 107 * g - 21 * b + (128 << 10) + 512) >> 10;
+
+                uPlane[std::size_t(cy) * chromaWidth + cx] = std::uint8_t(std::min(u, 255));
+                vPlane[std::size_t(cy) * chromaWidth + cx] = std::uint8_t(std::min(v, 255));
+            }
+        }
+    }
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace gl
+{
+    // Encoders for frames read back from GL. Input is always tightly packed RGBA8 with rows
+    // bottom to top, the way glReadPixels returns them; alpha is dropped.
+    class ImageEncoder {
+    public:
+        // binary PPM (P6)
+        static std::vector<std::uint8_t> encodePpm(const std::uint8_t* rgba, unsigned width, unsigned height);
+
+        // RGB PNG with the Sub filter and a single pass fixed-Huffman deflate - a lot larger
+        // than what zlib -9 makes, but fast enough to keep up with rendering
+        static std::vector<std::uint8_t> encodePng(const std::uint8_t* rgba, unsigned width, unsigned height);
+
+        // "YUV4MPEG2 ..." stream header for 4:2:0 frames with full range BT.601 colors
+        static std::vector<std::uint8_t> y4mHeader(unsigned width, unsigned height, unsigned frameRate);
+
+        // appends one y4m frame: "FRAME\n" followed by the Y, U and V planes
+        static void encodeY4mFrame(const std::uint8_t* rgba, unsigned width, unsigned height, std::vector<std::uint8_t>& out);
+    };
+}
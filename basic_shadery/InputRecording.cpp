@@ -0,0 +1,109 @@
+﻿#include "InputRecording.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace gl
+{
+    namespace
+    {
+        const char magic[8] = { 'G', 'R', 'A', 'F', 'R', 'E', 'C', '\0' };
+        const std::uint32_t version = 1;
+        const std::size_t recordSize = 44;
+
+        // memcpy keeps the host byte order, which is little-endian everywhere this builds
+        template<typename T>
+        void put(unsigned char*& out, T value) {
+            std::memcpy(out, &value, sizeof(T));
+            out += sizeof(T);
+        }
+
+        template<typename T>
+        T get(const unsigned char*& in) {
+            T value;
+            std::memcpy(&value, in, sizeof(T));
+            in += sizeof(T);
+            return value;
+        }
+    }
+
+    InputRecorder::InputRecorder(const std::string& path): m_file(path, std::ios::binary | std::ios::trunc), m_frames(0) {
+        if (!m_file)
+            throw recording_exception{ "Could not create recording " + path };
+
+        m_file.write(magic, sizeof(magic));
+        m_file.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+
+    InputRecorder& InputRecorder::record(const FrameRecord& frame) {
+        unsigned char buffer[recordSize];
+        unsigned char* out = buffer;
+
+        put(out, frame.timeStep);
+        put(out, frame.input.keys);
+        put(out, frame.input.actions);
+        put(out, std::uint8_t(frame.input.hasFocus ? 1 : 0));
+        put(out, std::int16_t(frame.input.mouseOffset.x));
+        put(out, std::int16_t(frame.input.mouseOffset.y));
+        put(out, frame.input.wheelDelta);
+        put(out, std::int16_t(frame.input.wheelPosition.x));
+        put(out, std::int16_t(frame.input.wheelPosition.y));
+
+        for (int i = 0; i < 3; i++)
+            put(out, frame.cameraPosition[i]);
+        for (int i = 0; i < 3; i++)
+            put(out, frame.cameraDirection[i]);
+
+        m_file.write(reinterpret_cast<const char*>(buffer), recordSize);
+        if (!m_file)
+            throw recording_exception{ "Could not write frame " + std::to_string(m_frames) + " of the recording" };
+
+        m_frames++;
+        return *this;
+    }
+
+    InputPlayer::InputPlayer(const std::string& path): m_frames(), m_position(0) {
+        std::ifstream file{ path, std::ios::binary };
+        if (!file)
+            throw recording_exception{ "Could not open recording " + path };
+
+        std::vector<unsigned char> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+        const std::size_t headerSize = sizeof(magic) + sizeof(version);
+        if (data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)) != 0)
+            throw recording_exception{ path + " is not an input recording" };
+
+        const unsigned char* in = data.data() + sizeof(magic);
+        if (get<std::uint32_t>(in) != version)
+            throw recording_exception{ path + " was recorded with an unsupported version" };
+
+        std::size_t count = (data.size() - headerSize) / recordSize;
+        m_frames.resize(count);
+
+        for (auto& frame : m_frames) {
+            frame.timeStep = get<float>(in);
+            frame.input.keys = get<std::uint16_t>(in);
+            frame.input.actions = get<std::uint8_t>(in);
+            frame.input.hasFocus = get<std::uint8_t>(in) != 0;
+            frame.input.mouseOffset.x = get<std::int16_t>(in);
+            frame.input.mouseOffset.y = get<std::int16_t>(in);
+            frame.input.wheelDelta = get<float>(in);
+            frame.input.wheelPosition.x = get<std::int16_t>(in);
+            frame.input.wheelPosition.y = get<std::int16_t>(in);
+
+            for (int i = 0; i < 3; i++)
+                frame.cameraPosition[i] = get<float>(in);
+            for (int i = 0; i < 3; i++)
+                frame.cameraDirection[i] = get<float>(in);
+        }
+    }
+
+    bool InputPlayer::next(FrameRecord& frame) {
+        if (m_position >= m_frames.size())
+            return false;
+
+        frame = m_frames[m_position++];
+        return true;
+    }
+}
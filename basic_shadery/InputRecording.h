@@ -0,0 +1,75 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "InputState.h"
+#include "exceptions.h"
+
+namespace gl
+{
+    class recording_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        recording_exception(): message(), super() {}
+        recording_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // one frame of a session: how long it took, what the user did, and where the camera ended up
+    struct FrameRecord {
+        float timeStep = .0f;   // microseconds, the same units the controls take
+        InputState input;
+        glm::vec3 cameraPosition{ .0f };
+        glm::vec3 cameraDirection{ .0f, .0f, -1.f };
+    };
+
+    // Appends frames to a binary log: an 8 byte magic and a version, then fixed size
+    // little-endian records of 44 bytes each. A log cut short by a crash stays readable
+    // up to its last whole frame.
+    class InputRecorder {
+    public:
+        explicit InputRecorder(const std::string& path);
+
+        InputRecorder(const InputRecorder&) = delete;
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        InputRecorder& record(const FrameRecord& frame);
+
+        std::size_t frameCount() const { return m_frames; }
+
+    private:
+        std::ofstream m_file;
+        std::size_t m_frames;
+    };
+
+    class InputPlayer {
+    public:
+        explicit InputPlayer(const std::string& path);
+
+        // false once every frame has been played
+        bool next(FrameRecord& frame);
+
+        InputPlayer& rewind() {
+            m_position = 0;
+            return *this;
+        }
+
+        std::size_t frameCount() const { return m_frames.size(); }
+        std::size_t position() const { return m_position; }
+        const std::vector<FrameRecord>& frames() const { return m_frames; }
+
+    private:
+        std::vector<FrameRecord> m_frames;
+        std::size_t m_position;
+    };
+}
@@ -0,0 +1,25 @@
+﻿#include "InputState.h"
+
+#include <SFML/Window.hpp>
+
+gl::InputState gl::InputState::poll(const sf::Window& window) {
+    using sf::Keyboard;
+
+    InputState input;
+    input.hasFocus = window.hasFocus();
+
+    if (Keyboard::isKeyPressed(Keyboard::Up) || Keyboard::isKeyPressed(Keyboard::W))
+        input.keys |= Forward;
+    if (Keyboard::isKeyPressed(Keyboard::Down) || Keyboard::isKeyPressed(Keyboard::S))
+        input.keys |= Back;
+    if (Keyboard::isKeyPressed(Keyboard::Left) || Keyboard::isKeyPressed(Keyboard::A))
+        input.keys |= Left;
+    if (Keyboard::isKeyPressed(Keyboard::Right) || Keyboard::isKeyPressed(Keyboard::D))
+        input.keys |= Right;
+    if (Keyboard::isKeyPressed(Keyboard::RShift) || Keyboard::isKeyPressed(Keyboard::LShift))
+        input.keys |= Down;
+    if (Keyboard::isKeyPressed(Keyboard::Space))
+        input.keys |= Up;
+
+    return input;
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <cstdint>
+
+#include <glm/vec2.hpp>
+
+namespace sf
+{
+    class Window;
+}
+
+namespace gl
+{
+    // Everything the application reacts to in one frame. Sampled from the window while
+    // running live, read back from a recording when replaying, so both take the same path.
+    struct InputState {
+        enum Key : std::uint16_t {
+            Forward = 1 << 0,   // W / Up
+            Back = 1 << 1,      // S / Down
+            Left = 1 << 2,      // A / Left
+            Right = 1 << 3,     // D / Right
+            Down = 1 << 4,      // Shift
+            Up = 1 << 5         // Space
+        };
+
+        // one-off actions from key and mouse button presses
+        enum Action : std::uint8_t {
+            ResetLook = 1 << 0,
+            ToggleFractal = 1 << 1,
+            ToggleMouseCapture = 1 << 2
+        };
+
+        std::uint16_t keys = 0;
+        std::uint8_t actions = 0;
+        bool hasFocus = true;
+
+        glm::ivec2 mouseOffset{ 0 };    // from the window center, y up; zero when the mouse is not captured
+
+        float wheelDelta = .0f;
+        glm::ivec2 wheelPosition{ 0 };
+
+        bool isDown(Key key) const { return (keys & key) != 0; }
+        bool has(Action action) const { return (actions & action) != 0; }
+
+        // keyboard state and focus; the mouse belongs to the camera controls
+        static InputState poll(const sf::Window& window);
+    };
+}
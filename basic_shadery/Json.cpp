@@ -0,0 +1,261 @@
+﻿#include "Json.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+namespace gl
+{
+    class JsonParser {
+    public:
+        JsonParser(std::string_view text): m_text(text), m_pos(0) {}
+
+        JsonValue parseDocument() {
+            JsonValue value = parseValue(0);
+            skipWhitespace();
+
+            if (m_pos != m_text.size())
+                fail("unexpected data after the document");
+
+            return value;
+        }
+
+    private:
+        static constexpr int maxDepth = 256;
+
+        [[noreturn]] void fail(const char* what) const {
+            throw json_exception{ std::string{ "JSON parse error at offset " } + std::to_string(m_pos) + ": " + what };
+        }
+
+        void skipWhitespace() {
+            while (m_pos < m_text.size() && (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r'))
+                m_pos++;
+        }
+
+        void expect(char c) {
+            skipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != c)
+                fail("unexpected character");
+            m_pos++;
+        }
+
+        bool consumeLiteral(std::string_view literal) {
+            if (m_text.substr(m_pos, literal.size()) != literal)
+                return false;
+            m_pos += literal.size();
+            return true;
+        }
+
+        JsonValue parseValue(int depth) {
+            if (depth > maxDepth)
+                fail("document nested too deeply");
+
+            skipWhitespace();
+            if (m_pos >= m_text.size())
+                fail("unexpected end of document");
+
+            JsonValue value;
+            char c = m_text[m_pos];
+
+            if (c == '{') {
+                m_pos++;
+                value.m_type = JsonValue::Type::Object;
+
+                skipWhitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == '}') {
+                    m_pos++;
+                    return value;
+                }
+
+                for (;;) {
+                    skipWhitespace();
+                    std::string key = parseString();
+                    expect(':');
+                    value.m_object[std::move(key)] = parseValue(depth + 1);
+
+                    skipWhitespace();
+                    if (m_pos < m_text.size() && m_text[m_pos] == ',') {
+                        m_pos++;
+                        continue;
+                    }
+                    expect('}');
+                    return value;
+                }
+            }
+
+            if (c == '[') {
+                m_pos++;
+                value.m_type = JsonValue::Type::Array;
+
+                skipWhitespace();
+                if (m_pos < m_text.size() && m_text[m_pos] == ']') {
+                    m_pos++;
+                    return value;
+                }
+
+                for (;;) {
+                    value.m_array.push_back(parseValue(depth + 1));
+
+                    skipWhitespace();
+                    if (m_pos < m_text.size() && m_text[m_pos] == ',') {
+                        m_pos++;
+                        continue;
+                    }
+                    expect(']');
+                    return value;
+                }
+            }
+
+            if (c == '"') {
+                value.m_type = JsonValue::Type::String;
+                value.m_string = parseString();
+                return value;
+            }
+
+            if (consumeLiteral("true")) {
+                value.m_type = JsonValue::Type::Bool;
+                value.m_number = 1.0;
+                return value;
+            }
+
+            if (consumeLiteral("false")) {
+                value.m_type = JsonValue::Type::Bool;
+                return value;
+            }
+
+            if (consumeLiteral("null"))
+                return value;
+
+            value.m_type = JsonValue::Type::Number;
+            value.m_number = parseNumber();
+            return value;
+        }
+
+        double parseNumber() {
+            std::size_t start = m_pos;
+            while (m_pos < m_text.size() && std::string_view{ "+-0123456789.eE" }.find(m_text[m_pos]) != std::string_view::npos)
+                m_pos++;
+
+            if (start == m_pos)
+                fail("unexpected character");
+
+            double number = 0.0;
+            auto result = std::from_chars(m_text.data() + start, m_text.data() + m_pos, number);
+            if (result.ec != std::errc{} || result.ptr != m_text.data() + m_pos)
+                fail("malformed number");
+
+            return number;
+        }
+
+        void appendUtf8(std::string& out, unsigned codepoint) {
+            if (codepoint < 0x80) {
+                out += static_cast<char>(codepoint);
+            } else if (codepoint < 0x800) {
+                out += static_cast<char>(0xC0 | (codepoint >> 6));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x10000) {
+                out += static_cast<char>(0xE0 | (codepoint >> 12));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (codepoint >> 18));
+                out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+        }
+
+        unsigned parseHex4() {
+            if (m_pos + 4 > m_text.size())
+                fail("truncated \\u escape");
+
+            unsigned value = 0;
+            auto result = std::from_chars(m_text.data() + m_pos, m_text.data() + m_pos + 4, value, 16);
+            if (result.ptr != m_text.data() + m_pos + 4)
+                fail("malformed \\u escape");
+
+            m_pos += 4;
+            return value;
+        }
+
+        std::string parseString() {
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"')
+                fail("expected a string");
+            m_pos++;
+
+            std::string out;
+            while (m_pos < m_text.size()) {
+                char c = m_text[m_pos++];
+
+                if (c == '"')
+                    return out;
+
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+
+                if (m_pos >= m_text.size())
+                    break;
+
+                switch (m_text[m_pos++]) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned codepoint = parseHex4();
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00 && consumeLiteral("\\u")) {
+                        unsigned low = parseHex4();
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    fail("unknown escape sequence");
+                }
+            }
+
+            fail("unterminated string");
+        }
+
+        std::string_view m_text;
+        std::size_t m_pos;
+    };
+
+    JsonValue JsonValue::parse(std::string_view text) {
+        return JsonParser{ text }.parseDocument();
+    }
+
+    std::size_t JsonValue::asIndex(std::size_t fallback) const {
+        if (!isNumber())
+            return fallback;
+
+        // SIZE_MAX rounds up to a power of two as a double, so < keeps the cast in range
+        if (!std::isfinite(m_number) || m_number < 0.0 || m_number != std::floor(m_number) || m_number >= static_cast<double>(SIZE_MAX))
+            throw json_exception{ "JSON number is not a valid index" };
+
+        return static_cast<std::size_t>(m_number);
+    }
+
+    const JsonValue& JsonValue::operator[](std::size_t index) const {
+        static const JsonValue null;
+        return (isArray() && index < m_array.size()) ? m_array[index] : null;
+    }
+
+    const JsonValue& JsonValue::operator[](const std::string& key) const {
+        static const JsonValue null;
+
+        if (!isObject())
+            return null;
+
+        auto it = m_object.find(key);
+        return it != m_object.end() ? it->second : null;
+    }
+}
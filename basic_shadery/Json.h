@@ -0,0 +1,67 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    class json_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        json_exception(): message(), super() {}
+        json_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Minimal read-only JSON document, enough for asset manifests like glTF.
+    // Lookups of missing keys or indices return a null value instead of throwing.
+    class JsonValue {
+    public:
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        JsonValue(): m_type(Type::Null), m_number(0.0), m_string(), m_array(), m_object() {}
+
+        static JsonValue parse(std::string_view text);
+
+        Type getType() const { return m_type; }
+        bool isNull() const { return m_type == Type::Null; }
+        bool isNumber() const { return m_type == Type::Number; }
+        bool isString() const { return m_type == Type::String; }
+        bool isArray() const { return m_type == Type::Array; }
+        bool isObject() const { return m_type == Type::Object; }
+
+        double asNumber(double fallback = 0.0) const { return isNumber() ? m_number : fallback; }
+        // throws when the number is negative, fractional or too big for an index
+        std::size_t asIndex(std::size_t fallback = 0) const;
+        bool asBool(bool fallback = false) const { return m_type == Type::Bool ? m_number != 0.0 : fallback; }
+        const std::string& asString() const { return m_string; }
+
+        std::size_t size() const { return isArray() ? m_array.size() : m_object.size(); }
+        bool contains(const std::string& key) const { return m_object.count(key) != 0; }
+
+        const JsonValue& operator[](std::size_t index) const;
+        const JsonValue& operator[](const std::string& key) const;
+
+        const std::vector<JsonValue>& items() const { return m_array; }
+        const std::map<std::string, JsonValue>& members() const { return m_object; }
+
+    private:
+        friend class JsonParser;
+
+        Type m_type;
+        double m_number;
+        std::string m_string;
+        std::vector<JsonValue> m_array;
+        std::map<std::string, JsonValue> m_object;
+    };
+}
@@ -0,0 +1,198 @@
+﻿#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <emmintrin.h>
+
+namespace gl
+{
+    namespace
+    {
+        // keeps between a quarter and as much again on top of what this frame used, so the next
+        // frames can use more without reallocating
+        template<typename T>
+        void reserveSlack(std::vector<T>& list, std::size_t used) {
+            if (list.capacity() < used + used / 4)
+                list.reserve(used * 2);
+        }
+    }
+
+    LightClusters::LightClusters(unsigned tilesX, unsigned tilesY, unsigned slices, ThreadPool& pool):
+        m_tilesX(tilesX),
+        m_tilesY(tilesY),
+        m_slices(slices),
+        m_pool(pool),
+        m_projection(.0f),
+        m_near(.0f),
+        m_far(.0f),
+        m_depthScale(.0f, .0f),
+        m_sliceDepths(slices + 1),
+        m_boundsMin(std::size_t(tilesX) * tilesY * slices),
+        m_boundsMax(std::size_t(tilesX) * tilesY * slices),
+        m_lightData(),
+        m_sliceLights(slices),
+        m_grid(std::size_t(tilesX) * tilesY * slices),
+        m_indices()
+    {}
+
+    unsigned LightClusters::slice(float depth) const {
+        float slice = std::floor(std::log(depth) * m_depthScale.x - m_depthScale.y);
+        return static_cast<unsigned>(std::clamp(slice, .0f, float(m_slices - 1)));
+    }
+
+    void LightClusters::buildBounds(const glm::mat4& projection, float near, float far) {
+        m_projection = projection;
+        m_near = near;
+        m_far = far;
+
+        float logRange = std::log(far / near);
+        m_depthScale = { m_slices / logRange, m_slices * std::log(near) / logRange };
+
+        for (unsigned s = 0; s <= m_slices; s++)
+            m_sliceDepths[s] = near * std::pow(far / near, float(s) / m_slices);
+
+        // a view space point at depth d lands on NDC x = x * projection[0][0] / d, so the
+        // edges of a tile are the lines x = ndc * d / projection[0][0]
+        float unprojectX = 1.f / projection[0][0], unprojectY = 1.f / projection[1][1];
+
+        for (unsigned s = 0; s < m_slices; s++) {
+            float nearDepth = m_sliceDepths[s], farDepth = m_sliceDepths[s + 1];
+
+            for (unsigned y = 0; y < m_tilesY; y++) {
+                float bottom = -1.f + 2.f * y / m_tilesY, top = -1.f + 2.f * (y + 1) / m_tilesY;
+
+                for (unsigned x = 0; x < m_tilesX; x++) {
+                    float left = -1.f + 2.f * x / m_tilesX, right = -1.f + 2.f * (x + 1) / m_tilesX;
+
+                    float xs[] = { left * nearDepth, left * farDepth, right * nearDepth, right * farDepth };
+                    float ys[] = { bottom * nearDepth, bottom * farDepth, top * nearDepth, top * farDepth };
+
+                    std::size_t cluster = clusterIndex(x, y, s);
+                    m_boundsMin[cluster] = { *std::min_element(xs, xs + 4) * unprojectX, *std::min_element(ys, ys + 4) * unprojectY, -farDepth };
+                    m_boundsMax[cluster] = { *std::max_element(xs, xs + 4) * unprojectX, *std::max_element(ys, ys + 4) * unprojectY, -nearDepth };
+                }
+            }
+        }
+    }
+
+    LightClusters& LightClusters::assign(const PerspectiveCamera& camera, const std::vector<PointLight>& lights) {
+        if (camera.getProjectionMatrix() != m_projection || camera.getNear() != m_near || camera.getFar() != m_far)
+            buildBounds(camera.getProjectionMatrix(), camera.getNear(), camera.getFar());
+
+        std::size_t lightCount = std::min(lights.size(), maxLights);
+        const glm::mat4& view = camera.getViewMatrix();
+
+        m_lightData.resize(lightCount * 2);
+        for (std::size_t i = 0; i < lightCount; i++) {
+            m_lightData[i * 2] = glm::vec4{ glm::vec3{ view * glm::vec4{ lights[i].position, 1.f } }, lights[i].radius };
+            m_lightData[i * 2 + 1] = glm::vec4{ lights[i].color, .0f };
+        }
+
+        m_pool.parallelFor(m_slices, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t s = begin; s < end; s++)
+                assignSlice(static_cast<unsigned>(s), lightCount);
+        });
+
+        // lights move between slices from frame to frame, so every slice gets room for as much
+        // as the fullest one had
+        std::size_t mostLights = 0, mostIndices = 0;
+        for (const auto& slice : m_sliceLights) {
+            mostLights = std::max(mostLights, slice.x.size());
+            mostIndices = std::max(mostIndices, slice.indices.size());
+        }
+
+        for (auto& slice : m_sliceLights) {
+            reserveSlack(slice.x, mostLights);
+            reserveSlack(slice.y, mostLights);
+            reserveSlack(slice.z, mostLights);
+            reserveSlack(slice.radiusSquared, mostLights);
+            reserveSlack(slice.lights, mostLights);
+            reserveSlack(slice.indices, mostIndices);
+        }
+
+        // offsets were local to each slice's list until the lists are joined
+        std::size_t total = 0;
+        for (unsigned s = 0; s < m_slices; s++) {
+            for (std::size_t cluster = clusterIndex(0, 0, s); cluster < clusterIndex(0, 0, s + 1); cluster++)
+                m_grid[cluster].x += static_cast<unsigned>(total);
+            total += m_sliceLights[s].indices.size();
+        }
+
+        reserveSlack(m_indices, total);
+        m_indices.resize(total);
+        auto out = m_indices.begin();
+        for (const auto& slice : m_sliceLights)
+            out = std::copy(slice.indices.begin(), slice.indices.end(), out);
+
+        return *this;
+    }
+
+    void LightClusters::assignSlice(unsigned s, std::size_t lightCount) {
+        Slice& slice = m_sliceLights[s];
+        float nearDepth = m_sliceDepths[s], farDepth = m_sliceDepths[s + 1];
+
+        slice.x.clear();
+        slice.y.clear();
+        slice.z.clear();
+        slice.radiusSquared.clear();
+        slice.lights.clear();
+        slice.indices.clear();
+
+        for (std::size_t i = 0; i < lightCount; i++) {
+            const glm::vec4& light = m_lightData[i * 2];
+            float depth = -light.z;
+            if (depth + light.w < nearDepth || depth - light.w > farDepth)
+                continue;
+
+            slice.x.push_back(light.x);
+            slice.y.push_back(light.y);
+            slice.z.push_back(light.z);
+            slice.radiusSquared.push_back(light.w * light.w);
+            slice.lights.push_back(static_cast<std::uint16_t>(i));
+        }
+
+        // a zero radius light at infinity is never closer than its radius
+        while (slice.x.size() % 4 != 0) {
+            slice.x.push_back(std::numeric_limits<float>::infinity());
+            slice.y.push_back(.0f);
+            slice.z.push_back(.0f);
+            slice.radiusSquared.push_back(.0f);
+        }
+
+        const __m128 zero = _mm_setzero_ps();
+
+        for (unsigned y = 0; y < m_tilesY; y++) {
+            for (unsigned x = 0; x < m_tilesX; x++) {
+                std::size_t cluster = clusterIndex(x, y, s);
+                std::size_t first = slice.indices.size();
+
+                const glm::vec3& boundsMin = m_boundsMin[cluster];
+                const glm::vec3& boundsMax = m_boundsMax[cluster];
+                const __m128 minX = _mm_set1_ps(boundsMin.x), minY = _mm_set1_ps(boundsMin.y), minZ = _mm_set1_ps(boundsMin.z);
+                const __m128 maxX = _mm_set1_ps(boundsMax.x), maxY = _mm_set1_ps(boundsMax.y), maxZ = _mm_set1_ps(boundsMax.z);
+
+                for (std::size_t i = 0; i < slice.x.size(); i += 4) {
+                    __m128 centerX = _mm_loadu_ps(slice.x.data() + i);
+                    __m128 centerY = _mm_loadu_ps(slice.y.data() + i);
+                    __m128 centerZ = _mm_loadu_ps(slice.z.data() + i);
+
+                    // distance from the center to the box, per axis: how far it is past either face
+                    __m128 dx = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minX, centerX), zero), _mm_max_ps(_mm_sub_ps(centerX, maxX), zero));
+                    __m128 dy = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minY, centerY), zero), _mm_max_ps(_mm_sub_ps(centerY, maxY), zero));
+                    __m128 dz = _mm_add_ps(_mm_max_ps(_mm_sub_ps(minZ, centerZ), zero), _mm_max_ps(_mm_sub_ps(centerZ, maxZ), zero));
+                    __m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+                    int hits = _mm_movemask_ps(_mm_cmple_ps(distanceSquared, _mm_loadu_ps(slice.radiusSquared.data() + i)));
+                    for (; hits != 0; hits &= hits - 1) {
+                        int lane = hits & 1 ? 0 : hits & 2 ? 1 : hits & 4 ? 2 : 3;
+                        slice.indices.push_back(slice.lights[i + lane]);
+                    }
+                }
+
+                m_grid[cluster] = { static_cast<unsigned>(first), static_cast<unsigned>(slice.indices.size() - first) };
+            }
+        }
+    }
+}
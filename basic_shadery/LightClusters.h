@@ -0,0 +1,93 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "PerspectiveCamera.h"
+#include "ThreadPool.h"
+
+namespace gl
+{
+    struct PointLight {
+        glm::vec3 position;     // world space
+        float radius;           // nothing is lit past this distance
+        glm::vec3 color;        // linear, can go over 1
+    };
+
+    // CPU side of clustered lighting: the camera's frustum cut into tilesX x tilesY screen tiles
+    // and slices depth slices, and for every such cluster the list of lights reaching into it.
+    //
+    // The slices are spaced exponentially between the near and the far plane, so clusters
+    // stay about as deep as they are wide. Lights are tested against the view space bounding
+    // box of every cluster, one depth slice per job on the thread pool: the lights overlapping
+    // the slice's depth range are gathered first, then tested against the slice's tiles four at
+    // a time with SSE. The per-slice lists are joined into one compact index list with an
+    // (offset, count) pair per cluster, ready to be uploaded as is.
+    //
+    // The lists keep their capacity between frames, with at least a quarter on top of the
+    // fullest slice so far, so assign() stays off the heap once the lights settle. Memory
+    // grows with the light and cluster overlaps actually found, not clusters times lights.
+    class LightClusters {
+    public:
+        // indices are 16-bit, further lights are ignored
+        static constexpr std::size_t maxLights = 65536;
+
+        explicit LightClusters(unsigned tilesX = 16, unsigned tilesY = 9, unsigned slices = 24, ThreadPool& pool = ThreadPool::shared());
+
+        LightClusters(const LightClusters&) = delete;
+        LightClusters& operator=(const LightClusters&) = delete;
+
+        // cluster bounds are rebuilt only when the camera's projection changed since the last call
+        LightClusters& assign(const PerspectiveCamera& camera, const std::vector<PointLight>& lights);
+
+        glm::uvec3 dimensions() const { return { m_tilesX, m_tilesY, m_slices }; }
+        std::size_t clusterCount() const { return m_grid.size(); }
+        // x fastest, then y (bottom up), then the depth slice (near to far)
+        std::size_t clusterIndex(unsigned x, unsigned y, unsigned slice) const { return (std::size_t(slice) * m_tilesY + y) * m_tilesX + x; }
+
+        // slice of view depth d (positive) is floor(log(d) * depthScale().x - depthScale().y)
+        glm::vec2 depthScale() const { return m_depthScale; }
+        unsigned slice(float depth) const;
+
+        // per cluster the offset of its first light in indices() and the light count
+        const std::vector<glm::uvec2>& grid() const { return m_grid; }
+        const std::vector<std::uint16_t>& indices() const { return m_indices; }
+        // two per light: view space position and radius, then color
+        const std::vector<glm::vec4>& lightData() const { return m_lightData; }
+
+        const glm::vec3& boundsMin(std::size_t cluster) const { return m_boundsMin[cluster]; }
+        const glm::vec3& boundsMax(std::size_t cluster) const { return m_boundsMax[cluster]; }
+
+    private:
+        // lights overlapping one depth slice, padded to a multiple of 4 with lights that reach nothing
+        struct Slice {
+            std::vector<float> x, y, z, radiusSquared;
+            std::vector<std::uint16_t> lights;
+            std::vector<std::uint16_t> indices;
+        };
+
+        void buildBounds(const glm::mat4& projection, float near, float far);
+        void assignSlice(unsigned slice, std::size_t lightCount);
+
+        unsigned m_tilesX, m_tilesY, m_slices;
+        ThreadPool& m_pool;
+
+        // the projection the bounds were built for
+        glm::mat4 m_projection;
+        float m_near, m_far;
+        glm::vec2 m_depthScale;
+        std::vector<float> m_sliceDepths;
+        std::vector<glm::vec3> m_boundsMin;
+        std::vector<glm::vec3> m_boundsMax;
+
+        std::vector<glm::vec4> m_lightData;
+        std::vector<Slice> m_sliceLights;
+        std::vector<glm::uvec2> m_grid;
+        std::vector<std::uint16_t> m_indices;
+    };
+}
@@ -0,0 +1,131 @@
+﻿#include "LodMesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+namespace gl
+{
+    LodChain LodChain::build(MeshData mesh, const LodChainOptions& options) {
+        LodChain chain;
+        chain.vertices = std::move(mesh.vertices);
+        chain.indices = std::move(mesh.indices);
+        chain.indices.resize(chain.indices.size() / 3 * 3);
+        chain.levels.push_back({ 0, chain.indices.size(), .0f });
+
+        if (!chain.vertices.empty()) {
+            glm::vec3 low = chain.vertices[0].position, high = low;
+            for (const auto& v : chain.vertices) {
+                low = glm::min(low, v.position);
+                high = glm::max(high, v.position);
+            }
+
+            chain.center = (low + high) * .5f;
+            for (const auto& v : chain.vertices)
+                chain.radius = std::max(chain.radius, glm::length(v.position - chain.center));
+        }
+
+        // every level is simplified from the previous one, so errors add up along the chain
+        std::vector<std::uint32_t> previous = chain.indices;
+        float error = .0f;
+
+        while (chain.levels.size() < options.maxLevels) {
+            std::size_t triangles = previous.size() / 3;
+            std::size_t target = static_cast<std::size_t>(triangles * options.reduction);
+            if (target < options.minTriangles)
+                break;
+
+            SimplifyResult result = MeshSimplifier::simplify(chain.vertices, previous, target, std::numeric_limits<float>::max(), options.simplify);
+
+            // locked borders and seams can stop the simplifier early, a barely smaller level is not worth keeping
+            if (result.indices.size() / 3 > triangles * 9 / 10)
+                break;
+
+            error += result.error;
+            chain.levels.push_back({ chain.indices.size(), result.indices.size(), error });
+            chain.indices.insert(chain.indices.end(), result.indices.begin(), result.indices.end());
+            previous = std::move(result.indices);
+        }
+
+        return chain;
+    }
+
+    LodMesh LodMesh::fromChain(const LodChain& chain, const MeshAttributes& attributes) {
+        LodMesh mesh;
+        mesh.m_levels = chain.levels;
+        mesh.m_center = chain.center;
+        mesh.m_radius = chain.radius;
+
+        mesh.m_vao.bind();
+
+        mesh.m_vertices
+            .bind()
+            .upload(chain.vertices.data(), chain.vertices.size() * sizeof(MeshVertex));
+
+        constexpr GLsizei stride = sizeof(MeshVertex);
+        mesh.m_vao
+            .setAttribute(attributes.position, 3, GL_FLOAT, stride, offsetof(MeshVertex, position))
+            .setAttribute(attributes.normal, 3, GL_FLOAT, stride, offsetof(MeshVertex, normal))
+            .setAttribute(attributes.texCoord, 2, GL_FLOAT, stride, offsetof(MeshVertex, texCoord));
+
+        mesh.m_indices
+            .bind()
+            .upload(chain.indices.data(), chain.indices.size() * sizeof(std::uint32_t));
+
+        glBindVertexArray(0);
+        return mesh;
+    }
+
+    void LodMesh::draw(std::size_t level) const {
+        const LodLevel& lod = m_levels[std::min(level, m_levels.size() - 1)];
+
+        m_vao.bind();
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(lod.indexCount), GL_UNSIGNED_INT, (void*) (lod.indexOffset * sizeof(std::uint32_t)));
+    }
+
+    LodSelector& LodSelector::setView(const PerspectiveCamera& camera, unsigned viewportHeight) {
+        m_cameraPosition = camera.getPosition();
+        m_pixelsPerUnit = viewportHeight / (2.f * std::tan(camera.getFov() * .5f));
+        m_near = camera.getNear();
+        return *this;
+    }
+
+    float LodSelector::projectedError(float error, const glm::vec3& center, float radius, const glm::mat4& model) const {
+        float scale = std::max({ glm::length(glm::vec3{ model[0] }), glm::length(glm::vec3{ model[1] }), glm::length(glm::vec3{ model[2] }) });
+        glm::vec3 worldCenter{ model * glm::vec4{ center, 1.f } };
+
+        // nearest point of the bounding sphere, the camera inside it counts as right at the near plane
+        float distance = std::max(glm::length(worldCenter - m_cameraPosition) - radius * scale, m_near);
+
+        return error * scale * m_pixelsPerUnit / distance;
+    }
+
+    std::size_t LodSelector::select(const std::vector<LodLevel>& levels, const glm::vec3& center, float radius, const glm::mat4& model, std::size_t current) const {
+        if (levels.empty())
+            return 0;
+
+        // the scale and distance are the same for every level, so measure pixels per model unit once
+        float pixelsPerError = projectedError(1.f, center, radius, model);
+
+        // coarsest level within the limit, and within the stricter limit required to coarsen
+        std::size_t fine = 0, coarse = 0;
+        for (std::size_t i = 0; i < levels.size(); i++) {
+            float pixels = levels[i].error * pixelsPerError;
+
+            if (pixels <= m_maxPixelError)
+                fine = i;
+            if (pixels <= m_maxPixelError * (1.f - m_hysteresis))
+                coarse = i;
+        }
+
+        current = std::min(current, levels.size() - 1);
+
+        if (current > fine)
+            return fine;
+        if (coarse > current)
+            return coarse;
+        return current;
+    }
+}
@@ -0,0 +1,122 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/matrix.hpp>
+#include <glm/vec3.hpp>
+
+#include "Mesh.h"
+#include "MeshSimplifier.h"
+#include "PerspectiveCamera.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+namespace gl
+{
+    struct LodChainOptions {
+        std::size_t maxLevels = 6;
+        float reduction = .5f;          // triangle count ratio between consecutive levels
+        std::size_t minTriangles = 32;
+        SimplifyOptions simplify;
+    };
+
+    struct LodLevel {
+        std::size_t indexOffset;        // in indices
+        std::size_t indexCount;
+        float error;                    // distance from the full detail surface, in model units
+    };
+
+    // CPU-side LOD chain: all levels index the same vertices, their index lists are stored
+    // back to back. Level 0 is the source mesh. Can be built at load time or kept offline.
+    struct LodChain {
+        std::vector<MeshVertex> vertices;
+        std::vector<std::uint32_t> indices;
+        std::vector<LodLevel> levels;
+
+        // bounding sphere, used to measure the distance to the camera
+        glm::vec3 center{ .0f };
+        float radius = .0f;
+
+        static LodChain build(MeshData mesh, const LodChainOptions& options = {});
+    };
+
+    // GPU copy of a LodChain: one vertex buffer and one index buffer for all the levels
+    class LodMesh {
+    public:
+        LodMesh(const LodMesh&) = delete;
+        LodMesh& operator=(const LodMesh&) = delete;
+
+        LodMesh(LodMesh&&) noexcept = default;
+        LodMesh& operator=(LodMesh&&) noexcept = default;
+
+        static LodMesh fromChain(const LodChain& chain, const MeshAttributes& attributes);
+
+        void draw(std::size_t level) const;
+
+        std::size_t levelCount() const { return m_levels.size(); }
+        const LodLevel& getLevel(std::size_t level) const { return m_levels[level]; }
+        const std::vector<LodLevel>& getLevels() const { return m_levels; }
+
+        const glm::vec3& getCenter() const { return m_center; }
+        float getRadius() const { return m_radius; }
+
+    private:
+        LodMesh(): m_vao(), m_vertices(VertexBuffer::Target::Array), m_indices(VertexBuffer::Target::ElementArray), m_levels(), m_center(.0f), m_radius(.0f) {}
+
+        VertexArray m_vao;
+        VertexBuffer m_vertices;
+        VertexBuffer m_indices;
+        std::vector<LodLevel> m_levels;
+
+        glm::vec3 m_center;
+        float m_radius;
+    };
+
+    // Picks a level per object from the projected (screen-space) size of its error.
+    // The state is just the level the object used last frame, which the caller keeps:
+    // switching to a coarser level needs the error to be `hysteresis` below the limit,
+    // so objects near the threshold distance do not flicker between two levels.
+    class LodSelector {
+    public:
+        LodSelector(float maxPixelError = 1.f, float hysteresis = .25f):
+            m_maxPixelError(maxPixelError),
+            m_hysteresis(hysteresis),
+            m_cameraPosition(.0f),
+            m_pixelsPerUnit(1.f),
+            m_near(.0f)
+        {}
+
+        // call once per frame (or when the camera or viewport changes)
+        LodSelector& setView(const PerspectiveCamera& camera, unsigned viewportHeight);
+
+        LodSelector& setMaxPixelError(float pixels) {
+            m_maxPixelError = pixels;
+            return *this;
+        }
+
+        LodSelector& setHysteresis(float hysteresis) {
+            m_hysteresis = hysteresis;
+            return *this;
+        }
+
+        // size in pixels of `error` model units on a mesh drawn with the given model matrix
+        float projectedError(float error, const glm::vec3& center, float radius, const glm::mat4& model) const;
+
+        std::size_t select(const LodMesh& mesh, const glm::mat4& model, std::size_t current) const {
+            return select(mesh.getLevels(), mesh.getCenter(), mesh.getRadius(), model, current);
+        }
+
+        std::size_t select(const std::vector<LodLevel>& levels, const glm::vec3& center, float radius, const glm::mat4& model, std::size_t current) const;
+
+    private:
+        float m_maxPixelError;
+        float m_hysteresis;
+
+        glm::vec3 m_cameraPosition;
+        float m_pixelsPerUnit;          // at distance 1
+        float m_near;
+    };
+}
@@ -0,0 +1,121 @@
+﻿#include "MappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gl
+{
+#ifdef _WIN32
+    MappedFile::MappedFile(const std::filesystem::path& path): m_data(nullptr), m_size(0), m_file(invalidHandle), m_mapping(invalidHandle) {
+        HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            throw file_map_exception{ path.string() + ": file could not be opened" };
+
+        m_file = file;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            close();
+            throw file_map_exception{ path.string() + ": file size could not be read" };
+        }
+
+        m_size = static_cast<std::size_t>(size.QuadPart);
+
+        // empty files cannot be mapped, an empty view is fine though
+        if (m_size == 0)
+            return;
+
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!m_mapping) {
+            close();
+            throw file_map_exception{ path.string() + ": file mapping could not be created" };
+        }
+
+        m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!m_data) {
+            close();
+            throw file_map_exception{ path.string() + ": file could not be mapped" };
+        }
+    }
+
+    void MappedFile::close() {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping != invalidHandle)
+            CloseHandle(m_mapping);
+        if (m_file != invalidHandle)
+            CloseHandle(m_file);
+
+        m_data = nullptr;
+        m_size = 0;
+        m_file = m_mapping = invalidHandle;
+    }
+#else
+    MappedFile::MappedFile(const std::filesystem::path& path): m_data(nullptr), m_size(0), m_file(invalidHandle), m_mapping(invalidHandle) {
+        m_file = ::open(path.c_str(), O_RDONLY);
+        if (m_file == invalidHandle)
+            throw file_map_exception{ path.string() + ": file could not be opened" };
+
+        struct stat info;
+        if (fstat(m_file, &info) != 0) {
+            close();
+            throw file_map_exception{ path.string() + ": file size could not be read" };
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size == 0)
+            return;
+
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_file, 0);
+        if (data == MAP_FAILED) {
+            close();
+            throw file_map_exception{ path.string() + ": file could not be mapped" };
+        }
+
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const unsigned char*>(data);
+    }
+
+    void MappedFile::close() {
+        if (m_data)
+            munmap(const_cast<unsigned char*>(m_data), m_size);
+        if (m_file != invalidHandle)
+            ::close(m_file);
+
+        m_data = nullptr;
+        m_size = 0;
+        m_file = m_mapping = invalidHandle;
+    }
+#endif
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept: m_data(nullptr), m_size(0), m_file(invalidHandle), m_mapping(invalidHandle) {
+        std::swap(m_data, other.m_data);
+        std::swap(m_size, other.m_size);
+        std::swap(m_file, other.m_file);
+        std::swap(m_mapping, other.m_mapping);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+            std::swap(m_file, other.m_file);
+            std::swap(m_mapping, other.m_mapping);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+}
@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    class file_map_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        file_map_exception(): message(), super() {}
+        file_map_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Read-only memory mapping of a whole file. The OS pages data in on demand, so nothing
+    // is copied until it is touched and the mapping can be handed to GL uploads directly.
+    class MappedFile {
+    public:
+        MappedFile(): m_data(nullptr), m_size(0), m_file(invalidHandle), m_mapping(invalidHandle) {}
+        explicit MappedFile(const std::filesystem::path& path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        const unsigned char* data() const { return m_data; }
+        std::size_t size() const { return m_size; }
+        std::string_view view() const { return { reinterpret_cast<const char*>(m_data), m_size }; }
+
+        ~MappedFile();
+
+    private:
+        void close();
+
+#ifdef _WIN32
+        using Handle = void*;
+        static constexpr Handle invalidHandle = nullptr;
+#else
+        using Handle = int;
+        static constexpr Handle invalidHandle = -1;
+#endif
+
+        const unsigned char* m_data;
+        std::size_t m_size;
+        Handle m_file;
+        Handle m_mapping;
+    };
+}
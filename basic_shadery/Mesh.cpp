@@ -0,0 +1,65 @@
+﻿#include "Mesh.h"
+
+namespace gl
+{
+    Mesh Mesh::fromData(const MeshData& data, const MeshAttributes& attributes) {
+        return fromBuffers(uploadBuffers(data), attributes);
+    }
+
+    MeshBuffers Mesh::uploadBuffers(const MeshData& data) {
+        MeshBuffers buffers;
+        buffers.indexCount = static_cast<GLsizei>(data.indices.size());
+
+        buffers.vertices
+            .bind()
+            .upload(data.vertices.data(), data.vertices.size() * sizeof(MeshVertex));
+        buffers.indices
+            .bind()
+            .upload(data.indices.data(), data.indices.size() * sizeof(std::uint32_t));
+
+        return buffers;
+    }
+
+    Mesh Mesh::fromBuffers(MeshBuffers buffers, const MeshAttributes& attributes) {
+        Mesh mesh;
+
+        Primitive primitive{ VertexArray{}, buffers.indexCount, GL_UNSIGNED_INT, 0 };
+        primitive.vao.bind();
+
+        buffers.vertices.bind();
+
+        constexpr GLsizei stride = sizeof(MeshVertex);
+        primitive.vao
+            .setAttribute(attributes.position, 3, GL_FLOAT, stride, offsetof(MeshVertex, position))
+            .setAttribute(attributes.normal, 3, GL_FLOAT, stride, offsetof(MeshVertex, normal))
+            .setAttribute(attributes.texCoord, 2, GL_FLOAT, stride, offsetof(MeshVertex, texCoord));
+
+        // element array binding is part of the VAO state
+        buffers.indices.bindAs(VertexBuffer::Target::ElementArray);
+
+        glBindVertexArray(0);
+
+        mesh.m_buffers.push_back(std::move(buffers.vertices));
+        mesh.m_buffers.push_back(std::move(buffers.indices));
+        mesh.m_primitives.push_back(std::move(primitive));
+        return mesh;
+    }
+
+    void Mesh::draw() const {
+        for (const auto& primitive : m_primitives) {
+            primitive.vao.bind();
+
+            if (primitive.indexType == GL_NONE)
+                glDrawArrays(GL_TRIANGLES, 0, primitive.count);
+            else
+                glDrawElements(GL_TRIANGLES, primitive.count, primitive.indexType, (void*) primitive.indexOffset);
+        }
+    }
+
+    std::size_t Mesh::gpuBytes() const {
+        std::size_t bytes = 0;
+        for (const auto& buffer : m_buffers)
+            bytes += buffer.getSize();
+        return bytes;
+    }
+}
@@ -0,0 +1,91 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+
+#include "Program.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+namespace gl
+{
+    // interleaved vertex layout produced by the mesh importers
+    struct MeshVertex {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 texCoord;
+    };
+
+    // CPU-side indexed triangle list
+    struct MeshData {
+        std::vector<MeshVertex> vertices;
+        std::vector<std::uint32_t> indices;
+
+        std::size_t triangleCount() const { return indices.size() / 3; }
+    };
+
+    // attribute locations the mesh vertex streams are bound to, -1 skips a stream
+    struct MeshAttributes {
+        GLint position = -1;
+        GLint normal = -1;
+        GLint texCoord = -1;
+
+        static MeshAttributes fromProgram(Program& prog) {
+            return { prog.getAttributeLocation("position"), prog.getAttributeLocation("normal"), prog.getAttributeLocation("texCoord") };
+        }
+    };
+
+    // vertex and index buffer of an indexed triangle list, before a vertex array ties them together
+    struct MeshBuffers {
+        VertexBuffer vertices{ VertexBuffer::Target::Array };
+        // uploaded through the array target, which unlike the element array one is not part of
+        // whatever vertex array is bound at the time
+        VertexBuffer indices{ VertexBuffer::Target::Array };
+        GLsizei indexCount = 0;
+
+        std::size_t gpuBytes() const { return vertices.getSize() + indices.getSize(); }
+    };
+
+    // GPU-side mesh: one or more indexed primitives sharing a set of buffers
+    class Mesh {
+    public:
+        Mesh(): m_buffers(), m_primitives() {}
+
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+
+        Mesh(Mesh&&) noexcept = default;
+        Mesh& operator=(Mesh&&) noexcept = default;
+
+        static Mesh fromData(const MeshData& data, const MeshAttributes& attributes);
+
+        // the two halves of fromData: buffers are shared between contexts and can be uploaded
+        // on a GL worker thread, vertex arrays are not and have to be made where the mesh is drawn
+        static MeshBuffers uploadBuffers(const MeshData& data);
+        static Mesh fromBuffers(MeshBuffers buffers, const MeshAttributes& attributes);
+
+        void draw() const;
+
+        std::size_t primitiveCount() const { return m_primitives.size(); }
+        // total size of the vertex and index buffers
+        std::size_t gpuBytes() const;
+
+    private:
+        struct Primitive {
+            VertexArray vao;
+            GLsizei count;
+            GLenum indexType;    // GL_NONE draws the vertices in order
+            std::size_t indexOffset;
+        };
+
+        std::vector<VertexBuffer> m_buffers;
+        std::vector<Primitive> m_primitives;
+
+        friend class MeshLoader;
+    };
+}
@@ -0,0 +1,776 @@
+﻿#include "MeshLoader.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <glm/glm.hpp>
+
+#include "Json.h"
+#include "MappedFile.h"
+
+namespace gl
+{
+    namespace
+    {
+        // ---- OBJ ----
+
+        struct ObjCorner {
+            std::int32_t index[3];   // position, texcoord, normal; -1 when missing
+            std::uint8_t relative;   // bit i set: index[i] is relative to the chunk start (negative OBJ index)
+        };
+
+        struct ObjChunk {
+            const char* begin;
+            const char* end;
+
+            std::vector<glm::vec3> positions;
+            std::vector<glm::vec2> texCoords;
+            std::vector<glm::vec3> normals;
+            std::vector<ObjCorner> corners;   // three per triangle
+
+            // filled while resolving the corners when they are deduplicated: the hash of each
+            // corner and the corners owned by each dedup partition
+            std::vector<std::uint64_t> cornerHashes;
+            std::vector<std::vector<std::uint32_t>> partitionCorners;
+
+            std::size_t positionOffset, texCoordOffset, normalOffset, cornerOffset;
+        };
+
+        inline bool isBlank(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        inline const char* skipBlank(const char* p, const char* end) {
+            while (p < end && isBlank(*p))
+                p++;
+            return p;
+        }
+
+        inline const char* parseFloat(const char* p, const char* end, float& value) {
+            p = skipBlank(p, end);
+            if (p < end && *p == '+')
+                p++;
+
+            auto result = std::from_chars(p, end, value);
+            return result.ec == std::errc{} ? result.ptr : nullptr;
+        }
+
+        // parses "v", "v/t", "v//n" or "v/t/n", storing indices relative to the chunk counts
+        const char* parseCorner(const char* p, const char* end, const ObjChunk& chunk, ObjCorner& corner) {
+            const std::size_t counts[3] = { chunk.positions.size(), chunk.texCoords.size(), chunk.normals.size() };
+
+            corner = { { -1, -1, -1 }, 0 };
+
+            for (int i = 0; i < 3; i++) {
+                if (i > 0) {
+                    if (p >= end || *p != '/')
+                        break;
+                    p++;
+
+                    // empty texcoord slot in "v//n"
+                    if (p < end && *p == '/')
+                        continue;
+                }
+
+                std::int32_t value;
+                auto result = std::from_chars(p, end, value);
+                if (result.ec != std::errc{} || value == 0)
+                    return nullptr;
+
+                p = result.ptr;
+
+                if (value > 0) {
+                    corner.index[i] = value - 1;
+                } else {
+                    corner.index[i] = static_cast<std::int32_t>(counts[i]) + value;
+                    corner.relative |= 1 << i;
+                }
+            }
+
+            return p;
+        }
+
+        void parseObjChunk(ObjChunk& chunk) {
+            std::vector<ObjCorner> polygon;
+            const char* p = chunk.begin;
+
+            while (p < chunk.end) {
+                const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', chunk.end - p));
+                if (!lineEnd)
+                    lineEnd = chunk.end;
+
+                p = skipBlank(p, lineEnd);
+
+                if (lineEnd - p >= 2 && p[0] == 'v' && isBlank(p[1])) {
+                    glm::vec3 v;
+                    const char* q = parseFloat(p + 2, lineEnd, v.x);
+                    if (q) q = parseFloat(q, lineEnd, v.y);
+                    if (q) q = parseFloat(q, lineEnd, v.z);
+                    if (!q)
+                        throw mesh_load_exception{ "OBJ: malformed vertex position" };
+                    chunk.positions.push_back(v);
+                } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isBlank(p[2])) {
+                    glm::vec2 t{ .0f, .0f };
+                    const char* q = parseFloat(p + 3, lineEnd, t.x);
+                    if (q) q = parseFloat(q, lineEnd, t.y);
+                    if (!q)
+                        throw mesh_load_exception{ "OBJ: malformed texture coordinate" };
+                    chunk.texCoords.push_back(t);
+                } else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && isBlank(p[2])) {
+                    glm::vec3 n;
+                    const char* q = parseFloat(p + 3, lineEnd, n.x);
+                    if (q) q = parseFloat(q, lineEnd, n.y);
+                    if (q) q = parseFloat(q, lineEnd, n.z);
+                    if (!q)
+                        throw mesh_load_exception{ "OBJ: malformed vertex normal" };
+                    chunk.normals.push_back(n);
+                } else if (lineEnd - p >= 2 && p[0] == 'f' && isBlank(p[1])) {
+                    polygon.clear();
+
+                    const char* q = skipBlank(p + 2, lineEnd);
+                    while (q < lineEnd) {
+                        ObjCorner corner;
+                        q = parseCorner(q, lineEnd, chunk, corner);
+                        if (!q)
+                            throw mesh_load_exception{ "OBJ: malformed face" };
+
+                        polygon.push_back(corner);
+                        q = skipBlank(q, lineEnd);
+                    }
+
+                    // fan triangulation of convex polygons
+                    for (std::size_t i = 2; i < polygon.size(); i++) {
+                        chunk.corners.push_back(polygon[0]);
+                        chunk.corners.push_back(polygon[i - 1]);
+                        chunk.corners.push_back(polygon[i]);
+                    }
+                }
+                // everything else (groups, materials, smoothing, comments) is ignored
+
+                p = lineEnd + 1;
+            }
+        }
+
+        inline std::uint64_t hashCorner(const ObjCorner& corner) {
+            std::uint64_t h = static_cast<std::uint32_t>(corner.index[0]) * 0x9E3779B97F4A7C15ull;
+            h ^= (static_cast<std::uint32_t>(corner.index[1]) + 0x632BE59BD9B4E019ull) * 0xC2B2AE3D27D4EB4Full;
+            h ^= (static_cast<std::uint32_t>(corner.index[2]) + 0x165667B19E3779F9ull) * 0x94D049BB133111EBull;
+            return h ^ (h >> 29);
+        }
+
+        inline bool sameCorner(const ObjCorner& a, const ObjCorner& b) {
+            return a.index[0] == b.index[0] && a.index[1] == b.index[1] && a.index[2] == b.index[2];
+        }
+
+        // open-addressing (linear probing) map from corner to vertex number, key and value
+        // share a slot so a lookup usually touches a single cache line
+        class CornerTable {
+        public:
+            explicit CornerTable(std::size_t expected): m_slots(), m_mask(0), m_count(0) {
+                std::size_t capacity = 64;
+                while (capacity < expected * 2)
+                    capacity *= 2;
+
+                m_slots.assign(capacity, Slot{ {}, empty });
+                m_mask = capacity - 1;
+            }
+
+            // returns the vertex number of the corner, inserting it as `next` if missing
+            std::uint32_t insert(const ObjCorner& corner, std::uint64_t hash, std::uint32_t next, bool& inserted) {
+                if (m_count * 2 >= m_slots.size())
+                    grow();
+
+                for (std::size_t i = static_cast<std::size_t>(hash >> 8) & m_mask;; i = (i + 1) & m_mask) {
+                    Slot& slot = m_slots[i];
+
+                    if (slot.vertex == empty) {
+                        slot = { corner, next };
+                        m_count++;
+                        inserted = true;
+                        return next;
+                    }
+
+                    if (sameCorner(slot.corner, corner)) {
+                        inserted = false;
+                        return slot.vertex;
+                    }
+                }
+            }
+
+        private:
+            static constexpr std::uint32_t empty = 0xFFFFFFFFu;
+
+            struct Slot {
+                ObjCorner corner;
+                std::uint32_t vertex;
+            };
+
+            void grow() {
+                std::vector<Slot> slots = std::move(m_slots);
+
+                m_slots.assign(slots.size() * 2, Slot{ {}, empty });
+                m_mask = m_slots.size() - 1;
+                m_count = 0;
+
+                bool inserted;
+                for (const auto& slot : slots)
+                    if (slot.vertex != empty)
+                        insert(slot.corner, hashCorner(slot.corner), slot.vertex, inserted);
+            }
+
+            std::vector<Slot> m_slots;
+            std::size_t m_mask;
+            std::size_t m_count;
+        };
+
+        void generateNormals(MeshData& mesh) {
+            for (auto& v : mesh.vertices)
+                v.normal = glm::vec3{ .0f };
+
+            // area weighted: the cross product length is twice the triangle area
+            for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                MeshVertex& a = mesh.vertices[mesh.indices[i]];
+                MeshVertex& b = mesh.vertices[mesh.indices[i + 1]];
+                MeshVertex& c = mesh.vertices[mesh.indices[i + 2]];
+
+                glm::vec3 n = glm::cross(b.position - a.position, c.position - a.position);
+                a.normal += n;
+                b.normal += n;
+                c.normal += n;
+            }
+
+            for (auto& v : mesh.vertices) {
+                float length = glm::length(v.normal);
+                v.normal = length > .0f ? v.normal / length : glm::vec3{ .0f, 1.f, .0f };
+            }
+        }
+
+        // ---- glTF ----
+
+        enum GltfComponent {
+            Byte = 5120,
+            UnsignedByte = 5121,
+            Short = 5122,
+            UnsignedShort = 5123,
+            UnsignedInt = 5125,
+            Float = 5126
+        };
+
+        struct GltfAsset {
+            MappedFile file;
+            JsonValue document;
+            std::vector<std::string_view> buffers;
+            std::vector<MappedFile> externalBuffers;
+            std::vector<std::string> decodedBuffers;
+        };
+
+        struct AccessorView {
+            const unsigned char* data;   // first element
+            std::size_t count;
+            std::size_t stride;
+            int componentType;
+            int components;
+            bool normalized;
+
+            std::size_t bufferIndex;
+            std::size_t bufferOffset;    // offset of the first element in its buffer
+            GLsizei byteStride;          // 0 when tightly packed
+        };
+
+        std::size_t componentSize(int componentType) {
+            switch (componentType) {
+            case Byte: case UnsignedByte: return 1;
+            case Short: case UnsignedShort: return 2;
+            case UnsignedInt: case Float: return 4;
+            default: throw mesh_load_exception{ "glTF: unsupported accessor component type" };
+            }
+        }
+
+        int componentCount(const std::string& type) {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2") return 2;
+            if (type == "VEC3") return 3;
+            if (type == "VEC4") return 4;
+            throw mesh_load_exception{ "glTF: unsupported accessor type " + type };
+        }
+
+        std::string decodeBase64(std::string_view in) {
+            auto value = [](char c) -> int {
+                if (c >= 'A' && c <= 'Z') return c - 'A';
+                if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+                if (c >= '0' && c <= '9') return c - '0' + 52;
+                if (c == '+') return 62;
+                if (c == '/') return 63;
+                return -1;
+            };
+
+            std::string out;
+            out.reserve(in.size() / 4 * 3);
+
+            unsigned bits = 0;
+            int bitCount = 0;
+            for (char c : in) {
+                int v = value(c);
+                if (v < 0)
+                    continue;
+
+                bits = (bits << 6) | static_cast<unsigned>(v);
+                bitCount += 6;
+                if (bitCount >= 8) {
+                    bitCount -= 8;
+                    out += static_cast<char>((bits >> bitCount) & 0xFF);
+                }
+            }
+
+            return out;
+        }
+
+        void openGltf(const std::filesystem::path& path, GltfAsset& asset) {
+            asset.file = MappedFile{ path };
+            std::string_view bytes = asset.file.view();
+            std::string_view json = bytes;
+            std::string_view binaryChunk;
+
+            // binary container: 12 byte header, then a JSON chunk and an optional BIN chunk
+            if (bytes.size() >= 12 && bytes.substr(0, 4) == "glTF") {
+                auto readU32 = [&bytes](std::size_t at) {
+                    std::uint32_t v;
+                    std::memcpy(&v, bytes.data() + at, 4);
+                    return v;
+                };
+
+                std::size_t pos = 12;
+                json = {};
+                while (pos + 8 <= bytes.size()) {
+                    std::uint32_t length = readU32(pos);
+                    std::uint32_t type = readU32(pos + 4);
+                    if (pos + 8 + length > bytes.size())
+                        throw mesh_load_exception{ path.string() + ": truncated GLB chunk" };
+
+                    std::string_view data = bytes.substr(pos + 8, length);
+                    if (type == 0x4E4F534Au)        // "JSON"
+                        json = data;
+                    else if (type == 0x004E4942u)   // "BIN\0"
+                        binaryChunk = data;
+
+                    pos += 8 + ((length + 3) & ~3u);
+                }
+            }
+
+            try {
+                asset.document = JsonValue::parse(json);
+            } catch (json_exception& e) {
+                throw mesh_load_exception{ path.string() + ": " + e.what() };
+            }
+
+            const JsonValue& buffers = asset.document["buffers"];
+            asset.decodedBuffers.reserve(buffers.size());
+            asset.externalBuffers.reserve(buffers.size());
+
+            for (std::size_t i = 0; i < buffers.size(); i++) {
+                const JsonValue& buffer = buffers[i];
+                std::size_t length = buffer["byteLength"].asIndex();
+                std::string_view data;
+
+                if (!buffer.contains("uri")) {
+                    data = binaryChunk;
+                } else {
+                    const std::string& uri = buffer["uri"].asString();
+
+                    if (uri.compare(0, 5, "data:") == 0) {
+                        std::size_t comma = uri.find(',');
+                        if (comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos)
+                            throw mesh_load_exception{ path.string() + ": only base64 data URIs are supported" };
+
+                        asset.decodedBuffers.push_back(decodeBase64(std::string_view{ uri }.substr(comma + 1)));
+                        data = asset.decodedBuffers.back();
+                    } else {
+                        asset.externalBuffers.emplace_back(path.parent_path() / std::filesystem::u8path(uri));
+                        data = asset.externalBuffers.back().view();
+                    }
+                }
+
+                if (data.size() < length)
+                    throw mesh_load_exception{ path.string() + ": buffer " + std::to_string(i) + " is shorter than its byteLength" };
+
+                asset.buffers.push_back(data.substr(0, length));
+            }
+        }
+
+        AccessorView accessorView(const GltfAsset& asset, std::size_t index) {
+            const JsonValue& accessor = asset.document["accessors"][index];
+            if (accessor.isNull())
+                throw mesh_load_exception{ "glTF: accessor " + std::to_string(index) + " does not exist" };
+
+            if (!accessor.contains("bufferView"))
+                throw mesh_load_exception{ "glTF: sparse or empty accessors are not supported" };
+
+            const JsonValue& view = asset.document["bufferViews"][accessor["bufferView"].asIndex()];
+
+            AccessorView result;
+            result.componentType = static_cast<int>(accessor["componentType"].asNumber());
+            result.components = componentCount(accessor["type"].asString());
+            result.normalized = accessor["normalized"].asBool();
+            result.count = accessor["count"].asIndex();
+            result.bufferIndex = view["buffer"].asIndex();
+            result.bufferOffset = view["byteOffset"].asIndex() + accessor["byteOffset"].asIndex();
+            result.byteStride = static_cast<GLsizei>(view["byteStride"].asIndex());
+
+            std::size_t elementSize = componentSize(result.componentType) * result.components;
+            result.stride = result.byteStride ? static_cast<std::size_t>(result.byteStride) : elementSize;
+
+            if (result.bufferIndex >= asset.buffers.size())
+                throw mesh_load_exception{ "glTF: buffer view points at a missing buffer" };
+
+            std::string_view buffer = asset.buffers[result.bufferIndex];
+            if (result.count > 0 && result.bufferOffset + (result.count - 1) * result.stride + elementSize > buffer.size())
+                throw mesh_load_exception{ "glTF: accessor " + std::to_string(index) + " reaches past the end of its buffer" };
+
+            result.data = reinterpret_cast<const unsigned char*>(buffer.data()) + result.bufferOffset;
+            return result;
+        }
+
+        float readComponent(const AccessorView& view, std::size_t element, int component) {
+            const unsigned char* p = view.data + element * view.stride + component * componentSize(view.componentType);
+
+            switch (view.componentType) {
+            case Float: { float v; std::memcpy(&v, p, 4); return v; }
+            case UnsignedByte: return view.normalized ? *p / 255.f : *p;
+            case UnsignedShort: { std::uint16_t v; std::memcpy(&v, p, 2); return view.normalized ? v / 65535.f : v; }
+            case Byte: { auto v = static_cast<std::int8_t>(*p); return view.normalized ? std::max(v / 127.f, -1.f) : v; }
+            case Short: { std::int16_t v; std::memcpy(&v, p, 2); return view.normalized ? std::max(v / 32767.f, -1.f) : v; }
+            default: throw mesh_load_exception{ "glTF: unsupported vertex attribute component type" };
+            }
+        }
+
+        std::uint32_t readIndex(const AccessorView& view, std::size_t element) {
+            const unsigned char* p = view.data + element * view.stride;
+
+            switch (view.componentType) {
+            case UnsignedByte: return *p;
+            case UnsignedShort: { std::uint16_t v; std::memcpy(&v, p, 2); return v; }
+            case UnsignedInt: { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+            default: throw mesh_load_exception{ "glTF: unsupported index component type" };
+            }
+        }
+
+        template<typename Fn>
+        void forEachTrianglePrimitive(const GltfAsset& asset, Fn&& fn) {
+            const JsonValue& meshes = asset.document["meshes"];
+            for (std::size_t m = 0; m < meshes.size(); m++) {
+                const JsonValue& primitives = meshes[m]["primitives"];
+                for (std::size_t p = 0; p < primitives.size(); p++) {
+                    const JsonValue& primitive = primitives[p];
+
+                    // 4 = TRIANGLES, also the default
+                    if (primitive["mode"].asIndex(4) != 4)
+                        continue;
+
+                    if (!primitive["attributes"].contains("POSITION"))
+                        continue;
+
+                    fn(primitive);
+                }
+            }
+        }
+    }
+
+    MeshData MeshLoader::load(const std::filesystem::path& path, ThreadPool& pool) {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+
+        if (extension == ".obj")
+            return loadObj(path, pool);
+
+        if (extension == ".gltf" || extension == ".glb")
+            return loadGltf(path);
+
+        throw mesh_load_exception{ path.string() + ": unsupported mesh format" };
+    }
+
+    MeshData MeshLoader::loadObj(const std::filesystem::path& path, ThreadPool& pool) {
+        MappedFile file{ path };
+        const char* begin = reinterpret_cast<const char*>(file.data());
+        const char* end = begin + file.size();
+
+        // split at line boundaries into a few chunks per thread
+        constexpr std::size_t minChunkSize = 1 << 16;
+        std::size_t chunkCount = std::max<std::size_t>(std::min((pool.size() + 1) * 4, file.size() / minChunkSize), 1);
+
+        std::vector<ObjChunk> chunks(chunkCount);
+        const char* chunkBegin = begin;
+        for (std::size_t i = 0; i < chunkCount; i++) {
+            const char* chunkEnd = (i + 1 == chunkCount) ? end : begin + file.size() * (i + 1) / chunkCount;
+            if (chunkEnd < chunkBegin)
+                chunkEnd = chunkBegin;
+
+            const char* newline = static_cast<const char*>(std::memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = (i + 1 == chunkCount || !newline) ? end : newline + 1;
+
+            chunks[i].begin = chunkBegin;
+            chunks[i].end = chunkEnd;
+            chunkBegin = chunkEnd;
+        }
+
+        pool.parallelFor(chunkCount, [&chunks](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++)
+                parseObjChunk(chunks[i]);
+        });
+
+        // global numbering of everything declared before each chunk
+        std::size_t positionCount = 0, texCoordCount = 0, normalCount = 0, cornerCount = 0;
+        for (auto& chunk : chunks) {
+            chunk.positionOffset = positionCount;
+            chunk.texCoordOffset = texCoordCount;
+            chunk.normalOffset = normalCount;
+            chunk.cornerOffset = cornerCount;
+
+            positionCount += chunk.positions.size();
+            texCoordCount += chunk.texCoords.size();
+            normalCount += chunk.normals.size();
+            cornerCount += chunk.corners.size();
+        }
+
+        if (cornerCount > 0xFFFFFFFFu)
+            throw mesh_load_exception{ path.string() + ": too many faces for 32-bit indices" };
+
+        std::vector<glm::vec3> positions(positionCount), normals(normalCount);
+        std::vector<glm::vec2> texCoords(texCoordCount);
+        const std::size_t counts[3] = { positionCount, texCoordCount, normalCount };
+
+        // corners of positions only are already unique per position, the others are deduplicated
+        // below: partition p owns the corners whose hash % partitions == p
+        const bool isDeduplicated = texCoordCount > 0 || normalCount > 0;
+        const std::size_t partitions = pool.size() + 1;
+
+        pool.parallelFor(chunkCount, [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++) {
+                ObjChunk& chunk = chunks[i];
+                std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + chunk.positionOffset);
+                std::copy(chunk.texCoords.begin(), chunk.texCoords.end(), texCoords.begin() + chunk.texCoordOffset);
+                std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + chunk.normalOffset);
+
+                // resolve relative indices and validate
+                const std::size_t offsets[3] = { chunk.positionOffset, chunk.texCoordOffset, chunk.normalOffset };
+                for (auto& corner : chunk.corners) {
+                    for (int a = 0; a < 3; a++) {
+                        std::int64_t index = corner.index[a];
+                        if (corner.relative & (1 << a))
+                            index += offsets[a];
+
+                        if ((a == 0 || index != -1 || (corner.relative & (1 << a))) && (index < 0 || static_cast<std::size_t>(index) >= counts[a]))
+                            throw mesh_load_exception{ path.string() + ": face index out of range" };
+
+                        corner.index[a] = static_cast<std::int32_t>(index);
+                    }
+                    corner.relative = 0;
+                }
+
+                // hashed once here, so that each partition walks only the corners it owns
+                if (isDeduplicated) {
+                    chunk.cornerHashes.resize(chunk.corners.size());
+                    chunk.partitionCorners.resize(partitions);
+                    for (auto& owned : chunk.partitionCorners)
+                        owned.reserve(chunk.corners.size() / partitions + 16);
+
+                    for (std::size_t c = 0; c < chunk.corners.size(); c++) {
+                        std::uint64_t hash = hashCorner(chunk.corners[c]);
+                        chunk.cornerHashes[c] = hash;
+                        chunk.partitionCorners[hash % partitions].push_back(static_cast<std::uint32_t>(c));
+                    }
+                }
+
+                chunk.positions = {};
+                chunk.texCoords = {};
+                chunk.normals = {};
+            }
+        });
+
+        MeshData mesh;
+
+        // positions only (typical for scans)
+        if (!isDeduplicated) {
+            mesh.vertices.resize(positionCount);
+            mesh.indices.resize(cornerCount);
+
+            pool.parallelFor(chunkCount, [&](std::size_t first, std::size_t last) {
+                for (std::size_t c = first; c < last; c++) {
+                    const ObjChunk& chunk = chunks[c];
+                    std::uint32_t* out = mesh.indices.data() + chunk.cornerOffset;
+
+                    for (const auto& corner : chunk.corners)
+                        *out++ = static_cast<std::uint32_t>(corner.index[0]);
+                }
+            });
+
+            pool.parallelFor(positionCount, [&](std::size_t first, std::size_t last) {
+                for (std::size_t i = first; i < last; i++)
+                    mesh.vertices[i] = { positions[i], glm::vec3{ .0f }, glm::vec2{ .0f } };
+            });
+
+            generateNormals(mesh);
+            return mesh;
+        }
+
+        std::vector<std::uint32_t> cornerVertex(cornerCount);
+        std::vector<std::vector<ObjCorner>> uniqueCorners(partitions);
+
+        pool.parallelFor(partitions, [&](std::size_t first, std::size_t last) {
+            for (std::size_t p = first; p < last; p++) {
+                CornerTable table{ positionCount / partitions + 16 };
+                auto& unique = uniqueCorners[p];
+
+                for (const auto& chunk : chunks) {
+                    for (std::uint32_t i : chunk.partitionCorners[p]) {
+                        const ObjCorner& corner = chunk.corners[i];
+
+                        bool inserted;
+                        cornerVertex[chunk.cornerOffset + i] = table.insert(corner, chunk.cornerHashes[i], static_cast<std::uint32_t>(unique.size()), inserted);
+                        if (inserted)
+                            unique.push_back(corner);
+                    }
+                }
+            }
+        });
+
+        std::vector<std::uint32_t> vertexOffset(partitions + 1, 0);
+        for (std::size_t p = 0; p < partitions; p++)
+            vertexOffset[p + 1] = vertexOffset[p] + static_cast<std::uint32_t>(uniqueCorners[p].size());
+
+        mesh.vertices.resize(vertexOffset[partitions]);
+        mesh.indices.resize(cornerCount);
+
+        pool.parallelFor(partitions, [&](std::size_t first, std::size_t last) {
+            for (std::size_t p = first; p < last; p++) {
+                MeshVertex* out = mesh.vertices.data() + vertexOffset[p];
+                for (const auto& corner : uniqueCorners[p]) {
+                    out->position = positions[corner.index[0]];
+                    out->texCoord = corner.index[1] >= 0 ? texCoords[corner.index[1]] : glm::vec2{ .0f, .0f };
+                    out->normal = corner.index[2] >= 0 ? normals[corner.index[2]] : glm::vec3{ .0f, .0f, .0f };
+                    out++;
+                }
+            }
+        });
+
+        pool.parallelFor(chunkCount, [&](std::size_t first, std::size_t last) {
+            for (std::size_t c = first; c < last; c++) {
+                const ObjChunk& chunk = chunks[c];
+                for (std::size_t i = 0; i < chunk.corners.size(); i++) {
+                    std::size_t p = chunk.cornerHashes[i] % partitions;
+                    mesh.indices[chunk.cornerOffset + i] = vertexOffset[p] + cornerVertex[chunk.cornerOffset + i];
+                }
+            }
+        });
+
+        if (normalCount == 0)
+            generateNormals(mesh);
+
+        return mesh;
+    }
+
+    MeshData MeshLoader::loadGltf(const std::filesystem::path& path) {
+        GltfAsset asset;
+        openGltf(path, asset);
+
+        MeshData mesh;
+
+        forEachTrianglePrimitive(asset, [&](const JsonValue& primitive) {
+            const JsonValue& attributes = primitive["attributes"];
+            AccessorView positions = accessorView(asset, attributes["POSITION"].asIndex());
+
+            std::size_t base = mesh.vertices.size();
+            mesh.vertices.resize(base + positions.count);
+
+            for (std::size_t i = 0; i < positions.count; i++)
+                for (int c = 0; c < 3; c++)
+                    mesh.vertices[base + i].position[c] = readComponent(positions, i, c);
+
+            if (attributes.contains("NORMAL")) {
+                AccessorView normals = accessorView(asset, attributes["NORMAL"].asIndex());
+                for (std::size_t i = 0; i < std::min(normals.count, positions.count); i++)
+                    for (int c = 0; c < 3; c++)
+                        mesh.vertices[base + i].normal[c] = readComponent(normals, i, c);
+            }
+
+            if (attributes.contains("TEXCOORD_0")) {
+                AccessorView texCoords = accessorView(asset, attributes["TEXCOORD_0"].asIndex());
+                for (std::size_t i = 0; i < std::min(texCoords.count, positions.count); i++)
+                    for (int c = 0; c < 2; c++)
+                        mesh.vertices[base + i].texCoord[c] = readComponent(texCoords, i, c);
+            }
+
+            if (primitive.contains("indices")) {
+                AccessorView indices = accessorView(asset, primitive["indices"].asIndex());
+                mesh.indices.reserve(mesh.indices.size() + indices.count);
+
+                for (std::size_t i = 0; i < indices.count; i++) {
+                    std::uint32_t index = readIndex(indices, i);
+                    if (index >= positions.count)
+                        throw mesh_load_exception{ path.string() + ": vertex index out of range" };
+                    mesh.indices.push_back(static_cast<std::uint32_t>(base + index));
+                }
+            } else {
+                for (std::size_t i = 0; i < positions.count; i++)
+                    mesh.indices.push_back(static_cast<std::uint32_t>(base + i));
+            }
+        });
+
+        return mesh;
+    }
+
+    Mesh MeshLoader::loadGltfToGpu(const std::filesystem::path& path, const MeshAttributes& attributes) {
+        GltfAsset asset;
+        openGltf(path, asset);
+
+        Mesh mesh;
+
+        // every glTF buffer becomes one GL buffer, uploaded straight out of the mapping
+        mesh.m_buffers.reserve(asset.buffers.size());
+        for (const auto& buffer : asset.buffers) {
+            mesh.m_buffers.emplace_back(VertexBuffer::Target::Array);
+            mesh.m_buffers.back()
+                .bind()
+                .upload(buffer.data(), buffer.size());
+        }
+
+        forEachTrianglePrimitive(asset, [&](const JsonValue& primitive) {
+            const JsonValue& gltfAttributes = primitive["attributes"];
+            AccessorView positions = accessorView(asset, gltfAttributes["POSITION"].asIndex());
+
+            Mesh::Primitive result{ VertexArray{}, static_cast<GLsizei>(positions.count), GL_NONE, 0 };
+            result.vao.bind();
+
+            auto bindAttribute = [&](const char* name, GLint location) {
+                if (location < 0 || !gltfAttributes.contains(name))
+                    return;
+
+                AccessorView view = accessorView(asset, gltfAttributes[name].asIndex());
+                mesh.m_buffers[view.bufferIndex].bindAs(VertexBuffer::Target::Array);
+                result.vao.setAttribute(location, view.components, view.componentType, view.byteStride, view.bufferOffset, view.normalized);
+            };
+
+            bindAttribute("POSITION", attributes.position);
+            bindAttribute("NORMAL", attributes.normal);
+            bindAttribute("TEXCOORD_0", attributes.texCoord);
+
+            if (primitive.contains("indices")) {
+                AccessorView indices = accessorView(asset, primitive["indices"].asIndex());
+                if (indices.byteStride != 0 && static_cast<std::size_t>(indices.byteStride) != componentSize(indices.componentType))
+                    throw mesh_load_exception{ path.string() + ": strided index buffers are not supported" };
+
+                mesh.m_buffers[indices.bufferIndex].bindAs(VertexBuffer::Target::ElementArray);
+                result.count = static_cast<GLsizei>(indices.count);
+                result.indexType = static_cast<GLenum>(indices.componentType);
+                result.indexOffset = indices.bufferOffset;
+            }
+
+            glBindVertexArray(0);
+            mesh.m_primitives.push_back(std::move(result));
+        });
+
+        return mesh;
+    }
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include <filesystem>
+#include <string>
+
+#include "Mesh.h"
+#include "ThreadPool.h"
+#include "exceptions.h"
+
+namespace gl
+{
+    class mesh_load_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        mesh_load_exception(): message(), super() {}
+        mesh_load_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Mesh importers working on memory-mapped files.
+    //
+    // OBJ files are split into chunks at line boundaries and parsed in parallel. Corners
+    // (position/texcoord/normal index triplets) are then deduplicated into vertices with
+    // open-addressing hash tables, one per thread, each owning a slice of the hash space.
+    //
+    // glTF files (.gltf with external or data: URI buffers, and binary .glb) are read
+    // from the same mapping. All triangle primitives of all meshes are merged, node
+    // transforms are not applied.
+    class MeshLoader {
+    public:
+        // picks the importer by file extension
+        static MeshData load(const std::filesystem::path& path, ThreadPool& pool = ThreadPool::shared());
+
+        static MeshData loadObj(const std::filesystem::path& path, ThreadPool& pool = ThreadPool::shared());
+        static MeshData loadGltf(const std::filesystem::path& path);
+
+        // uploads glTF buffers to GL straight from the file mapping and points the vertex
+        // attributes at the accessors in place - vertex data is never copied on the CPU side
+        static Mesh loadGltfToGpu(const std::filesystem::path& path, const MeshAttributes& attributes);
+    };
+}
@@ -0,0 +1,291 @@
+﻿#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+namespace gl
+{
+    namespace
+    {
+        constexpr std::uint32_t unused = 0xFFFFFFFFu;
+
+        // FIFO post-transform cache: a vertex is resident while fewer than cacheSize misses happened since it was loaded
+        class CacheSimulator {
+        public:
+            CacheSimulator(std::size_t vertexCount, unsigned cacheSize): m_loadedAt(vertexCount, 0), m_misses(0), m_cacheSize(cacheSize) {}
+
+            // returns true on a miss
+            bool access(std::uint32_t vertex) {
+                std::uint32_t loadedAt = m_loadedAt[vertex];
+                if (loadedAt != 0 && m_misses - loadedAt < m_cacheSize)
+                    return false;
+
+                m_loadedAt[vertex] = ++m_misses;
+                return true;
+            }
+
+            void reset() {
+                // pushing enough misses evicts everything without touching the array
+                m_misses += m_cacheSize;
+            }
+
+            std::uint32_t misses() const { return m_misses; }
+
+        private:
+            std::vector<std::uint32_t> m_loadedAt;
+            std::uint32_t m_misses;
+            unsigned m_cacheSize;
+        };
+
+        struct Cluster {
+            std::size_t begin, end;   // triangle range
+            bool facing;
+            float distance;
+        };
+    }
+
+    VertexCacheStats MeshOptimizer::analyzeVertexCache(const MeshData& mesh, unsigned cacheSize) {
+        VertexCacheStats stats;
+        if (mesh.triangleCount() == 0)
+            return stats;
+
+        CacheSimulator cache{ mesh.vertices.size(), cacheSize };
+        std::vector<bool> referenced(mesh.vertices.size(), false);
+        std::size_t referencedCount = 0;
+
+        std::size_t misses = 0;
+        for (std::uint32_t index : mesh.indices) {
+            if (cache.access(index))
+                misses++;
+
+            if (!referenced[index]) {
+                referenced[index] = true;
+                referencedCount++;
+            }
+        }
+
+        stats.acmr = double(misses) / mesh.triangleCount();
+        stats.atvr = double(misses) / referencedCount;
+        return stats;
+    }
+
+    std::vector<std::size_t> MeshOptimizer::optimizeVertexCache(MeshData& mesh, unsigned cacheSize) {
+        std::vector<std::size_t> clusters;
+
+        const std::size_t vertexCount = mesh.vertices.size();
+        const std::size_t triangleCount = mesh.triangleCount();
+        if (triangleCount == 0)
+            return clusters;
+
+        // vertex -> triangles adjacency in compressed rows
+        std::vector<std::uint32_t> liveTriangles(vertexCount, 0);
+        for (std::size_t i = 0; i < triangleCount * 3; i++)
+            liveTriangles[mesh.indices[i]]++;
+
+        std::vector<std::uint32_t> adjacencyOffset(vertexCount + 1, 0);
+        for (std::size_t v = 0; v < vertexCount; v++)
+            adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+
+        std::vector<std::uint32_t> adjacency(triangleCount * 3);
+        std::vector<std::uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (std::size_t i = 0; i < triangleCount * 3; i++)
+            adjacency[fill[mesh.indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+
+        // cache timestamps start far enough in the past for everything to count as a miss
+        std::vector<std::int64_t> cacheTime(vertexCount, 0);
+        std::int64_t time = cacheSize + 1;
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<std::uint32_t> deadEnds;
+        std::vector<std::uint32_t> candidates;
+        std::size_t cursor = 0;
+
+        std::vector<std::uint32_t> output;
+        output.reserve(triangleCount * 3);
+
+        auto skipDeadEnd = [&]() -> std::int64_t {
+            while (!deadEnds.empty()) {
+                std::uint32_t v = deadEnds.back();
+                deadEnds.pop_back();
+                if (liveTriangles[v] > 0)
+                    return v;
+            }
+
+            for (; cursor < vertexCount; cursor++)
+                if (liveTriangles[cursor] > 0)
+                    return static_cast<std::int64_t>(cursor);
+
+            return -1;
+        };
+
+        std::int64_t fanning = skipDeadEnd();
+        clusters.push_back(0);
+
+        while (fanning >= 0) {
+            candidates.clear();
+
+            for (std::uint32_t a = adjacencyOffset[fanning]; a < adjacencyOffset[fanning + 1]; a++) {
+                std::uint32_t triangle = adjacency[a];
+                if (emitted[triangle])
+                    continue;
+
+                for (int c = 0; c < 3; c++) {
+                    std::uint32_t v = mesh.indices[triangle * 3 + c];
+                    output.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+
+                    if (time - cacheTime[v] > cacheSize)
+                        cacheTime[v] = time++;
+                }
+
+                emitted[triangle] = true;
+            }
+
+            // prefer the oldest candidate that will still be in the cache after its remaining triangles are emitted
+            std::int64_t next = -1;
+            std::int64_t bestPriority = -1;
+            for (std::uint32_t v : candidates) {
+                if (liveTriangles[v] == 0)
+                    continue;
+
+                std::int64_t priority = 0;
+                if (time - cacheTime[v] + 2 * std::int64_t(liveTriangles[v]) <= cacheSize)
+                    priority = time - cacheTime[v];
+
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            if (next < 0) {
+                next = skipDeadEnd();
+                if (next >= 0)
+                    clusters.push_back(output.size() / 3);
+            }
+
+            fanning = next;
+        }
+
+        // degenerate leftovers (e.g. a trailing partial triangle) are kept as they were
+        output.insert(output.end(), mesh.indices.begin() + triangleCount * 3, mesh.indices.end());
+        mesh.indices = std::move(output);
+
+        return clusters;
+    }
+
+    void MeshOptimizer::optimizeOverdraw(MeshData& mesh, const std::vector<std::size_t>& hardClusters, const glm::vec3& viewpoint, float threshold, unsigned cacheSize) {
+        const std::size_t triangleCount = mesh.triangleCount();
+        if (triangleCount == 0)
+            return;
+
+        const double targetAcmr = analyzeVertexCache(mesh, cacheSize).acmr * threshold;
+
+        // split hard clusters wherever the part emitted so far is already cache efficient on its own
+        std::vector<Cluster> clusters;
+        CacheSimulator cache{ mesh.vertices.size(), cacheSize };
+
+        for (std::size_t h = 0; h < hardClusters.size(); h++) {
+            std::size_t end = (h + 1 < hardClusters.size()) ? hardClusters[h + 1] : triangleCount;
+            std::size_t begin = hardClusters[h];
+
+            cache.reset();
+            std::uint32_t startMisses = cache.misses();
+
+            for (std::size_t t = begin; t < end; t++) {
+                for (int c = 0; c < 3; c++)
+                    cache.access(mesh.indices[t * 3 + c]);
+
+                std::size_t triangles = t + 1 - begin;
+                if (t + 1 < end && double(cache.misses() - startMisses) / triangles <= targetAcmr) {
+                    clusters.push_back({ begin, t + 1, false, .0f });
+                    begin = t + 1;
+
+                    cache.reset();
+                    startMisses = cache.misses();
+                }
+            }
+
+            clusters.push_back({ begin, end, false, .0f });
+        }
+
+        for (auto& cluster : clusters) {
+            glm::vec3 centroid{ .0f };
+            glm::vec3 normal{ .0f };
+            float area = .0f;
+
+            for (std::size_t t = cluster.begin; t < cluster.end; t++) {
+                const glm::vec3& a = mesh.vertices[mesh.indices[t * 3]].position;
+                const glm::vec3& b = mesh.vertices[mesh.indices[t * 3 + 1]].position;
+                const glm::vec3& c = mesh.vertices[mesh.indices[t * 3 + 2]].position;
+
+                glm::vec3 n = glm::cross(b - a, c - a);
+                float triangleArea = glm::length(n);
+
+                centroid += (a + b + c) * (triangleArea / 3.f);
+                normal += n;
+                area += triangleArea;
+            }
+
+            if (area > .0f)
+                centroid /= area;
+            else
+                centroid = mesh.vertices[mesh.indices[cluster.begin * 3]].position;
+
+            cluster.facing = glm::dot(normal, viewpoint - centroid) > .0f;
+            cluster.distance = glm::length(viewpoint - centroid);
+        }
+
+        // front-facing clusters nearest first, back-facing ones get culled anyway
+        std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+            if (a.facing != b.facing)
+                return a.facing;
+            return a.distance < b.distance;
+        });
+
+        std::vector<std::uint32_t> output;
+        output.reserve(mesh.indices.size());
+        for (const auto& cluster : clusters)
+            output.insert(output.end(), mesh.indices.begin() + cluster.begin * 3, mesh.indices.begin() + cluster.end * 3);
+
+        output.insert(output.end(), mesh.indices.begin() + triangleCount * 3, mesh.indices.end());
+        mesh.indices = std::move(output);
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(MeshData& mesh) {
+        std::vector<std::uint32_t> remap(mesh.vertices.size(), unused);
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(mesh.vertices.size());
+
+        for (auto& index : mesh.indices) {
+            if (remap[index] == unused) {
+                remap[index] = static_cast<std::uint32_t>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        mesh.vertices = std::move(vertices);
+    }
+
+    MeshOptimizeReport MeshOptimizer::optimize(MeshData& mesh, const MeshOptimizeOptions& options) {
+        MeshOptimizeReport report;
+        report.before = analyzeVertexCache(mesh, options.cacheSize);
+
+        std::vector<std::size_t> clusters = optimizeVertexCache(mesh, options.cacheSize);
+
+        if (options.reduceOverdraw)
+            optimizeOverdraw(mesh, clusters, options.viewpoint, options.overdrawThreshold, options.cacheSize);
+
+        if (options.optimizeFetch)
+            optimizeVertexFetch(mesh);
+
+        report.after = analyzeVertexCache(mesh, options.cacheSize);
+        return report;
+    }
+}
@@ -0,0 +1,54 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "Mesh.h"
+
+namespace gl
+{
+    // post-transform vertex cache efficiency of an index buffer, simulated with a FIFO cache
+    struct VertexCacheStats {
+        double acmr = 0.0;   // transformed vertices per triangle, 0.5 is the ideal for a regular grid, 3 the worst
+        double atvr = 0.0;   // transformed vertices per unique vertex, 1 is ideal
+    };
+
+    struct MeshOptimizeOptions {
+        unsigned cacheSize = 16;
+
+        // sort triangle clusters front to back as seen from the viewpoint; clusters are cut
+        // only where the cache efficiency stays within threshold times the optimized ACMR
+        bool reduceOverdraw = false;
+        glm::vec3 viewpoint = glm::vec3{ .0f };
+        float overdrawThreshold = 1.05f;
+
+        bool optimizeFetch = true;
+    };
+
+    struct MeshOptimizeReport {
+        VertexCacheStats before;
+        VertexCacheStats after;
+    };
+
+    // Reorders the triangles and vertices of a MeshData without changing what is drawn.
+    class MeshOptimizer {
+    public:
+        static VertexCacheStats analyzeVertexCache(const MeshData& mesh, unsigned cacheSize = 16);
+
+        // Tipsify (Sander et al. 2007): fans around recently used vertices, linear time.
+        // Returns the first triangle of every cluster that starts with a jump (dead end).
+        static std::vector<std::size_t> optimizeVertexCache(MeshData& mesh, unsigned cacheSize = 16);
+
+        // splits the clusters further where cache efficiency allows and sorts them front to back
+        static void optimizeOverdraw(MeshData& mesh, const std::vector<std::size_t>& clusters, const glm::vec3& viewpoint, float threshold = 1.05f, unsigned cacheSize = 16);
+
+        // renumbers vertices in first-use order so fetches walk the vertex buffer linearly,
+        // unused vertices are dropped
+        static void optimizeVertexFetch(MeshData& mesh);
+
+        // runs all the enabled stages in order
+        static MeshOptimizeReport optimize(MeshData& mesh, const MeshOptimizeOptions& options = {});
+    };
+}
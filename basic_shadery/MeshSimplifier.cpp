@@ -0,0 +1,369 @@
+﻿#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
+
+namespace gl
+{
+    namespace
+    {
+        // symmetric 3x3 A, vector b and scalar c of the quadric x'Ax + 2b'x + c, plus the area it was built from
+        struct Quadric {
+            double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+            double b0 = 0, b1 = 0, b2 = 0;
+            double c = 0;
+            double area = 0;
+
+            static Quadric fromPlane(const glm::dvec3& n, double d, double weight) {
+                Quadric q;
+                q.a00 = weight * n.x * n.x; q.a01 = weight * n.x * n.y; q.a02 = weight * n.x * n.z;
+                q.a11 = weight * n.y * n.y; q.a12 = weight * n.y * n.z; q.a22 = weight * n.z * n.z;
+                q.b0 = weight * d * n.x; q.b1 = weight * d * n.y; q.b2 = weight * d * n.z;
+                q.c = weight * d * d;
+                q.area = weight;
+                return q;
+            }
+
+            Quadric& operator+=(const Quadric& o) {
+                a00 += o.a00; a01 += o.a01; a02 += o.a02;
+                a11 += o.a11; a12 += o.a12; a22 += o.a22;
+                b0 += o.b0; b1 += o.b1; b2 += o.b2;
+                c += o.c;
+                area += o.area;
+                return *this;
+            }
+
+            double evaluate(const glm::dvec3& p) const {
+                double r = a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+                    + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+                    + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z)
+                    + c;
+                return std::max(r, 0.0);
+            }
+        };
+
+        struct Collapse {
+            double cost;
+            std::uint32_t from, to;
+            std::uint32_t fromVersion, toVersion;
+
+            bool operator<(const Collapse& other) const {
+                // min-heap on cost
+                return cost > other.cost;
+            }
+        };
+
+        struct PositionKey {
+            std::uint32_t bits[3];
+
+            bool operator==(const PositionKey& o) const {
+                return bits[0] == o.bits[0] && bits[1] == o.bits[1] && bits[2] == o.bits[2];
+            }
+        };
+
+        struct PositionHash {
+            std::size_t operator()(const PositionKey& k) const {
+                std::uint64_t h = k.bits[0] * 0x9E3779B97F4A7C15ull;
+                h ^= (h >> 31) ^ (k.bits[1] * 0xC2B2AE3D27D4EB4Full);
+                h ^= (h >> 29) ^ (k.bits[2] * 0x165667B19E3779F9ull);
+                return static_cast<std::size_t>(h ^ (h >> 32));
+            }
+        };
+
+        PositionKey positionKey(const glm::vec3& p) {
+            PositionKey key;
+            std::memcpy(key.bits, &p.x, sizeof(key.bits));
+            return key;
+        }
+
+        inline std::uint64_t edgeKey(std::uint32_t a, std::uint32_t b) {
+            if (a > b)
+                std::swap(a, b);
+            return (std::uint64_t(a) << 32) | b;
+        }
+    }
+
+    SimplifyResult MeshSimplifier::simplify(
+        const std::vector<MeshVertex>& vertices,
+        const std::vector<std::uint32_t>& sourceIndices,
+        std::size_t targetTriangles,
+        float maxError,
+        const SimplifyOptions& options
+    ) {
+        SimplifyResult result;
+        result.indices.assign(sourceIndices.begin(), sourceIndices.begin() + sourceIndices.size() / 3 * 3);
+
+        const std::size_t vertexCount = vertices.size();
+        const std::size_t triangleCount = result.indices.size() / 3;
+        if (triangleCount <= targetTriangles || vertexCount == 0)
+            return result;
+
+        std::vector<std::uint32_t>& indices = result.indices;
+
+        // work in a unit-sized frame so attribute weights mean the same for every mesh
+        glm::vec3 low{ std::numeric_limits<float>::max() }, high{ -std::numeric_limits<float>::max() };
+        for (std::uint32_t index : indices) {
+            low = glm::min(low, vertices[index].position);
+            high = glm::max(high, vertices[index].position);
+        }
+
+        const double extent = std::max<double>(glm::length(high - low), 1e-20);
+        const double scale = 1.0 / extent;
+
+        std::vector<glm::dvec3> positions(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; v++)
+            positions[v] = glm::dvec3{ vertices[v].position - low } * scale;
+
+        auto attributeDistance = [&vertices](std::uint32_t from, std::uint32_t to) {
+            glm::vec3 n = vertices[from].normal - vertices[to].normal;
+            glm::vec2 uv = vertices[from].texCoord - vertices[to].texCoord;
+            return double(glm::dot(n, n) + glm::dot(uv, uv));
+        };
+
+        // Vertices are welded first: copies of a vertex with the same position and attributes
+        // (an unwelded mesh, a triangle soup) become one, so they can collapse. Only positions
+        // still shared by several vertices after that sit on an attribute seam, and are locked.
+        std::vector<std::uint32_t> canonical(vertexCount);
+        std::vector<bool> locked(vertexCount, false);
+        {
+            constexpr double weldDistanceSquared = 1e-10;
+
+            std::unordered_map<PositionKey, std::uint32_t, PositionHash> firstAt;
+            firstAt.reserve(vertexCount);
+
+            // the distinct vertices at each position, linked from the first one
+            std::vector<std::uint32_t> weld(vertexCount);
+            std::vector<std::uint32_t> nextDistinct(vertexCount, std::numeric_limits<std::uint32_t>::max());
+            std::vector<bool> isSeam(vertexCount, false);
+
+            for (std::uint32_t v = 0; v < vertexCount; v++) {
+                canonical[v] = firstAt.emplace(positionKey(vertices[v].position), v).first->second;
+                weld[v] = v;
+
+                for (std::uint32_t d = canonical[v]; d != v; d = nextDistinct[d]) {
+                    if (attributeDistance(v, d) <= weldDistanceSquared) {
+                        weld[v] = d;
+                        break;
+                    }
+
+                    if (nextDistinct[d] == std::numeric_limits<std::uint32_t>::max()) {
+                        nextDistinct[d] = v;
+                        isSeam[canonical[v]] = true;
+                    }
+                }
+            }
+
+            for (std::uint32_t& index : indices)
+                index = weld[index];
+
+            for (std::size_t v = 0; v < vertexCount; v++)
+                locked[v] = isSeam[canonical[v]];
+        }
+
+        // border and non-manifold edges are found on welded positions, so seams do not count as borders
+        if (options.lockBorder) {
+            std::unordered_map<std::uint64_t, std::uint32_t> edgeUse;
+            edgeUse.reserve(triangleCount * 3 / 2);
+
+            for (std::size_t t = 0; t < triangleCount; t++)
+                for (int e = 0; e < 3; e++)
+                    edgeUse[edgeKey(canonical[indices[t * 3 + e]], canonical[indices[t * 3 + (e + 1) % 3]])]++;
+
+            std::vector<bool> borderPosition(vertexCount, false);
+            for (const auto& [key, uses] : edgeUse) {
+                if (uses != 2) {
+                    borderPosition[key >> 32] = true;
+                    borderPosition[key & 0xFFFFFFFFu] = true;
+                }
+            }
+
+            for (std::size_t v = 0; v < vertexCount; v++)
+                if (borderPosition[canonical[v]])
+                    locked[v] = true;
+        }
+
+        std::vector<Quadric> quadrics(vertexCount);
+        std::vector<std::vector<std::uint32_t>> vertexTriangles(vertexCount);
+
+        for (std::uint32_t t = 0; t < triangleCount; t++) {
+            const std::uint32_t* tri = &indices[t * 3];
+            const glm::dvec3& a = positions[tri[0]];
+
+            glm::dvec3 normal = glm::cross(positions[tri[1]] - a, positions[tri[2]] - a);
+            double length = glm::length(normal);
+
+            if (length > 0.0) {
+                normal /= length;
+                Quadric q = Quadric::fromPlane(normal, -glm::dot(normal, a), length * 0.5);
+                for (int c = 0; c < 3; c++)
+                    quadrics[tri[c]] += q;
+            }
+
+            for (int c = 0; c < 3; c++)
+                vertexTriangles[tri[c]].push_back(t);
+        }
+
+        std::vector<bool> removedTriangle(triangleCount, false);
+        std::vector<bool> removedVertex(vertexCount, false);
+        std::vector<std::uint32_t> version(vertexCount, 0);
+
+        const double attributeWeight = options.attributeWeight;
+        const double maxErrorSquared = double(maxError) * scale * double(maxError) * scale;
+
+        // error after merging `from` into `to`, normalized by area so it reads as a squared distance
+        auto geometricError = [&](std::uint32_t from, std::uint32_t to) {
+            Quadric q = quadrics[from];
+            q += quadrics[to];
+            return q.area > 0.0 ? q.evaluate(positions[to]) / q.area : 0.0;
+        };
+
+        std::priority_queue<Collapse> queue;
+
+        auto push = [&](std::uint32_t from, std::uint32_t to) {
+            if (locked[from] || from == to)
+                return;
+
+            Quadric q = quadrics[from];
+            q += quadrics[to];
+            double cost = q.evaluate(positions[to]) + attributeWeight * quadrics[from].area * attributeDistance(from, to);
+
+            queue.push({ cost, from, to, version[from], version[to] });
+        };
+
+        for (std::size_t t = 0; t < triangleCount; t++)
+            for (int e = 0; e < 3; e++)
+                push(indices[t * 3 + e], indices[t * 3 + (e + 1) % 3]);
+
+        // rejects collapses that would flip or squash a triangle around `from`
+        auto keepsOrientation = [&](std::uint32_t from, std::uint32_t to) {
+            for (std::uint32_t t : vertexTriangles[from]) {
+                if (removedTriangle[t])
+                    continue;
+
+                const std::uint32_t* tri = &indices[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                    continue;
+
+                glm::dvec3 p[3], moved[3];
+                for (int c = 0; c < 3; c++) {
+                    p[c] = positions[tri[c]];
+                    moved[c] = tri[c] == from ? positions[to] : p[c];
+                }
+
+                glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::dvec3 after = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+
+                if (glm::dot(before, after) <= 0.0)
+                    return false;
+            }
+
+            return true;
+        };
+
+        std::size_t liveTriangles = triangleCount;
+        double worstError = 0.0;
+        std::vector<std::uint32_t> neighbours;
+
+        auto sharesTriangle = [&](std::uint32_t a, std::uint32_t b) {
+            for (std::uint32_t t : vertexTriangles[a]) {
+                const std::uint32_t* tri = &indices[t * 3];
+                if (!removedTriangle[t] && (tri[0] == b || tri[1] == b || tri[2] == b))
+                    return true;
+            }
+            return false;
+        };
+
+        // collapses turned down by the orientation check, per `from`. The check only depends on
+        // the triangles around `from`, so they are tried again once those change.
+        std::vector<std::vector<std::uint32_t>> rejected(vertexCount);
+
+        while (liveTriangles > targetTriangles && !queue.empty()) {
+            Collapse collapse = queue.top();
+            queue.pop();
+
+            const std::uint32_t from = collapse.from, to = collapse.to;
+            if (removedVertex[from] || removedVertex[to] || version[from] != collapse.fromVersion || version[to] != collapse.toVersion)
+                continue;
+
+            double error = geometricError(from, to);
+            if (error > maxErrorSquared)
+                continue;
+
+            if (!keepsOrientation(from, to)) {
+                rejected[from].push_back(to);
+                continue;
+            }
+
+            // move every triangle of `from` over to `to`, the ones spanning the edge degenerate
+            for (std::uint32_t t : vertexTriangles[from]) {
+                if (removedTriangle[t])
+                    continue;
+
+                std::uint32_t* tri = &indices[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to) {
+                    removedTriangle[t] = true;
+                    liveTriangles--;
+                    continue;
+                }
+
+                for (int c = 0; c < 3; c++)
+                    if (tri[c] == from)
+                        tri[c] = to;
+
+                vertexTriangles[to].push_back(t);
+            }
+
+            quadrics[to] += quadrics[from];
+            removedVertex[from] = true;
+            vertexTriangles[from] = {};
+            rejected[from] = {};
+            version[to]++;
+            worstError = std::max(worstError, error);
+
+            // drop dead triangles from the list and requeue the edges whose cost changed
+            auto& around = vertexTriangles[to];
+            around.erase(std::remove_if(around.begin(), around.end(), [&](std::uint32_t t) { return removedTriangle[t]; }), around.end());
+
+            neighbours.clear();
+            for (std::uint32_t t : around)
+                for (int c = 0; c < 3; c++)
+                    if (indices[t * 3 + c] != to)
+                        neighbours.push_back(indices[t * 3 + c]);
+
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+
+            // the edges of `to` are all pushed again with its new version. Neighbours that shared
+            // triangles with `from` have new triangles now, their rejected collapses are retried.
+            rejected[to].clear();
+            for (std::uint32_t n : neighbours) {
+                push(to, n);
+                push(n, to);
+
+                for (std::uint32_t other : rejected[n])
+                    if (other != to && sharesTriangle(n, other))
+                        push(n, other);
+                rejected[n].clear();
+            }
+        }
+
+        std::size_t out = 0;
+        for (std::size_t t = 0; t < triangleCount; t++) {
+            if (removedTriangle[t])
+                continue;
+
+            for (int c = 0; c < 3; c++)
+                indices[out * 3 + c] = indices[t * 3 + c];
+            out++;
+        }
+
+        indices.resize(out * 3);
+        result.error = static_cast<float>(std::sqrt(worstError) * extent);
+        return result;
+    }
+}
@@ -0,0 +1,48 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Mesh.h"
+
+namespace gl
+{
+    struct SimplifyOptions {
+        // how much a unit of normal/texcoord difference costs compared to geometric error
+        float attributeWeight = .5f;
+
+        // keep open boundaries in place so LODs of neighbouring pieces still meet
+        bool lockBorder = true;
+    };
+
+    struct SimplifyResult {
+        std::vector<std::uint32_t> indices;   // refer to the unchanged input vertices
+        float error = .0f;                    // largest RMS distance to the original surface, in model units
+    };
+
+    // Quadric error metric simplification (Garland & Heckbert) with half-edge collapses:
+    // vertices are only ever merged into existing ones, so every LOD can share the
+    // original vertex buffer and attributes never need to be interpolated.
+    //
+    // Copies of a vertex (same position and attributes) are welded first. Vertices on attribute
+    // seams (several vertices with different normals or UVs sharing a position) are never
+    // moved, which keeps UV and normal seams from cracking open.
+    class MeshSimplifier {
+    public:
+        // collapses edges until at most targetTriangles are left, or the next collapse
+        // would move the surface by more than maxError
+        static SimplifyResult simplify(
+            const std::vector<MeshVertex>& vertices,
+            const std::vector<std::uint32_t>& indices,
+            std::size_t targetTriangles,
+            float maxError = std::numeric_limits<float>::max(),
+            const SimplifyOptions& options = {}
+        );
+
+        static SimplifyResult simplify(const MeshData& mesh, std::size_t targetTriangles, float maxError = std::numeric_limits<float>::max(), const SimplifyOptions& options = {}) {
+            return simplify(mesh.vertices, mesh.indices, targetTriangles, maxError, options);
+        }
+    };
+}
@@ -0,0 +1,113 @@
+﻿#include "MultiView.h"
+
+#include <algorithm>
+#include <string>
+
+namespace gl
+{
+    namespace
+    {
+        GLuint createLayers(GLint internalFormat, GLenum format, GLenum type, GLsizei width, GLsizei height, GLsizei layers) {
+            GLuint texture = 0;
+            glGenTextures(1, &texture);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internalFormat, width, height, layers, 0, format, type, nullptr);
+
+            glTextureParameteri(texture, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTextureParameteri(texture, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTextureParameteri(texture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTextureParameteri(texture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            return texture;
+        }
+    }
+
+    MultiView::MultiView(Program& program, std::size_t viewCount, GLsizei width, GLsizei height, ProgramCache& programs):
+        m_viewCount(std::clamp<std::size_t>(viewCount, 1, maxViews)),
+        m_width(width),
+        m_height(height),
+        m_framebuffer(),
+        m_color(createLayers(GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, width, height, static_cast<GLsizei>(m_viewCount))),
+        m_depth(createLayers(GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_FLOAT, width, height, static_cast<GLsizei>(m_viewCount))),
+        m_program(program),
+        m_viewProjections(),
+        m_viewCountUniform(program.createUniform<GLint>("viewCount", static_cast<GLint>(m_viewCount))),
+        m_compositeProgram(programs.get("assets/shaders/quad.vert.glsl", "assets/shaders/multiview_composite.frag.glsl")),
+        m_quad(),
+        m_rect(m_compositeProgram.createUniform<glm::vec4>("rect", { -1.f, -1.f, 1.f, 1.f })),
+        m_uvRect(m_compositeProgram.createUniform<glm::vec4>("uvRect", { .0f, .0f, 1.f, 1.f })),
+        m_compositeViewCount(m_compositeProgram.createUniform<GLint>("viewCount", static_cast<GLint>(m_viewCount))),
+        m_columns(m_compositeProgram.createUniform<GLint>("columns", 1)),
+        m_sampler(m_compositeProgram.createUniform<GLint>("views", 0)),
+        m_previousFramebuffer(0),
+        m_previousViewport()
+    {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+        // the elements of the array are separate uniforms, each one sent only when its view moves
+        m_viewProjections.reserve(m_viewCount);
+        for (std::size_t view = 0; view < m_viewCount; view++) {
+            std::string name = "viewProjections[" + std::to_string(view) + "]";
+            m_viewProjections.push_back(program.createUniform<glm::mat4>(name.c_str()));
+        }
+
+        m_framebuffer.bind();
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_color, 0);
+        glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_depth, 0);
+        m_framebuffer.checkStatus();
+        Framebuffer::unbind();
+    }
+
+    MultiView& MultiView::setCameras(const std::vector<PerspectiveCamera>& cameras) {
+        std::size_t count = std::min(cameras.size(), m_viewCount);
+
+        for (std::size_t view = 0; view < count; view++) {
+            glm::mat4 viewProjection = cameras[view].getProjectionMatrix() * cameras[view].getViewMatrix();
+            if (m_viewProjections[view].value() != viewProjection)
+                m_viewProjections[view] = viewProjection;
+        }
+
+        return *this;
+    }
+
+    MultiView& MultiView::begin() {
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+
+        // clears every layer of a layered attachment
+        m_framebuffer.bind();
+        glViewport(0, 0, m_width, m_height);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        return *this;
+    }
+
+    MultiView& MultiView::end() {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(m_previousFramebuffer));
+        glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+        return *this;
+    }
+
+    MultiView& MultiView::composite(unsigned columns) {
+        columns = std::clamp<unsigned>(columns, 1, static_cast<unsigned>(m_viewCount));
+        if (m_columns.value() != static_cast<GLint>(columns))
+            m_columns = static_cast<GLint>(columns);
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        m_compositeProgram.bind();
+        m_quad.bind();
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_color);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        if (depthTest)
+            glEnable(GL_DEPTH_TEST);
+
+        return *this;
+    }
+
+    MultiView::~MultiView() {
+        glDeleteTextures(1, &m_color);
+        glDeleteTextures(1, &m_depth);
+    }
+}
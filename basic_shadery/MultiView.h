@@ -0,0 +1,87 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/vec4.hpp>
+
+#include "Framebuffer.h"
+#include "PerspectiveCamera.h"
+#include "Program.h"
+#include "ProgramCache.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+
+namespace gl
+{
+    // The scene seen by several cameras at once (split screen, a wall of security cameras, the
+    // six faces of a cube map) from a single submission of its draws.
+    //
+    // The views are the layers of a layered render target, a color and a depth texture array
+    // attached whole to one framebuffer. The scene program runs multiview.geom.glsl, which
+    // emits every triangle once per view into that view's layer (gl_Layer), projected with the
+    // view's camera and skipped where it is outside that camera's frustum. The draw calls and
+    // state changes are the same for any number of views, only the geometry shader's work grows.
+    // composite() then shows all the layers side by side in a single pass.
+    //
+    // The scene program is expected to be built from multiview.vert.glsl (or a vertex shader
+    // that likewise leaves world space positions in gl_Position) and multiview.geom.glsl.
+    class MultiView {
+    public:
+        // the size of the array in multiview.geom.glsl
+        static constexpr std::size_t maxViews = 8;
+
+        // viewCount layers of width x height, the composite pass is loaded through programs
+        MultiView(Program& program, std::size_t viewCount, GLsizei width, GLsizei height, ProgramCache& programs);
+
+        MultiView(const MultiView&) = delete;
+        MultiView& operator=(const MultiView&) = delete;
+
+        // view i is seen by cameras[i], only the matrices that changed are sent
+        MultiView& setCameras(const std::vector<PerspectiveCamera>& cameras);
+
+        // binds the layered target and clears every view, the scene's draws go to all of them
+        MultiView& begin();
+        // binds the framebuffer and the viewport bound before begin() back
+        MultiView& end();
+
+        // the views in a grid over the bound framebuffer's viewport, row by row from the top
+        // left. Leaves texture unit 0 in use.
+        MultiView& composite(unsigned columns);
+
+        std::size_t viewCount() const { return m_viewCount; }
+        GLsizei width() const { return m_width; }
+        GLsizei height() const { return m_height; }
+
+        // GL_TEXTURE_2D_ARRAY with a layer per view
+        GLuint colorTexture() const { return m_color; }
+
+        ~MultiView();
+
+    private:
+        std::size_t m_viewCount;
+        GLsizei m_width;
+        GLsizei m_height;
+
+        Framebuffer m_framebuffer;
+        GLuint m_color;
+        GLuint m_depth;
+
+        Program& m_program;
+        std::vector<Uniform<glm::mat4>> m_viewProjections;
+        Uniform<GLint> m_viewCountUniform;
+
+        Program& m_compositeProgram;
+        VertexArray m_quad;
+        Uniform<glm::vec4> m_rect;
+        Uniform<glm::vec4> m_uvRect;
+        Uniform<GLint> m_compositeViewCount;
+        Uniform<GLint> m_columns;
+        Uniform<GLint> m_sampler;
+
+        // what begin() replaced
+        GLint m_previousFramebuffer;
+        GLint m_previousViewport[4];
+    };
+}
@@ -0,0 +1,382 @@
+﻿#include "OcclusionCuller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OCCLUSION_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace gl
+{
+    namespace
+    {
+        // keeps the part of a polygon in front of the near plane (z >= -w), at most one vertex is added per plane
+        std::size_t clipNear(const glm::vec4* in, std::size_t count, glm::vec4* out) {
+            std::size_t outCount = 0;
+
+            for (std::size_t i = 0; i < count; i++) {
+                const glm::vec4& a = in[i];
+                const glm::vec4& b = in[(i + 1) % count];
+                float da = a.z + a.w;
+                float db = b.z + b.w;
+
+                if (da >= .0f)
+                    out[outCount++] = a;
+
+                if ((da >= .0f) != (db >= .0f)) {
+                    float t = da / (da - db);
+                    out[outCount++] = a + (b - a) * t;
+                }
+            }
+
+            return outCount;
+        }
+    }
+
+    OcclusionCuller::OcclusionCuller(unsigned width, unsigned height, ThreadPool& pool):
+        m_width((std::max(width, 4u) + 3) & ~3u),   // rows are processed 4 pixels at a time
+        m_height(std::max(height, 1u)),
+        m_tilesX((m_width + tileSize - 1) / tileSize),
+        m_tilesY((m_height + tileSize - 1) / tileSize),
+        m_pool(pool),
+        m_occluders(),
+        m_bins(pool.size() + 1),
+        m_levels(),
+        m_rasterizedTriangles(0)
+    {
+        for (auto& bin : m_bins)
+            bin.tiles.resize(std::size_t(m_tilesX) * m_tilesY);
+
+        unsigned w = m_width, h = m_height;
+        for (;;) {
+            m_levels.push_back({ w, h, std::vector<float>(std::size_t(w) * h, 1.f), std::vector<float>(std::size_t(w) * h, 1.f) });
+            if (w == 1 && h == 1)
+                break;
+
+            w = (w + 1) / 2;
+            h = (h + 1) / 2;
+        }
+    }
+
+    OcclusionCuller& OcclusionCuller::clear() {
+        m_occluders.clear();
+
+        for (auto& level : m_levels) {
+            std::fill(level.minDepth.begin(), level.minDepth.end(), 1.f);
+            std::fill(level.maxDepth.begin(), level.maxDepth.end(), 1.f);
+        }
+
+        return *this;
+    }
+
+    OcclusionCuller& OcclusionCuller::addOccluder(const MeshData& mesh, const glm::mat4& modelViewProjection, bool twoSided) {
+        m_occluders.push_back({
+            reinterpret_cast<const unsigned char*>(mesh.vertices.data()) + offsetof(MeshVertex, position),
+            sizeof(MeshVertex),
+            mesh.indices.data(),
+            mesh.triangleCount(),
+            modelViewProjection,
+            twoSided
+        });
+        return *this;
+    }
+
+    OcclusionCuller& OcclusionCuller::addOccluder(const std::vector<glm::vec3>& positions, const std::vector<std::uint32_t>& indices, const glm::mat4& modelViewProjection, bool twoSided) {
+        m_occluders.push_back({
+            reinterpret_cast<const unsigned char*>(positions.data()),
+            sizeof(glm::vec3),
+            indices.data(),
+            indices.size() / 3,
+            modelViewProjection,
+            twoSided
+        });
+        return *this;
+    }
+
+    void OcclusionCuller::setupTriangle(const glm::vec4 clip[3], bool twoSided, Bin& bin) const {
+        glm::vec4 polygon[4];
+        std::size_t count = clipNear(clip, 3, polygon);
+
+        glm::vec3 screen[4];
+        for (std::size_t i = 0; i < count; i++) {
+            float invW = 1.f / polygon[i].w;
+            screen[i] = {
+                (polygon[i].x * invW * .5f + .5f) * m_width,
+                (polygon[i].y * invW * .5f + .5f) * m_height,
+                polygon[i].z * invW * .5f + .5f
+            };
+        }
+
+        for (std::size_t i = 2; i < count; i++) {
+            glm::vec3 v[3] = { screen[0], screen[i - 1], screen[i] };
+
+            float area = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+            if (std::abs(area) < 1e-8f)
+                continue;
+
+            // counter-clockwise is front facing, same as the GL default; two-sided ones get flipped
+            if (area < .0f) {
+                if (!twoSided)
+                    continue;
+
+                std::swap(v[1], v[2]);
+                area = -area;
+            }
+
+            Triangle triangle;
+            float minX = std::min({ v[0].x, v[1].x, v[2].x }), maxX = std::max({ v[0].x, v[1].x, v[2].x });
+            float minY = std::min({ v[0].y, v[1].y, v[2].y }), maxY = std::max({ v[0].y, v[1].y, v[2].y });
+
+            // pixels whose centers can be inside
+            triangle.minX = std::max(int(std::ceil(minX - .5f)), 0);
+            triangle.maxX = std::min(int(std::floor(maxX - .5f)), int(m_width) - 1);
+            triangle.minY = std::max(int(std::ceil(minY - .5f)), 0);
+            triangle.maxY = std::min(int(std::floor(maxY - .5f)), int(m_height) - 1);
+
+            if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+                continue;
+
+            for (int c = 0; c < 3; c++) {
+                triangle.x[c] = v[c].x;
+                triangle.y[c] = v[c].y;
+            }
+
+            triangle.depthX = ((v[1].z - v[0].z) * (v[2].y - v[0].y) - (v[2].z - v[0].z) * (v[1].y - v[0].y)) / area;
+            triangle.depthY = ((v[2].z - v[0].z) * (v[1].x - v[0].x) - (v[1].z - v[0].z) * (v[2].x - v[0].x)) / area;
+            triangle.depthC = v[0].z - triangle.depthX * v[0].x - triangle.depthY * v[0].y;
+
+            auto index = static_cast<std::uint32_t>(bin.triangles.size());
+            bin.triangles.push_back(triangle);
+
+            for (unsigned ty = triangle.minY / tileSize; ty <= unsigned(triangle.maxY) / tileSize; ty++)
+                for (unsigned tx = triangle.minX / tileSize; tx <= unsigned(triangle.maxX) / tileSize; tx++)
+                    bin.tiles[ty * m_tilesX + tx].push_back(index);
+        }
+    }
+
+    void OcclusionCuller::rasterizeTile(unsigned tile) {
+        const int tileX0 = (tile % m_tilesX) * tileSize, tileY0 = (tile / m_tilesX) * tileSize;
+        const int tileX1 = std::min(tileX0 + int(tileSize), int(m_width)) - 1;
+        const int tileY1 = std::min(tileY0 + int(tileSize), int(m_height)) - 1;
+
+        float* depth = m_levels[0].minDepth.data();
+
+        for (const auto& bin : m_bins) {
+            for (std::uint32_t index : bin.tiles[tile]) {
+                const Triangle& t = bin.triangles[index];
+
+                const int x0 = std::max(t.minX, tileX0), x1 = std::min(t.maxX, tileX1);
+                const int y0 = std::max(t.minY, tileY0), y1 = std::min(t.maxY, tileY1);
+
+                // edge i -> i+1: e(x, y) = a * x + b * y + c, positive inside
+                float a[3], b[3], c[3];
+                for (int e = 0; e < 3; e++) {
+                    int n = (e + 1) % 3;
+                    a[e] = t.y[e] - t.y[n];
+                    b[e] = t.x[n] - t.x[e];
+                    c[e] = -(a[e] * t.x[e] + b[e] * t.y[e]);
+                }
+
+#ifdef OCCLUSION_USE_SSE
+                const __m128 columnOffset = _mm_setr_ps(.5f, 1.5f, 2.5f, 3.5f);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 a0 = _mm_set1_ps(a[0]), a1 = _mm_set1_ps(a[1]), a2 = _mm_set1_ps(a[2]);
+                const __m128 depthX = _mm_set1_ps(t.depthX);
+                const __m128i firstColumn = _mm_set1_epi32(x0), lastColumn = _mm_set1_epi32(x1);
+                const __m128i columnIndex = _mm_setr_epi32(0, 1, 2, 3);
+
+                for (int y = y0; y <= y1; y++) {
+                    float py = y + .5f;
+                    __m128 row0 = _mm_set1_ps(b[0] * py + c[0]);
+                    __m128 row1 = _mm_set1_ps(b[1] * py + c[1]);
+                    __m128 row2 = _mm_set1_ps(b[2] * py + c[2]);
+                    __m128 rowDepth = _mm_set1_ps(t.depthY * py + t.depthC);
+
+                    float* out = depth + std::size_t(y) * m_width;
+
+                    for (int x = x0 & ~3; x <= x1; x += 4) {
+                        __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), columnOffset);
+
+                        __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                        __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                        __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+
+                        __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+                        // the first and last group of a row can stick out of the triangle bounds or the tile
+                        __m128i column = _mm_add_epi32(_mm_set1_epi32(x), columnIndex);
+                        __m128i outside = _mm_or_si128(_mm_cmplt_epi32(column, firstColumn), _mm_cmpgt_epi32(column, lastColumn));
+                        inside = _mm_andnot_ps(_mm_castsi128_ps(outside), inside);
+
+                        if (_mm_movemask_ps(inside) == 0)
+                            continue;
+
+                        __m128 z = _mm_add_ps(_mm_mul_ps(depthX, px), rowDepth);
+                        __m128 old = _mm_loadu_ps(out + x);
+                        __m128 nearer = _mm_min_ps(old, z);
+
+                        _mm_storeu_ps(out + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+                    }
+                }
+#else
+                for (int y = y0; y <= y1; y++) {
+                    float py = y + .5f;
+                    float* out = depth + std::size_t(y) * m_width;
+
+                    for (int x = x0; x <= x1; x++) {
+                        float px = x + .5f;
+                        if (a[0] * px + b[0] * py + c[0] < .0f || a[1] * px + b[1] * py + c[1] < .0f || a[2] * px + b[2] * py + c[2] < .0f)
+                            continue;
+
+                        out[x] = std::min(out[x], t.depthX * px + t.depthY * py + t.depthC);
+                    }
+                }
+#endif
+            }
+        }
+    }
+
+    void OcclusionCuller::buildPyramid() {
+        m_levels[0].maxDepth = m_levels[0].minDepth;
+
+        for (std::size_t l = 1; l < m_levels.size(); l++) {
+            const Level& fine = m_levels[l - 1];
+            Level& coarse = m_levels[l];
+
+            for (unsigned y = 0; y < coarse.height; y++) {
+                unsigned fy0 = y * 2, fy1 = std::min(y * 2 + 1, fine.height - 1);
+
+                for (unsigned x = 0; x < coarse.width; x++) {
+                    unsigned fx0 = x * 2, fx1 = std::min(x * 2 + 1, fine.width - 1);
+
+                    std::size_t i00 = fy0 * fine.width + fx0, i01 = fy0 * fine.width + fx1;
+                    std::size_t i10 = fy1 * fine.width + fx0, i11 = fy1 * fine.width + fx1;
+
+                    coarse.minDepth[y * coarse.width + x] = std::min({ fine.minDepth[i00], fine.minDepth[i01], fine.minDepth[i10], fine.minDepth[i11] });
+                    coarse.maxDepth[y * coarse.width + x] = std::max({ fine.maxDepth[i00], fine.maxDepth[i01], fine.maxDepth[i10], fine.maxDepth[i11] });
+                }
+            }
+        }
+    }
+
+    OcclusionCuller& OcclusionCuller::rasterize() {
+        std::vector<std::size_t> firstTriangle(m_occluders.size() + 1, 0);
+        for (std::size_t i = 0; i < m_occluders.size(); i++)
+            firstTriangle[i + 1] = firstTriangle[i] + m_occluders[i].triangleCount;
+
+        const std::size_t totalTriangles = firstTriangle.back();
+        const std::size_t jobs = m_bins.size();
+
+        // transform, clip and bin: job j takes an equal slice of all occluder triangles
+        m_pool.parallelFor(jobs, [&](std::size_t first, std::size_t last) {
+            for (std::size_t j = first; j < last; j++) {
+                Bin& bin = m_bins[j];
+                bin.triangles.clear();
+                for (auto& tile : bin.tiles)
+                    tile.clear();
+
+                std::size_t begin = totalTriangles * j / jobs, end = totalTriangles * (j + 1) / jobs;
+                std::size_t o = std::upper_bound(firstTriangle.begin(), firstTriangle.end(), begin) - firstTriangle.begin() - 1;
+
+                for (std::size_t t = begin; t < end; t++) {
+                    while (t >= firstTriangle[o + 1])
+                        o++;
+
+                    const Occluder& occluder = m_occluders[o];
+                    const std::uint32_t* tri = occluder.indices + (t - firstTriangle[o]) * 3;
+
+                    glm::vec4 clip[3];
+                    for (int c = 0; c < 3; c++) {
+                        const auto* position = reinterpret_cast<const glm::vec3*>(occluder.vertices + occluder.stride * tri[c]);
+                        clip[c] = occluder.modelViewProjection * glm::vec4{ *position, 1.f };
+                    }
+
+                    // fully behind the near plane
+                    if (clip[0].z < -clip[0].w && clip[1].z < -clip[1].w && clip[2].z < -clip[2].w)
+                        continue;
+
+                    setupTriangle(clip, occluder.twoSided, bin);
+                }
+            }
+        });
+
+        m_rasterizedTriangles = 0;
+        for (const auto& bin : m_bins)
+            m_rasterizedTriangles += bin.triangles.size();
+
+        m_pool.parallelFor(std::size_t(m_tilesX) * m_tilesY, [this](std::size_t first, std::size_t last) {
+            for (std::size_t tile = first; tile < last; tile++)
+                rasterizeTile(static_cast<unsigned>(tile));
+        });
+
+        buildPyramid();
+        return *this;
+    }
+
+    OcclusionCuller::Visibility OcclusionCuller::test(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelViewProjection) const {
+        float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+        float maxX = -minX, maxY = -minX, maxZ = -minX;
+
+        for (int corner = 0; corner < 8; corner++) {
+            glm::vec4 p{
+                (corner & 1) ? boundsMax.x : boundsMin.x,
+                (corner & 2) ? boundsMax.y : boundsMin.y,
+                (corner & 4) ? boundsMax.z : boundsMin.z,
+                1.f
+            };
+            glm::vec4 clip = modelViewProjection * p;
+
+            // crossing the near plane: too close to say anything
+            if (clip.w <= 1e-6f || clip.z < -clip.w)
+                return Visibility::Visible;
+
+            float invW = 1.f / clip.w;
+            float x = (clip.x * invW * .5f + .5f) * m_width;
+            float y = (clip.y * invW * .5f + .5f) * m_height;
+            float z = clip.z * invW * .5f + .5f;
+
+            minX = std::min(minX, x); maxX = std::max(maxX, x);
+            minY = std::min(minY, y); maxY = std::max(maxY, y);
+            minZ = std::min(minZ, z); maxZ = std::max(maxZ, z);
+        }
+
+        if (maxX < .0f || maxY < .0f || minX >= float(m_width) || minY >= float(m_height) || minZ > 1.f)
+            return Visibility::Hidden;
+
+        int x0 = std::max(int(std::floor(minX)), 0), x1 = std::min(int(std::floor(maxX)), int(m_width) - 1);
+        int y0 = std::max(int(std::floor(minY)), 0), y1 = std::min(int(std::floor(maxY)), int(m_height) - 1);
+
+        // coarsest useful level: the rectangle spans at most 4x4 texels there
+        std::size_t level = 0;
+        while (level + 1 < m_levels.size() && (x1 - x0 >= 4 || y1 - y0 >= 4)) {
+            x0 >>= 1; x1 >>= 1;
+            y0 >>= 1; y1 >>= 1;
+            level++;
+        }
+
+        const Level& l = m_levels[level];
+        bool occludedEverywhere = true;
+        bool inFrontEverywhere = true;
+
+        for (int y = y0; y <= y1; y++) {
+            for (int x = x0; x <= x1; x++) {
+                std::size_t i = std::size_t(y) * l.width + x;
+
+                if (minZ < l.maxDepth[i])
+                    occludedEverywhere = false;
+                if (maxZ >= l.minDepth[i])
+                    inFrontEverywhere = false;
+            }
+        }
+
+        if (occludedEverywhere)
+            return Visibility::Hidden;
+
+        return inFrontEverywhere ? Visibility::Unoccluded : Visibility::Visible;
+    }
+}
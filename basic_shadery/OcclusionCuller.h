@@ -0,0 +1,107 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/matrix.hpp>
+#include <glm/vec3.hpp>
+
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+namespace gl
+{
+    // Software occlusion culling against a low resolution depth buffer.
+    //
+    // Each frame: clear(), addOccluder() for a handful of large, simple meshes (walls,
+    // buildings, terrain), rasterize(), then ask isVisible() for the bounds of everything
+    // else before submitting it. Occluder triangles are transformed and binned into
+    // screen tiles in parallel, then every tile is rasterized by a single thread with SSE
+    // edge functions, so no two threads ever write the same depth value. A min/max
+    // depth pyramid built on top keeps the bounds tests to a few texel reads.
+    //
+    // Depth is NDC z remapped to [0, 1], the same as the default GL depth range.
+    class OcclusionCuller {
+    public:
+        enum class Visibility {
+            Hidden,         // behind the occluders, or outside the view
+            Visible,        // at least partly in front of the occluders
+            Unoccluded      // entirely in front of every occluder it overlaps
+        };
+
+        static constexpr unsigned tileSize = 32;
+
+        explicit OcclusionCuller(unsigned width = 256, unsigned height = 128, ThreadPool& pool = ThreadPool::shared());
+
+        OcclusionCuller(const OcclusionCuller&) = delete;
+        OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+        OcclusionCuller& clear();
+
+        // mesh data is referenced, not copied - it has to outlive the next rasterize().
+        // Closed meshes can skip their back faces, open ones (walls, planes) need both sides.
+        OcclusionCuller& addOccluder(const MeshData& mesh, const glm::mat4& modelViewProjection, bool twoSided = false);
+        OcclusionCuller& addOccluder(const std::vector<glm::vec3>& positions, const std::vector<std::uint32_t>& indices, const glm::mat4& modelViewProjection, bool twoSided = false);
+
+        OcclusionCuller& rasterize();
+
+        Visibility test(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelViewProjection) const;
+
+        bool isVisible(const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4& modelViewProjection) const {
+            return test(boundsMin, boundsMax, modelViewProjection) != Visibility::Hidden;
+        }
+
+        unsigned getWidth() const { return m_width; }
+        unsigned getHeight() const { return m_height; }
+
+        // level 0 is the rasterized depth, every next level halves the resolution
+        std::size_t levelCount() const { return m_levels.size(); }
+        const std::vector<float>& getMinDepth(std::size_t level) const { return m_levels[level].minDepth; }
+        const std::vector<float>& getMaxDepth(std::size_t level) const { return m_levels[level].maxDepth; }
+
+        std::size_t triangleCount() const { return m_rasterizedTriangles; }
+
+    private:
+        struct Occluder {
+            const unsigned char* vertices;
+            std::size_t stride;
+            const std::uint32_t* indices;
+            std::size_t triangleCount;
+            glm::mat4 modelViewProjection;
+            bool twoSided;
+        };
+
+        // screen space triangle, counter-clockwise, with depth as a plane
+        struct Triangle {
+            float x[3], y[3];
+            float depthX, depthY, depthC;   // z = depthX * x + depthY * y + depthC
+            int minX, minY, maxX, maxY;     // pixel bounds, inclusive
+        };
+
+        struct Level {
+            unsigned width, height;
+            std::vector<float> minDepth;
+            std::vector<float> maxDepth;
+        };
+
+        // per binning job: triangles it set up and, per tile, which of them touch that tile
+        struct Bin {
+            std::vector<Triangle> triangles;
+            std::vector<std::vector<std::uint32_t>> tiles;
+        };
+
+        void setupTriangle(const glm::vec4 clip[3], bool twoSided, Bin& bin) const;
+        void rasterizeTile(unsigned tile);
+        void buildPyramid();
+
+        unsigned m_width, m_height;
+        unsigned m_tilesX, m_tilesY;
+        ThreadPool& m_pool;
+
+        std::vector<Occluder> m_occluders;
+        std::vector<Bin> m_bins;
+        std::vector<Level> m_levels;
+        std::size_t m_rasterizedTriangles;
+    };
+}
@@ -0,0 +1,216 @@
+﻿#include "ParticleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gl
+{
+    namespace
+    {
+        // the geometry shader outputs captured into the particle buffer, in the buffer's layout
+        const GLchar* const capturedVaryings[] = { "NextPositionAge", "NextVelocityLifetime" };
+
+        void setParticleAttributes(const VertexArray& array, const Program& program, VertexBuffer& particles) {
+            GLsizei stride = static_cast<GLsizei>(ParticleSystem::particleBytes);
+
+            array.bind();
+            particles.bind();
+            array
+                .setAttribute(program.getAttributeLocation("positionAge"), 4, GL_FLOAT, stride, 0)
+                .setAttribute(program.getAttributeLocation("velocityLifetime"), 4, GL_FLOAT, stride, sizeof(glm::vec4));
+        }
+    }
+
+    Program ParticleSystem::buildUpdateProgram() {
+        Shader vertexShader = Shader::fromFile("assets/shaders/particles_update.vert.glsl", ShaderType::Vertex);
+        Shader geometryShader = Shader::fromFile("assets/shaders/particles_update.geom.glsl", ShaderType::Geometry);
+        vertexShader.compile();
+        geometryShader.compile();
+
+        // no fragment shader, the update runs with rasterization off
+        Program program;
+        program
+            .useShader(vertexShader)
+            .useShader(geometryShader)
+            .transformFeedbackVaryings(capturedVaryings, 2)
+            .link();
+
+        return program;
+    }
+
+    ParticleSystem::ParticleSystem(std::size_t capacity, ProgramCache& programs):
+        m_capacity(capacity),
+        m_emitter(),
+        m_gravity(.0f, -9.81f, .0f),
+        m_size(.05f),
+        m_startColor(1.f, .7f, .3f, 1.f),
+        m_endColor(.6f, .1f, .05f, .0f),
+        m_updateProgram(buildUpdateProgram()),
+        m_renderProgram(programs.get("assets/shaders/particles.vert.glsl", "assets/shaders/particles.geom.glsl", "assets/shaders/particles.frag.glsl")),
+        m_generations(),
+        m_emitArray(),
+        m_current(0),
+        m_hasParticles(false),
+        m_pending(0),
+        m_emitCarry(.0f),
+        m_frame(0),
+        m_queries(),
+        m_firstQuery(0),
+        m_queryCount(0),
+        m_aliveCount(0),
+        m_emitting(m_updateProgram.createUniform<GLint>("emitting")),
+        m_seed(m_updateProgram.createUniform<GLuint>("seed")),
+        m_timeStep(m_updateProgram.createUniform<GLfloat>("timeStep")),
+        m_gravityUniform(m_updateProgram.createUniform<glm::vec3>("gravity")),
+        m_emitterPosition(m_updateProgram.createUniform<glm::vec3>("emitterPosition")),
+        m_emitterRadius(m_updateProgram.createUniform<GLfloat>("emitterRadius")),
+        m_emitterVelocity(m_updateProgram.createUniform<glm::vec3>("emitterVelocity")),
+        m_velocitySpread(m_updateProgram.createUniform<GLfloat>("velocitySpread")),
+        m_lifetime(m_updateProgram.createUniform<glm::vec2>("lifetime")),
+        m_view(m_renderProgram.createUniform<glm::mat4>("view")),
+        m_projection(m_renderProgram.createUniform<glm::mat4>("projection")),
+        m_sizeUniform(m_renderProgram.createUniform<GLfloat>("particleSize")),
+        m_startColorUniform(m_renderProgram.createUniform<glm::vec4>("startColor")),
+        m_endColorUniform(m_renderProgram.createUniform<glm::vec4>("endColor"))
+    {
+        for (auto& generation : m_generations) {
+            generation.particles
+                .bind()
+                .upload(nullptr, capacity * particleBytes, VertexBuffer::Usage::Copy);
+
+            glGenTransformFeedbacks(1, &generation.feedback);
+            glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, generation.feedback);
+            glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, generation.particles.getId());
+
+            setParticleAttributes(generation.updateArray, m_updateProgram, generation.particles);
+            setParticleAttributes(generation.renderArray, m_renderProgram, generation.particles);
+        }
+
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+        glBindVertexArray(0);
+
+        glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+    }
+
+    ParticleSystem& ParticleSystem::emit(std::size_t count) {
+        m_pending += count;
+        return *this;
+    }
+
+    ParticleSystem& ParticleSystem::update(float timeStep) {
+        pollAliveCount();
+
+        m_emitCarry += m_emitter.rate * timeStep;
+        float emitted = std::floor(m_emitCarry);
+        m_emitCarry -= emitted;
+
+        // more than the capacity would not be written anyway
+        std::size_t emitCount = std::min(m_pending + static_cast<std::size_t>(emitted), m_capacity);
+        m_pending = 0;
+
+        if (!m_hasParticles && emitCount == 0)
+            return *this;
+
+        Generation& source = m_generations[m_current];
+        Generation& target = m_generations[1 - m_current];
+
+        m_timeStep = timeStep;
+        m_gravityUniform = m_gravity;
+        m_seed = m_frame++;
+        if (emitCount > 0) {
+            m_emitterPosition = m_emitter.position;
+            m_emitterRadius = m_emitter.radius;
+            m_emitterVelocity = m_emitter.velocity;
+            m_velocitySpread = m_emitter.velocitySpread;
+            m_lifetime = m_emitter.lifetime;
+        }
+
+        m_updateProgram.bind();
+        glEnable(GL_RASTERIZER_DISCARD);
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, target.feedback);
+
+        // the count is only read back, an update without a free query still runs
+        bool isCounted = m_queryCount < queryDepth;
+        if (isCounted)
+            glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, m_queries[(m_firstQuery + m_queryCount) % queryDepth]);
+
+        glBeginTransformFeedback(GL_POINTS);
+
+        // survivors first, so that particles past the capacity are the newest ones
+        if (m_hasParticles) {
+            m_emitting = 0;
+            source.updateArray.bind();
+            glDrawTransformFeedback(GL_POINTS, source.feedback);
+        }
+
+        if (emitCount > 0) {
+            m_emitting = 1;
+            m_emitArray.bind();
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(emitCount));
+        }
+
+        glEndTransformFeedback();
+
+        if (isCounted) {
+            glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+            m_queryCount++;
+        }
+
+        glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
+        glDisable(GL_RASTERIZER_DISCARD);
+        glBindVertexArray(0);
+        glUseProgram(0);
+
+        m_current = 1 - m_current;
+        m_hasParticles = true;
+        return *this;
+    }
+
+    ParticleSystem& ParticleSystem::render(const PerspectiveCamera& camera) {
+        if (!m_hasParticles)
+            return *this;
+
+        m_view = camera.getViewMatrix();
+        m_projection = camera.getProjectionMatrix();
+        m_sizeUniform = m_size;
+        m_startColorUniform = m_startColor;
+        m_endColorUniform = m_endColor;
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        glDepthMask(GL_FALSE);
+
+        Generation& current = m_generations[m_current];
+        m_renderProgram.bind();
+        current.renderArray.bind();
+        glDrawTransformFeedback(GL_POINTS, current.feedback);
+
+        glDepthMask(GL_TRUE);
+        glDisable(GL_BLEND);
+        return *this;
+    }
+
+    void ParticleSystem::pollAliveCount() {
+        while (m_queryCount > 0) {
+            GLuint query = m_queries[m_firstQuery];
+
+            GLint isAvailable = GL_FALSE;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (!isAvailable)
+                return;
+
+            GLint written = 0;
+            glGetQueryObjectiv(query, GL_QUERY_RESULT, &written);
+            m_aliveCount = static_cast<std::size_t>(written);
+
+            m_firstQuery = (m_firstQuery + 1) % queryDepth;
+            m_queryCount--;
+        }
+    }
+
+    ParticleSystem::~ParticleSystem() {
+        glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+        for (auto& generation : m_generations)
+            glDeleteTransformFeedbacks(1, &generation.feedback);
+    }
+}
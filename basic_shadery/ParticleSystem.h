@@ -0,0 +1,128 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "PerspectiveCamera.h"
+#include "Program.h"
+#include "ProgramCache.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+namespace gl
+{
+    // Particles simulated and drawn entirely on the GPU, the CPU only ever sees how many to emit.
+    //
+    // The particles live in two buffers used in turns. Every update draws the previous buffer as
+    // points with rasterization off and captures the advanced particles into the other one with
+    // transform feedback; the geometry shader only passes on the particles still alive, so the
+    // dead ones drop out and the live ones stay packed at the front of the buffer. The new
+    // particles are emitted by a second draw into the same capture, appended after the survivors,
+    // and whatever does not fit the capacity is not written. Drawing uses the count GL recorded
+    // for the capture (glDrawTransformFeedback), nothing is read back to size the draws.
+    //
+    // Rendering expands every point in the geometry shader into a quad facing the camera, built
+    // in view space from the camera's matrices, blended additively without writing depth.
+    class ParticleSystem {
+    public:
+        struct Emitter {
+            glm::vec3 position{ .0f, .0f, .0f };
+            float radius = .1f;                     // particles start anywhere in this sphere
+            glm::vec3 velocity{ .0f, 2.f, .0f };
+            float velocitySpread = 1.f;             // random velocity added in any direction, up to this length
+            glm::vec2 lifetime{ 1.f, 3.f };         // seconds, min and max
+            float rate = .0f;                       // particles per second emitted by update()
+        };
+
+        // the particle shaders are loaded through programs, capacity is the most particles alive at once
+        ParticleSystem(std::size_t capacity, ProgramCache& programs);
+
+        ParticleSystem(const ParticleSystem&) = delete;
+        ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+        Emitter& emitter() { return m_emitter; }
+        ParticleSystem& setGravity(const glm::vec3& gravity) { m_gravity = gravity; return *this; }
+        ParticleSystem& setSize(float size) { m_size = size; return *this; }
+        ParticleSystem& setColors(const glm::vec4& start, const glm::vec4& end) { m_startColor = start; m_endColor = end; return *this; }
+
+        // particles emitted by the next update() on top of the emitter's rate
+        ParticleSystem& emit(std::size_t count);
+
+        // advances the particles by timeStep seconds, removes the dead ones and emits new ones.
+        // Leaves rasterization on and no program bound.
+        ParticleSystem& update(float timeStep);
+
+        // draws into the bound framebuffer, leaves blending off and depth writes on
+        ParticleSystem& render(const PerspectiveCamera& camera);
+
+        std::size_t capacity() const { return m_capacity; }
+        // particles alive after an update a few frames back, the count is read without waiting on the GPU
+        std::size_t aliveCount() const { return m_aliveCount; }
+
+        static constexpr std::size_t particleBytes = 2 * sizeof(glm::vec4);
+
+        ~ParticleSystem();
+
+    private:
+        static constexpr std::size_t queryDepth = 4;
+
+        // one of the two particle buffers, with the transform feedback object capturing into it
+        // and the vertex arrays reading it with either program
+        struct Generation {
+            VertexBuffer particles;
+            GLuint feedback = 0;
+            VertexArray updateArray;
+            VertexArray renderArray;
+        };
+
+        static Program buildUpdateProgram();
+        void pollAliveCount();
+
+        std::size_t m_capacity;
+        Emitter m_emitter;
+        glm::vec3 m_gravity;
+        float m_size;
+        glm::vec4 m_startColor;
+        glm::vec4 m_endColor;
+
+        Program m_updateProgram;
+        Program& m_renderProgram;
+
+        std::array<Generation, 2> m_generations;
+        // attribute-less, the emitting draw makes the particles up from gl_VertexID
+        VertexArray m_emitArray;
+        std::size_t m_current;
+        bool m_hasParticles;
+        std::size_t m_pending;
+        float m_emitCarry;
+        std::uint32_t m_frame;
+
+        // GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN of the last updates, oldest first
+        std::array<GLuint, queryDepth> m_queries;
+        std::size_t m_firstQuery, m_queryCount;
+        std::size_t m_aliveCount;
+
+        Uniform<GLint> m_emitting;
+        Uniform<GLuint> m_seed;
+        Uniform<GLfloat> m_timeStep;
+        Uniform<glm::vec3> m_gravityUniform;
+        Uniform<glm::vec3> m_emitterPosition;
+        Uniform<GLfloat> m_emitterRadius;
+        Uniform<glm::vec3> m_emitterVelocity;
+        Uniform<GLfloat> m_velocitySpread;
+        Uniform<glm::vec2> m_lifetime;
+
+        Uniform<glm::mat4> m_view;
+        Uniform<glm::mat4> m_projection;
+        Uniform<GLfloat> m_sizeUniform;
+        Uniform<glm::vec4> m_startColorUniform;
+        Uniform<glm::vec4> m_endColorUniform;
+    };
+}
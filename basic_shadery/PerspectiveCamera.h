@@ -36,6 +36,11 @@ namespace gl
             updateViewMatrix();
         };
 
+        float getFov() const { return m_fov; }
+        float getAspect() const { return m_aspect; }
+        float getNear() const { return m_near; }
+        float getFar() const { return m_far; }
+
         void setFov(float fov) {
             m_fov = fov;
             updateProjectionMatrix();
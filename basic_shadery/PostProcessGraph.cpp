@@ -0,0 +1,333 @@
+﻿#include "PostProcessGraph.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace gl
+{
+    namespace
+    {
+        const char* quadShader = "assets/shaders/quad.vert.glsl";
+        const char* sceneName = "scene";
+
+        bool contains(const std::vector<std::size_t>& values, std::size_t value) {
+            return std::find(values.begin(), values.end(), value) != values.end();
+        }
+    }
+
+    PostProcessGraph::Pass::Pass(Program& program):
+        program(&program),
+        effects(),
+        inputs(),
+        target(0),
+        uvRect(program.createUniform<glm::vec4>("uvRect")),
+        texelSize(program.createUniform<glm::vec2>("texelSize")),
+        uvMax(program.createUniform<glm::vec2>("uvMax"))
+    {
+        program.createUniform<glm::vec4>("rect", { -1.f, -1.f, 1.f, 1.f });
+    }
+
+    PostProcessGraph::PostProcessGraph(GLsizei width, GLsizei height, ProgramCache& programs, Texture::Format format):
+        m_programs(programs),
+        m_width(width),
+        m_height(height),
+        m_format(format),
+        m_effects(),
+        m_output(0),
+        m_isCompiled(false),
+        m_passes(),
+        m_targets(),
+        m_results(),
+        m_quad(),
+        m_uploadedSize(0, 0)
+    {}
+
+    PostProcessGraph& PostProcessGraph::add(const std::string& name, Access access, const std::vector<std::string>& inputs, const std::string& source) {
+        if (name.empty() || name == sceneName || find(name) != sceneInput)
+            throw post_process_exception{ ("Post-processing effect name \"" + name + "\" is reserved or already taken").c_str() };
+        if (inputs.empty())
+            throw post_process_exception{ ("Post-processing effect " + name + " has no inputs").c_str() };
+
+        Effect effect{ name, access, source, {} };
+        for (const auto& input : inputs) {
+            std::size_t index = find(input);
+            if (index == sceneInput && input != sceneName)
+                throw post_process_exception{ ("Post-processing effect " + name + " reads " + input + ", which is not declared before it").c_str() };
+
+            effect.inputs.push_back(index);
+        }
+
+        m_effects.push_back(std::move(effect));
+        m_output = m_effects.size() - 1;
+        m_isCompiled = false;
+        return *this;
+    }
+
+    PostProcessGraph& PostProcessGraph::addFile(const std::string& name, Access access, const std::vector<std::string>& inputs, const char* filename) {
+        ifstream in{ filename };
+        if (!in)
+            throw post_process_exception{ (std::string{ filename } + ": post-processing effect source could not be opened").c_str() };
+
+        return add(name, access, inputs, string{ std::istreambuf_iterator<char>{ in }, {} });
+    }
+
+    PostProcessGraph& PostProcessGraph::setOutput(const std::string& name) {
+        std::size_t index = find(name);
+        if (index == sceneInput)
+            throw post_process_exception{ ("Post-processing output " + name + " is not an effect of the graph").c_str() };
+
+        m_output = index;
+        m_isCompiled = false;
+        return *this;
+    }
+
+    PostProcessGraph& PostProcessGraph::resize(GLsizei width, GLsizei height) {
+        m_width = width;
+        m_height = height;
+
+        for (auto& target : m_targets)
+            target->resize(width, height);
+        return *this;
+    }
+
+    std::size_t PostProcessGraph::find(const std::string& name) const {
+        for (std::size_t i = 0; i < m_effects.size(); i++) {
+            if (m_effects[i].name == name)
+                return i;
+        }
+        return sceneInput;
+    }
+
+    PostProcessGraph& PostProcessGraph::compile() {
+        if (m_effects.empty())
+            throw post_process_exception{ "Post-processing graph has no effects" };
+
+        std::size_t count = m_effects.size();
+
+        // only what the output depends on is evaluated; results that a neighborhood effect
+        // samples around the pixel have to be in a texture, as does the output
+        std::vector<bool> isLive(count, false), isWritten(count, false);
+        isLive[m_output] = isWritten[m_output] = true;
+        for (std::size_t i = m_output + 1; i-- > 0;) {
+            if (!isLive[i])
+                continue;
+
+            for (std::size_t input : m_effects[i].inputs) {
+                if (input == sceneInput)
+                    continue;
+
+                isLive[input] = true;
+                if (m_effects[i].access == Access::Neighborhood)
+                    isWritten[input] = true;
+            }
+        }
+
+        // every other effect is inlined into the pass of its consumers, going from the output
+        // back so that the consumers are placed first; consumers in different passes would each
+        // compute it again, so then it is written out instead
+        std::vector<std::size_t> passOf(count, noTarget);
+        for (std::size_t i = m_output + 1; i-- > 0;) {
+            if (!isLive[i])
+                continue;
+
+            for (std::size_t consumer = i + 1; consumer <= m_output && !isWritten[i]; consumer++) {
+                if (!isLive[consumer] || !contains(m_effects[consumer].inputs, i))
+                    continue;
+
+                if (passOf[i] == noTarget)
+                    passOf[i] = passOf[consumer];
+                else if (passOf[i] != passOf[consumer])
+                    isWritten[i] = true;
+            }
+
+            if (isWritten[i])
+                passOf[i] = i;
+        }
+
+        // a pass only reads results written before it, so ordering the passes by their written
+        // effect keeps every dependency ahead of its use
+        std::vector<std::size_t> roots;
+        std::vector<std::size_t> lastUse(count, 0);
+        m_passes.clear();
+
+        for (std::size_t root = 0; root <= m_output; root++) {
+            if (!isLive[root] || passOf[root] != root)
+                continue;
+
+            std::vector<std::size_t> effects, inputs;
+            for (std::size_t i = 0; i <= root; i++) {
+                if (!isLive[i] || passOf[i] != root)
+                    continue;
+
+                effects.push_back(i);
+                for (std::size_t input : m_effects[i].inputs) {
+                    if ((input == sceneInput || passOf[input] != root) && !contains(inputs, input))
+                        inputs.push_back(input);
+                }
+            }
+
+            for (std::size_t input : inputs) {
+                if (input != sceneInput)
+                    lastUse[input] = m_passes.size();
+            }
+
+            Program& program = m_programs.getGenerated(quadShader, generate(effects, inputs));
+            for (std::size_t unit = 0; unit < inputs.size(); unit++) {
+                std::string sampler = "input_" + (inputs[unit] == sceneInput ? std::string{ sceneName } : m_effects[inputs[unit]].name);
+                program.createUniform<GLint>(sampler.c_str(), static_cast<GLint>(unit));
+            }
+
+            m_passes.emplace_back(program);
+            m_passes.back().effects = std::move(effects);
+            m_passes.back().inputs = std::move(inputs);
+            roots.push_back(root);
+        }
+
+        allocateTargets(lastUse, roots);
+
+        m_uploadedSize = { 0, 0 };
+        m_isCompiled = true;
+        return *this;
+    }
+
+    string PostProcessGraph::generate(const std::vector<std::size_t>& effects, const std::vector<std::size_t>& inputs) const {
+        auto inputName = [this](std::size_t input) {
+            return input == sceneInput ? std::string{ sceneName } : m_effects[input].name;
+        };
+
+        std::ostringstream source;
+        source << "#version 150 core\n\n"
+            << "// generated by PostProcessGraph\n\n"
+            << "in vec2 uv;\n"
+            << "out vec4 outColor;\n\n"
+            << "uniform vec2 texelSize;\n"
+            << "uniform vec2 uvMax;\n"
+            << "uniform vec4 uvRect;\n";
+
+        for (std::size_t input : inputs)
+            source << "uniform sampler2D input_" << inputName(input) << ";\n";
+
+        source << "\nvec4 fetch(sampler2D image, vec2 at) {\n"
+            << "    return texture(image, clamp(at, 0.5*texelSize, uvMax));\n"
+            << "}\n\n"
+            << "vec2 screenPosition(vec2 at) {\n"
+            << "    return (at - uvRect.xy)/(uvRect.zw - uvRect.xy);\n"
+            << "}\n";
+
+        for (std::size_t effect : effects)
+            source << "\n// " << m_effects[effect].name << "\n" << m_effects[effect].source << "\n";
+
+        source << "\nvoid main() {\n";
+
+        // textures read at the pixel are fetched once, however many effects use them
+        for (std::size_t input : inputs) {
+            bool isReadPerPixel = false;
+            for (std::size_t effect : effects)
+                isReadPerPixel |= m_effects[effect].access == Access::PerPixel && contains(m_effects[effect].inputs, input);
+
+            if (isReadPerPixel)
+                source << "    vec4 value_" << inputName(input) << " = texture(input_" << inputName(input) << ", uv);\n";
+        }
+
+        for (std::size_t effect : effects) {
+            const Effect& e = m_effects[effect];
+            source << "    vec4 value_" << e.name << " = " << e.name << "(";
+
+            for (std::size_t input : e.inputs)
+                source << (e.access == Access::PerPixel ? "value_" : "input_") << inputName(input) << ", ";
+
+            source << "uv);\n";
+        }
+
+        source << "    outColor = value_" << m_effects[effects.back()].name << ";\n"
+            << "}\n";
+
+        return source.str();
+    }
+
+    void PostProcessGraph::allocateTargets(const std::vector<std::size_t>& lastUse, const std::vector<std::size_t>& roots) {
+        m_results.assign(m_effects.size(), noTarget);
+
+        std::vector<std::size_t> available;
+        std::size_t used = 0;
+
+        for (std::size_t i = 0; i < m_passes.size(); i++) {
+            Pass& pass = m_passes[i];
+
+            if (roots[i] == m_output) {
+                pass.target = noTarget;
+            } else if (available.empty()) {
+                pass.target = used++;
+            } else {
+                pass.target = available.back();
+                available.pop_back();
+            }
+
+            if (pass.target != noTarget)
+                m_results[roots[i]] = pass.target;
+
+            // a texture is free for the passes after its last reader, never for the pass reading it
+            for (std::size_t input : pass.inputs) {
+                if (input != sceneInput && lastUse[input] == i)
+                    available.push_back(m_results[input]);
+            }
+        }
+
+        // targets are kept across recompiles, only missing ones are created
+        while (m_targets.size() < used)
+            m_targets.push_back(std::make_unique<RenderTarget>(m_width, m_height, m_format, false));
+        m_targets.resize(used);
+    }
+
+    void PostProcessGraph::apply(Texture& scene, const glm::ivec2& size) {
+        if (!m_isCompiled)
+            compile();
+
+        GLint output = 0, viewport[4] = {};
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &output);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+
+        GLboolean depthTest = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        glm::vec2 textureSize{ static_cast<float>(m_width), static_cast<float>(m_height) };
+        glm::vec2 uvSize = glm::vec2{ static_cast<float>(size.x), static_cast<float>(size.y) } / textureSize;
+        glm::vec4 uvRect{ .0f, .0f, uvSize.x, uvSize.y };
+        // the last texel center inside the region, neighborhood reads past it would see what was not drawn
+        glm::vec2 uvMax = uvSize - .5f / textureSize;
+
+        m_quad.bind();
+
+        for (auto& pass : m_passes) {
+            if (pass.target == noTarget) {
+                glBindFramebuffer(GL_FRAMEBUFFER, output);
+                glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+            } else {
+                m_targets[pass.target]->bind(size.x, size.y);
+            }
+
+            pass.program->bind();
+            for (std::size_t unit = 0; unit < pass.inputs.size(); unit++) {
+                std::size_t input = pass.inputs[unit];
+                glActiveTexture(GL_TEXTURE0 + static_cast<GLenum>(unit));
+                (input == sceneInput ? scene : m_targets[m_results[input]]->color()).bind();
+            }
+
+            // only sent when the size changed, most frames keep it
+            if (size != m_uploadedSize) {
+                pass.uvRect = uvRect;
+                pass.uvMax = uvMax;
+                pass.texelSize = 1.f / textureSize;
+            }
+
+            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        }
+
+        m_uploadedSize = size;
+        glActiveTexture(GL_TEXTURE0);
+        if (depthTest)
+            glEnable(GL_DEPTH_TEST);
+    }
+}
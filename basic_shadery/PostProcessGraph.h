@@ -0,0 +1,135 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "exceptions.h"
+#include "Program.h"
+#include "ProgramCache.h"
+#include "RenderTarget.h"
+#include "Texture.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+
+namespace gl
+{
+    class post_process_exception : public exception {
+        using super = exception;
+    public:
+        post_process_exception(): super() {}
+        post_process_exception(const char* message): super(message) {}
+        post_process_exception(const char* message, int code): super(message, code) {}
+    };
+
+    // Full screen effects applied to a rendered scene, declared as GLSL snippets with named
+    // inputs ("scene" or earlier effects). The snippet of an effect called name defines
+    //
+    //     vec4 name(vec4 input..., vec2 uv)          for a PerPixel effect
+    //     vec4 name(sampler2D input..., vec2 uv)     for a Neighborhood effect
+    //
+    // with the inputs in the declared order. Neighborhood effects sample their inputs with
+    // fetch(input, uv), which keeps the reads inside the rendered region. Every snippet can use
+    // texelSize and screenPosition(uv), 0 to 1 over the output; anything else a snippet declares
+    // must not clash with what the others do.
+    //
+    // Compiling the graph merges effects into as few passes as it can: a per-pixel effect is
+    // evaluated inside the shader of the effect that consumes it, so a chain of them costs one
+    // full screen pass. Results are written to a texture only where a neighborhood effect reads
+    // them or effects from different passes need them, and those textures are shared by
+    // results whose lifetimes do not overlap.
+    class PostProcessGraph {
+    public:
+        enum class Access {
+            PerPixel,
+            Neighborhood
+        };
+
+        // intermediate results are width x height textures of the given format
+        PostProcessGraph(GLsizei width, GLsizei height, ProgramCache& programs, Texture::Format format = Texture::Format::RGBA16F);
+
+        PostProcessGraph(const PostProcessGraph&) = delete;
+        PostProcessGraph& operator=(const PostProcessGraph&) = delete;
+
+        PostProcessGraph& add(const std::string& name, Access access, const std::vector<std::string>& inputs, const std::string& source);
+        PostProcessGraph& addFile(const std::string& name, Access access, const std::vector<std::string>& inputs, const char* filename);
+        // the effect written to the output, the last one added by default
+        PostProcessGraph& setOutput(const std::string& name);
+
+        PostProcessGraph& resize(GLsizei width, GLsizei height);
+
+        // sets a uniform declared by the snippets in every pass that has it, meant for parameters
+        // that change now and then; the graph has to be compiled
+        template<typename T>
+        PostProcessGraph& setUniform(const char* name, const T& value) {
+            for (auto& pass : m_passes) {
+                if (pass.program->hasUniform(name))
+                    pass.program->createUniform<T>(name, value);
+            }
+            return *this;
+        }
+
+        // merges the effects into passes and builds their shaders, apply() does it when needed
+        PostProcessGraph& compile();
+
+        // runs the effects on the lower left size pixels of scene (the size the graph was created
+        // with), the output goes to the bound draw framebuffer and viewport
+        void apply(Texture& scene, const glm::ivec2& size);
+
+        std::size_t passCount() const { return m_passes.size(); }
+        std::size_t textureCount() const { return m_targets.size(); }
+
+    private:
+        struct Effect {
+            std::string name;
+            Access access;
+            std::string source;
+            // indices of earlier effects, sceneInput for the scene
+            std::vector<std::size_t> inputs;
+        };
+
+        struct Pass {
+            explicit Pass(Program& program);
+
+            Program* program;
+            // effects evaluated in the pass, in the order they were added, the last one is written out
+            std::vector<std::size_t> effects;
+            // results sampled from textures, bound to consecutive units
+            std::vector<std::size_t> inputs;
+            // index into m_targets, noTarget for the output
+            std::size_t target;
+
+            Uniform<glm::vec4> uvRect;
+            Uniform<glm::vec2> texelSize;
+            Uniform<glm::vec2> uvMax;
+        };
+
+        static const std::size_t sceneInput = static_cast<std::size_t>(-1);
+        static const std::size_t noTarget = static_cast<std::size_t>(-1);
+
+        std::size_t find(const std::string& name) const;
+        string generate(const std::vector<std::size_t>& effects, const std::vector<std::size_t>& inputs) const;
+        void allocateTargets(const std::vector<std::size_t>& lastUse, const std::vector<std::size_t>& roots);
+
+        ProgramCache& m_programs;
+        GLsizei m_width, m_height;
+        Texture::Format m_format;
+
+        std::vector<Effect> m_effects;
+        std::size_t m_output;
+        bool m_isCompiled;
+
+        std::vector<Pass> m_passes;
+        std::vector<std::unique_ptr<RenderTarget>> m_targets;
+        // render target holding each effect's result, noTarget where it is not written out
+        std::vector<std::size_t> m_results;
+
+        VertexArray m_quad;
+        glm::ivec2 m_uploadedSize;
+    };
+}
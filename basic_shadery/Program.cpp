@@ -4,10 +4,12 @@ gl::Program& gl::Program::link() {
     glLinkProgram(m_programId);
 
     GLint hasLinked;
-    glGetProgramiv(m_programId, GL_COMPILE_STATUS, &hasLinked);
+    glGetProgramiv(m_programId, GL_LINK_STATUS, &hasLinked);
 
-    if (hasLinked)
+    if (hasLinked) {
+        m_reflection.reflect(m_programId);
         return *this;
+    }
 
     GLint log_length;
     glGetProgramiv(m_programId, GL_INFO_LOG_LENGTH, &log_length);
@@ -19,3 +21,16 @@ gl::Program& gl::Program::link() {
 
     throw program_link_exception{ buffer };
 };
+
+GLint gl::Program::uniformLocation(std::uint64_t nameHash, const GLchar* name, GLenum expectedType) const {
+    const ReflectedVariable* uniform = m_reflection.uniform(nameHash);
+    if (!uniform)
+        return -1;
+
+    if (!isUniformTypeCompatible(uniform->type, expectedType)) {
+        std::string message = std::string{ "Uniform " } + name + " is declared as " + glTypeName(uniform->type) + ", not " + glTypeName(expectedType);
+        throw uniform_type_exception{ message };
+    }
+
+    return uniform->location;
+}
@@ -1,7 +1,11 @@
 ﻿#pragma once
 
-#include <GL/glew.h>
+#include <string_view>
 
+#include "GlDispatch.h"
+
+#include "hash.h"
+#include "ProgramReflection.h"
 #include "Shader.h"
 #include "exceptions.h"
 
@@ -25,19 +29,38 @@ namespace gl
         }
     };
 
+    class uniform_type_exception : public exception {
+        using super = exception;
+        string message;
+
+    public:
+        uniform_type_exception(): message(), super() {}
+        uniform_type_exception(std::string& mess): message(std::move(mess)), super(mess.c_str()) {}
+        uniform_type_exception(const char* message): message(message), super(message) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Uniform and attribute locations come from the reflection taken in link(), so creating
+    // uniforms and looking up attributes does not call GL; names the program has no active
+    // variable for get -1 as from GL.
     class Program {
     public:
-        Program(): m_programId(glCreateProgram()) {};
+        Program(): m_programId(glCreateProgram()), m_reflection() {};
 
         Program(const Program&) = delete;
         Program& operator=(const Program&) = delete;
 
-        Program(Program&& other) noexcept: m_programId(0) {
+        Program(Program&& other) noexcept: m_programId(0), m_reflection() {
             std::swap(m_programId, other.m_programId);
+            std::swap(m_reflection, other.m_reflection);
         }
         Program& operator=(Program&& other) noexcept {
             if (this != &other) {
                 std::swap(m_programId, other.m_programId);
+                std::swap(m_reflection, other.m_reflection);
             }
             return *this;
         }
@@ -47,6 +70,12 @@ namespace gl
             return *this;
         };
 
+        // outputs captured by transform feedback, takes effect on the next link()
+        Program& transformFeedbackVaryings(const GLchar* const* names, GLsizei count, GLenum bufferMode = GL_INTERLEAVED_ATTRIBS) {
+            glTransformFeedbackVaryings(m_programId, count, names, bufferMode);
+            return *this;
+        };
+
         Program& useShader(const Shader& shader) {
             glAttachShader(m_programId, shader.m_shaderId);
             return *this;
@@ -59,10 +88,17 @@ namespace gl
             return *this;
         };
 
-        GLint getAttributeLocation(const GLchar* name) {
-            return glGetAttribLocation(m_programId, name);
+        GLint getAttributeLocation(const GLchar* name) const {
+            const ReflectedVariable* attribute = m_reflection.attribute(fnv1a(name));
+            return attribute ? attribute->location : -1;
         }
 
+        bool hasUniform(const GLchar* name) const {
+            return m_reflection.uniform(fnv1a(name)) != nullptr;
+        }
+
+        const ProgramReflection& reflection() const { return m_reflection; }
+
         ~Program() {
             glDeleteProgram(m_programId);
         };
@@ -78,7 +114,11 @@ namespace gl
         };
 
     private:
+        // -1 for names without an active uniform, throws uniform_type_exception when the declared type is not expectedType
+        GLint uniformLocation(std::uint64_t nameHash, const GLchar* name, GLenum expectedType) const;
+
         GLuint m_programId;
+        ProgramReflection m_reflection;
 
         template<typename>
         friend class Uniform;
@@ -0,0 +1,89 @@
+﻿#include "ProgramCache.h"
+
+#include "hash.h"
+
+namespace gl
+{
+    namespace
+    {
+        std::uint64_t hashDefines(const ShaderDefines& defines, std::uint64_t hash) {
+            for (const auto& [name, value] : defines) {
+                hash = fnv1a(name, hash);
+                hash = fnv1a("=", hash);
+                hash = fnv1a(value, hash);
+                hash = fnv1a(";", hash);
+            }
+            return hash;
+        }
+    }
+
+    const Shader& ProgramCache::shader(const char* filename, ShaderType type, const ShaderDefines& defines, std::uint64_t& hash) {
+        return compiled(m_preprocessor.process(filename, defines), type, hash);
+    }
+
+    const Shader& ProgramCache::compiled(const string& source, ShaderType type, std::uint64_t& hash) {
+        hash = hashCombine(fnv1a(source), static_cast<std::uint64_t>(type));
+
+        auto it = m_shaders.find(hash);
+        if (it != m_shaders.end())
+            return it->second;
+
+        Shader created = Shader::fromSource(source, type);
+        created.compile();
+
+        return m_shaders.emplace(hash, std::move(created)).first->second;
+    }
+
+    Program& ProgramCache::get(const char* vertexFile, const char* geometryFile, const char* fragmentFile, const ShaderDefines& defines) {
+        std::uint64_t variant = fnv1a(vertexFile);
+        variant = fnv1a(geometryFile ? geometryFile : "", hashCombine(variant, 1));
+        variant = fnv1a(fragmentFile, hashCombine(variant, 2));
+        variant = hashDefines(defines, variant);
+
+        auto found = m_variants.find(variant);
+        if (found != m_variants.end())
+            return *found->second;
+
+        std::uint64_t vertexHash, geometryHash = 0, fragmentHash;
+        const Shader& vertexShader = shader(vertexFile, ShaderType::Vertex, defines, vertexHash);
+        const Shader* geometryShader = geometryFile ? &shader(geometryFile, ShaderType::Geometry, defines, geometryHash) : nullptr;
+        const Shader& fragmentShader = shader(fragmentFile, ShaderType::Fragment, defines, fragmentHash);
+
+        std::uint64_t key = hashCombine(hashCombine(vertexHash, geometryHash), fragmentHash);
+
+        Program& program = linked(vertexShader, geometryShader, fragmentShader, key);
+        m_variants.emplace(variant, &program);
+        return program;
+    }
+
+    Program& ProgramCache::getGenerated(const char* vertexFile, const string& fragmentSource) {
+        std::uint64_t vertexHash, fragmentHash;
+        const Shader& vertexShader = shader(vertexFile, ShaderType::Vertex, {}, vertexHash);
+        const Shader& fragmentShader = compiled(fragmentSource, ShaderType::Fragment, fragmentHash);
+
+        return linked(vertexShader, nullptr, fragmentShader, hashCombine(hashCombine(vertexHash, 0), fragmentHash));
+    }
+
+    Program& ProgramCache::linked(const Shader& vertexShader, const Shader* geometryShader, const Shader& fragmentShader, std::uint64_t key) {
+        auto it = m_programs.find(key);
+        if (it != m_programs.end())
+            return *it->second;
+
+        auto prog = std::make_unique<Program>();
+        prog->useShader(vertexShader);
+        if (geometryShader)
+            prog->useShader(*geometryShader);
+
+        prog->useShader(fragmentShader)
+            .bindFragDataLocation(0, "outColor")
+            .link();
+
+        return *m_programs.emplace(key, std::move(prog)).first->second;
+    }
+
+    void ProgramCache::clear() {
+        m_variants.clear();
+        m_programs.clear();
+        m_shaders.clear();
+    }
+}
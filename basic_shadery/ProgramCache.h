@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+#include "Program.h"
+#include "Shader.h"
+#include "ShaderPreprocessor.h"
+
+namespace gl
+{
+    // Owns compiled shader variants and linked programs. Variants are keyed by a hash of
+    // their preprocessed source (so of the file contents and the injected defines), so
+    // identical variants are compiled and linked only once. Returned references stay valid
+    // for the lifetime of the cache.
+    class ProgramCache {
+    public:
+        ProgramCache(): m_preprocessor(), m_shaders(), m_programs(), m_variants() {}
+
+        ProgramCache(const ProgramCache&) = delete;
+        ProgramCache& operator=(const ProgramCache&) = delete;
+
+        ShaderPreprocessor& preprocessor() { return m_preprocessor; }
+
+        // pass nullptr as the geometry file to build a vertex + fragment program
+        Program& get(const char* vertexFile, const char* geometryFile, const char* fragmentFile, const ShaderDefines& defines = {});
+
+        Program& get(const char* vertexFile, const char* fragmentFile, const ShaderDefines& defines = {}) {
+            return get(vertexFile, nullptr, fragmentFile, defines);
+        }
+
+        // fragment shader source built at run time, e.g. by PostProcessGraph, cached by its hash like the rest
+        Program& getGenerated(const char* vertexFile, const string& fragmentSource);
+
+        std::size_t programCount() const { return m_programs.size(); }
+        std::size_t shaderCount() const { return m_shaders.size(); }
+
+        void clear();
+
+    private:
+        const Shader& shader(const char* filename, ShaderType type, const ShaderDefines& defines, std::uint64_t& hash);
+        const Shader& compiled(const string& source, ShaderType type, std::uint64_t& hash);
+        Program& linked(const Shader& vertexShader, const Shader* geometryShader, const Shader& fragmentShader, std::uint64_t key);
+
+        ShaderPreprocessor m_preprocessor;
+
+        std::unordered_map<std::uint64_t, Shader> m_shaders;
+        std::unordered_map<std::uint64_t, std::unique_ptr<Program>> m_programs;
+        // (file names, defines) -> program, lets repeated lookups skip reading the sources
+        std::unordered_map<std::uint64_t, Program*> m_variants;
+    };
+}
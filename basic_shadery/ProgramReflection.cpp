@@ -0,0 +1,204 @@
+﻿#include "ProgramReflection.h"
+
+#include <utility>
+
+namespace gl
+{
+    namespace
+    {
+        template<typename T>
+        using NamedEntries = std::vector<std::pair<std::string, T>>;
+
+        bool isArrayElement(const std::string& name, std::string& base) {
+            if (name.size() < 3 || name.compare(name.size() - 3, 3, "[0]") != 0)
+                return false;
+
+            base = name.substr(0, name.size() - 3);
+            return true;
+        }
+
+        bool isSampler(GLenum type) {
+            switch (type) {
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_1D_SHADOW:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_1D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_1D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_SAMPLER_BUFFER:
+            case GL_SAMPLER_2D_RECT:
+            case GL_SAMPLER_2D_RECT_SHADOW:
+            case GL_INT_SAMPLER_1D:
+            case GL_INT_SAMPLER_2D:
+            case GL_INT_SAMPLER_3D:
+            case GL_INT_SAMPLER_CUBE:
+            case GL_INT_SAMPLER_1D_ARRAY:
+            case GL_INT_SAMPLER_2D_ARRAY:
+            case GL_INT_SAMPLER_BUFFER:
+            case GL_UNSIGNED_INT_SAMPLER_1D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_3D:
+            case GL_UNSIGNED_INT_SAMPLER_CUBE:
+            case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // bvecN of the same size as an ivecN or uvecN, GL_NONE for other types
+        GLenum boolType(GLenum type) {
+            switch (type) {
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+                return GL_BOOL;
+            case GL_INT_VEC2:
+            case GL_UNSIGNED_INT_VEC2:
+                return GL_BOOL_VEC2;
+            case GL_INT_VEC3:
+            case GL_UNSIGNED_INT_VEC3:
+                return GL_BOOL_VEC3;
+            case GL_INT_VEC4:
+            case GL_UNSIGNED_INT_VEC4:
+                return GL_BOOL_VEC4;
+            default:
+                return GL_NONE;
+            }
+        }
+    }
+
+    void ProgramReflection::reflect(GLuint program) {
+        GLint count = 0, maxLength = 0;
+        std::string name;
+
+        NamedEntries<ReflectedVariable> uniforms;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        name.resize(maxLength);
+
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            ReflectedVariable uniform{ -1, GL_NONE, 0 };
+            glGetActiveUniform(program, i, maxLength, &length, &uniform.size, &uniform.type, name.data());
+
+            std::string uniformName{ name.data(), static_cast<std::size_t>(length) };
+            uniform.location = glGetUniformLocation(program, uniformName.c_str());
+            // members of uniform blocks have no location
+            if (uniform.location < 0)
+                continue;
+
+            uniforms.emplace_back(uniformName, uniform);
+
+            std::string base;
+            if (!isArrayElement(uniformName, base))
+                continue;
+
+            // elements past the first are looked up once here, so that indexing never asks GL
+            uniforms.emplace_back(base, uniform);
+            for (GLint element = 1; element < uniform.size; element++) {
+                std::string elementName = base + "[" + std::to_string(element) + "]";
+                ReflectedVariable rest{ glGetUniformLocation(program, elementName.c_str()), uniform.type, uniform.size - element };
+                uniforms.emplace_back(std::move(elementName), rest);
+            }
+        }
+
+        m_uniforms.reset(uniforms.size());
+        for (const auto& [uniformName, uniform] : uniforms)
+            m_uniforms.insert(fnv1a(uniformName), uniform);
+
+        NamedEntries<ReflectedVariable> attributes;
+        glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+        glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+        name.resize(maxLength);
+
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            ReflectedVariable attribute{ -1, GL_NONE, 0 };
+            glGetActiveAttrib(program, i, maxLength, &length, &attribute.size, &attribute.type, name.data());
+
+            std::string attributeName{ name.data(), static_cast<std::size_t>(length) };
+            attribute.location = glGetAttribLocation(program, attributeName.c_str());
+            // built-in inputs like gl_VertexID are listed by some drivers
+            if (attribute.location >= 0)
+                attributes.emplace_back(std::move(attributeName), attribute);
+        }
+
+        m_attributes.reset(attributes.size());
+        for (const auto& [attributeName, attribute] : attributes)
+            m_attributes.insert(fnv1a(attributeName), attribute);
+
+        NamedEntries<ReflectedBlock> blocks;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+        name.resize(maxLength);
+
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            ReflectedBlock block{ static_cast<GLuint>(i), 0, 0 };
+            glGetActiveUniformBlockName(program, block.index, maxLength, &length, name.data());
+            glGetActiveUniformBlockiv(program, block.index, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+            glGetActiveUniformBlockiv(program, block.index, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+
+            std::string blockName{ name.data(), static_cast<std::size_t>(length) };
+            std::string base;
+            if (isArrayElement(blockName, base))
+                blocks.emplace_back(base, block);
+            blocks.emplace_back(std::move(blockName), block);
+        }
+
+        m_blocks.reset(blocks.size());
+        for (const auto& [blockName, block] : blocks)
+            m_blocks.insert(fnv1a(blockName), block);
+    }
+
+    bool isUniformTypeCompatible(GLenum declared, GLenum expected) {
+        if (declared == expected)
+            return true;
+
+        // samplers are set with glUniform1i, booleans with any of the integer variants
+        if (expected == GL_INT && isSampler(declared))
+            return true;
+
+        return declared != GL_NONE && declared == boolType(expected);
+    }
+
+    const char* glTypeName(GLenum type) {
+        switch (type) {
+        case GL_FLOAT: return "float";
+        case GL_FLOAT_VEC2: return "vec2";
+        case GL_FLOAT_VEC3: return "vec3";
+        case GL_FLOAT_VEC4: return "vec4";
+        case GL_INT: return "int";
+        case GL_INT_VEC2: return "ivec2";
+        case GL_INT_VEC3: return "ivec3";
+        case GL_INT_VEC4: return "ivec4";
+        case GL_UNSIGNED_INT: return "uint";
+        case GL_UNSIGNED_INT_VEC2: return "uvec2";
+        case GL_UNSIGNED_INT_VEC3: return "uvec3";
+        case GL_UNSIGNED_INT_VEC4: return "uvec4";
+        case GL_BOOL: return "bool";
+        case GL_BOOL_VEC2: return "bvec2";
+        case GL_BOOL_VEC3: return "bvec3";
+        case GL_BOOL_VEC4: return "bvec4";
+        case GL_FLOAT_MAT2: return "mat2";
+        case GL_FLOAT_MAT2x3: return "mat2x3";
+        case GL_FLOAT_MAT2x4: return "mat2x4";
+        case GL_FLOAT_MAT3: return "mat3";
+        case GL_FLOAT_MAT3x2: return "mat3x2";
+        case GL_FLOAT_MAT3x4: return "mat3x4";
+        case GL_FLOAT_MAT4: return "mat4";
+        case GL_FLOAT_MAT4x2: return "mat4x2";
+        case GL_FLOAT_MAT4x3: return "mat4x3";
+        default: return isSampler(type) ? "sampler" : "unknown type";
+        }
+    }
+}
@@ -0,0 +1,119 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "GlDispatch.h"
+
+#include "hash.h"
+
+namespace gl
+{
+    // active uniform or vertex attribute, size is the array length (1 for plain variables)
+    struct ReflectedVariable {
+        GLint location;
+        GLenum type;
+        GLint size;
+    };
+
+    struct ReflectedBlock {
+        GLuint index;
+        GLint dataSize;
+        GLint binding;
+    };
+
+    // Active uniforms, uniform blocks and vertex attributes of a linked program, queried once
+    // and kept in flat open-addressing tables keyed by the FNV-1a hash of the name. Lookups are
+    // a probe or two and no GL calls, and names known at compile time hash to constants.
+    // Array uniforms are found by their plain name, as name[0] and as name[i] for every element.
+    // Uniforms inside blocks are only reachable through their block.
+    class ProgramReflection {
+    public:
+        ProgramReflection(): m_uniforms(), m_attributes(), m_blocks() {}
+
+        // replaces the tables with the program's interface, the program must be linked
+        void reflect(GLuint program);
+
+        // nullptr for names the program does not have as active variables
+        const ReflectedVariable* uniform(std::uint64_t nameHash) const { return m_uniforms.find(nameHash); }
+        const ReflectedVariable* attribute(std::uint64_t nameHash) const { return m_attributes.find(nameHash); }
+        const ReflectedBlock* uniformBlock(std::uint64_t nameHash) const { return m_blocks.find(nameHash); }
+
+        std::size_t uniformCount() const { return m_uniforms.size(); }
+        std::size_t attributeCount() const { return m_attributes.size(); }
+        std::size_t uniformBlockCount() const { return m_blocks.size(); }
+
+    private:
+        template<typename T>
+        class Table {
+        public:
+            Table(): m_slots(), m_size(0) {}
+
+            // capacity is the number of entries the table will get, it never grows past it
+            void reset(std::size_t capacity);
+            void insert(std::uint64_t hash, const T& value);
+            const T* find(std::uint64_t hash) const;
+
+            std::size_t size() const { return m_size; }
+
+        private:
+            struct Slot {
+                std::uint64_t hash;
+                T value;
+                bool isUsed;
+            };
+
+            std::vector<Slot> m_slots;
+            std::size_t m_size;
+        };
+
+        Table<ReflectedVariable> m_uniforms;
+        Table<ReflectedVariable> m_attributes;
+        Table<ReflectedBlock> m_blocks;
+    };
+
+    // whether a uniform declared with the type can be set as expected, e.g. samplers with an int
+    bool isUniformTypeCompatible(GLenum declared, GLenum expected);
+    // name of a GL type for messages, e.g. "vec3" for GL_FLOAT_VEC3
+    const char* glTypeName(GLenum type);
+
+    template<typename T>
+    void ProgramReflection::Table<T>::reset(std::size_t capacity) {
+        // power of two at least twice the entries, probe sequences stay short
+        std::size_t slots = 8;
+        while (slots < capacity * 2)
+            slots *= 2;
+
+        m_slots.assign(slots, Slot{ 0, T{}, false });
+        m_size = 0;
+    }
+
+    template<typename T>
+    void ProgramReflection::Table<T>::insert(std::uint64_t hash, const T& value) {
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = m_slots[i];
+            if (slot.isUsed && slot.hash != hash)
+                continue;
+
+            m_size += slot.isUsed ? 0 : 1;
+            slot = Slot{ hash, value, true };
+            return;
+        }
+    }
+
+    template<typename T>
+    const T* ProgramReflection::Table<T>::find(std::uint64_t hash) const {
+        if (m_slots.empty())
+            return nullptr;
+
+        std::size_t mask = m_slots.size() - 1;
+        for (std::size_t i = hash & mask; m_slots[i].isUsed; i = (i + 1) & mask) {
+            if (m_slots[i].hash == hash)
+                return &m_slots[i].value;
+        }
+        return nullptr;
+    }
+}
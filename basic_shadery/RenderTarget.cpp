@@ -0,0 +1,62 @@
+﻿#include "RenderTarget.h"
+
+namespace gl
+{
+    RenderTarget::RenderTarget(GLsizei width, GLsizei height, Texture::Format colorFormat, bool hasDepth):
+        m_framebuffer(),
+        m_color(),
+        m_depth(),
+        m_colorFormat(colorFormat),
+        m_hasDepth(hasDepth),
+        m_width(0),
+        m_height(0)
+    {
+        m_color.bind()
+            .setWrapping(Texture::Wrap::ClampToEdge)
+            .setMinFilter(Texture::MinFilter::Linear)
+            .setMagFilter(Texture::MagFilter::Linear);
+
+        if (m_hasDepth) {
+            m_depth.bind()
+                .setWrapping(Texture::Wrap::ClampToEdge)
+                .setMinFilter(Texture::MinFilter::Nearest)
+                .setMagFilter(Texture::MagFilter::Nearest);
+        }
+
+        resize(width, height);
+    }
+
+    RenderTarget& RenderTarget::resize(GLsizei width, GLsizei height) {
+        if (width == m_width && height == m_height)
+            return *this;
+
+        m_width = width;
+        m_height = height;
+
+        m_color.bind().allocate(m_width, m_height, m_colorFormat);
+        if (m_hasDepth)
+            m_depth.bind().allocate(m_width, m_height, Texture::Format::Depth24);
+
+        m_framebuffer.bind().attachColor(m_color);
+        if (m_hasDepth)
+            m_framebuffer.attachDepth(m_depth);
+        m_framebuffer.checkStatus();
+        Framebuffer::unbind();
+
+        return *this;
+    }
+
+    RenderTarget& RenderTarget::bind() {
+        return bind(m_width, m_height);
+    }
+
+    RenderTarget& RenderTarget::bind(GLsizei width, GLsizei height) {
+        m_framebuffer.bind();
+        glViewport(0, 0, width, height);
+        return *this;
+    }
+
+    void RenderTarget::blitToWindow(const glm::ivec2& sourceSize, const glm::ivec2& windowSize, GLenum filter) const {
+        m_framebuffer.blit(0, { 0, 0, sourceSize.x, sourceSize.y }, { 0, 0, windowSize.x, windowSize.y }, GL_COLOR_BUFFER_BIT, filter);
+    }
+}
@@ -0,0 +1,46 @@
+﻿#pragma once
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+
+#include "Framebuffer.h"
+#include "Texture.h"
+
+namespace gl
+{
+    // Framebuffer with its own color texture and optionally a depth texture, for rendering
+    // off screen and then sampling or blitting the result.
+    class RenderTarget {
+    public:
+        RenderTarget(GLsizei width, GLsizei height, Texture::Format colorFormat = Texture::Format::RGBA8, bool hasDepth = true);
+
+        RenderTarget(const RenderTarget&) = delete;
+        RenderTarget& operator=(const RenderTarget&) = delete;
+
+        // reallocates the attachments, only if the size changes
+        RenderTarget& resize(GLsizei width, GLsizei height);
+
+        // binds the framebuffer with the viewport over all of it
+        RenderTarget& bind();
+        // binds the framebuffer with the viewport over its lower left width x height pixels
+        RenderTarget& bind(GLsizei width, GLsizei height);
+
+        // copies the lower left sourceSize pixels to the window, stretched over windowSize
+        void blitToWindow(const glm::ivec2& sourceSize, const glm::ivec2& windowSize, GLenum filter = GL_LINEAR) const;
+
+        Texture& color() { return m_color; }
+        Framebuffer& framebuffer() { return m_framebuffer; }
+
+        GLsizei width() const { return m_width; }
+        GLsizei height() const { return m_height; }
+
+    private:
+        Framebuffer m_framebuffer;
+        Texture m_color;
+        Texture m_depth;
+        Texture::Format m_colorFormat;
+        bool m_hasDepth;
+        GLsizei m_width;
+        GLsizei m_height;
+    };
+}
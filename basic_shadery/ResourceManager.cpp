@@ -0,0 +1,346 @@
+﻿#include "ResourceManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "MeshLoader.h"
+#include "hash.h"
+
+namespace gl
+{
+    namespace
+    {
+        // size of the full mip chain glGenerateMipmap builds
+        std::size_t mipChainBytes(int width, int height, int channels) {
+            std::size_t bytes = 0;
+            for (;;) {
+                bytes += static_cast<std::size_t>(width) * height * channels;
+                if (width == 1 && height == 1)
+                    return bytes;
+
+                width = std::max(width / 2, 1);
+                height = std::max(height / 2, 1);
+            }
+        }
+
+        // stb_image keeps its settings and the failure reason in globals, so the loader threads
+        // take turns in it and read the reason before another load replaces it. The flip setting
+        // is left alone, the rows are flipped after the decode.
+        std::mutex stbiMutex;
+
+        // bottom row first, like the textures loaded by Texture::loadImage
+        void flipRows(unsigned char* pixels, int width, int height, int channels) {
+            std::size_t rowBytes = static_cast<std::size_t>(width) * channels;
+            std::vector<unsigned char> row(rowBytes);
+
+            for (int top = 0, bottom = height - 1; top < bottom; top++, bottom--) {
+                unsigned char* topRow = pixels + top * rowBytes;
+                unsigned char* bottomRow = pixels + bottom * rowBytes;
+                std::memcpy(row.data(), topRow, rowBytes);
+                std::memcpy(topRow, bottomRow, rowBytes);
+                std::memcpy(bottomRow, row.data(), rowBytes);
+            }
+        }
+
+        class TextureEntry : public TypedResourceEntry<Texture> {
+        public:
+            TextureEntry(const std::string& path, const TextureParams& params):
+                TypedResourceEntry(ResourceType::Texture, path),
+                m_params(params),
+                m_pixels(nullptr),
+                m_width(0),
+                m_height(0),
+                m_channels(0)
+            {}
+
+            ~TextureEntry() {
+                stbi_image_free(m_pixels);
+            }
+
+        protected:
+            void decode() override {
+                int width, height, channels;
+                unsigned char* pixels;
+                {
+                    std::lock_guard<std::mutex> lock{ stbiMutex };
+                    pixels = stbi_load(path().c_str(), &width, &height, &channels, 0);
+
+                    if (!pixels)
+                        throw image_load_exception{ stbi_failure_reason() };
+                }
+
+                // outside the lock, the other loads need not wait for it
+                flipRows(pixels, width, height, channels);
+
+                stbi_image_free(m_pixels);
+                m_pixels = pixels;
+                m_width = width;
+                m_height = height;
+                m_channels = channels;
+            }
+
+            std::size_t upload() override {
+                auto texture = std::make_unique<Texture>();
+                texture->adoptImage(std::exchange(m_pixels, nullptr), m_width, m_height, m_channels)
+                    .bind()
+                    .setWrapping(m_params.wrap)
+                    .setMinFilter(m_params.minFilter)
+                    .setMagFilter(m_params.magFilter)
+                    .upload()
+                    .releaseImage();
+
+                m_object = std::move(texture);
+                return mipChainBytes(m_width, m_height, m_channels);
+            }
+
+            void release() override {
+                m_object.reset();
+                stbi_image_free(m_pixels);
+                m_pixels = nullptr;
+            }
+
+        private:
+            TextureParams m_params;
+
+            unsigned char* m_pixels;
+            int m_width, m_height, m_channels;
+        };
+
+        class MeshEntry : public TypedResourceEntry<Mesh> {
+        public:
+            MeshEntry(const std::string& path, const MeshAttributes& attributes):
+                TypedResourceEntry(ResourceType::Mesh, path),
+                m_attributes(attributes),
+                m_data(),
+                m_buffers()
+            {}
+
+        protected:
+            // runs on a loader thread, so the importer can still spread over the shared pool
+            void decode() override {
+                m_data = MeshLoader::load(path(), ThreadPool::shared());
+            }
+
+            std::size_t upload() override {
+                m_buffers = std::make_unique<MeshBuffers>(Mesh::uploadBuffers(m_data));
+                m_data = {};
+
+                return m_buffers->gpuBytes();
+            }
+
+            void finishUpload() override {
+                m_object = std::make_unique<Mesh>(Mesh::fromBuffers(std::move(*m_buffers), m_attributes));
+                m_buffers.reset();
+            }
+
+            void release() override {
+                m_object.reset();
+                m_buffers.reset();
+                m_data = {};
+            }
+
+        private:
+            MeshAttributes m_attributes;
+            MeshData m_data;
+            std::unique_ptr<MeshBuffers> m_buffers;
+        };
+    }
+
+    ResourceEntry::ResourceEntry(ResourceType type, const std::string& path):
+        m_type(type),
+        m_path(path),
+        m_decoding(),
+        m_uploading(),
+        m_error(),
+        m_isResident(false),
+        m_bytes(0),
+        m_lastUsed(0),
+        m_lruPosition()
+    {}
+
+    ResourceManager::ResourceManager(std::size_t budget, std::size_t loaderThreads, GlWorkerPool* uploaders):
+        m_loaders(std::max<std::size_t>(loaderThreads, 1)),
+        m_uploaders(uploaders),
+        m_programs(),
+        m_entries(),
+        m_lru(),
+        m_budget(budget),
+        m_residentBytes(0),
+        m_typeBytes(),
+        m_frame(0),
+        m_loads(0),
+        m_evictions(0)
+    {}
+
+    std::size_t ResourceManager::KeyHash::operator()(const Key& key) const {
+        std::uint64_t hash = hashCombine(fnv1a(key.path), static_cast<std::uint64_t>(key.type));
+        for (std::int32_t param : key.params)
+            hash = hashCombine(hash, static_cast<std::uint32_t>(param));
+
+        return static_cast<std::size_t>(hash);
+    }
+
+    Resource<Texture> ResourceManager::texture(const std::string& path, const TextureParams& params) {
+        Key key{ path, ResourceType::Texture, {
+            static_cast<std::int32_t>(params.wrap),
+            static_cast<std::int32_t>(params.minFilter),
+            static_cast<std::int32_t>(params.magFilter)
+        } };
+
+        if (auto found = find<Texture>(key))
+            return found;
+
+        return add<Texture>(std::move(key), std::make_shared<TextureEntry>(path, params));
+    }
+
+    Resource<Mesh> ResourceManager::mesh(const std::string& path, const MeshAttributes& attributes) {
+        Key key{ path, ResourceType::Mesh, { attributes.position, attributes.normal, attributes.texCoord } };
+
+        if (auto found = find<Mesh>(key))
+            return found;
+
+        return add<Mesh>(std::move(key), std::make_shared<MeshEntry>(path, attributes));
+    }
+
+    void ResourceManager::startLoad(ResourceEntry& entry) {
+        ResourceEntry* loaded = &entry;
+        entry.m_error = nullptr;
+        entry.m_decoding = m_loaders.submit([loaded]() { loaded->decode(); });
+    }
+
+    void ResourceManager::collect(ResourceEntry& entry) {
+        try {
+            entry.m_decoding.get();
+
+            if (m_uploaders) {
+                ResourceEntry* loaded = &entry;
+                entry.m_uploading = m_uploaders->submit([loaded]() { return loaded->upload(); });
+            } else {
+                upload(entry);
+            }
+        } catch (...) {
+            entry.m_error = std::current_exception();
+        }
+    }
+
+    void ResourceManager::upload(ResourceEntry& entry) {
+        addResident(entry, entry.upload());
+    }
+
+    void ResourceManager::addResident(ResourceEntry& entry, std::size_t bytes) {
+        entry.finishUpload();
+
+        entry.m_bytes = bytes;
+        entry.m_isResident = true;
+        // counts as used, or it could be the first thing evicted below
+        entry.m_lastUsed = m_frame;
+        entry.m_lruPosition = m_lru.insert(m_lru.end(), &entry);
+
+        m_residentBytes += entry.m_bytes;
+        m_typeBytes[static_cast<std::size_t>(entry.m_type)] += entry.m_bytes;
+        m_loads++;
+
+        evict();
+    }
+
+    void ResourceManager::use(ResourceEntry& entry) {
+        if (!entry.m_isResident) {
+            if (entry.m_error)
+                std::rethrow_exception(std::exchange(entry.m_error, nullptr));
+
+            // a background load is waited for, anything else is loaded right here instead
+            // of queueing behind other loads. An upload on a GL worker is taken only now, so
+            // the GPU waits for it when the resource is first needed rather than when it lands.
+            if (entry.m_uploading.isValid()) {
+                addResident(entry, entry.m_uploading.get());
+            } else {
+                if (entry.m_decoding.valid())
+                    entry.m_decoding.get();
+                else
+                    entry.decode();
+
+                upload(entry);
+            }
+        }
+
+        entry.m_lastUsed = m_frame;
+        m_lru.splice(m_lru.end(), m_lru, entry.m_lruPosition);
+    }
+
+    void ResourceManager::unload(ResourceEntry& entry) {
+        entry.release();
+
+        if (entry.m_isResident) {
+            m_residentBytes -= entry.m_bytes;
+            m_typeBytes[static_cast<std::size_t>(entry.m_type)] -= entry.m_bytes;
+            m_lru.erase(entry.m_lruPosition);
+        }
+
+        entry.m_isResident = false;
+        entry.m_bytes = 0;
+    }
+
+    void ResourceManager::evict() {
+        if (m_budget == 0)
+            return;
+
+        // the list is in order of last use, once an entry used this frame comes up
+        // all the remaining ones were too, and the budget is allowed to overflow
+        while (m_residentBytes > m_budget && !m_lru.empty() && m_lru.front()->m_lastUsed != m_frame) {
+            unload(*m_lru.front());
+            m_evictions++;
+        }
+    }
+
+    ResourceManager& ResourceManager::update() {
+        m_frame++;
+
+        for (auto it = m_entries.begin(); it != m_entries.end();) {
+            ResourceEntry& entry = *it->second;
+
+            if (entry.m_decoding.valid() && entry.m_decoding.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+                collect(entry);
+
+            // the map holds the only reference left, a finished upload is dropped unused
+            if (it->second.use_count() == 1 && (!entry.isLoading() || entry.m_uploading.isReady())) {
+                entry.m_uploading = {};
+                unload(entry);
+                it = m_entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        evict();
+        return *this;
+    }
+
+    ResourceManager& ResourceManager::finishLoads() {
+        for (auto& [key, entry] : m_entries) {
+            if (entry->m_decoding.valid())
+                collect(*entry);
+            entry->m_uploading.wait();
+        }
+        return *this;
+    }
+
+    ResourceManager& ResourceManager::setBudget(std::size_t bytes) {
+        m_budget = bytes;
+        evict();
+        return *this;
+    }
+
+    ResourceManager::~ResourceManager() {
+        for (auto& [key, entry] : m_entries) {
+            if (entry->m_decoding.valid())
+                entry->m_decoding.wait();
+            // waits for the worker, it must be done with the entry before it goes
+            entry->m_uploading = {};
+            unload(*entry);
+        }
+    }
+}
@@ -0,0 +1,266 @@
+﻿#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "GlWorkerPool.h"
+#include "Mesh.h"
+#include "ProgramCache.h"
+#include "Texture.h"
+#include "ThreadPool.h"
+#include "exceptions.h"
+
+namespace gl
+{
+    class resource_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        resource_exception(): message(), super() {}
+        resource_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    enum class ResourceType {
+        Texture,
+        Mesh,
+        Count
+    };
+
+    // sampler state a texture is loaded with, part of its key
+    struct TextureParams {
+        Texture::Wrap wrap = Texture::Wrap::Repeat;
+        Texture::MinFilter minFilter = Texture::MinFilter::Linear_MipmapLinear;
+        Texture::MagFilter magFilter = Texture::MagFilter::Linear;
+    };
+
+    class ResourceManager;
+
+    // Bookkeeping for one loaded file. The file is read and decoded on a loader thread,
+    // the GL object is created from the result on the GL thread or a GL worker thread.
+    class ResourceEntry {
+    public:
+        ResourceEntry(ResourceType type, const std::string& path);
+
+        ResourceEntry(const ResourceEntry&) = delete;
+        ResourceEntry& operator=(const ResourceEntry&) = delete;
+
+        ResourceType type() const { return m_type; }
+        const std::string& path() const { return m_path; }
+
+        bool isResident() const { return m_isResident; }
+        bool isLoading() const { return m_decoding.valid() || m_uploading.isValid(); }
+        // resident, or uploaded on a GL worker and only waiting for its first use
+        bool isReady() const { return m_isResident || m_uploading.isReady(); }
+        std::size_t gpuBytes() const { return m_bytes; }
+
+        virtual ~ResourceEntry() = default;
+
+    protected:
+        // loader thread: reads the file into CPU memory
+        virtual void decode() = 0;
+        // GL thread or a GL worker: creates the GL objects from the decoded data, returns their
+        // size in bytes. Only objects shared between contexts can be made here.
+        virtual std::size_t upload() = 0;
+        // GL thread, after upload(): creates what contexts do not share, e.g. vertex arrays
+        virtual void finishUpload() {}
+        // GL thread: destroys the GL object and any decoded data
+        virtual void release() = 0;
+
+    private:
+        ResourceType m_type;
+        std::string m_path;
+
+        std::future<void> m_decoding;   // valid while a load is in flight
+        GlJob<std::size_t> m_uploading; // valid from the upload on a GL worker until the first use
+        std::exception_ptr m_error;     // of a failed background load, rethrown by the next get()
+        bool m_isResident;
+        std::size_t m_bytes;
+        std::uint64_t m_lastUsed;       // frame of the last get()
+        std::list<ResourceEntry*>::iterator m_lruPosition;
+
+        friend class ResourceManager;
+    };
+
+    template<typename T>
+    class TypedResourceEntry : public ResourceEntry {
+    public:
+        using ResourceEntry::ResourceEntry;
+
+        T& object() { return *m_object; }
+
+    protected:
+        std::unique_ptr<T> m_object;
+    };
+
+    // Ref-counted handle to a managed resource. get() makes the resource resident, waiting
+    // for a pending load or reloading it from disk if it was evicted, so a handle can be kept
+    // for as long as the resource is needed without pinning its GPU memory. Resources used
+    // in the current frame are never evicted, so references returned by get() stay valid
+    // until the next ResourceManager::update(). Handles are for the GL thread only and must
+    // not outlive their manager.
+    template<typename T>
+    class Resource {
+    public:
+        Resource(): m_entry(), m_manager(nullptr) {}
+
+        T& get();
+        T& operator*() { return get(); }
+        T* operator->() { return &get(); }
+
+        // starts loading an evicted resource in the background, so a later get() does not block
+        Resource& prefetch();
+
+        // get() will not block
+        bool isReady() const { return m_entry && m_entry->isReady(); }
+        std::size_t gpuBytes() const { return m_entry ? m_entry->gpuBytes() : 0; }
+
+        explicit operator bool() const { return m_entry != nullptr; }
+
+    private:
+        Resource(std::shared_ptr<TypedResourceEntry<T>> entry, ResourceManager* manager): m_entry(std::move(entry)), m_manager(manager) {}
+
+        std::shared_ptr<TypedResourceEntry<T>> m_entry;
+        ResourceManager* m_manager;
+
+        friend class ResourceManager;
+    };
+
+    // Registry of the textures and meshes loaded from files. Loads are keyed by the path and
+    // the load parameters, so asking for the same file twice shares one GPU copy. Files are
+    // read and decoded on loader threads, GL objects are created on the thread calling update()
+    // or get(), or on GL worker threads when the manager is given some - then a resource becomes
+    // resident at its first use, which makes the GPU (not the CPU) wait for the upload, and only
+    // from then on counts toward the budget. GPU memory is accounted per resource type; when the
+    // total goes over the budget, the least recently used textures and meshes are evicted and
+    // reloaded on their next use. A resource is freed in the first update() after its last
+    // handle is gone. Managed textures keep no CPU copy of the image.
+    //
+    // Programs are small and cannot be reloaded behind a linked program's back, they stay in
+    // the owned ProgramCache, which already deduplicates them.
+    class ResourceManager {
+    public:
+        // budget in bytes, 0 is unlimited. The uploaders have to outlive the manager.
+        explicit ResourceManager(std::size_t budget = 0, std::size_t loaderThreads = 1, GlWorkerPool* uploaders = nullptr);
+
+        ResourceManager(const ResourceManager&) = delete;
+        ResourceManager& operator=(const ResourceManager&) = delete;
+
+        Resource<Texture> texture(const std::string& path, const TextureParams& params = {});
+        Resource<Mesh> mesh(const std::string& path, const MeshAttributes& attributes);
+
+        ProgramCache& programs() { return m_programs; }
+
+        // once per frame on the GL thread: uploads finished loads (or starts their upload on a
+        // GL worker), frees resources without handles and evicts down to the budget
+        ResourceManager& update();
+
+        // blocks until every pending load has finished, uploads on GL workers are still waited
+        // for on the GPU at their first use
+        ResourceManager& finishLoads();
+
+        ResourceManager& setBudget(std::size_t bytes);
+        std::size_t budget() const { return m_budget; }
+
+        std::size_t residentBytes() const { return m_residentBytes; }
+        std::size_t residentBytes(ResourceType type) const { return m_typeBytes[static_cast<std::size_t>(type)]; }
+
+        std::size_t resourceCount() const { return m_entries.size(); }
+        std::size_t loadCount() const { return m_loads; }
+        std::size_t evictionCount() const { return m_evictions; }
+
+        ~ResourceManager();
+
+    private:
+        // the whole key is compared, so a hash collision cannot hand out an entry of another
+        // file or type
+        struct Key {
+            std::string path;
+            ResourceType type;
+            std::array<std::int32_t, 3> params;
+
+            bool operator==(const Key& other) const {
+                return type == other.type && params == other.params && path == other.path;
+            }
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const;
+        };
+
+        template<typename T>
+        Resource<T> find(const Key& key);
+        template<typename T>
+        Resource<T> add(Key key, std::shared_ptr<TypedResourceEntry<T>> entry);
+
+        void use(ResourceEntry& entry);
+        void startLoad(ResourceEntry& entry);
+        // takes the result of a finished background decode and starts the upload
+        void collect(ResourceEntry& entry);
+        void upload(ResourceEntry& entry);
+        void addResident(ResourceEntry& entry, std::size_t bytes);
+        void unload(ResourceEntry& entry);
+        void evict();
+
+        ThreadPool m_loaders;
+        GlWorkerPool* m_uploaders;
+        ProgramCache m_programs;
+
+        std::unordered_map<Key, std::shared_ptr<ResourceEntry>, KeyHash> m_entries;
+        std::list<ResourceEntry*> m_lru;    // resident entries, least recently used first
+
+        std::size_t m_budget;
+        std::size_t m_residentBytes;
+        std::size_t m_typeBytes[static_cast<std::size_t>(ResourceType::Count)];
+        std::uint64_t m_frame;
+        std::size_t m_loads;
+        std::size_t m_evictions;
+
+        template<typename T>
+        friend class Resource;
+    };
+
+    template<typename T>
+    T& Resource<T>::get() {
+        if (!m_entry)
+            throw resource_exception{ "Empty resource handle" };
+
+        m_manager->use(*m_entry);
+        return m_entry->object();
+    }
+
+    template<typename T>
+    Resource<T>& Resource<T>::prefetch() {
+        if (m_entry && !m_entry->isResident() && !m_entry->isLoading())
+            m_manager->startLoad(*m_entry);
+        return *this;
+    }
+
+    template<typename T>
+    Resource<T> ResourceManager::find(const Key& key) {
+        auto found = m_entries.find(key);
+        if (found == m_entries.end())
+            return {};
+
+        return { std::static_pointer_cast<TypedResourceEntry<T>>(found->second), this };
+    }
+
+    template<typename T>
+    Resource<T> ResourceManager::add(Key key, std::shared_ptr<TypedResourceEntry<T>> entry) {
+        m_entries.emplace(std::move(key), entry);
+        startLoad(*entry);
+
+        return { std::move(entry), this };
+    }
+}
@@ -1,7 +1,13 @@
 ﻿#include "Shader.h"
+#include "ShaderPreprocessor.h"
 
 using namespace gl;
 
+Shader Shader::fromFile(const char* filename, ShaderType m_type, const ShaderDefines& defines) {
+    ShaderPreprocessor preprocessor;
+    return Shader{ preprocessor.process(filename, defines), m_type };
+}
+
 Shader::Shader(const GLchar* m_source, ShaderType m_type):
     m_type(m_type),
     m_source(m_source),
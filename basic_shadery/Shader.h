@@ -3,14 +3,18 @@
 #include <fstream>
 #include <string>
 #include <iterator>
+#include <map>
 
 #include "core.h"
 #include "exceptions.h"
 
-#include <GL/glew.h>
+#include "GlDispatch.h"
 
 namespace gl
 {
+    // ordered, so that the same set of defines always produces the same source (and hash)
+    using ShaderDefines = std::map<std::string, std::string>;
+
     enum class ShaderType {
         Vertex = GL_VERTEX_SHADER,
         Geometry = GL_GEOMETRY_SHADER,
@@ -51,14 +55,8 @@ namespace gl
             return Shader{ m_source, m_type };
         }
 
-        static Shader fromFile(const char* filename, ShaderType m_type) {
-            ifstream in{ filename };
-
-            if (!in)
-                throw shader_exception{ "Shader source file could not be opened" };
-
-            return Shader{ in, m_type };
-        }
+        // runs the source through ShaderPreprocessor, so #include and injected defines work
+        static Shader fromFile(const char* filename, ShaderType m_type, const ShaderDefines& defines = {});
 
         Shader(): m_type(), m_shaderId(0), m_source() {}
 
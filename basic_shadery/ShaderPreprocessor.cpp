@@ -0,0 +1,117 @@
+﻿#include "ShaderPreprocessor.h"
+
+namespace gl
+{
+    namespace
+    {
+        // returns the directive name if the line is a preprocessor directive, rest holds what follows it
+        std::string directive(const std::string& line, std::string& rest) {
+            std::size_t pos = line.find_first_not_of(" \t");
+            if (pos == std::string::npos || line[pos] != '#')
+                return {};
+
+            pos = line.find_first_not_of(" \t", pos + 1);
+            if (pos == std::string::npos)
+                return {};
+
+            std::size_t end = line.find_first_of(" \t", pos);
+            rest = (end == std::string::npos) ? std::string{} : line.substr(end);
+            return line.substr(pos, end - pos);
+        }
+
+        // extracts the file name out of "name" or <name>
+        bool includeName(const std::string& rest, std::string& name) {
+            std::size_t open = rest.find_first_of("\"<");
+            if (open == std::string::npos)
+                return false;
+
+            std::size_t close = rest.find(rest[open] == '"' ? '"' : '>', open + 1);
+            if (close == std::string::npos)
+                return false;
+
+            name = rest.substr(open + 1, close - open - 1);
+            return true;
+        }
+    }
+
+    string ShaderPreprocessor::process(const std::filesystem::path& filename, const ShaderDefines& defines) {
+        std::ostringstream out;
+        std::set<std::filesystem::path> included;
+
+        m_files.clear();
+        expand(filename, out, included, &defines);
+
+        return out.str();
+    }
+
+    std::filesystem::path ShaderPreprocessor::resolve(const std::filesystem::path& from, const std::string& name) const {
+        std::filesystem::path local = from.parent_path() / name;
+        if (std::filesystem::exists(local))
+            return local;
+
+        for (const auto& dir : m_includeDirectories) {
+            std::filesystem::path candidate = dir / name;
+            if (std::filesystem::exists(candidate))
+                return candidate;
+        }
+
+        throw shader_preprocess_exception{ from.string() + ": included file \"" + name + "\" could not be found" };
+    }
+
+    void ShaderPreprocessor::expand(const std::filesystem::path& file, std::ostringstream& out, std::set<std::filesystem::path>& included, const ShaderDefines* defines) {
+        std::filesystem::path canonical = std::filesystem::weakly_canonical(file);
+        if (!included.insert(canonical).second)
+            return;
+
+        ifstream in{ file };
+        if (!in)
+            throw shader_preprocess_exception{ file.string() + ": shader source file could not be opened" };
+
+        std::size_t fileIndex = m_files.size();
+        m_files.push_back(file);
+
+        std::vector<string> lines;
+        for (string line; std::getline(in, line);)
+            lines.push_back(std::move(line));
+
+        // defines go in right after #version (which has to stay the first directive),
+        // or at the very top when there is none
+        std::size_t definesAt = 0;
+        if (defines && !defines->empty()) {
+            std::string rest;
+            for (std::size_t i = 0; i < lines.size(); i++) {
+                if (directive(lines[i], rest) == "version") {
+                    definesAt = i + 1;
+                    break;
+                }
+            }
+        }
+
+        if (fileIndex != 0)
+            out << "#line 1 " << fileIndex << '\n';
+
+        for (std::size_t i = 0; i <= lines.size(); i++) {
+            if (defines && !defines->empty() && i == definesAt) {
+                for (const auto& [name, value] : *defines)
+                    out << "#define " << name << ' ' << value << '\n';
+                out << "#line " << i + 1 << ' ' << fileIndex << '\n';
+            }
+
+            if (i == lines.size())
+                break;
+
+            std::string rest;
+            if (directive(lines[i], rest) != "include") {
+                out << lines[i] << '\n';
+                continue;
+            }
+
+            std::string name;
+            if (!includeName(rest, name))
+                throw shader_preprocess_exception{ file.string() + "(" + std::to_string(i + 1) + "): malformed #include" };
+
+            expand(resolve(file, name), out, included, nullptr);
+            out << "#line " << i + 2 << ' ' << fileIndex << '\n';
+        }
+    }
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core.h"
+#include "Shader.h"
+
+namespace gl
+{
+    class shader_preprocess_exception : public shader_exception {
+        using super = shader_exception;
+        std::string message;
+
+    public:
+        shader_preprocess_exception(): message(), super() {}
+        shader_preprocess_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Resolves #include "file" directives (relative to the including file first, then to the
+    // include directories; every file is included at most once) and injects #define lines
+    // right after #version. #line directives keep compiler messages pointing at the right
+    // lines, the source string number being the file's index in getFiles().
+    class ShaderPreprocessor {
+    public:
+        ShaderPreprocessor(): m_includeDirectories(), m_files() {}
+
+        ShaderPreprocessor& addIncludeDirectory(const std::filesystem::path& directory) {
+            m_includeDirectories.push_back(directory);
+            return *this;
+        }
+
+        string process(const std::filesystem::path& filename, const ShaderDefines& defines = {});
+
+        // files that took part in the last process() call, in source string number order
+        const std::vector<std::filesystem::path>& getFiles() const { return m_files; }
+
+    private:
+        void expand(const std::filesystem::path& file, std::ostringstream& out, std::set<std::filesystem::path>& included, const ShaderDefines* defines);
+        std::filesystem::path resolve(const std::filesystem::path& from, const std::string& name) const;
+
+        std::vector<std::filesystem::path> m_includeDirectories;
+        std::vector<std::filesystem::path> m_files;
+    };
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <cstddef>
+
+#include <glm/matrix.hpp>
+#include <glm/vec4.hpp>
+
+#include "SoftwareRasterizer.h"
+#include "SoftwareTexture.h"
+
+namespace gl
+{
+    // C++ counterparts of the programs in assets/shaders, for SoftwareRasterizer::draw().
+    // Vertices need the same members the GLSL attributes are named after.
+
+    // default.vert.glsl + default.frag.glsl
+    struct SoftwareDefaultProgram {
+        static constexpr std::size_t varyingCount = 3;     // Color
+
+        glm::mat4 model{ 1.f };
+        glm::mat4 view{ 1.f };
+        glm::mat4 projection{ 1.f };
+
+        template<typename Vertex>
+        glm::vec4 vertex(const Vertex& v, float* varyings) const {
+            varyings[0] = v.color.x;
+            varyings[1] = v.color.y;
+            varyings[2] = v.color.z;
+
+            return projection * view * model * glm::vec4{ v.position, 1.f };
+        }
+
+        glm::vec4 fragment(const SoftwareFragment& f) const {
+            return glm::vec4{ f.vec3(0), 1.f };
+        }
+    };
+
+    // textured.vert.glsl + textured.frag.glsl
+    struct SoftwareTexturedProgram {
+        static constexpr std::size_t varyingCount = 2;     // TexCoord
+
+        glm::mat4 model{ 1.f };
+        glm::mat4 view{ 1.f };
+        glm::mat4 projection{ 1.f };
+        const SoftwareTexture* tex1 = nullptr;
+
+        template<typename Vertex>
+        glm::vec4 vertex(const Vertex& v, float* varyings) const {
+            varyings[0] = v.texCoord.x;
+            varyings[1] = v.texCoord.y;
+
+            return projection * view * model * glm::vec4{ v.position, 1.f };
+        }
+
+        glm::vec4 fragment(const SoftwareFragment& f) const {
+            return tex1->sample(f.vec2(0), f.dFdx2(0), f.dFdy2(0));
+        }
+    };
+}
@@ -0,0 +1,192 @@
+﻿#include "SoftwareRasterizer.h"
+
+#include <cmath>
+
+namespace gl
+{
+    SoftwareTarget::SoftwareTarget(unsigned width, unsigned height):
+        m_width(std::max(width, 1u)),
+        m_height(std::max(height, 1u)),
+        m_depthStride((m_width + 3) & ~3u),
+        m_color(std::size_t(m_width) * m_height, 0),
+        m_depth(std::size_t(m_depthStride) * m_height, 1.f)
+    {}
+
+    SoftwareTarget& SoftwareTarget::clear(const glm::vec4& color, float depth) {
+        auto channel = [](float value) { return std::uint32_t(std::min(std::max(value, .0f), 1.f) * 255.f + .5f); };
+
+        std::fill(m_color.begin(), m_color.end(), channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (channel(color.w) << 24));
+        std::fill(m_depth.begin(), m_depth.end(), depth);
+        return *this;
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer(ThreadPool& pool):
+        m_pool(pool),
+        m_cullFace(CullFace::Back),
+        m_depthTest(true),
+        m_width(0),
+        m_height(0),
+        m_tilesX(0),
+        m_tilesY(0),
+        m_clipVertices(),
+        m_bins(pool.size() + 1),
+        m_triangleCount(0)
+    {}
+
+    void SoftwareRasterizer::binTriangles(const std::vector<std::uint32_t>& indices, std::size_t varyingCount, const SoftwareTarget& target) {
+        if (target.getWidth() != m_width || target.getHeight() != m_height) {
+            m_width = target.getWidth();
+            m_height = target.getHeight();
+            m_tilesX = (m_width + tileSize - 1) / tileSize;
+            m_tilesY = (m_height + tileSize - 1) / tileSize;
+
+            for (auto& bin : m_bins)
+                bin.tiles.assign(std::size_t(m_tilesX) * m_tilesY, {});
+        }
+
+        const std::size_t totalTriangles = indices.size() / 3;
+        const std::size_t jobs = m_bins.size();
+
+        // job j takes the j-th slice of the triangles, so walking the bins in order keeps submission order
+        m_pool.parallelFor(jobs, [&](std::size_t first, std::size_t last) {
+            for (std::size_t j = first; j < last; j++) {
+                Bin& bin = m_bins[j];
+                bin.triangles.clear();
+                bin.planes.clear();
+                for (auto& tile : bin.tiles)
+                    tile.clear();
+
+                for (std::size_t t = totalTriangles * j / jobs, end = totalTriangles * (j + 1) / jobs; t < end; t++) {
+                    const ClipVertex* triangle[3] = {
+                        &m_clipVertices[indices[t * 3]],
+                        &m_clipVertices[indices[t * 3 + 1]],
+                        &m_clipVertices[indices[t * 3 + 2]]
+                    };
+
+                    const glm::vec4& p0 = triangle[0]->position;
+                    const glm::vec4& p1 = triangle[1]->position;
+                    const glm::vec4& p2 = triangle[2]->position;
+
+                    // trivially outside one of the frustum planes
+                    if ((p0.x > p0.w && p1.x > p1.w && p2.x > p2.w) || (p0.x < -p0.w && p1.x < -p1.w && p2.x < -p2.w) ||
+                        (p0.y > p0.w && p1.y > p1.w && p2.y > p2.w) || (p0.y < -p0.w && p1.y < -p1.w && p2.y < -p2.w) ||
+                        (p0.z > p0.w && p1.z > p1.w && p2.z > p2.w) || (p0.z < -p0.w && p1.z < -p1.w && p2.z < -p2.w))
+                        continue;
+
+                    if (p0.z >= -p0.w && p1.z >= -p1.w && p2.z >= -p2.w) {
+                        setupTriangle(triangle, varyingCount, bin);
+                        continue;
+                    }
+
+                    // crosses the near plane: keep the part in front of it, one vertex at most is added
+                    ClipVertex polygon[4];
+                    std::size_t count = 0;
+
+                    for (std::size_t i = 0; i < 3; i++) {
+                        const ClipVertex& a = *triangle[i];
+                        const ClipVertex& b = *triangle[(i + 1) % 3];
+                        float da = a.position.z + a.position.w;
+                        float db = b.position.z + b.position.w;
+
+                        if (da >= .0f)
+                            polygon[count++] = a;
+
+                        if ((da >= .0f) != (db >= .0f)) {
+                            float s = da / (da - db);
+                            ClipVertex& v = polygon[count++];
+
+                            v.position = a.position + (b.position - a.position) * s;
+                            for (std::size_t k = 0; k < varyingCount; k++)
+                                v.varyings[k] = a.varyings[k] + (b.varyings[k] - a.varyings[k]) * s;
+                        }
+                    }
+
+                    for (std::size_t i = 2; i < count; i++) {
+                        const ClipVertex* fan[3] = { &polygon[0], &polygon[i - 1], &polygon[i] };
+                        setupTriangle(fan, varyingCount, bin);
+                    }
+                }
+            }
+        });
+
+        m_triangleCount = 0;
+        for (const auto& bin : m_bins)
+            m_triangleCount += bin.triangles.size();
+    }
+
+    void SoftwareRasterizer::setupTriangle(const ClipVertex* const clip[3], std::size_t varyingCount, Bin& bin) const {
+        const ClipVertex* vertex[3] = { clip[0], clip[1], clip[2] };
+        float x[3], y[3], z[3], invW[3];
+
+        for (int i = 0; i < 3; i++) {
+            const glm::vec4& p = vertex[i]->position;
+            invW[i] = 1.f / p.w;
+            x[i] = (p.x * invW[i] * .5f + .5f) * m_width;
+            y[i] = (p.y * invW[i] * .5f + .5f) * m_height;
+            z[i] = p.z * invW[i] * .5f + .5f;
+        }
+
+        float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+        if (std::abs(area) < 1e-8f)
+            return;
+
+        // counter-clockwise is front facing, same as the GL default
+        if ((area < .0f && m_cullFace == CullFace::Back) || (area > .0f && m_cullFace == CullFace::Front))
+            return;
+
+        if (area < .0f) {
+            std::swap(vertex[1], vertex[2]);
+            std::swap(x[1], x[2]);
+            std::swap(y[1], y[2]);
+            std::swap(z[1], z[2]);
+            std::swap(invW[1], invW[2]);
+            area = -area;
+        }
+
+        Triangle t;
+        t.minX = std::max(int(std::ceil(std::min({ x[0], x[1], x[2] }) - .5f)), 0);
+        t.maxX = std::min(int(std::floor(std::max({ x[0], x[1], x[2] }) - .5f)), int(m_width) - 1);
+        t.minY = std::max(int(std::ceil(std::min({ y[0], y[1], y[2] }) - .5f)), 0);
+        t.maxY = std::min(int(std::floor(std::max({ y[0], y[1], y[2] }) - .5f)), int(m_height) - 1);
+
+        if (t.minX > t.maxX || t.minY > t.maxY)
+            return;
+
+        t.topLeft = 0;
+        for (int e = 0; e < 3; e++) {
+            int n = (e + 1) % 3;
+            t.edgeA[e] = y[e] - y[n];
+            t.edgeB[e] = x[n] - x[e];
+            t.edgeC[e] = -(t.edgeA[e] * x[e] + t.edgeB[e] * y[e]);
+
+            // left edges have the inside to their right, top ones are horizontal with the inside below
+            if (t.edgeA[e] > .0f || (t.edgeA[e] == .0f && t.edgeB[e] < .0f))
+                t.topLeft |= 1u << e;
+        }
+
+        const float invArea = 1.f / area;
+        auto plane = [&](float q0, float q1, float q2, float& planeX, float& planeY, float& planeC) {
+            planeX = ((q1 - q0) * (y[2] - y[0]) - (q2 - q0) * (y[1] - y[0])) * invArea;
+            planeY = ((q2 - q0) * (x[1] - x[0]) - (q1 - q0) * (x[2] - x[0])) * invArea;
+            planeC = q0 - planeX * x[0] - planeY * y[0];
+        };
+
+        plane(z[0], z[1], z[2], t.depthX, t.depthY, t.depthC);
+        plane(invW[0], invW[1], invW[2], t.invWX, t.invWY, t.invWC);
+
+        // varyings divided by w are linear in screen space, the fragment multiplies w back in
+        t.planes = static_cast<std::uint32_t>(bin.planes.size());
+        bin.planes.resize(bin.planes.size() + varyingCount * 3);
+        float* planes = bin.planes.data() + t.planes;
+
+        for (std::size_t k = 0; k < varyingCount; k++)
+            plane(vertex[0]->varyings[k] * invW[0], vertex[1]->varyings[k] * invW[1], vertex[2]->varyings[k] * invW[2], planes[k * 3], planes[k * 3 + 1], planes[k * 3 + 2]);
+
+        auto index = static_cast<std::uint32_t>(bin.triangles.size());
+        bin.triangles.push_back(t);
+
+        for (unsigned ty = t.minY / tileSize; ty <= unsigned(t.maxY) / tileSize; ty++)
+            for (unsigned tx = t.minX / tileSize; tx <= unsigned(t.maxX) / tileSize; tx++)
+                bin.tiles[ty * m_tilesX + tx].push_back(index);
+    }
+}
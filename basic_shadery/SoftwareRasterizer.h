@@ -0,0 +1,316 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include "ThreadPool.h"
+
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RASTERIZER_USE_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace gl
+{
+    // Color and depth buffer the software rasterizer draws into. Rows go bottom to top
+    // like glReadPixels, color is RGBA8 packed with red in the lowest byte.
+    class SoftwareTarget {
+    public:
+        SoftwareTarget(unsigned width, unsigned height);
+
+        SoftwareTarget& clear(const glm::vec4& color, float depth = 1.f);
+
+        unsigned getWidth() const { return m_width; }
+        unsigned getHeight() const { return m_height; }
+
+        const std::vector<std::uint32_t>& getColor() const { return m_color; }
+        std::uint32_t getPixel(unsigned x, unsigned y) const { return m_color[std::size_t(y) * m_width + x]; }
+        float getDepth(unsigned x, unsigned y) const { return m_depth[std::size_t(y) * m_depthStride + x]; }
+
+    private:
+        friend class SoftwareRasterizer;
+
+        unsigned m_width, m_height;
+        unsigned m_depthStride;     // rounded up to 4, so whole groups of pixels can be loaded at row ends
+        std::vector<std::uint32_t> m_color;
+        std::vector<float> m_depth;
+    };
+
+    // What a fragment stage gets: the interpolated varyings of one pixel and their
+    // screen-space derivatives, which the texture sampling needs to pick a mip level.
+    class SoftwareFragment {
+    public:
+        float x, y;     // pixel center in window coordinates
+        float depth;
+
+        float value(std::size_t i) const { return m_values[i]; }
+        float dFdx(std::size_t i) const { return (m_planes[i * 3] - m_values[i] * m_invWX) * m_w; }
+        float dFdy(std::size_t i) const { return (m_planes[i * 3 + 1] - m_values[i] * m_invWY) * m_w; }
+
+        glm::vec2 vec2(std::size_t i) const { return { value(i), value(i + 1) }; }
+        glm::vec3 vec3(std::size_t i) const { return { value(i), value(i + 1), value(i + 2) }; }
+        glm::vec4 vec4(std::size_t i) const { return { value(i), value(i + 1), value(i + 2), value(i + 3) }; }
+
+        glm::vec2 dFdx2(std::size_t i) const { return { dFdx(i), dFdx(i + 1) }; }
+        glm::vec2 dFdy2(std::size_t i) const { return { dFdy(i), dFdy(i + 1) }; }
+
+    private:
+        friend class SoftwareRasterizer;
+
+        const float* m_values;
+        const float* m_planes;      // per varying: value/w = planeX * x + planeY * y + planeC
+        float m_w;
+        float m_invWX, m_invWY;
+    };
+
+    // Tile-binned CPU rasterizer for machines without a usable GPU.
+    //
+    // A program is a plain C++ class standing in for a linked vertex + fragment shader pair
+    // (see SoftwarePrograms.h):
+    //
+    //     static constexpr std::size_t varyingCount;
+    //     glm::vec4 vertex(const Vertex& v, float* varyings) const;     // returns gl_Position
+    //     glm::vec4 fragment(const SoftwareFragment& f) const;          // returns the color
+    //
+    // draw() shades vertices in parallel, then every thread clips, culls and sets up an
+    // equal slice of the triangles and bins them into screen tiles, and finally each tile
+    // is rasterized by one thread - SSE edge functions and an early depth test over four
+    // pixels at a time, then the program runs for the covered ones with perspective
+    // correct varyings. Tiles walk the bins in submission order, so overlapping triangles
+    // resolve the same as on a GPU. Depth test is GL_LESS with depth writes when enabled,
+    // no blending.
+    class SoftwareRasterizer {
+    public:
+        static constexpr unsigned tileSize = 64;
+        static constexpr std::size_t maxVaryings = 16;
+
+        enum class CullFace {
+            None,
+            Back,
+            Front
+        };
+
+        explicit SoftwareRasterizer(ThreadPool& pool = ThreadPool::shared());
+
+        SoftwareRasterizer(const SoftwareRasterizer&) = delete;
+        SoftwareRasterizer& operator=(const SoftwareRasterizer&) = delete;
+
+        SoftwareRasterizer& setCullFace(CullFace cull) {
+            m_cullFace = cull;
+            return *this;
+        }
+
+        SoftwareRasterizer& setDepthTest(bool enabled) {
+            m_depthTest = enabled;
+            return *this;
+        }
+
+        template<typename Program, typename Vertex>
+        SoftwareRasterizer& draw(const Program& program, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices, SoftwareTarget& target);
+
+        // triangles that survived clipping and culling in the last draw()
+        std::size_t triangleCount() const { return m_triangleCount; }
+
+    private:
+        struct ClipVertex {
+            glm::vec4 position;
+            float varyings[maxVaryings];
+        };
+
+        // screen space triangle, counter-clockwise, with everything interpolated as planes
+        struct Triangle {
+            float edgeA[3], edgeB[3], edgeC[3];     // edge i: a * x + b * y + c, positive inside
+            std::uint32_t topLeft;                  // bit i set: pixels exactly on edge i are inside
+            float depthX, depthY, depthC;
+            float invWX, invWY, invWC;
+            std::uint32_t planes;                   // offset of the varying planes in Bin::planes
+            int minX, minY, maxX, maxY;             // pixel bounds, inclusive
+        };
+
+        struct Bin {
+            std::vector<Triangle> triangles;
+            std::vector<float> planes;
+            std::vector<std::vector<std::uint32_t>> tiles;
+        };
+
+        void binTriangles(const std::vector<std::uint32_t>& indices, std::size_t varyingCount, const SoftwareTarget& target);
+        void setupTriangle(const ClipVertex* const clip[3], std::size_t varyingCount, Bin& bin) const;
+
+        template<typename Program>
+        void rasterizeTile(const Program& program, unsigned tile, SoftwareTarget& target) const;
+
+        static std::uint32_t packColor(const glm::vec4& color) {
+            auto channel = [](float value) { return std::uint32_t(std::min(std::max(value, .0f), 1.f) * 255.f + .5f); };
+            return channel(color.x) | (channel(color.y) << 8) | (channel(color.z) << 16) | (channel(color.w) << 24);
+        }
+
+        ThreadPool& m_pool;
+        CullFace m_cullFace;
+        bool m_depthTest;
+
+        unsigned m_width, m_height;
+        unsigned m_tilesX, m_tilesY;
+
+        std::vector<ClipVertex> m_clipVertices;
+        std::vector<Bin> m_bins;
+        std::size_t m_triangleCount;
+    };
+
+    template<typename Program, typename Vertex>
+    SoftwareRasterizer& SoftwareRasterizer::draw(const Program& program, const std::vector<Vertex>& vertices, const std::vector<std::uint32_t>& indices, SoftwareTarget& target) {
+        static_assert(Program::varyingCount <= maxVaryings, "too many varyings for the software rasterizer");
+
+        m_clipVertices.resize(vertices.size());
+        m_pool.parallelFor(vertices.size(), [&](std::size_t first, std::size_t last) {
+            for (std::size_t i = first; i < last; i++)
+                m_clipVertices[i].position = program.vertex(vertices[i], m_clipVertices[i].varyings);
+        });
+
+        binTriangles(indices, Program::varyingCount, target);
+
+        // tiles are handed out one at a time, their cost varies far too much for equal ranges
+        std::atomic<unsigned> nextTile{ 0 };
+        const unsigned tileCount = m_tilesX * m_tilesY;
+
+        m_pool.parallelFor(m_pool.size() + 1, [&](std::size_t, std::size_t) {
+            for (unsigned tile = nextTile++; tile < tileCount; tile = nextTile++)
+                rasterizeTile(program, tile, target);
+        });
+
+        return *this;
+    }
+
+    template<typename Program>
+    void SoftwareRasterizer::rasterizeTile(const Program& program, unsigned tile, SoftwareTarget& target) const {
+        const int tileX0 = (tile % m_tilesX) * tileSize, tileY0 = (tile / m_tilesX) * tileSize;
+        const int tileX1 = std::min(tileX0 + int(tileSize), int(m_width)) - 1;
+        const int tileY1 = std::min(tileY0 + int(tileSize), int(m_height)) - 1;
+
+        float values[maxVaryings];
+        SoftwareFragment fragment;
+        fragment.m_values = values;
+
+        for (const auto& bin : m_bins) {
+            for (std::uint32_t index : bin.tiles[tile]) {
+                const Triangle& t = bin.triangles[index];
+                const float* planes = bin.planes.data() + t.planes;
+
+                const int x0 = std::max(t.minX, tileX0), x1 = std::min(t.maxX, tileX1);
+                const int y0 = std::max(t.minY, tileY0), y1 = std::min(t.maxY, tileY1);
+
+                fragment.m_planes = planes;
+                fragment.m_invWX = t.invWX;
+                fragment.m_invWY = t.invWY;
+
+                auto shade = [&](int x, float px, float py, float z, std::uint32_t* color) {
+                    float w = 1.f / (t.invWX * px + t.invWY * py + t.invWC);
+                    for (std::size_t i = 0; i < Program::varyingCount; i++)
+                        values[i] = (planes[i * 3] * px + planes[i * 3 + 1] * py + planes[i * 3 + 2]) * w;
+
+                    fragment.x = px;
+                    fragment.y = py;
+                    fragment.depth = z;
+                    fragment.m_w = w;
+                    color[x] = packColor(program.fragment(fragment));
+                };
+
+#ifdef SOFTWARE_RASTERIZER_USE_SSE
+                const __m128 columnOffset = _mm_setr_ps(.5f, 1.5f, 2.5f, 3.5f);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 one = _mm_set1_ps(1.f);
+                const __m128 a0 = _mm_set1_ps(t.edgeA[0]), a1 = _mm_set1_ps(t.edgeA[1]), a2 = _mm_set1_ps(t.edgeA[2]);
+                const __m128 onEdge0 = _mm_castsi128_ps(_mm_set1_epi32((t.topLeft & 1) ? -1 : 0));
+                const __m128 onEdge1 = _mm_castsi128_ps(_mm_set1_epi32((t.topLeft & 2) ? -1 : 0));
+                const __m128 onEdge2 = _mm_castsi128_ps(_mm_set1_epi32((t.topLeft & 4) ? -1 : 0));
+                const __m128 depthX = _mm_set1_ps(t.depthX);
+                const __m128i firstColumn = _mm_set1_epi32(x0), lastColumn = _mm_set1_epi32(x1);
+                const __m128i columnIndex = _mm_setr_epi32(0, 1, 2, 3);
+
+                for (int y = y0; y <= y1; y++) {
+                    const float py = y + .5f;
+                    const __m128 row0 = _mm_set1_ps(t.edgeB[0] * py + t.edgeC[0]);
+                    const __m128 row1 = _mm_set1_ps(t.edgeB[1] * py + t.edgeC[1]);
+                    const __m128 row2 = _mm_set1_ps(t.edgeB[2] * py + t.edgeC[2]);
+                    const __m128 rowDepth = _mm_set1_ps(t.depthY * py + t.depthC);
+
+                    float* depth = target.m_depth.data() + std::size_t(y) * target.m_depthStride;
+                    std::uint32_t* color = target.m_color.data() + std::size_t(y) * m_width;
+
+                    for (int x = x0 & ~3; x <= x1; x += 4) {
+                        __m128 px = _mm_add_ps(_mm_set1_ps(float(x)), columnOffset);
+
+                        __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                        __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                        __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+
+                        // top-left rule: a pixel center on an edge shared by two triangles is drawn once
+                        __m128 inside = _mm_or_ps(_mm_cmpgt_ps(e0, zero), _mm_and_ps(_mm_cmpeq_ps(e0, zero), onEdge0));
+                        inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(e1, zero), _mm_and_ps(_mm_cmpeq_ps(e1, zero), onEdge1)));
+                        inside = _mm_and_ps(inside, _mm_or_ps(_mm_cmpgt_ps(e2, zero), _mm_and_ps(_mm_cmpeq_ps(e2, zero), onEdge2)));
+
+                        __m128i column = _mm_add_epi32(_mm_set1_epi32(x), columnIndex);
+                        __m128i outside = _mm_or_si128(_mm_cmplt_epi32(column, firstColumn), _mm_cmpgt_epi32(column, lastColumn));
+                        inside = _mm_andnot_ps(_mm_castsi128_ps(outside), inside);
+
+                        if (_mm_movemask_ps(inside) == 0)
+                            continue;
+
+                        // early depth test, the programs never write depth themselves
+                        __m128 z = _mm_add_ps(_mm_mul_ps(depthX, px), rowDepth);
+                        __m128 old = _mm_loadu_ps(depth + x);
+                        inside = _mm_and_ps(inside, _mm_and_ps(_mm_cmpge_ps(z, zero), _mm_cmple_ps(z, one)));
+                        if (m_depthTest)
+                            inside = _mm_and_ps(inside, _mm_cmplt_ps(z, old));
+
+                        int mask = _mm_movemask_ps(inside);
+                        if (mask == 0)
+                            continue;
+
+                        if (m_depthTest)
+                            _mm_storeu_ps(depth + x, _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, old)));
+
+                        alignas(16) float zs[4];
+                        _mm_store_ps(zs, z);
+
+                        for (int i = 0; i < 4; i++)
+                            if (mask & (1 << i))
+                                shade(x + i, x + i + .5f, py, zs[i], color);
+                    }
+                }
+#else
+                auto covers = [&](int e, float px, float py) {
+                    float value = t.edgeA[e] * px + t.edgeB[e] * py + t.edgeC[e];
+                    return value > .0f || (value == .0f && (t.topLeft & (1u << e)));
+                };
+
+                for (int y = y0; y <= y1; y++) {
+                    const float py = y + .5f;
+                    float* depth = target.m_depth.data() + std::size_t(y) * target.m_depthStride;
+                    std::uint32_t* color = target.m_color.data() + std::size_t(y) * m_width;
+
+                    for (int x = x0; x <= x1; x++) {
+                        const float px = x + .5f;
+                        if (!covers(0, px, py) || !covers(1, px, py) || !covers(2, px, py))
+                            continue;
+
+                        float z = t.depthX * px + t.depthY * py + t.depthC;
+                        if (z < .0f || z > 1.f || (m_depthTest && z >= depth[x]))
+                            continue;
+
+                        if (m_depthTest)
+                            depth[x] = z;
+                        shade(x, px, py, z, color);
+                    }
+                }
+#endif
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+﻿#include "SoftwareTexture.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/glm.hpp>
+
+namespace gl
+{
+    namespace
+    {
+        inline std::uint32_t pack(unsigned r, unsigned g, unsigned b, unsigned a) {
+            return r | (g << 8) | (b << 16) | (a << 24);
+        }
+
+        inline int wrap(int i, int size, Texture::Wrap mode) {
+            if (mode == Texture::Wrap::Repeat) {
+                if ((size & (size - 1)) == 0)
+                    return i & (size - 1);
+
+                i %= size;
+                return i < 0 ? i + size : i;
+            }
+
+            return std::clamp(i, 0, size - 1);
+        }
+    }
+
+    SoftwareTexture SoftwareTexture::fromTexture(const Texture& texture) {
+        if (!texture.getPixels())
+            throw image_load_exception{ "texture has no image data on the CPU side" };
+
+        return fromPixels(texture.getPixels(), texture.getWidth(), texture.getHeight(), texture.getChannels());
+    }
+
+    SoftwareTexture SoftwareTexture::fromPixels(const unsigned char* pixels, int width, int height, int channels) {
+        SoftwareTexture texture;
+
+        Level base{ width, height, std::vector<std::uint32_t>(std::size_t(width) * height) };
+        for (std::size_t i = 0; i < base.texels.size(); i++) {
+            const unsigned char* p = pixels + i * channels;
+
+            switch (channels) {
+            case 1: base.texels[i] = pack(p[0], p[0], p[0], 255); break;
+            case 2: base.texels[i] = pack(p[0], p[0], p[0], p[1]); break;
+            case 3: base.texels[i] = pack(p[0], p[1], p[2], 255); break;
+            default: base.texels[i] = pack(p[0], p[1], p[2], p[3]); break;
+            }
+        }
+
+        texture.m_levels.push_back(std::move(base));
+        texture.generateMipmaps();
+        return texture;
+    }
+
+    void SoftwareTexture::generateMipmaps() {
+        while (m_levels.back().width > 1 || m_levels.back().height > 1) {
+            const Level& fine = m_levels.back();
+            Level coarse{ std::max(fine.width / 2, 1), std::max(fine.height / 2, 1), {} };
+            coarse.texels.resize(std::size_t(coarse.width) * coarse.height);
+
+            // 2x2 box filter, odd sizes just drop the last row/column like most drivers do
+            for (int y = 0; y < coarse.height; y++) {
+                int y0 = std::min(y * 2, fine.height - 1), y1 = std::min(y * 2 + 1, fine.height - 1);
+
+                for (int x = 0; x < coarse.width; x++) {
+                    int x0 = std::min(x * 2, fine.width - 1), x1 = std::min(x * 2 + 1, fine.width - 1);
+
+                    std::uint32_t t[4] = {
+                        fine.texels[y0 * fine.width + x0], fine.texels[y0 * fine.width + x1],
+                        fine.texels[y1 * fine.width + x0], fine.texels[y1 * fine.width + x1]
+                    };
+
+                    unsigned channel[4];
+                    for (int c = 0; c < 4; c++) {
+                        unsigned sum = 0;
+                        for (auto texel : t)
+                            sum += (texel >> (c * 8)) & 0xFF;
+                        channel[c] = (sum + 2) / 4;
+                    }
+
+                    coarse.texels[y * coarse.width + x] = pack(channel[0], channel[1], channel[2], channel[3]);
+                }
+            }
+
+            m_levels.push_back(std::move(coarse));
+        }
+    }
+
+    glm::vec4 SoftwareTexture::fetch(const Level& level, int x, int y) const {
+        std::uint32_t texel = level.texels[std::size_t(y) * level.width + x];
+
+        return glm::vec4{
+            float(texel & 0xFF),
+            float((texel >> 8) & 0xFF),
+            float((texel >> 16) & 0xFF),
+            float(texel >> 24)
+        } * (1.f / 255.f);
+    }
+
+    glm::vec4 SoftwareTexture::nearest(const Level& level, const glm::vec2& uv) const {
+        int x = wrap(int(std::floor(uv.x * level.width)), level.width, m_wrapX);
+        int y = wrap(int(std::floor(uv.y * level.height)), level.height, m_wrapY);
+        return fetch(level, x, y);
+    }
+
+    glm::vec4 SoftwareTexture::bilinear(const Level& level, const glm::vec2& uv) const {
+        float x = uv.x * level.width - .5f;
+        float y = uv.y * level.height - .5f;
+        float fx = std::floor(x), fy = std::floor(y);
+        float tx = x - fx, ty = y - fy;
+
+        int x0 = wrap(int(fx), level.width, m_wrapX), x1 = wrap(int(fx) + 1, level.width, m_wrapX);
+        int y0 = wrap(int(fy), level.height, m_wrapY), y1 = wrap(int(fy) + 1, level.height, m_wrapY);
+
+        glm::vec4 bottom = glm::mix(fetch(level, x0, y0), fetch(level, x1, y0), tx);
+        glm::vec4 top = glm::mix(fetch(level, x0, y1), fetch(level, x1, y1), tx);
+        return glm::mix(bottom, top, ty);
+    }
+
+    glm::vec4 SoftwareTexture::sample(const glm::vec2& uv, const glm::vec2& uvDx, const glm::vec2& uvDy) const {
+        if (m_levels.empty())
+            return glm::vec4{ .0f, .0f, .0f, 1.f };
+
+        glm::vec2 size{ float(m_levels[0].width), float(m_levels[0].height) };
+        glm::vec2 dx = uvDx * size, dy = uvDy * size;
+        float rhoSquared = std::max(glm::dot(dx, dx), glm::dot(dy, dy));
+
+        return sampleLevel(uv, rhoSquared > .0f ? .5f * std::log2(rhoSquared) : -1.f);
+    }
+
+    glm::vec4 SoftwareTexture::sampleLevel(const glm::vec2& uv, float lod) const {
+        if (m_levels.empty())
+            return glm::vec4{ .0f, .0f, .0f, 1.f };
+
+        if (lod <= .0f)
+            return m_magFilter == Texture::MagFilter::Nearest ? nearest(m_levels[0], uv) : bilinear(m_levels[0], uv);
+
+        const float maxLevel = float(m_levels.size() - 1);
+        lod = std::min(lod, maxLevel);
+
+        switch (m_minFilter) {
+        case Texture::MinFilter::Nearest:
+            return nearest(m_levels[0], uv);
+        case Texture::MinFilter::Linear:
+            return bilinear(m_levels[0], uv);
+        case Texture::MinFilter::Nearest_MipmapNearest:
+            return nearest(m_levels[std::size_t(lod + .5f)], uv);
+        case Texture::MinFilter::Linear_MipmapNearest:
+            return bilinear(m_levels[std::size_t(lod + .5f)], uv);
+        case Texture::MinFilter::Nearest_MipmapLinear: {
+            std::size_t level = std::size_t(lod);
+            std::size_t next = std::min(level + 1, m_levels.size() - 1);
+            return glm::mix(nearest(m_levels[level], uv), nearest(m_levels[next], uv), lod - float(level));
+        }
+        default: {
+            std::size_t level = std::size_t(lod);
+            std::size_t next = std::min(level + 1, m_levels.size() - 1);
+            return glm::mix(bilinear(m_levels[level], uv), bilinear(m_levels[next], uv), lod - float(level));
+        }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "Texture.h"
+#include "exceptions.h"
+
+namespace gl
+{
+    // CPU copy of a texture for the software rasterizer: RGBA8 with a full mip chain,
+    // sampled the same way GL would with the wrap and filter modes of gl::Texture.
+    class SoftwareTexture {
+    public:
+        SoftwareTexture():
+            m_levels(),
+            m_wrapX(Texture::Wrap::Repeat),
+            m_wrapY(Texture::Wrap::Repeat),
+            m_minFilter(Texture::MinFilter::Linear_MipmapLinear),
+            m_magFilter(Texture::MagFilter::Linear)
+        {}
+
+        // needs the image data kept by Texture::loadImage()
+        static SoftwareTexture fromTexture(const Texture& texture);
+
+        // pixels are tightly packed rows, bottom to top, with 1 to 4 channels
+        static SoftwareTexture fromPixels(const unsigned char* pixels, int width, int height, int channels);
+
+        SoftwareTexture& setWrapping(Texture::Wrap wrapping) {
+            m_wrapX = m_wrapY = wrapping;
+            return *this;
+        }
+        SoftwareTexture& setWrapping(Texture::Wrap wrappingX, Texture::Wrap wrappingY) {
+            m_wrapX = wrappingX;
+            m_wrapY = wrappingY;
+            return *this;
+        }
+
+        SoftwareTexture& setMinFilter(Texture::MinFilter f) {
+            m_minFilter = f;
+            return *this;
+        }
+        SoftwareTexture& setMagFilter(Texture::MagFilter f) {
+            m_magFilter = f;
+            return *this;
+        }
+
+        // level of detail picked from the screen-space derivatives of the coordinates
+        glm::vec4 sample(const glm::vec2& uv, const glm::vec2& uvDx, const glm::vec2& uvDy) const;
+        glm::vec4 sampleLevel(const glm::vec2& uv, float lod) const;
+
+        int getWidth() const { return m_levels.empty() ? 0 : m_levels[0].width; }
+        int getHeight() const { return m_levels.empty() ? 0 : m_levels[0].height; }
+        std::size_t levelCount() const { return m_levels.size(); }
+
+    private:
+        struct Level {
+            int width, height;
+            std::vector<std::uint32_t> texels;
+        };
+
+        void generateMipmaps();
+
+        glm::vec4 fetch(const Level& level, int x, int y) const;   // x and y already wrapped
+        glm::vec4 nearest(const Level& level, const glm::vec2& uv) const;
+        glm::vec4 bilinear(const Level& level, const glm::vec2& uv) const;
+
+        std::vector<Level> m_levels;
+        Texture::Wrap m_wrapX, m_wrapY;
+        Texture::MinFilter m_minFilter;
+        Texture::MagFilter m_magFilter;
+    };
+}
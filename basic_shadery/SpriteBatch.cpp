@@ -0,0 +1,157 @@
+﻿#include "SpriteBatch.h"
+
+#include <algorithm>
+
+namespace gl
+{
+    namespace
+    {
+        std::uint32_t packColor(const glm::vec4& color) {
+            auto channel = [](float value) {
+                return static_cast<std::uint32_t>(std::clamp(value, .0f, 1.f) * 255.f + .5f);
+            };
+
+            return channel(color.x) | channel(color.y) << 8 | channel(color.z) << 16 | channel(color.w) << 24;
+        }
+    }
+
+    SpriteBatch::SpriteBatch(ProgramCache& programs, std::size_t capacity):
+        m_capacity(std::clamp<std::size_t>(capacity, 1, maxCapacity)),
+        m_order(Order::Submission),
+        m_drawCount(0),
+        m_program(programs.get("assets/shaders/sprite.vert.glsl", "assets/shaders/sprite.frag.glsl")),
+        m_projection(m_program.createUniform<glm::mat4>("projection")),
+        m_sampler(m_program.createUniform<GLint>("sprite", 0)),
+        m_array(),
+        m_vertexBuffer(VertexBuffer::Target::Array),
+        m_indexBuffer(VertexBuffer::Target::ElementArray),
+        m_white(),
+        m_vertices(),
+        m_quadTextures(),
+        m_sortKeys(),
+        m_sortedVertices(),
+        m_sortedTextures()
+    {
+        std::vector<std::uint16_t> indices(m_capacity * 6);
+        for (std::size_t quad = 0; quad < m_capacity; quad++) {
+            std::uint16_t first = static_cast<std::uint16_t>(quad * 4);
+            const std::uint16_t pattern[] = { 0, 1, 2, 0, 2, 3 };
+            for (int i = 0; i < 6; i++)
+                indices[quad * 6 + i] = first + pattern[i];
+        }
+
+        GLsizei stride = sizeof(Vertex);
+
+        // the element array binding is part of the vertex array
+        m_array.bind();
+        m_indexBuffer
+            .bind()
+            .upload(indices.data(), indices.size() * sizeof(indices[0]));
+        m_vertexBuffer
+            .bind()
+            .upload(nullptr, m_capacity * 4 * sizeof(Vertex), VertexBuffer::Usage::Stream);
+        m_array
+            .setAttribute(m_program.getAttributeLocation("position"), 2, GL_FLOAT, stride, offsetof(Vertex, position))
+            .setAttribute(m_program.getAttributeLocation("texCoord"), 2, GL_FLOAT, stride, offsetof(Vertex, uv))
+            .setAttribute(m_program.getAttributeLocation("color"), 4, GL_UNSIGNED_BYTE, stride, offsetof(Vertex, color), true);
+        glBindVertexArray(0);
+
+        const unsigned char white[] = { 255, 255, 255, 255 };
+        m_white
+            .bind()
+            .allocate(1, 1, Texture::Format::RGBA8)
+            .setMinFilter(Texture::MinFilter::Nearest)
+            .setMagFilter(Texture::MagFilter::Nearest);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, white);
+    }
+
+    SpriteBatch& SpriteBatch::begin(const glm::mat4& projection, Order order) {
+        if (m_projection.value() != projection)
+            m_projection = projection;
+
+        m_order = order;
+        m_vertices.clear();
+        m_quadTextures.clear();
+        return *this;
+    }
+
+    SpriteBatch& SpriteBatch::draw(Texture& texture, const glm::vec2& position, const glm::vec2& size, const glm::vec4& uvRect, const glm::vec4& color) {
+        std::uint32_t packed = packColor(color);
+        glm::vec2 max = position + size;
+
+        m_vertices.push_back({ position, { uvRect.x, uvRect.y }, packed });
+        m_vertices.push_back({ { max.x, position.y }, { uvRect.z, uvRect.y }, packed });
+        m_vertices.push_back({ max, { uvRect.z, uvRect.w }, packed });
+        m_vertices.push_back({ { position.x, max.y }, { uvRect.x, uvRect.w }, packed });
+        m_quadTextures.push_back(&texture);
+        return *this;
+    }
+
+    void SpriteBatch::sortByTexture() {
+        std::size_t quadCount = m_quadTextures.size();
+
+        m_sortKeys.resize(quadCount);
+        for (std::size_t quad = 0; quad < quadCount; quad++)
+            m_sortKeys[quad] = std::uint64_t(m_quadTextures[quad]->getId()) << 32 | quad;
+
+        std::sort(m_sortKeys.begin(), m_sortKeys.end());
+
+        m_sortedVertices.resize(m_vertices.size());
+        m_sortedTextures.resize(quadCount);
+        for (std::size_t i = 0; i < quadCount; i++) {
+            std::size_t quad = static_cast<std::uint32_t>(m_sortKeys[i]);
+            std::copy_n(m_vertices.begin() + quad * 4, 4, m_sortedVertices.begin() + i * 4);
+            m_sortedTextures[i] = m_quadTextures[quad];
+        }
+    }
+
+    SpriteBatch& SpriteBatch::end() {
+        m_drawCount = 0;
+        if (m_quadTextures.empty())
+            return *this;
+
+        const Vertex* vertices = m_vertices.data();
+        Texture* const* textures = m_quadTextures.data();
+        if (m_order == Order::Texture) {
+            sortByTexture();
+            vertices = m_sortedVertices.data();
+            textures = m_sortedTextures.data();
+        }
+
+        bool isDepthTested = glIsEnabled(GL_DEPTH_TEST);
+        glDisable(GL_DEPTH_TEST);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glActiveTexture(GL_TEXTURE0);
+
+        m_program.bind();
+        m_array.bind();
+        m_vertexBuffer.bind();
+
+        std::size_t quadCount = m_quadTextures.size();
+        for (std::size_t chunk = 0; chunk < quadCount; chunk += m_capacity) {
+            std::size_t chunkSize = std::min(m_capacity, quadCount - chunk);
+            m_vertexBuffer.upload(vertices + chunk * 4, chunkSize * 4 * sizeof(Vertex), VertexBuffer::Usage::Stream);
+
+            for (std::size_t first = 0; first < chunkSize;) {
+                Texture* texture = textures[chunk + first];
+
+                std::size_t last = first + 1;
+                while (last < chunkSize && textures[chunk + last] == texture)
+                    last++;
+
+                texture->bind();
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>((last - first) * 6), GL_UNSIGNED_SHORT, (void*) (first * 6 * sizeof(std::uint16_t)));
+                m_drawCount++;
+                first = last;
+            }
+        }
+
+        glBindVertexArray(0);
+        glDisable(GL_BLEND);
+        if (isDepthTested)
+            glEnable(GL_DEPTH_TEST);
+
+        return *this;
+    }
+}
@@ -0,0 +1,105 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/mat4x4.hpp>
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+
+#include "Program.h"
+#include "ProgramCache.h"
+#include "Texture.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+namespace gl
+{
+    // Textured, tinted 2D quads for overlays and HUDs, drawn with as few draw calls as their
+    // textures allow instead of a draw and a uniform update per quad.
+    //
+    // draw() only appends the quad's four corners to a CPU array. end() uploads them into a
+    // stream buffer and issues one glDrawElements per run of quads sharing a texture. Every
+    // quad uses the same six indices shifted by four vertices, so the index buffer is built
+    // once and a run of quads is just a range of it. The vertex buffer is re-specified on every
+    // upload, so the driver hands out new storage instead of waiting for the last frame's draws
+    // to be done reading it. More quads than the capacity are drawn in several chunks.
+    //
+    // In submission order every texture change starts a new draw and overlapping sprites stay
+    // layered as drawn. Sorted by texture, every texture is drawn once per chunk, but the order
+    // is only kept among the sprites of the same texture.
+    class SpriteBatch {
+    public:
+        enum class Order {
+            Submission,
+            Texture
+        };
+
+        struct Vertex {
+            glm::vec2 position;
+            glm::vec2 uv;
+            std::uint32_t color;    // RGBA8, red in the lowest byte
+        };
+
+        // indices are 16-bit, a chunk is at most 65536 vertices
+        static constexpr std::size_t maxCapacity = 16384;
+
+        // the sprite shaders are loaded through programs, capacity is the most quads per upload
+        SpriteBatch(ProgramCache& programs, std::size_t capacity = maxCapacity);
+
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+        // projection maps sprite positions to clip space, e.g. glm::ortho(0, width, height, 0)
+        // for pixels with the origin in the top left corner
+        SpriteBatch& begin(const glm::mat4& projection, Order order = Order::Submission);
+
+        // position is the quad's min corner, uvRect holds the min uv in xy and the max in zw
+        SpriteBatch& draw(Texture& texture, const glm::vec2& position, const glm::vec2& size,
+            const glm::vec4& uvRect = { .0f, .0f, 1.f, 1.f }, const glm::vec4& color = { 1.f, 1.f, 1.f, 1.f });
+
+        // a solid rectangle, drawn with a white texture of the batch's own
+        SpriteBatch& fill(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color) {
+            return draw(m_white, position, size, { .0f, .0f, 1.f, 1.f }, color);
+        }
+
+        // draws the quads since begin() into the bound framebuffer, alpha blended and without the
+        // depth test. Leaves blending off, the depth test as it was and texture unit 0 in use.
+        SpriteBatch& end();
+
+        std::size_t capacity() const { return m_capacity; }
+        // quads since begin(), or in the last batch after end()
+        std::size_t spriteCount() const { return m_quadTextures.size(); }
+        // draw calls made by the last end()
+        std::size_t drawCount() const { return m_drawCount; }
+
+    private:
+        void sortByTexture();
+
+        std::size_t m_capacity;
+        Order m_order;
+        std::size_t m_drawCount;
+
+        Program& m_program;
+        Uniform<glm::mat4> m_projection;
+        Uniform<GLint> m_sampler;
+
+        VertexArray m_array;
+        VertexBuffer m_vertexBuffer;
+        VertexBuffer m_indexBuffer;
+        Texture m_white;
+
+        // four vertices and a texture per quad, in submission order
+        std::vector<Vertex> m_vertices;
+        std::vector<Texture*> m_quadTextures;
+
+        // texture id in the high half, submission index in the low one: sorted, it keeps the
+        // submission order within a texture without a stable sort
+        std::vector<std::uint64_t> m_sortKeys;
+        std::vector<Vertex> m_sortedVertices;
+        std::vector<Texture*> m_sortedTextures;
+    };
+}
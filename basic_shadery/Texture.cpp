@@ -12,10 +12,69 @@ namespace gl
         return *this;
     }
 
+    Texture& Texture::adoptImage(unsigned char* pixels, int w, int h, int c) {
+        stbi_image_free(data);
+
+        data = pixels;
+        width = w;
+        height = h;
+        channels = c;
+
+        return *this;
+    }
+
+    Texture& Texture::releaseImage() {
+        stbi_image_free(data);
+        data = nullptr;
+
+        return *this;
+    }
+
     Texture& Texture::upload() {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+        static const GLenum formats[] = { GL_RED, GL_RG, GL_RGB, GL_RGBA };
+        GLenum format = channels >= 1 && channels <= 4 ? formats[channels - 1] : GL_RGB;
+
+        // stb_image rows are tightly packed
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
         glGenerateMipmap(GL_TEXTURE_2D);
 
+        // grayscale (+ alpha) images sample as gray, not red
+        if (channels == 1 || channels == 2) {
+            GLint swizzle[] = { GL_RED, GL_RED, GL_RED, channels == 2 ? GL_GREEN : GL_ONE };
+            glTextureParameteriv(m_texId, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+
+        return *this;
+    }
+
+    Texture& Texture::allocate(GLsizei w, GLsizei h, Texture::Format format) {
+        GLenum pixelFormat = GL_RGBA, pixelType = GL_UNSIGNED_BYTE;
+
+        switch (format) {
+        case Format::R32F:
+            pixelFormat = GL_RED;
+            pixelType = GL_FLOAT;
+            break;
+        case Format::RGB8:
+            pixelFormat = GL_RGB;
+            break;
+        case Format::RGBA16F:
+            pixelType = GL_FLOAT;
+            break;
+        case Format::Depth24:
+            pixelFormat = GL_DEPTH_COMPONENT;
+            pixelType = GL_FLOAT;
+            break;
+        default:
+            break;
+        }
+
+        width = w;
+        height = h;
+        glTexImage2D(GL_TEXTURE_2D, 0, (GLint) format, width, height, 0, pixelFormat, pixelType, nullptr);
+
         return *this;
     }
 }
@@ -1,6 +1,8 @@
 ﻿#pragma once
 
-#include <GL/glew.h>
+#include <utility>
+
+#include "GlDispatch.h"
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
 #include <STB/stb_image.h>
@@ -21,7 +23,8 @@ namespace gl
     public:
         enum class Wrap {
             Repeat = GL_REPEAT,
-            Clamp = GL_CLAMP
+            Clamp = GL_CLAMP,
+            ClampToEdge = GL_CLAMP_TO_EDGE
         };
 
         enum class MinFilter {
@@ -38,6 +41,15 @@ namespace gl
             Linear = GL_LINEAR
         };
 
+        // storage formats for textures that are rendered to instead of loaded from an image
+        enum class Format {
+            R32F = GL_R32F,
+            RGB8 = GL_RGB8,
+            RGBA8 = GL_RGBA8,
+            RGBA16F = GL_RGBA16F,
+            Depth24 = GL_DEPTH_COMPONENT24
+        };
+
         Texture():
             m_texId(0),
             width(0),
@@ -122,7 +134,20 @@ namespace gl
         };
 
         Texture& loadImage(const char* filename);
+        // takes ownership of pixels allocated by stb_image, e.g. decoded on a loader thread
+        Texture& adoptImage(unsigned char* pixels, int width, int height, int channels);
+        // frees the CPU copy of the image once it has been uploaded
+        Texture& releaseImage();
         Texture& upload();
+        Texture& allocate(GLsizei width, GLsizei height, Texture::Format format);
+
+        GLuint getId() const { return m_texId; }
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
+
+        // image data kept from loadImage(), rows bottom to top, nullptr for allocated textures
+        int getChannels() const { return channels; }
+        const unsigned char* getPixels() const { return data; }
 
         ~Texture() {
             glDeleteTextures(1, &m_texId);
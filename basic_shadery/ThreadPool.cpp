@@ -0,0 +1,143 @@
+﻿#include "ThreadPool.h"
+
+namespace gl
+{
+    ThreadPool::ThreadPool(std::size_t threadCount):
+        m_workers(),
+        m_jobs(),
+        m_ranges(nullptr),
+        m_mutex(),
+        m_hasJobs(),
+        m_rangeFinished(),
+        m_isStopping(false)
+    {
+        if (threadCount == 0)
+            threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+        m_workers.reserve(threadCount);
+        for (std::size_t i = 0; i < threadCount; i++)
+            m_workers.emplace_back(&ThreadPool::work, this);
+    }
+
+    std::future<void> ThreadPool::submit(std::function<void()> job) {
+        std::packaged_task<void()> task{ std::move(job) };
+        auto result = task.get_future();
+
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_jobs.push(std::move(task));
+        }
+        m_hasJobs.notify_one();
+
+        return result;
+    }
+
+    void ThreadPool::work() {
+        for (;;) {
+            std::packaged_task<void()> task;
+            Ranges* ranges = nullptr;
+            std::size_t begin = 0, end = 0;
+
+            {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_hasJobs.wait(lock, [this]() { return m_isStopping || !m_jobs.empty() || m_ranges; });
+
+                // a thread is blocked on the ranges, they go first
+                if (m_ranges) {
+                    ranges = m_ranges;
+                    takeRange(*ranges, begin, end);
+                    ranges->running++;
+                } else if (m_jobs.empty()) {
+                    return;
+                } else {
+                    task = std::move(m_jobs.front());
+                    m_jobs.pop();
+                }
+            }
+
+            if (!ranges) {
+                task();
+                continue;
+            }
+
+            runRange(*ranges, begin, end);
+
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                ranges->running--;
+            }
+            // the ranges may be gone once the lock is released, only the pool is touched
+            m_rangeFinished.notify_all();
+        }
+    }
+
+    void ThreadPool::runRanges(Ranges& ranges) {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            ranges.nextRanges = m_ranges;
+            m_ranges = &ranges;
+        }
+        m_hasJobs.notify_all();
+
+        // the calling thread takes ranges like the workers, until none is left
+        for (;;) {
+            std::size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock{ m_mutex };
+                if (ranges.next == ranges.count)
+                    break;
+
+                takeRange(ranges, begin, end);
+            }
+
+            runRange(ranges, begin, end);
+        }
+
+        // every range has to finish before fn goes out of scope, even when one of them throws
+        std::unique_lock<std::mutex> lock{ m_mutex };
+        m_rangeFinished.wait(lock, [&ranges]() { return ranges.running == 0; });
+
+        if (ranges.error)
+            std::rethrow_exception(ranges.error);
+    }
+
+    void ThreadPool::takeRange(Ranges& ranges, std::size_t& begin, std::size_t& end) {
+        begin = ranges.next;
+        end = std::min(begin + ranges.step, ranges.count);
+        ranges.next = end;
+
+        if (end < ranges.count)
+            return;
+
+        Ranges** link = &m_ranges;
+        while (*link != &ranges)
+            link = &(*link)->nextRanges;
+        *link = ranges.nextRanges;
+    }
+
+    void ThreadPool::runRange(Ranges& ranges, std::size_t begin, std::size_t end) {
+        try {
+            ranges.run(ranges.fn, begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            if (!ranges.error)
+                ranges.error = std::current_exception();
+        }
+    }
+
+    ThreadPool& ThreadPool::shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_isStopping = true;
+        }
+        m_hasJobs.notify_all();
+
+        for (auto& worker : m_workers)
+            worker.join();
+    }
+}
@@ -0,0 +1,97 @@
+﻿#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace gl
+{
+    // Fixed set of worker threads executing submitted jobs in FIFO order.
+    class ThreadPool {
+    public:
+        // 0 threads means one per hardware thread
+        explicit ThreadPool(std::size_t threadCount = 0);
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        std::future<void> submit(std::function<void()> job);
+
+        // splits [0, count) into about one range per thread and blocks until all of them are done,
+        // the calling thread works on ranges too. Makes no heap allocations, so it can be used in
+        // frames that have to stay off the heap. Must not be called from inside a job.
+        template<typename Fn>
+        void parallelFor(std::size_t count, Fn&& fn);
+
+        std::size_t size() const { return m_workers.size(); }
+
+        // shared pool for CPU-side work that does not need its own threads
+        static ThreadPool& shared();
+
+        ~ThreadPool();
+
+    private:
+        // a parallelFor in progress, on the stack of the calling thread. The ranges are handed
+        // out in order, step items each; the fields below run are guarded by m_mutex.
+        struct Ranges {
+            void (*run)(const void* fn, std::size_t begin, std::size_t end);
+            const void* fn;
+            std::size_t count;
+            std::size_t step;
+
+            std::size_t next;           // first item not handed out yet
+            std::size_t running;        // ranges taken by workers and not finished
+            std::exception_ptr error;   // the first one thrown by a range
+            Ranges* nextRanges;         // in the list of those with ranges left
+        };
+
+        void work();
+        void runRanges(Ranges& ranges);
+        // hands out the next range, the ranges are unlisted with the last one. Expects m_mutex locked.
+        void takeRange(Ranges& ranges, std::size_t& begin, std::size_t& end);
+        void runRange(Ranges& ranges, std::size_t begin, std::size_t end);
+
+        std::vector<std::thread> m_workers;
+        std::queue<std::packaged_task<void()>> m_jobs;
+        Ranges* m_ranges;   // parallelFor calls with ranges left, served before the jobs
+        std::mutex m_mutex;
+        std::condition_variable m_hasJobs;
+        std::condition_variable m_rangeFinished;
+        bool m_isStopping;
+    };
+
+    template<typename Fn>
+    void ThreadPool::parallelFor(std::size_t count, Fn&& fn) {
+        using Function = std::remove_reference_t<Fn>;
+
+        if (count == 0)
+            return;
+
+        std::size_t parts = std::min(count, size() + 1);
+        if (parts == 1) {
+            fn(std::size_t{ 0 }, count);
+            return;
+        }
+
+        Ranges ranges{
+            [](const void* f, std::size_t begin, std::size_t end) { (*static_cast<Function*>(const_cast<void*>(f)))(begin, end); },
+            std::addressof(fn),
+            count,
+            (count + parts - 1) / parts,
+            0,
+            0,
+            nullptr,
+            nullptr
+        };
+        runRanges(ranges);
+    }
+}
@@ -1,12 +1,15 @@
 ﻿#pragma once
 
-#include <GL/glew.h>
+#include <string_view>
+
+#include "GlDispatch.h"
 #include <glm/matrix.hpp>
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "hash.h"
 #include "Program.h"
 
 namespace gl
@@ -17,12 +20,13 @@ namespace gl
     class Uniform {
         friend class Program;
 
+        // the name is hashed here, inline, so that literal names hash at compile time
         Uniform(const Program& prog, const char* name): m_prog(&prog), m_value(), m_uniformId(0) {
-            m_uniformId = glGetUniformLocation(m_prog->m_programId, name);
+            m_uniformId = m_prog->uniformLocation(fnv1a(name), name, glType());
         }
 
         Uniform(const Program& prog, const char* name, const T& value): m_prog(&prog), m_value(value), m_uniformId(0) {
-            m_uniformId = glGetUniformLocation(m_prog->m_programId, name);
+            m_uniformId = m_prog->uniformLocation(fnv1a(name), name, glType());
             update();
         }
 
@@ -74,6 +78,9 @@ namespace gl
         }
 
         void update();
+
+        // GL type of a uniform declared to match T
+        static GLenum glType();
     private:
 
         T m_value;
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
-#include <GL/glew.h>
+#include <cstddef>
+#include <utility>
+
+#include "GlDispatch.h"
 
 namespace gl
 {
@@ -10,10 +13,33 @@ namespace gl
             glGenVertexArrays(1, &m_arrayId);
         };
 
+        VertexArray(const VertexArray&) = delete;
+        VertexArray& operator=(const VertexArray&) = delete;
+
+        VertexArray(VertexArray&& other) noexcept: m_arrayId(0) {
+            std::swap(m_arrayId, other.m_arrayId);
+        }
+        VertexArray& operator=(VertexArray&& other) noexcept {
+            if (this != &other) {
+                std::swap(m_arrayId, other.m_arrayId);
+            }
+            return *this;
+        }
+
         void bind() const {
             glBindVertexArray(m_arrayId);
         };
 
+        // expects this array and the source buffer to be bound, negative locations are skipped
+        const VertexArray& setAttribute(GLint location, GLint components, GLenum type, GLsizei stride, std::size_t offset, bool normalized = false) const {
+            if (location < 0)
+                return *this;
+
+            glEnableVertexAttribArray(location);
+            glVertexAttribPointer(location, components, type, normalized ? GL_TRUE : GL_FALSE, stride, (void*) offset);
+            return *this;
+        };
+
         ~VertexArray() {
             glDeleteVertexArrays(1, &m_arrayId);
         };
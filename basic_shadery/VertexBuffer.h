@@ -1,12 +1,74 @@
 ﻿#pragma once
 
-#include <Gl/glew.h>
+#include <cstddef>
+#include <utility>
+
+#include "GlDispatch.h"
 
 namespace gl
 {
     class VertexBuffer {
+    public:
+        enum class Target {
+            Array = GL_ARRAY_BUFFER,
+            ElementArray = GL_ELEMENT_ARRAY_BUFFER
+        };
+
+        enum class Usage {
+            Static = GL_STATIC_DRAW,
+            Dynamic = GL_DYNAMIC_DRAW,
+            Stream = GL_STREAM_DRAW,
+            Copy = GL_DYNAMIC_COPY      // written and read by the GPU, e.g. through transform feedback
+        };
+
+        VertexBuffer(Target target = Target::Array): m_vbId(0), m_target(target), m_size(0) {
+            glGenBuffers(1, &m_vbId);
+        }
+
+        VertexBuffer(const VertexBuffer&) = delete;
+        VertexBuffer& operator=(const VertexBuffer&) = delete;
+
+        VertexBuffer(VertexBuffer&& other) noexcept: m_vbId(0), m_target(other.m_target), m_size(0) {
+            std::swap(m_vbId, other.m_vbId);
+            std::swap(m_size, other.m_size);
+        }
+        VertexBuffer& operator=(VertexBuffer&& other) noexcept {
+            if (this != &other) {
+                std::swap(m_vbId, other.m_vbId);
+                std::swap(m_target, other.m_target);
+                std::swap(m_size, other.m_size);
+            }
+            return *this;
+        }
+
+        VertexBuffer& bind() {
+            glBindBuffer((GLenum) m_target, m_vbId);
+            return *this;
+        };
+
+        VertexBuffer& bindAs(Target target) {
+            glBindBuffer((GLenum) target, m_vbId);
+            return *this;
+        };
+
+        // expects the buffer to be bound. data is read straight from the given memory
+        // (e.g. a file mapping), no intermediate copy is made on our side
+        VertexBuffer& upload(const void* data, std::size_t bytes, Usage usage = Usage::Static) {
+            glBufferData((GLenum) m_target, static_cast<GLsizeiptr>(bytes), data, (GLenum) usage);
+            m_size = bytes;
+            return *this;
+        };
+
+        GLuint getId() const { return m_vbId; }
+        std::size_t getSize() const { return m_size; }
+
+        ~VertexBuffer() {
+            glDeleteBuffers(1, &m_vbId);
+        };
 
     private:
         GLuint m_vbId;
+        Target m_target;
+        std::size_t m_size;
     };
 }
@@ -0,0 +1,467 @@
+﻿#include "VirtualTexture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace gl
+{
+    namespace
+    {
+        std::uint32_t readValue(const unsigned char* at) {
+            std::uint32_t value;
+            std::memcpy(&value, at, sizeof(value));
+            return value;
+        }
+
+        VirtualTextureLayout readLayout(const MappedFile& file, const std::filesystem::path& path) {
+            const unsigned char* data = file.data();
+
+            if (file.size() < VirtualTextureLayout::headerSize || std::memcmp(data, VirtualTextureLayout::magic, sizeof(VirtualTextureLayout::magic)) != 0)
+                throw virtual_texture_exception{ path.string() + ": not a virtual texture file" };
+            if (readValue(data + 8) != VirtualTextureLayout::version)
+                throw virtual_texture_exception{ path.string() + ": unsupported virtual texture version " + std::to_string(readValue(data + 8)) };
+
+            VirtualTextureLayout layout{ readValue(data + 12), readValue(data + 16), readValue(data + 20), readValue(data + 24) };
+            if (readValue(data + 28) != layout.levels.size() || file.size() < layout.fileSize())
+                throw virtual_texture_exception{ path.string() + ": virtual texture file is truncated or does not match its header" };
+
+            return layout;
+        }
+
+        unsigned nextPowerOfTwo(unsigned value) {
+            unsigned power = 1;
+            while (power < value)
+                power *= 2;
+            return power;
+        }
+    }
+
+    VirtualTexture::VirtualTexture(const std::filesystem::path& path, Program& program, const glm::tvec2<unsigned>& viewport, unsigned slotsPerSide, unsigned feedbackDownscale):
+        m_file(path),
+        m_layout(readLayout(m_file, path)),
+        m_cache(),
+        m_indirection(),
+        m_indirectionSize(nextPowerOfTwo(m_layout.levels[0].pagesX), nextPowerOfTwo(m_layout.levels[0].pagesY)),
+        m_entries(),
+        m_entryOffsets(),
+        m_slotsPerSide(slotsPerSide),
+        m_pageSlot(m_layout.pageCount(), noSlot),
+        m_slotPage(std::size_t(slotsPerSide) * slotsPerSide, noSlot),
+        m_slotUsed(std::size_t(slotsPerSide) * slotsPerSide, 0),
+        m_residentCount(0),
+        m_uploaded(0),
+        m_dirtyLevel(-1),
+        m_feedbackDownscale(std::max(feedbackDownscale, 1u)),
+        m_feedback(std::max<GLsizei>(viewport.x / m_feedbackDownscale, 1), std::max<GLsizei>(viewport.y / m_feedbackDownscale, 1)),
+        m_readbacks(),
+        m_nextReadback(0),
+        m_previousFramebuffer(0),
+        m_previousViewport(),
+        m_frame(1),
+        m_seenFrame(m_layout.pageCount(), 0),
+        m_pixelCount(m_layout.pageCount(), 0),
+        m_visible(),
+        m_missing(),
+        m_isFeedback(program.createUniform<GLint>("feedback", 0)),
+        m_lodBias(program.createUniform<GLfloat>("lodBias", .0f)),
+        m_mutex(),
+        m_wake(),
+        m_wanted(),
+        m_nextWanted(0),
+        m_isLoading(m_layout.pageCount(), false),
+        m_buffers(loadedPages, std::vector<unsigned char>(m_layout.pageBytes())),
+        m_freeBuffers(),
+        m_loaded(),
+        m_isStopping(false),
+        m_loader()
+    {
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+
+        // slots are addressed with 8 bits per axis in the indirection
+        GLsizei cacheSize = static_cast<GLsizei>(slotsPerSide * m_layout.slotSize());
+        if (slotsPerSide == 0 || slotsPerSide > 256 || cacheSize > maxSize)
+            throw virtual_texture_exception{ "Virtual texture page cache of " + std::to_string(slotsPerSide) + "^2 pages does not fit in a texture" };
+        // and pages with 12 bits in the feedback
+        if (m_layout.levels[0].pagesX > 4096 || m_layout.levels[0].pagesY > 4096)
+            throw virtual_texture_exception{ path.string() + ": virtual texture has more than 4096 pages per side" };
+
+        GLint previousTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+
+        m_indirection.bind()
+            .setMinFilter(Texture::MinFilter::Nearest_MipmapNearest)
+            .setMagFilter(Texture::MagFilter::Nearest);
+        glTextureParameteri(m_indirection.getId(), GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(m_layout.levels.size() - 1));
+
+        std::size_t entries = 0;
+        for (std::size_t level = 0; level < m_layout.levels.size(); level++) {
+            GLsizei width = std::max<GLsizei>(m_indirectionSize.x >> level, 1);
+            GLsizei height = std::max<GLsizei>(m_indirectionSize.y >> level, 1);
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA8UI, width, height, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+
+            m_entryOffsets.push_back(entries);
+            entries += std::size_t(width) * height * 4;
+        }
+        m_entries.assign(entries, 0);
+
+        m_cache.bind()
+            .setWrapping(Texture::Wrap::ClampToEdge)
+            .setMinFilter(Texture::MinFilter::Linear)
+            .setMagFilter(Texture::MagFilter::Linear)
+            .allocate(cacheSize, cacheSize, Texture::Format::RGBA8);
+
+        std::uint32_t root = m_layout.pageCount() - 1;
+        upload(root, m_file.data() + m_layout.pageOffset(root));
+        m_slotUsed[m_pageSlot[root]] = pinned;
+        updateIndirection();
+
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+
+        GLint previousBuffer = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previousBuffer);
+
+        for (auto& readback : m_readbacks) {
+            glGenBuffers(1, &readback.buffer);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+            glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(m_feedback.width()) * m_feedback.height() * 4, nullptr, GL_STREAM_READ);
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, previousBuffer);
+
+        program.createUniform<GLint>("pageCache", cacheUnit);
+        program.createUniform<GLint>("indirection", indirectionUnit);
+        program.createUniform<glm::vec2>("virtualSize", { static_cast<float>(m_layout.width), static_cast<float>(m_layout.height) });
+        program.createUniform<GLfloat>("pageSize", static_cast<float>(m_layout.pageSize));
+        program.createUniform<GLfloat>("border", static_cast<float>(m_layout.border));
+        program.createUniform<GLfloat>("slotSize", static_cast<float>(m_layout.slotSize()));
+        program.createUniform<GLfloat>("cacheSize", static_cast<float>(cacheSize));
+        program.createUniform<GLint>("maxLevel", static_cast<GLint>(m_layout.levels.size() - 1));
+
+        // reserved up front, so that no frame allocates
+        m_visible.reserve(m_layout.pageCount());
+        m_missing.reserve(m_layout.pageCount());
+        m_wanted.reserve(m_layout.pageCount());
+        m_loaded.reserve(loadedPages);
+        for (std::size_t i = 0; i < loadedPages; i++)
+            m_freeBuffers.push_back(i);
+
+        m_loader = std::thread{ &VirtualTexture::load, this };
+    }
+
+    void VirtualTexture::beginFeedback() {
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+        glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+
+        m_feedback.bind();
+        // alpha 0 marks pixels without the virtual texture
+        glClearColor(.0f, .0f, .0f, .0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // derivatives are feedbackDownscale times larger than in the scene, the bias brings the level back
+        m_isFeedback = 1;
+        m_lodBias = -std::log2(static_cast<float>(m_feedbackDownscale));
+    }
+
+    void VirtualTexture::endFeedback() {
+        ReadbackSlot& slot = m_readbacks[m_nextReadback];
+        // not read yet when the GPU is a whole ring behind, that feedback is skipped rather than waited for
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+
+        GLint previous = 0;
+        glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previous);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glReadPixels(0, 0, m_feedback.width(), m_feedback.height(), GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, previous);
+
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_nextReadback = (m_nextReadback + 1) % ringSize;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+        glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+
+        m_isFeedback = 0;
+        m_lodBias = .0f;
+    }
+
+    void VirtualTexture::update() {
+        // readbacks finish in order, only the newest finished one is worth reading
+        ReadbackSlot* newest = nullptr;
+        for (std::size_t i = 0; i < ringSize; i++) {
+            ReadbackSlot& slot = m_readbacks[(m_nextReadback + i) % ringSize];
+            if (!slot.fence)
+                continue;
+
+            GLenum status = glClientWaitSync(slot.fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+
+            if (newest) {
+                glDeleteSync(newest->fence);
+                newest->fence = nullptr;
+            }
+            newest = &slot;
+        }
+
+        if (newest) {
+            glDeleteSync(newest->fence);
+            newest->fence = nullptr;
+
+            GLint previous = 0;
+            glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &previous);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, newest->buffer);
+
+            const auto* pixels = static_cast<const std::uint8_t*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, GLsizeiptr(m_feedback.width()) * m_feedback.height() * 4, GL_MAP_READ_BIT));
+            if (pixels) {
+                m_frame++;
+                readFeedback(pixels);
+                glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                requestPages();
+            }
+
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, previous);
+        }
+
+        uploadLoaded();
+    }
+
+    void VirtualTexture::readFeedback(const std::uint8_t* pixels) {
+        for (std::uint32_t page : m_visible)
+            m_pixelCount[page] = 0;
+        m_visible.clear();
+
+        std::size_t count = std::size_t(m_feedback.width()) * m_feedback.height();
+        for (std::size_t i = 0; i < count; i++) {
+            const std::uint8_t* pixel = pixels + i * 4;
+            if (pixel[3] == 0)
+                continue;
+
+            // see virtual_textured.frag.glsl for the encoding
+            std::uint32_t level = pixel[3] - 1u;
+            std::uint32_t x = pixel[0] | (pixel[2] & 15u) << 8;
+            std::uint32_t y = pixel[1] | (pixel[2] >> 4) << 8;
+            if (level >= m_layout.levels.size() || x >= m_layout.levels[level].pagesX || y >= m_layout.levels[level].pagesY)
+                continue;
+
+            std::uint32_t page = m_layout.pageIndex(level, x, y);
+            if (m_seenFrame[page] != m_frame) {
+                m_seenFrame[page] = m_frame;
+                m_visible.push_back(page);
+            }
+            m_pixelCount[page]++;
+        }
+
+        // the ancestors are what the shader falls back to, they are kept and streamed in too
+        std::size_t seen = m_visible.size();
+        for (std::size_t i = 0; i < seen; i++) {
+            auto address = m_layout.pageAddress(m_visible[i]);
+
+            while (address.level + 1 < m_layout.levels.size()) {
+                address = { address.level + 1, address.x / 2, address.y / 2 };
+                std::uint32_t parent = m_layout.pageIndex(address.level, address.x, address.y);
+                if (m_seenFrame[parent] == m_frame)
+                    break;
+
+                m_seenFrame[parent] = m_frame;
+                m_visible.push_back(parent);
+            }
+        }
+
+        for (std::uint32_t page : m_visible) {
+            std::uint32_t slot = m_pageSlot[page];
+            if (slot != noSlot && m_slotUsed[slot] != pinned)
+                m_slotUsed[slot] = m_frame;
+        }
+    }
+
+    void VirtualTexture::requestPages() {
+        m_missing.clear();
+        for (std::uint32_t page : m_visible) {
+            if (m_pageSlot[page] == noSlot)
+                m_missing.push_back(page);
+        }
+
+        // coarse pages first, they cover the most and everything finer falls back to them;
+        // within a level the pages covering the most pixels
+        std::sort(m_missing.begin(), m_missing.end(), [this](std::uint32_t a, std::uint32_t b) {
+            std::uint32_t levelA = m_layout.pageAddress(a).level, levelB = m_layout.pageAddress(b).level;
+            if (levelA != levelB)
+                return levelA > levelB;
+            return m_pixelCount[a] > m_pixelCount[b];
+        });
+
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            // the previous request is dropped, whatever of it is still missing is in this one
+            m_wanted.swap(m_missing);
+            m_nextWanted = 0;
+        }
+        m_wake.notify_one();
+    }
+
+    void VirtualTexture::uploadLoaded() {
+        std::array<LoadedPage, uploadsPerFrame> taken;
+        std::size_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            count = std::min(m_loaded.size(), uploadsPerFrame);
+            std::copy_n(m_loaded.begin(), count, taken.begin());
+            m_loaded.erase(m_loaded.begin(), m_loaded.begin() + count);
+        }
+
+        if (count == 0 && m_dirtyLevel < 0)
+            return;
+
+        GLint previousTexture = 0;
+        glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+
+        m_cache.bind();
+        for (std::size_t i = 0; i < count; i++) {
+            // loaded twice when an older request still had it, or no slot free this frame;
+            // a page that did not fit is requested again by the next feedback
+            if (m_pageSlot[taken[i].page] == noSlot)
+                upload(taken[i].page, m_buffers[taken[i].buffer].data());
+        }
+
+        if (m_dirtyLevel >= 0)
+            updateIndirection();
+
+        glBindTexture(GL_TEXTURE_2D, previousTexture);
+
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            for (std::size_t i = 0; i < count; i++) {
+                m_isLoading[taken[i].page] = false;
+                m_freeBuffers.push_back(taken[i].buffer);
+            }
+        }
+        m_wake.notify_one();
+    }
+
+    bool VirtualTexture::upload(std::uint32_t page, const unsigned char* pixels) {
+        std::uint32_t slot = takeSlot();
+        if (slot == noSlot)
+            return false;
+
+        GLsizei slotSize = static_cast<GLsizei>(m_layout.slotSize());
+        glTexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(slot % m_slotsPerSide) * slotSize, static_cast<GLint>(slot / m_slotsPerSide) * slotSize, slotSize, slotSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+        m_pageSlot[page] = slot;
+        m_slotPage[slot] = page;
+        m_slotUsed[slot] = m_frame;
+        m_residentCount++;
+        m_uploaded++;
+        m_dirtyLevel = std::max(m_dirtyLevel, static_cast<int>(m_layout.pageAddress(page).level));
+        return true;
+    }
+
+    std::uint32_t VirtualTexture::takeSlot() {
+        std::uint32_t oldest = noSlot;
+        for (std::uint32_t slot = 0; slot < m_slotPage.size(); slot++) {
+            if (m_slotPage[slot] == noSlot)
+                return slot;
+
+            // pages seen in the newest feedback stay
+            if (m_slotUsed[slot] < m_frame && (oldest == noSlot || m_slotUsed[slot] < m_slotUsed[oldest]))
+                oldest = slot;
+        }
+
+        if (oldest == noSlot)
+            return noSlot;
+
+        std::uint32_t evicted = m_slotPage[oldest];
+        m_pageSlot[evicted] = noSlot;
+        m_slotPage[oldest] = noSlot;
+        m_residentCount--;
+        m_dirtyLevel = std::max(m_dirtyLevel, static_cast<int>(m_layout.pageAddress(evicted).level));
+        return oldest;
+    }
+
+    void VirtualTexture::updateIndirection() {
+        m_indirection.bind();
+
+        // coarse to fine, a missing page takes its parent's entry
+        for (int level = m_dirtyLevel; level >= 0; level--) {
+            const auto& info = m_layout.levels[level];
+            std::uint32_t width = std::max(m_indirectionSize.x >> level, 1u);
+            std::uint32_t height = std::max(m_indirectionSize.y >> level, 1u);
+            std::uint32_t parentWidth = std::max(m_indirectionSize.x >> (level + 1), 1u);
+
+            std::uint8_t* entries = m_entries.data() + m_entryOffsets[level];
+            const std::uint8_t* parents = level + 1 < static_cast<int>(m_layout.levels.size()) ? m_entries.data() + m_entryOffsets[level + 1] : nullptr;
+
+            for (std::uint32_t y = 0; y < height; y++) {
+                for (std::uint32_t x = 0; x < width; x++) {
+                    std::uint8_t* entry = entries + (std::size_t(y) * width + x) * 4;
+                    std::uint32_t slot = x < info.pagesX && y < info.pagesY ? m_pageSlot[m_layout.pageIndex(level, x, y)] : noSlot;
+
+                    if (slot != noSlot) {
+                        entry[0] = static_cast<std::uint8_t>(slot % m_slotsPerSide);
+                        entry[1] = static_cast<std::uint8_t>(slot / m_slotsPerSide);
+                        entry[2] = static_cast<std::uint8_t>(level);
+                        entry[3] = 1;
+                    } else if (parents) {
+                        std::copy_n(parents + (std::size_t(y / 2) * parentWidth + x / 2) * 4, 4, entry);
+                    } else {
+                        std::fill_n(entry, 4, std::uint8_t{ 0 });
+                    }
+                }
+            }
+
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, entries);
+        }
+
+        m_dirtyLevel = -1;
+    }
+
+    VirtualTexture& VirtualTexture::bind() {
+        glActiveTexture(GL_TEXTURE0 + indirectionUnit);
+        m_indirection.bind();
+        glActiveTexture(GL_TEXTURE0 + cacheUnit);
+        m_cache.bind();
+        return *this;
+    }
+
+    void VirtualTexture::load() {
+        std::unique_lock<std::mutex> lock{ m_mutex };
+
+        for (;;) {
+            m_wake.wait(lock, [this]() { return m_isStopping || (m_nextWanted < m_wanted.size() && !m_freeBuffers.empty()); });
+            if (m_isStopping)
+                return;
+
+            std::uint32_t page = m_wanted[m_nextWanted++];
+            if (m_isLoading[page])
+                continue;
+
+            m_isLoading[page] = true;
+            std::size_t buffer = m_freeBuffers.back();
+            m_freeBuffers.pop_back();
+
+            // touching the mapping is what reads the page from disk, done without the lock
+            lock.unlock();
+            std::memcpy(m_buffers[buffer].data(), m_file.data() + m_layout.pageOffset(page), m_layout.pageBytes());
+            lock.lock();
+
+            m_loaded.push_back({ page, buffer });
+        }
+    }
+
+    VirtualTexture::~VirtualTexture() {
+        {
+            std::lock_guard<std::mutex> lock{ m_mutex };
+            m_isStopping = true;
+        }
+        m_wake.notify_all();
+        m_loader.join();
+
+        for (auto& readback : m_readbacks) {
+            if (readback.fence)
+                glDeleteSync(readback.fence);
+            glDeleteBuffers(1, &readback.buffer);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+﻿#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/vec2.hpp>
+
+#include "MappedFile.h"
+#include "Program.h"
+#include "RenderTarget.h"
+#include "Texture.h"
+#include "Uniform.h"
+#include "VirtualTextureFile.h"
+
+namespace gl
+{
+    // Texture far larger than GPU memory, streamed in pages from a file made by VirtualTextureTiler.
+    //
+    // The scene is drawn a second time at a fraction of the resolution into a feedback target,
+    // where the shader writes the page each pixel would sample instead of its color. The target
+    // is read back through a ring of pixel pack buffers, like FrameCapture does, so the pages
+    // seen are known a couple of frames later without waiting on the GPU. Missing pages go to a
+    // loader thread, coarse levels first, which copies them out of the memory-mapped file so that
+    // the disk reads happen off the GL thread; the GL thread uploads a few of the loaded pages
+    // each frame into free slots of the page cache texture, evicting the least recently seen.
+    //
+    // The shader finds pages through the indirection texture, one texel per page of every
+    // level holding the cache slot and the level of the best resident page covering it, so a
+    // missing page samples its nearest resident ancestor until it is streamed in. The single
+    // page of the last level is loaded up front and never evicted, every lookup finds something.
+    //
+    // The program is expected to use virtual_textured.frag.glsl.
+    class VirtualTexture {
+    public:
+        // viewport is the resolution the scene is drawn at, the feedback is feedbackDownscale
+        // times smaller; the cache holds slotsPerSide^2 pages
+        VirtualTexture(const std::filesystem::path& path, Program& program, const glm::tvec2<unsigned>& viewport, unsigned slotsPerSide = 16, unsigned feedbackDownscale = 8);
+
+        VirtualTexture(const VirtualTexture&) = delete;
+        VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+        // binds the feedback target, draw the scene with the program after it. Leaves the
+        // clear color at zero.
+        void beginFeedback();
+        // queues the readback of the feedback and binds the previous framebuffer back
+        void endFeedback();
+
+        // once per frame on the GL thread: reads finished feedback, hands the missing pages to
+        // the loader thread and uploads the pages it has loaded
+        void update();
+
+        // binds the page cache and the indirection texture to their texture units
+        VirtualTexture& bind();
+
+        const VirtualTextureLayout& layout() const { return m_layout; }
+        std::size_t residentPages() const { return m_residentCount; }
+        std::size_t slotCount() const { return m_slotPage.size(); }
+        // pages seen in the last feedback read and their ancestors, resident or not
+        std::size_t visiblePages() const { return m_visible.size(); }
+        std::size_t uploadedPages() const { return m_uploaded; }
+
+        static constexpr std::size_t ringSize = 3;
+        // loaded pages waiting for an upload, the loader thread stops when all are taken
+        static constexpr std::size_t loadedPages = 32;
+        static constexpr std::size_t uploadsPerFrame = 16;
+        static constexpr GLint cacheUnit = 0;
+        static constexpr GLint indirectionUnit = 1;
+
+        ~VirtualTexture();
+
+    private:
+        static constexpr std::uint32_t noSlot = 0xffffffffu;
+        static constexpr std::uint64_t pinned = ~std::uint64_t{ 0 };
+
+        struct ReadbackSlot {
+            GLuint buffer = 0;
+            GLsync fence = nullptr;
+        };
+
+        struct LoadedPage {
+            std::uint32_t page;
+            std::size_t buffer;
+        };
+
+        void readFeedback(const std::uint8_t* pixels);
+        void requestPages();
+        void uploadLoaded();
+        // expects the cache to be bound, false when every slot holds a page seen in the last feedback
+        bool upload(std::uint32_t page, const unsigned char* pixels);
+        std::uint32_t takeSlot();
+        void updateIndirection();
+
+        void load();
+
+        MappedFile m_file;
+        VirtualTextureLayout m_layout;
+
+        Texture m_cache;
+        Texture m_indirection;
+        // size of the indirection texture's level 0, the page counts rounded up to powers of two
+        glm::uvec2 m_indirectionSize;
+        // CPU copy of every level of the indirection, level l starts at m_entryOffsets[l]
+        std::vector<std::uint8_t> m_entries;
+        std::vector<std::size_t> m_entryOffsets;
+
+        unsigned m_slotsPerSide;
+        std::vector<std::uint32_t> m_pageSlot;
+        std::vector<std::uint32_t> m_slotPage;
+        std::vector<std::uint64_t> m_slotUsed;
+        std::size_t m_residentCount;
+        std::size_t m_uploaded;
+        // coarsest level whose indirection changed since it was last uploaded, -1 for none
+        int m_dirtyLevel;
+
+        unsigned m_feedbackDownscale;
+        RenderTarget m_feedback;
+        std::array<ReadbackSlot, ringSize> m_readbacks;
+        std::size_t m_nextReadback;
+        GLint m_previousFramebuffer;
+        GLint m_previousViewport[4];
+
+        std::uint64_t m_frame;
+        std::vector<std::uint64_t> m_seenFrame;
+        std::vector<std::uint32_t> m_pixelCount;
+        std::vector<std::uint32_t> m_visible;
+        std::vector<std::uint32_t> m_missing;
+
+        Uniform<GLint> m_isFeedback;
+        Uniform<GLfloat> m_lodBias;
+
+        // shared with the loader thread
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::vector<std::uint32_t> m_wanted;
+        std::size_t m_nextWanted;
+        // set from the loader taking a page until the GL thread is done with it
+        std::vector<bool> m_isLoading;
+        std::vector<std::vector<unsigned char>> m_buffers;
+        std::vector<std::size_t> m_freeBuffers;
+        std::vector<LoadedPage> m_loaded;
+        bool m_isStopping;
+        std::thread m_loader;
+    };
+}
@@ -0,0 +1,135 @@
+﻿#include "VirtualTextureFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_STATIC
+#include <STB/stb_image.h>
+
+#include "ThreadPool.h"
+
+namespace gl
+{
+    namespace
+    {
+        void writeValue(std::ofstream& out, std::uint32_t value) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        // copies the page with its border out of an RGBA8 image, pixels past the edges repeat the edge
+        void cutPage(const unsigned char* image, std::uint32_t width, std::uint32_t height, const VirtualTextureLayout& layout, std::uint32_t pageX, std::uint32_t pageY, unsigned char* page) {
+            std::uint32_t slot = layout.slotSize();
+            long long left = static_cast<long long>(pageX) * layout.pageSize - layout.border;
+            long long bottom = static_cast<long long>(pageY) * layout.pageSize - layout.border;
+
+            for (std::uint32_t y = 0; y < slot; y++) {
+                std::size_t sourceY = static_cast<std::size_t>(std::clamp<long long>(bottom + y, 0, height - 1));
+                const unsigned char* row = image + sourceY * width * 4;
+
+                for (std::uint32_t x = 0; x < slot; x++) {
+                    std::size_t sourceX = static_cast<std::size_t>(std::clamp<long long>(left + x, 0, width - 1));
+                    std::copy_n(row + sourceX * 4, 4, page + (std::size_t(y) * slot + x) * 4);
+                }
+            }
+        }
+
+        // 2x2 box filter, an odd last row or column is averaged with itself
+        std::vector<unsigned char> downsample(const unsigned char* image, std::uint32_t width, std::uint32_t height, std::uint32_t halfWidth, std::uint32_t halfHeight) {
+            std::vector<unsigned char> half(std::size_t(halfWidth) * halfHeight * 4);
+
+            ThreadPool::shared().parallelFor(halfHeight, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t y = begin; y < end; y++) {
+                    const unsigned char* row0 = image + std::min<std::size_t>(2 * y, height - 1) * width * 4;
+                    const unsigned char* row1 = image + std::min<std::size_t>(2 * y + 1, height - 1) * width * 4;
+                    unsigned char* out = half.data() + y * halfWidth * 4;
+
+                    for (std::size_t x = 0; x < halfWidth; x++) {
+                        std::size_t x0 = 2 * x * 4, x1 = std::min<std::size_t>(2 * x + 1, width - 1) * 4;
+                        for (std::size_t c = 0; c < 4; c++)
+                            out[x * 4 + c] = static_cast<unsigned char>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+                    }
+                }
+            });
+
+            return half;
+        }
+    }
+
+    const char VirtualTextureLayout::magic[8] = { 'G', 'R', 'A', 'F', 'V', 'T', '\0', '\0' };
+
+    VirtualTextureLayout::VirtualTextureLayout(std::uint32_t width, std::uint32_t height, std::uint32_t pageSize, std::uint32_t border):
+        width(width),
+        height(height),
+        pageSize(pageSize),
+        border(border),
+        levels()
+    {
+        if (width == 0 || height == 0 || pageSize == 0)
+            throw virtual_texture_exception{ "Virtual texture with an empty image or page size" };
+
+        std::uint32_t firstPage = 0;
+        for (;;) {
+            Level level{ width, height, (width + pageSize - 1) / pageSize, (height + pageSize - 1) / pageSize, firstPage };
+            levels.push_back(level);
+
+            if (level.pagesX == 1 && level.pagesY == 1)
+                break;
+
+            firstPage += level.pagesX * level.pagesY;
+            width = (width + 1) / 2;
+            height = (height + 1) / 2;
+        }
+    }
+
+    VirtualTextureLayout VirtualTextureTiler::build(const char* imagePath, const std::filesystem::path& outputPath, std::uint32_t pageSize, std::uint32_t border) {
+        // same orientation as Texture::loadImage, rows bottom to top
+        stbi_set_flip_vertically_on_load(true);
+
+        int width, height, channels;
+        std::unique_ptr<unsigned char, void(*)(void*)> decoded{ stbi_load(imagePath, &width, &height, &channels, 4), stbi_image_free };
+        if (!decoded)
+            throw virtual_texture_exception{ std::string{ imagePath } + ": " + stbi_failure_reason() };
+
+        VirtualTextureLayout layout{ static_cast<std::uint32_t>(width), static_cast<std::uint32_t>(height), pageSize, border };
+
+        std::ofstream out{ outputPath, std::ios::binary };
+        if (!out)
+            throw virtual_texture_exception{ outputPath.string() + ": could not be opened for writing" };
+
+        out.write(VirtualTextureLayout::magic, sizeof(VirtualTextureLayout::magic));
+        for (std::uint32_t value : { VirtualTextureLayout::version, layout.width, layout.height, pageSize, border, static_cast<std::uint32_t>(layout.levels.size()) })
+            writeValue(out, value);
+
+        std::vector<unsigned char> page(layout.pageBytes());
+        std::vector<unsigned char> level;
+        const unsigned char* pixels = decoded.get();
+
+        for (std::size_t l = 0; l < layout.levels.size(); l++) {
+            const auto& info = layout.levels[l];
+
+            for (std::uint32_t y = 0; y < info.pagesY; y++) {
+                for (std::uint32_t x = 0; x < info.pagesX; x++) {
+                    cutPage(pixels, info.width, info.height, layout, x, y, page.data());
+                    out.write(reinterpret_cast<const char*>(page.data()), page.size());
+                }
+            }
+
+            if (l + 1 == layout.levels.size())
+                break;
+
+            const auto& next = layout.levels[l + 1];
+            level = downsample(pixels, info.width, info.height, next.width, next.height);
+            pixels = level.data();
+
+            // the full resolution image is the largest allocation, gone as soon as the next level exists
+            decoded.reset();
+        }
+
+        if (!out)
+            throw virtual_texture_exception{ outputPath.string() + ": writing the pages failed" };
+
+        return layout;
+    }
+}
@@ -0,0 +1,82 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "exceptions.h"
+
+namespace gl
+{
+    class virtual_texture_exception : public exception {
+        using super = exception;
+        std::string message;
+
+    public:
+        virtual_texture_exception(): message(), super() {}
+        virtual_texture_exception(const std::string& mess): message(mess), super(mess.c_str()) {}
+
+        const char* what() {
+            return message.c_str();
+        }
+    };
+
+    // Layout of a virtual texture file, shared by the tiler writing it and VirtualTexture reading it.
+    //
+    // The header is the magic, then version, width, height, page size, border and level count as
+    // 32-bit integers. The pages follow, level 0 first, each level's rows bottom to top. Every page
+    // is slotSize() x slotSize() RGBA8 pixels, rows bottom to top: the page's own pageSize pixels
+    // with a border of the neighbouring pixels around them, so that bilinear filtering in the page
+    // cache never reads another page. A page of level l covers pageSize << l pixels of level 0 and
+    // level l is level 0 scaled down by 2^l (rounded up), so the page holding a point at any level
+    // follows from its level 0 position alone. The last level is a single page.
+    struct VirtualTextureLayout {
+        struct Level {
+            std::uint32_t width, height;
+            std::uint32_t pagesX, pagesY;
+            std::uint32_t firstPage;
+        };
+
+        struct PageAddress {
+            std::uint32_t level, x, y;
+        };
+
+        static const char magic[8];
+        static const std::uint32_t version = 1;
+        static const std::size_t headerSize = 32;
+
+        VirtualTextureLayout(std::uint32_t width, std::uint32_t height, std::uint32_t pageSize, std::uint32_t border);
+
+        std::uint32_t slotSize() const { return pageSize + 2 * border; }
+        std::size_t pageBytes() const { return std::size_t(slotSize()) * slotSize() * 4; }
+        std::uint32_t pageCount() const { return levels.back().firstPage + 1; }
+        std::size_t fileSize() const { return headerSize + pageCount() * pageBytes(); }
+
+        std::uint32_t pageIndex(std::uint32_t level, std::uint32_t x, std::uint32_t y) const {
+            return levels[level].firstPage + y * levels[level].pagesX + x;
+        }
+        PageAddress pageAddress(std::uint32_t index) const {
+            std::uint32_t level = 0;
+            while (level + 1 < levels.size() && levels[level + 1].firstPage <= index)
+                level++;
+
+            std::uint32_t offset = index - levels[level].firstPage;
+            return { level, offset % levels[level].pagesX, offset / levels[level].pagesX };
+        }
+        std::size_t pageOffset(std::uint32_t index) const { return headerSize + index * pageBytes(); }
+
+        std::uint32_t width, height;
+        std::uint32_t pageSize, border;
+        std::vector<Level> levels;
+    };
+
+    // Offline step: cuts an image into the pages of a virtual texture file. The image is decoded
+    // whole with stb_image, the mip levels are built by 2x2 box filtering on the thread pool and
+    // written out one level at a time. Returns the layout of the file written.
+    class VirtualTextureTiler {
+    public:
+        static VirtualTextureLayout build(const char* imagePath, const std::filesystem::path& outputPath, std::uint32_t pageSize = 128, std::uint32_t border = 4);
+    };
+}
@@ -3,7 +3,21 @@
 in vec3 Color;
 out vec4 outColor;
 
+#ifdef CLUSTERED_LIGHTING
+#include "include/clustered_lighting.glsl"
+
+in vec3 ViewPosition;
+in vec4 ClipPosition;
+
+uniform vec3 ambient = vec3(0.15);
+#endif
+
 void main()
 {
 	outColor = vec4(Color, 1.0f);
+
+#ifdef CLUSTERED_LIGHTING
+	vec3 normal = normalize(cross(dFdx(ViewPosition), dFdy(ViewPosition)));
+	outColor.rgb *= ambient + clusteredLighting(ClipPosition, ViewPosition, normal);
+#endif
 }
\ No newline at end of file
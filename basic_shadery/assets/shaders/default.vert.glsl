@@ -6,6 +6,11 @@ in vec3 color;
 out vec3 Color;
 out vec3 pos;
 
+#ifdef CLUSTERED_LIGHTING
+out vec3 ViewPosition;
+out vec4 ClipPosition;
+#endif
+
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
@@ -13,5 +18,11 @@ uniform mat4 projection;
 void main(){
     Color = color;
     pos = position;
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    vec4 viewPosition = view * model * vec4(position, 1.0);
+    gl_Position = projection * viewPosition;
+
+#ifdef CLUSTERED_LIGHTING
+    ViewPosition = viewPosition.xyz;
+    ClipPosition = gl_Position;
+#endif
 }
@@ -0,0 +1,22 @@
+#version 150 core
+
+in vec2 uv;
+out vec4 outColor;
+
+uniform sampler2D iterations;
+uniform float iterationLimit;
+
+const float TWO_PI = 6.28318530718;
+
+void main() {
+    float value = texture(iterations, uv).r;
+
+    if (value < 0.0) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    float t = pow(value/iterationLimit, 0.35);
+
+    outColor = vec4(0.5 + 0.5*cos(TWO_PI*(t + vec3(0.0, 0.1, 0.2))), 1.0);
+}
@@ -0,0 +1,37 @@
+#version 150 core
+
+in vec2 uv;
+out vec4 outColor;
+
+uniform vec2 origin;
+uniform float extent;
+
+// injected per refinement stage, so the loop bound is a compile-time constant
+#ifndef ITERATION_LIMIT
+#define ITERATION_LIMIT 400
+#endif
+
+void main() {
+    vec2 c = origin + uv*extent;
+
+    // points inside the main cardioid and the period-2 bulb never escape
+    float q = (c.x - .25)*(c.x - .25) + c.y*c.y;
+    if (q*(q + c.x - .25) <= .25*c.y*c.y || (c.x + 1.0)*(c.x + 1.0) + c.y*c.y <= .0625) {
+        outColor = vec4(-1.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    vec2 z = vec2(0.0, 0.0);
+    int i = 0;
+
+    for (; i < ITERATION_LIMIT; i++) {
+        if (dot(z, z) > 256.0) break;
+
+        z = vec2(z.x*z.x - z.y*z.y, 2.0*z.x*z.y) + c;
+    }
+
+    // smooth (fractional) iteration count, -1 for points that did not escape
+    float value = (i < ITERATION_LIMIT) ? float(i) + 1.0 - log2(log2(dot(z, z))*0.5) : -1.0;
+
+    outColor = vec4(value, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,44 @@
+// Point lights looked up per cluster, set up by gl::ClusteredLighting. Pulled in with
+// #include "include/clustered_lighting.glsl" by shaders built with CLUSTERED_LIGHTING.
+
+// two texels per light: view space position and radius, color
+uniform samplerBuffer clusterLights;
+// per cluster: offset of its first light in clusterIndices, light count
+uniform usamplerBuffer clusterGrid;
+uniform usamplerBuffer clusterIndices;
+
+uniform uvec3 clusterCounts;
+// slice of view depth d is floor(log(d)*clusterDepthScale.x - clusterDepthScale.y)
+uniform vec2 clusterDepthScale;
+
+// the cluster holding a fragment, from its clip space and view space positions
+int clusterIndex(vec4 clipPosition, vec3 viewPosition) {
+    vec2 tiles = vec2(clusterCounts.xy);
+    vec2 tile = clamp(floor((clipPosition.xy/clipPosition.w*0.5 + 0.5)*tiles), vec2(0.0), tiles - 1.0);
+    float slice = clamp(floor(log(-viewPosition.z)*clusterDepthScale.x - clusterDepthScale.y), 0.0, float(clusterCounts.z) - 1.0);
+
+    return int((slice*tiles.y + tile.y)*tiles.x + tile.x);
+}
+
+// diffuse light reaching a point with the given view space normal
+vec3 clusteredLighting(vec4 clipPosition, vec3 viewPosition, vec3 normal) {
+    uvec2 cluster = texelFetch(clusterGrid, clusterIndex(clipPosition, viewPosition)).xy;
+
+    vec3 light = vec3(0.0);
+    for (uint i = 0u; i < cluster.y; i++) {
+        int index = int(texelFetch(clusterIndices, int(cluster.x + i)).r);
+        vec4 positionRadius = texelFetch(clusterLights, 2*index);
+        vec3 color = texelFetch(clusterLights, 2*index + 1).rgb;
+
+        vec3 toLight = positionRadius.xyz - viewPosition;
+        float distance = length(toLight);
+
+        // inverse square, windowed to reach zero at the radius
+        float window = clamp(1.0 - pow(distance/positionRadius.w, 4.0), 0.0, 1.0);
+        float attenuation = window*window/(distance*distance + 1.0);
+
+        light += color*max(dot(normal, toLight/max(distance, 1e-4)), 0.0)*attenuation;
+    }
+
+    return light;
+}
@@ -0,0 +1,9 @@
+// Helpers shared between fragment shaders, pulled in with #include "include/common.glsl"
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+float map(float x, float min_s, float max_s, float min_d, float max_d) {
+    return ((x - min_s)/(max_s - min_s))*(max_d - min_d) + min_d;
+}
@@ -4,7 +4,10 @@ in vec3 Color;
 in vec2 pos;
 out vec4 outColor;
 
+// can be overridden per variant with an injected define
+#ifndef ITERATION_LIMIT
 #define ITERATION_LIMIT 400
+#endif
 
 const float PI = 3.1415926535897932384626433832795;
 
@@ -0,0 +1,46 @@
+#version 150 core
+
+// Replicates every triangle into the layers of a layered render target, one layer per view,
+// projected with that view's camera. MAX_VIEWS has to match gl::MultiView::maxViews.
+
+#define MAX_VIEWS 8
+
+layout(triangles) in;
+// 3*MAX_VIEWS, layout qualifiers only take a literal in GLSL 1.50
+layout(triangle_strip, max_vertices = 24) out;
+
+in vec3 VertexColor[];
+in vec2 VertexTexCoord[];
+
+out vec3 Color;
+out vec2 TexCoord;
+
+uniform mat4 viewProjections[MAX_VIEWS];
+uniform int viewCount;
+
+void main() {
+    for (int view = 0; view < viewCount; view++) {
+        vec4 clip[3];
+        for (int i = 0; i < 3; i++)
+            clip[i] = viewProjections[view]*gl_in[i].gl_Position;
+
+        // all three corners past the same clip plane, the view does not see the triangle
+        bvec3 left = bvec3(clip[0].x < -clip[0].w, clip[1].x < -clip[1].w, clip[2].x < -clip[2].w);
+        bvec3 right = bvec3(clip[0].x > clip[0].w, clip[1].x > clip[1].w, clip[2].x > clip[2].w);
+        bvec3 bottom = bvec3(clip[0].y < -clip[0].w, clip[1].y < -clip[1].w, clip[2].y < -clip[2].w);
+        bvec3 top = bvec3(clip[0].y > clip[0].w, clip[1].y > clip[1].w, clip[2].y > clip[2].w);
+        bvec3 beforeNear = bvec3(clip[0].z < -clip[0].w, clip[1].z < -clip[1].w, clip[2].z < -clip[2].w);
+        bvec3 pastFar = bvec3(clip[0].z > clip[0].w, clip[1].z > clip[1].w, clip[2].z > clip[2].w);
+        if (all(left) || all(right) || all(bottom) || all(top) || all(beforeNear) || all(pastFar))
+            continue;
+
+        for (int i = 0; i < 3; i++) {
+            gl_Layer = view;
+            Color = VertexColor[i];
+            TexCoord = VertexTexCoord[i];
+            gl_Position = clip[i];
+            EmitVertex();
+        }
+        EndPrimitive();
+    }
+}
@@ -0,0 +1,19 @@
+#version 150 core
+
+// The scene's vertices for multiview.geom.glsl: only the model transform happens here,
+// the geometry shader projects every triangle once per view.
+
+in vec3 position;
+in vec3 color;
+in vec2 texCoord;
+
+out vec3 VertexColor;
+out vec2 VertexTexCoord;
+
+uniform mat4 model;
+
+void main() {
+    VertexColor = color;
+    VertexTexCoord = texCoord;
+    gl_Position = model * vec4(position, 1.0);
+}
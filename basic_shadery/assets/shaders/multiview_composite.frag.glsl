@@ -0,0 +1,27 @@
+#version 150 core
+
+// The layers of a gl::MultiView side by side, in a grid of the given number of columns and
+// as many rows as needed, filled row by row from the top left. Cells past the last view
+// stay black.
+
+in vec2 uv;
+out vec4 outColor;
+
+uniform sampler2DArray views;
+uniform int viewCount;
+uniform int columns;
+
+void main() {
+    int rows = (viewCount + columns - 1)/columns;
+    vec2 grid = vec2(columns, rows);
+    vec2 cell = min(floor(uv*grid), grid - 1.0);
+
+    // uv grows upwards, the first row is the top one
+    int view = int(cell.x) + (rows - 1 - int(cell.y))*columns;
+    if (view >= viewCount) {
+        outColor = vec4(0.0, 0.0, 0.0, 1.0);
+        return;
+    }
+
+    outColor = texture(views, vec3(uv*grid - cell, float(view)));
+}
@@ -0,0 +1,19 @@
+#version 150 core
+
+in vec2 Corner;
+in float FragLife;
+
+out vec4 outColor;
+
+uniform vec4 startColor;
+uniform vec4 endColor;
+
+void main() {
+    // round, fading out towards the edge
+    float falloff = 1.0 - dot(Corner, Corner);
+    if (falloff <= 0.0)
+        discard;
+
+    vec4 color = mix(startColor, endColor, FragLife);
+    outColor = vec4(color.rgb, color.a*falloff);
+}
@@ -0,0 +1,28 @@
+#version 150 core
+
+// expands a particle into a quad facing the camera: the corners are offset in view space,
+// where the camera looks down -z, and projected after that
+
+layout(points) in;
+layout(triangle_strip, max_vertices = 4) out;
+
+in float Life[];
+
+out vec2 Corner;
+out float FragLife;
+
+uniform mat4 projection;
+uniform float particleSize;
+
+void main() {
+    vec4 center = gl_in[0].gl_Position;
+
+    for (int i = 0; i < 4; i++) {
+        vec2 corner = vec2(i & 1, i >> 1)*2.0 - 1.0;
+
+        Corner = corner;
+        FragLife = Life[0];
+        gl_Position = projection*(center + vec4(corner*particleSize, 0.0, 0.0));
+        EmitVertex();
+    }
+}
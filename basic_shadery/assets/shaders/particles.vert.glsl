@@ -0,0 +1,14 @@
+#version 150 core
+
+in vec4 positionAge;
+in vec4 velocityLifetime;
+
+out float Life;
+
+uniform mat4 view;
+
+void main() {
+    // 0 when emitted, 1 at the end of its lifetime
+    Life = positionAge.w/velocityLifetime.w;
+    gl_Position = view*vec4(positionAge.xyz, 1.0);
+}
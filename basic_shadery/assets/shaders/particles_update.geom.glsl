@@ -0,0 +1,21 @@
+#version 150 core
+
+// passes on only the particles still alive, so the captured buffer holds no dead ones
+
+layout(points) in;
+layout(points, max_vertices = 1) out;
+
+in vec4 PositionAge[];
+in vec4 VelocityLifetime[];
+
+out vec4 NextPositionAge;
+out vec4 NextVelocityLifetime;
+
+void main() {
+    if (PositionAge[0].w >= VelocityLifetime[0].w)
+        return;
+
+    NextPositionAge = PositionAge[0];
+    NextVelocityLifetime = VelocityLifetime[0];
+    EmitVertex();
+}
@@ -0,0 +1,60 @@
+#version 150 core
+
+// ParticleSystem's update: advances one particle, or makes up a new one in the emitting draw
+
+in vec4 positionAge;        // xyz position, w age in seconds
+in vec4 velocityLifetime;   // xyz velocity, w lifetime in seconds
+
+out vec4 PositionAge;
+out vec4 VelocityLifetime;
+
+// no attributes are read while emitting, the particle comes from gl_VertexID and the seed
+uniform bool emitting;
+uniform uint seed;
+uniform float timeStep;
+uniform vec3 gravity;
+
+uniform vec3 emitterPosition;
+uniform float emitterRadius;
+uniform vec3 emitterVelocity;
+uniform float velocitySpread;
+uniform vec2 lifetime;
+
+// PCG hash, a different well mixed value for every particle and frame
+uint hash(uint x) {
+    uint state = x*747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state)*277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random(inout uint state) {
+    state = hash(state);
+    return float(state)/4294967295.0;
+}
+
+// uniformly distributed in the unit ball
+vec3 randomInBall(inout uint state) {
+    float z = random(state)*2.0 - 1.0;
+    float angle = random(state)*6.2831853;
+    float radius = pow(random(state), 1.0/3.0);
+    return radius*vec3(sqrt(1.0 - z*z)*vec2(cos(angle), sin(angle)), z);
+}
+
+void main() {
+    if (emitting) {
+        uint state = hash(uint(gl_VertexID) ^ hash(seed));
+
+        vec3 position = emitterPosition + emitterRadius*randomInBall(state);
+        vec3 velocity = emitterVelocity + velocitySpread*randomInBall(state);
+        float life = mix(lifetime.x, lifetime.y, random(state));
+
+        PositionAge = vec4(position, 0.0);
+        VelocityLifetime = vec4(velocity, life);
+        return;
+    }
+
+    vec3 velocity = velocityLifetime.xyz + gravity*timeStep;
+
+    PositionAge = vec4(positionAge.xyz + velocity*timeStep, positionAge.w + timeStep);
+    VelocityLifetime = vec4(velocity, velocityLifetime.w);
+}
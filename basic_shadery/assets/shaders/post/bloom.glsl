@@ -0,0 +1,7 @@
+// Per-pixel: adds the blurred bright parts back onto the scene.
+
+uniform float bloomStrength = 0.8;
+
+vec4 bloom(vec4 color, vec4 glow, vec2 uv) {
+    return vec4(color.rgb + glow.rgb*bloomStrength, color.a);
+}
@@ -0,0 +1,11 @@
+// Neighborhood: horizontal half of a 9 tap gaussian, the taps between texels are read with
+// bilinear filtering so 5 fetches cover all 9.
+
+vec4 blurX(sampler2D image, vec2 uv) {
+    vec2 offset = vec2(texelSize.x, 0.0);
+
+    vec4 sum = fetch(image, uv)*0.2270270270;
+    sum += (fetch(image, uv + 1.3846153846*offset) + fetch(image, uv - 1.3846153846*offset))*0.3162162162;
+    sum += (fetch(image, uv + 3.2307692308*offset) + fetch(image, uv - 3.2307692308*offset))*0.0702702703;
+    return sum;
+}
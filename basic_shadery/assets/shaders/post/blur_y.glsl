@@ -0,0 +1,10 @@
+// Neighborhood: vertical half of the gaussian in blur_x.glsl.
+
+vec4 blurY(sampler2D image, vec2 uv) {
+    vec2 offset = vec2(0.0, texelSize.y);
+
+    vec4 sum = fetch(image, uv)*0.2270270270;
+    sum += (fetch(image, uv + 1.3846153846*offset) + fetch(image, uv - 1.3846153846*offset))*0.3162162162;
+    sum += (fetch(image, uv + 3.2307692308*offset) + fetch(image, uv - 3.2307692308*offset))*0.0702702703;
+    return sum;
+}
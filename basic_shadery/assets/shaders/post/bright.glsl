@@ -0,0 +1,8 @@
+// Per-pixel: keeps what is brighter than the threshold, the light that blooms.
+
+uniform float bloomThreshold = 0.75;
+
+vec4 bright(vec4 color, vec2 uv) {
+    float luma = dot(color.rgb, vec3(0.2126, 0.7152, 0.0722));
+    return vec4(color.rgb*smoothstep(bloomThreshold, bloomThreshold + 0.25, luma), 1.0);
+}
@@ -0,0 +1,12 @@
+// Per-pixel: color grading, contrast around mid grey, saturation and a tint.
+
+uniform float contrast = 1.05;
+uniform float saturation = 1.1;
+uniform vec3 tint = vec3(1.0, 0.98, 0.95);
+
+vec4 grade(vec4 color, vec2 uv) {
+    vec3 graded = (color.rgb - 0.5)*contrast + 0.5;
+    float luma = dot(graded, vec3(0.2126, 0.7152, 0.0722));
+    graded = mix(vec3(luma), graded, saturation)*tint;
+    return vec4(clamp(graded, 0.0, 1.0), color.a);
+}
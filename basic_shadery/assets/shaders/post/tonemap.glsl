@@ -0,0 +1,9 @@
+// Per-pixel: filmic curve (Narkowicz's fit of ACES) mapping the bloomed scene back into 0..1.
+
+uniform float exposure = 1.2;
+
+vec4 tonemap(vec4 color, vec2 uv) {
+    vec3 x = color.rgb*exposure;
+    vec3 mapped = (x*(2.51*x + 0.03))/(x*(2.43*x + 0.59) + 0.14);
+    return vec4(clamp(mapped, 0.0, 1.0), color.a);
+}
@@ -0,0 +1,9 @@
+// Per-pixel: darkens the corners of the screen.
+
+uniform float vignetteStrength = 0.35;
+
+vec4 vignette(vec4 color, vec2 uv) {
+    vec2 offset = screenPosition(uv) - 0.5;
+    float falloff = 1.0 - smoothstep(0.25, 0.8, length(offset)*1.2);
+    return vec4(color.rgb*mix(1.0 - vignetteStrength, 1.0, falloff), color.a);
+}
@@ -0,0 +1,16 @@
+#version 150 core
+
+// Attribute-less quad, drawn with glDrawArrays(GL_TRIANGLE_STRIP, 0, 4).
+// rect and uvRect hold the min corner in xy and the max corner in zw.
+
+uniform vec4 rect;
+uniform vec4 uvRect;
+
+out vec2 uv;
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+
+    uv = mix(uvRect.xy, uvRect.zw, corner);
+    gl_Position = vec4(mix(rect.xy, rect.zw, corner), 0.0, 1.0);
+}
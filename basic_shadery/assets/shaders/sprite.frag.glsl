@@ -0,0 +1,12 @@
+#version 150 core
+
+in vec2 TexCoord;
+in vec4 Color;
+
+out vec4 outColor;
+
+uniform sampler2D sprite;
+
+void main() {
+    outColor = texture(sprite, TexCoord)*Color;
+}
@@ -0,0 +1,16 @@
+#version 150 core
+
+in vec2 position;
+in vec2 texCoord;
+in vec4 color;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+uniform mat4 projection;
+
+void main() {
+    TexCoord = texCoord;
+    Color = color;
+    gl_Position = projection*vec4(position, 0.0, 1.0);
+}
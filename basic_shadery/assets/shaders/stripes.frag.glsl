@@ -8,9 +8,7 @@ uniform mat4 model;
 uniform vec3 stripes_dir;
 uniform float time;
 
-float map(float x, float min_s, float max_s, float min_d, float max_d) {
-    return ((x - min_s)/(max_s - min_s))*(max_d - min_d) + min_d;
-}
+#include "include/common.glsl"
 
 float h(float x, float period, float peakToValleyRatio) {
     x = mod(x, period);
@@ -7,6 +7,21 @@ out vec4 outColor;
 
 uniform sampler2D tex1;
 
+#ifdef CLUSTERED_LIGHTING
+#include "include/clustered_lighting.glsl"
+
+in vec3 ViewPosition;
+in vec4 ClipPosition;
+
+uniform vec3 ambient = vec3(0.15);
+#endif
+
 void main() {
 	outColor = texture(tex1, TexCoord);
+
+#ifdef CLUSTERED_LIGHTING
+	// flat shading, the face normal from the screen space derivatives of the position
+	vec3 normal = normalize(cross(dFdx(ViewPosition), dFdy(ViewPosition)));
+	outColor.rgb *= ambient + clusteredLighting(ClipPosition, ViewPosition, normal);
+#endif
 }
\ No newline at end of file
@@ -8,6 +8,11 @@ out vec3 Color;
 out vec3 pos;
 out vec2 TexCoord;
 
+#ifdef CLUSTERED_LIGHTING
+out vec3 ViewPosition;
+out vec4 ClipPosition;
+#endif
+
 uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
@@ -17,5 +22,11 @@ void main() {
     pos = position;
     TexCoord = texCoord;
 
-    gl_Position = projection * view * model * vec4(position, 1.0);
+    vec4 viewPosition = view * model * vec4(position, 1.0);
+    gl_Position = projection * viewPosition;
+
+#ifdef CLUSTERED_LIGHTING
+    ViewPosition = viewPosition.xyz;
+    ClipPosition = gl_Position;
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#version 150 core
+
+// Bilinear upscale with contrast-adaptive sharpening: each pixel is pushed away from the
+// average of its four neighbours, less so where the neighbourhood already has high contrast,
+// so edges get crisper without ringing and flat areas stay flat.
+
+in vec2 uv;
+out vec4 outColor;
+
+uniform sampler2D source;
+uniform vec2 texelSize;     // of the source texture
+uniform vec2 uvMax;         // center of the last texel the scene was rendered to
+uniform float sharpness;    // 0 (none) to 1
+
+vec3 fetch(vec2 at) {
+    return texture(source, clamp(at, 0.5*texelSize, uvMax)).rgb;
+}
+
+void main() {
+    vec3 center = fetch(uv);
+    vec3 north = fetch(uv + vec2(0.0, texelSize.y));
+    vec3 south = fetch(uv - vec2(0.0, texelSize.y));
+    vec3 east = fetch(uv + vec2(texelSize.x, 0.0));
+    vec3 west = fetch(uv - vec2(texelSize.x, 0.0));
+
+    vec3 low = min(center, min(min(north, south), min(east, west)));
+    vec3 high = max(center, max(max(north, south), max(east, west)));
+
+    // headroom left before the neighbourhood clips, relative to its brightest value
+    vec3 amount = sqrt(clamp(min(low, 1.0 - high)/max(high, vec3(1e-4)), 0.0, 1.0));
+    vec3 weight = -amount*0.2*sharpness;
+
+    vec3 color = (center + (north + south + east + west)*weight)/(1.0 + 4.0*weight);
+    outColor = vec4(clamp(color, 0.0, 1.0), 1.0);
+}
@@ -0,0 +1,47 @@
+#version 150 core
+
+in vec3 Color;
+in vec2 TexCoord;
+
+out vec4 outColor;
+
+// textured.frag.glsl sampling a VirtualTexture instead of a plain texture
+
+uniform sampler2D pageCache;
+// per page of every level: cache slot x, y, level of the resident page covering it, 1 if any
+uniform usampler2D indirection;
+
+uniform vec2 virtualSize;
+uniform float pageSize;
+uniform float border;
+uniform float slotSize;
+uniform float cacheSize;
+uniform int maxLevel;
+uniform float lodBias;
+// writes the wanted page instead of the color, for the feedback pass
+uniform bool feedback;
+
+void main() {
+    // level 0 texels, the last half texel kept so that the edge stays in the last page
+    vec2 texel = clamp(TexCoord*virtualSize, vec2(0.0), virtualSize - 0.5);
+
+    vec2 dx = dFdx(TexCoord*virtualSize);
+    vec2 dy = dFdy(TexCoord*virtualSize);
+    float lod = 0.5*log2(max(max(dot(dx, dx), dot(dy, dy)), 1e-8)) + lodBias;
+    int level = clamp(int(floor(lod)), 0, maxLevel);
+
+    ivec2 page = ivec2(texel/(pageSize*exp2(float(level))));
+
+    if (feedback) {
+        // 12 bits of the page position per axis, the high 4 bits of both share blue
+        outColor = vec4(page.x & 255, page.y & 255, (page.x >> 8) | ((page.y >> 8) << 4), level + 1)/255.0;
+        return;
+    }
+
+    uvec4 entry = texelFetch(indirection, page, level);
+    // the entry can be of a coarser page, position within it
+    vec2 inPage = fract(texel/(pageSize*exp2(float(entry.z))))*pageSize;
+    vec2 uv = (vec2(entry.xy)*slotSize + border + inPage)/cacheSize;
+
+    outColor = textureLod(pageCache, uv, 0.0);
+}
@@ -3,7 +3,7 @@
 #include <fstream>
 #include <string>
 
-#include <Gl/glew.h>
+#include "GlDispatch.h"
 
 namespace gl
 {
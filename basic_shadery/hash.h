@@ -0,0 +1,25 @@
+﻿#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace gl
+{
+    // 64-bit FNV-1a. constexpr, so names known at compile time hash to constants.
+    constexpr std::uint64_t fnv1aBytes(const char* data, std::size_t length, std::uint64_t hash = 14695981039346656037ull) {
+        for (std::size_t i = 0; i < length; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    constexpr std::uint64_t fnv1a(std::string_view str, std::uint64_t hash = 14695981039346656037ull) {
+        return fnv1aBytes(str.data(), str.size(), hash);
+    }
+
+    constexpr std::uint64_t hashCombine(std::uint64_t seed, std::uint64_t value) {
+        return seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+    }
+}
@@ -2,8 +2,11 @@
 #include <cmath>
 #include <iomanip>
 #include <string>
+#include <memory>
+#include <random>
+#include <array>
 
-#include <GL/glew.h>
+#include "GlDispatch.h"
 #include <SFML/Window.hpp>
 #include <SFML/System.hpp>
 
@@ -13,6 +16,21 @@
 #include "Uniform.h"
 #include "FirstPersonControls.h"
 #include "Texture.h"
+#include "FractalView.h"
+#include "GlWorkerPool.h"
+#include "ResourceManager.h"
+#include "FrameCapture.h"
+#include "InputRecording.h"
+#include "FrameTimingLog.h"
+#include "FrameArena.h"
+#include "AllocationCounter.h"
+#include "DynamicResolution.h"
+#include "PostProcessGraph.h"
+#include "VirtualTexture.h"
+#include "ParticleSystem.h"
+#include "ClusteredLighting.h"
+#include "SpriteBatch.h"
+#include "MultiView.h"
 
 using Vec3f = glm::tvec3<GLfloat>;
 
@@ -30,7 +48,72 @@ std::ostream& operator<<(std::ostream& out, const glm::vec3& v) {
     return out;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Opcje uruchomienia:
+    //   --record <plik>       zapis wejścia i pozycji kamery z każdej klatki
+    //   --replay <plik>       odtworzenie zapisanej sesji zamiast wejścia użytkownika
+    //   --fixed-step <us>     stały krok czasu przy odtwarzaniu zamiast zapisanego
+    //   --uncapped            bez limitu klatek na sekundę
+    //   --timings <plik.csv>  czasy CPU/GPU kolejnych klatek
+    //   --gl-capture <plik>   zapis wszystkich wywołań GL do odtworzenia w programie replayer
+    //   --gl-stats            liczniki wywołań GL, średnie na klatkę wypisywane na koniec
+    //   --gpu-budget <ms>     czas GPU sceny, do którego dopasowywana jest rozdzielczość (0 - stała)
+    //   --no-post             bez efektów końcowych (bloom, tone mapping, korekcja kolorów, winieta)
+    //   --virtual-texture <plik.vt>  tekstura wirtualna (z programu tiler) doczytywana stronami zamiast korwinium
+    //   --particles <liczba>  fontanna cząsteczek nad piramidą, symulowana na GPU
+    //   --lights <liczba>     światła punktowe krążące wokół piramidy (oświetlenie klastrowe)
+    //   --hud                 wykres czasów ostatnich klatek w rogu okna
+    //   --views <liczba>      podzielony ekran: kamera gracza i kamery wokół piramidy (do 8), sama piramida
+    std::string recordPath, replayPath, timingsPath, glCapturePath, virtualTexturePath;
+    float fixedStep = .0f;
+    float gpuBudget = 12.f;
+    std::size_t particleCount = 0;
+    std::size_t lightCount = 0;
+    std::size_t viewCount = 0;
+    bool uncapped = false;
+    bool glStats = false;
+    bool postProcessing = true;
+    bool hudEnabled = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--record" && hasValue)
+            recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue)
+            replayPath = argv[++i];
+        else if (arg == "--fixed-step" && hasValue)
+            fixedStep = std::stof(argv[++i]);
+        else if (arg == "--timings" && hasValue)
+            timingsPath = argv[++i];
+        else if (arg == "--gpu-budget" && hasValue)
+            gpuBudget = std::stof(argv[++i]);
+        else if (arg == "--gl-capture" && hasValue)
+            glCapturePath = argv[++i];
+        else if (arg == "--virtual-texture" && hasValue)
+            virtualTexturePath = argv[++i];
+        else if (arg == "--particles" && hasValue)
+            particleCount = std::stoul(argv[++i]);
+        else if (arg == "--lights" && hasValue)
+            lightCount = std::stoul(argv[++i]);
+        else if (arg == "--views" && hasValue)
+            viewCount = std::stoul(argv[++i]);
+        else if (arg == "--uncapped")
+            uncapped = true;
+        else if (arg == "--gl-stats")
+            glStats = true;
+        else if (arg == "--no-post")
+            postProcessing = false;
+        else if (arg == "--hud")
+            hudEnabled = true;
+        else {
+            std::cerr << "Unknown option " << arg << "\n"
+                << "Usage: " << argv[0] << " [--record file] [--replay file] [--fixed-step us] [--uncapped] [--timings file.csv] [--gl-capture file] [--gl-stats] [--gpu-budget ms] [--no-post] [--virtual-texture file.vt] [--particles count] [--lights count] [--hud] [--views count]\n";
+            return -1;
+        }
+    }
+
     sf::ContextSettings settings;
     settings.depthBits = 24;
     settings.stencilBits = 8;
@@ -40,7 +123,7 @@ int main() {
     // Okno renderingu
     sf::Window window(sf::VideoMode(resolution.x, resolution.y, 32), "OpenGL", sf::Style::Titlebar | sf::Style::Close, settings);
     //window.setVerticalSyncEnabled(true);
-    window.setFramerateLimit(55);
+    window.setFramerateLimit(uncapped ? 0 : 55);
 
     // Inicjalizacja GLEW
     glewExperimental = GL_TRUE;
@@ -49,6 +132,17 @@ int main() {
         return -1;
     }
 
+    // przechwytywanie musi ruszyć przed utworzeniem pierwszego obiektu GL
+    gl::GlDispatch::setCounting(glStats);
+    if (!glCapturePath.empty()) {
+        try {
+            gl::GlDispatch::startCapture(glCapturePath);
+        } catch (gl::exception& e) {
+            std::cerr << "GL capture setup failed!\n" << e.what() << "\n";
+            return -1;
+        }
+    }
+
     glEnable(GL_DEPTH_TEST);
 
     // Utworzenie VAO (Vertex Array Object)
@@ -61,9 +155,14 @@ int main() {
     glGenBuffers(1, &vbo);
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
+    // z --lights shadery liczą oświetlenie ze świateł przypisanych do klastra fragmentu
+    gl::ShaderDefines sceneDefines;
+    if (lightCount > 0)
+        sceneDefines["CLUSTERED_LIGHTING"] = "1";
+
     gl::Shader vertexShader;
     try {
-        vertexShader = gl::Shader::fromFile("assets/shaders/textured.vert.glsl", gl::ShaderType::Vertex);
+        vertexShader = gl::Shader::fromFile("assets/shaders/textured.vert.glsl", gl::ShaderType::Vertex, sceneDefines);
         vertexShader.compile();
 
         std::cout << "Vertex shader compilation OK\n";
@@ -74,7 +173,8 @@ int main() {
 
     gl::Shader fragmentShader;
     try {
-        fragmentShader = gl::Shader::fromFile("assets/shaders/textured.frag.glsl", gl::ShaderType::Fragment);
+        const char* fragmentFile = virtualTexturePath.empty() ? "assets/shaders/textured.frag.glsl" : "assets/shaders/virtual_textured.frag.glsl";
+        fragmentShader = gl::Shader::fromFile(fragmentFile, gl::ShaderType::Fragment, sceneDefines);
         fragmentShader.compile();
 
         std::cout << "Fragment shader compilation OK\n";
@@ -96,14 +196,18 @@ int main() {
         return -1;
     }
 
-    gl::Texture korwin_tex;
+    // tekstury i siatki wysyłane do GPU z wątku z własnym kontekstem GL, żeby nie przycinały klatek;
+    // przy przechwytywaniu wywołań GL wszystko zostaje w tym wątku - replayer nie zna obiektów z innych kontekstów
+    std::unique_ptr<gl::GlWorkerPool> uploaders;
+    if (glCapturePath.empty())
+        uploaders = std::make_unique<gl::GlWorkerPool>(1);
+
+    // tekstury i siatki ładowane w tle, z limitem pamięci GPU
+    gl::ResourceManager resources{ 256u << 20, 1, uploaders.get() };
+
+    auto korwin_tex = resources.texture("assets/textures/korwinium.jpg", { gl::Texture::Wrap::Repeat, gl::Texture::MinFilter::Nearest, gl::Texture::MagFilter::Nearest });
     try {
-        korwin_tex.loadImage("assets/textures/korwinium.jpg")
-            .bind()
-            .setWrapping(gl::Texture::Wrap::Repeat)
-            .setMinFilter(gl::Texture::MinFilter::Nearest)
-            .setMagFilter(gl::Texture::MagFilter::Nearest)
-            .upload();
+        korwin_tex.get();
 
         std::cout << "Texture loading OK\n";
     } catch (gl::image_load_exception& e) {
@@ -111,6 +215,17 @@ int main() {
         return -1;
     }
 
+    // tekstura wirtualna - widoczne strony są doczytywane z pliku w tle
+    std::unique_ptr<gl::VirtualTexture> virtualTexture;
+    if (!virtualTexturePath.empty()) {
+        try {
+            virtualTexture = std::make_unique<gl::VirtualTexture>(virtualTexturePath, prog, resolution);
+        } catch (gl::exception& e) {
+            std::cerr << "Virtual texture setup failed!\n" << e.what() << "\n";
+            return -1;
+        }
+    }
+
     // Specifikacja formatu danych wierzchołkowych
     GLint posAttrib = prog.getAttributeLocation("position");
     glEnableVertexAttribArray(posAttrib);
@@ -170,27 +285,212 @@ int main() {
 
     controls.setViewUniform(view);
 
+    // światła krążące wokół piramidy, każde po własnej orbicie
+    struct LightOrbit {
+        float distance, height, angle, speed;
+    };
+    std::vector<gl::PointLight> lights;
+    std::vector<LightOrbit> lightOrbits;
+    std::unique_ptr<gl::ClusteredLighting> lighting;
+    if (lightCount > 0) {
+        std::mt19937 random{ 2137 };
+        std::uniform_real_distribution<float> unit{ .0f, 1.f };
+
+        for (std::size_t i = 0; i < lightCount; i++) {
+            float speed = (.2f + .8f * unit(random)) * (i % 2 ? 1.f : -1.f);
+            lightOrbits.push_back({ 2.f + 8.f * unit(random), -2.f + 8.f * unit(random), (float) twoPi * unit(random), speed });
+
+            // nasycony kolor o losowym odcieniu
+            float hue = unit(random);
+            glm::vec3 color = glm::clamp(glm::abs(glm::fract(hue + glm::vec3{ .0f, 2.f/3.f, 1.f/3.f }) * 6.f - 3.f) - 1.f, .0f, 1.f);
+            lights.push_back({ { .0f, .0f, .0f }, 1.5f + 1.5f * unit(random), color * 2.f });
+        }
+
+        lighting = std::make_unique<gl::ClusteredLighting>(prog);
+    }
+
+    // Widok fraktala (przełączany klawiszem F)
+    std::unique_ptr<gl::FractalView> fractal;
+    try {
+        fractal = std::make_unique<gl::FractalView>(resolution, resources.programs());
+    } catch (gl::exception& e) {
+        std::cerr << "Fractal view initialization failed!\n" << e.what() << "\n";
+        return -1;
+    }
+    bool fractalMode = false;
+
+    // cząsteczki - symulacja, usuwanie martwych i rysowanie w całości na GPU
+    std::unique_ptr<gl::ParticleSystem> particles;
+    if (particleCount > 0) {
+        try {
+            particles = std::make_unique<gl::ParticleSystem>(particleCount, resources.programs());
+            auto& emitter = particles->emitter();
+            emitter.position = { .0f, 5.f, .0f };
+            emitter.velocity = { .0f, 6.f, .0f };
+            emitter.velocitySpread = 2.f;
+            // średnio 2 s życia, więc tyle na sekundę utrzymuje pełną pojemność
+            emitter.rate = particleCount / 2.f;
+        } catch (gl::exception& e) {
+            std::cerr << "Particle system setup failed!\n" << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    // nakładka 2D - wszystkie prostokąty wykresu w jednym wywołaniu rysowania
+    std::unique_ptr<gl::SpriteBatch> hud;
+    std::array<float, 120> frameTimes{};
+    std::size_t frameTimeIndex = 0;
+    if (hudEnabled) {
+        try {
+            hud = std::make_unique<gl::SpriteBatch>(resources.programs());
+        } catch (gl::exception& e) {
+            std::cerr << "HUD setup failed!\n" << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    // podzielony ekran - piramida rysowana raz dla wszystkich kamer, shader geometrii powiela trójkąty do warstwy każdego widoku
+    std::unique_ptr<gl::MultiView> multiView;
+    std::vector<gl::PerspectiveCamera> viewCameras;
+    gl::VertexArray multiViewVao;
+    gl::Program* multiViewProgram = nullptr;
+    std::unique_ptr<gl::Uniform<glm::mat4>> multiViewModel;
+    unsigned viewColumns = 1;
+    if (viewCount > 1) {
+        try {
+            multiViewProgram = &resources.programs().get("assets/shaders/multiview.vert.glsl", "assets/shaders/multiview.geom.glsl", "assets/shaders/textured.frag.glsl");
+
+            viewCount = std::min(viewCount, gl::MultiView::maxViews);
+            viewColumns = static_cast<unsigned>(std::ceil(std::sqrt(double(viewCount))));
+            unsigned viewRows = static_cast<unsigned>((viewCount + viewColumns - 1) / viewColumns);
+            glm::tvec2<unsigned int> viewSize{ resolution.x / viewColumns, resolution.y / viewRows };
+
+            // pierwszy widok podąża za kamerą gracza, reszta to nieruchome kamery dookoła
+            viewCameras.assign(viewCount, gl::PerspectiveCamera{ (float) pi/3, viewSize, 0.05f, 100.0f });
+            for (std::size_t i = 1; i < viewCount; i++) {
+                float angle = (float) twoPi * (i - 1) / (viewCount - 1);
+                viewCameras[i].setPosition({ 14.f * std::sin(angle), 8.f, 14.f * std::cos(angle) });
+                viewCameras[i].lookAt({ .0f, .0f, .0f });
+            }
+
+            multiView = std::make_unique<gl::MultiView>(*multiViewProgram, viewCount, viewSize.x, viewSize.y, resources.programs());
+
+            multiViewModel = std::make_unique<gl::Uniform<glm::mat4>>(multiViewProgram->createUniform<glm::mat4>("model"));
+
+            // lokalizacje atrybutów mogą być inne niż w prog
+            multiViewVao.bind();
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            multiViewVao
+                .setAttribute(multiViewProgram->getAttributeLocation("position"), 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, position))
+                .setAttribute(multiViewProgram->getAttributeLocation("color"), 3, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, color))
+                .setAttribute(multiViewProgram->getAttributeLocation("texCoord"), 2, GL_FLOAT, sizeof(Vertex), offsetof(Vertex, texCoord));
+        } catch (gl::exception& e) {
+            std::cerr << "Multi-view setup failed!\n" << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    // scena renderowana w niższej rozdzielczości, gdy nie mieści się w budżecie czasu GPU
+    std::unique_ptr<gl::DynamicResolution> dynamicResolution;
+    try {
+        dynamicResolution = std::make_unique<gl::DynamicResolution>(resolution, resources.programs(), gpuBudget);
+        dynamicResolution->setEnabled(gpuBudget > .0f);
+    } catch (gl::exception& e) {
+        std::cerr << "Dynamic resolution setup failed!\n" << e.what() << "\n";
+        return -1;
+    }
+
+    // efekty końcowe - kolejne efekty na piksel są łączone w jeden shader, osobne przejścia są tylko tam, gdzie efekt czyta sąsiednie piksele
+    std::unique_ptr<gl::PostProcessGraph> postProcess;
+    if (postProcessing) {
+        using Access = gl::PostProcessGraph::Access;
+        try {
+            postProcess = std::make_unique<gl::PostProcessGraph>(resolution.x, resolution.y, resources.programs());
+            (*postProcess)
+                .addFile("bright", Access::PerPixel, { "scene" }, "assets/shaders/post/bright.glsl")
+                .addFile("blurX", Access::Neighborhood, { "bright" }, "assets/shaders/post/blur_x.glsl")
+                .addFile("blurY", Access::Neighborhood, { "blurX" }, "assets/shaders/post/blur_y.glsl")
+                .addFile("bloom", Access::PerPixel, { "scene", "blurY" }, "assets/shaders/post/bloom.glsl")
+                .addFile("tonemap", Access::PerPixel, { "bloom" }, "assets/shaders/post/tonemap.glsl")
+                .addFile("grade", Access::PerPixel, { "tonemap" }, "assets/shaders/post/grade.glsl")
+                .addFile("vignette", Access::PerPixel, { "grade" }, "assets/shaders/post/vignette.glsl")
+                .compile();
+            dynamicResolution->setPostProcess(postProcess.get());
+        } catch (gl::exception& e) {
+            std::cerr << "Post-processing setup failed!\n" << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    // zapis klatek do plików PNG, włączany klawiszem C
+    std::unique_ptr<gl::FrameCapture> capture;
+
+    // nagrywanie/odtwarzanie sesji i pomiar czasów klatek
+    std::unique_ptr<gl::InputRecorder> recorder;
+    std::unique_ptr<gl::InputPlayer> player;
+    std::unique_ptr<gl::FrameTimingLog> timings;
+    try {
+        if (!recordPath.empty())
+            recorder = std::make_unique<gl::InputRecorder>(recordPath);
+        if (!replayPath.empty())
+            player = std::make_unique<gl::InputPlayer>(replayPath);
+        if (!timingsPath.empty() || player)
+            timings = std::make_unique<gl::FrameTimingLog>(timingsPath);
+    } catch (gl::exception& e) {
+        std::cerr << "Session setup failed!\n" << e.what() << "\n";
+        return -1;
+    }
+    // przy odtwarzaniu mysz nie steruje kamerą
+    if (player)
+        controls.releaseMouse();
+    std::size_t driftedFrames = 0;
+
     // application state
     bool running = true;
     sf::Clock clock;
     sf::Time timeStep;
 
     const char* titleBase = "Korwinium (OpenGL) - ";
+    sf::Clock titleClock;
+
+    // pamięć na dane tymczasowe klatki, zwalniana w całości na początku kolejnej
+    gl::FrameArena frameArena{ 64 << 10 };
+    bool allocationReported = false;
 
     while (running) {
         timeStep = clock.getElapsedTime();
         clock.restart();
+        frameArena.beginFrame();
 
+        // zdarzenia tylko zbierają wejście, reakcja jest niżej - tak samo dla wejścia na żywo i z nagrania
+        gl::InputState input;
         sf::Event event;
         while (window.pollEvent(event)) {
             switch (event.type) {
             case sf::Event::MouseButtonPressed:
-                controls.toggleMouseCapture();
+                input.actions |= gl::InputState::ToggleMouseCapture;
+                break;
+
+            case sf::Event::MouseWheelScrolled:
+                input.wheelDelta += event.mouseWheelScroll.delta;
+                input.wheelPosition = { event.mouseWheelScroll.x, event.mouseWheelScroll.y };
                 break;
 
             case sf::Event::KeyPressed:
                 if (event.key.code == sf::Keyboard::R)
-                    controls.lookAt({ .0f, .0f, .0f });
+                    input.actions |= gl::InputState::ResetLook;
+
+                if (event.key.code == sf::Keyboard::F)
+                    input.actions |= gl::InputState::ToggleFractal;
+
+                if (event.key.code == sf::Keyboard::C) {
+                    if (capture) {
+                        std::cout << "Captured " << capture->capturedCount() << " frames\n";
+                        capture.reset();
+                    } else if (gl::FrameCapture::isSupported()) {
+                        capture = std::make_unique<gl::FrameCapture>(resolution.x, resolution.y, gl::FrameCapture::Format::Png, "frame_%05u.png");
+                    }
+                }
 
                 if (event.key.code != sf::Keyboard::Escape)
                     break;
@@ -199,30 +499,224 @@ int main() {
                 break;
             }
         }
-        controls.update(static_cast<float>(timeStep.asMicroseconds()));
+
+        // od tego miejsca do wymiany buforów klatka nie powinna alokować na stercie
+        // (sprawdzane w wersji debug, poza trybem fraktala i zapisem klatek)
+        gl::AllocationCounter::Scope frameAllocations;
+
+        gl::FrameRecord frame;
+        if (player) {
+            if (!player->next(frame))
+                break;
+
+            input = frame.input;
+            if (fixedStep > .0f)
+                frame.timeStep = fixedStep;
+        } else {
+            gl::InputState polled = gl::InputState::poll(window);
+            input.keys = polled.keys;
+            input.hasFocus = polled.hasFocus;
+
+            if (!fractalMode)
+                controls.pollMouse(input);
+
+            frame.timeStep = static_cast<float>(timeStep.asMicroseconds());
+        }
+
+        if (timings)
+            timings->beginFrame(frame.timeStep);
+
+        if (input.has(gl::InputState::ToggleMouseCapture) && !fractalMode && !player)
+            controls.toggleMouseCapture();
+
+        if (input.wheelDelta != .0f && fractalMode)
+            fractal->zoom(std::pow(1.25f, input.wheelDelta), glm::vec2{ input.wheelPosition });
+
+        if (input.has(gl::InputState::ResetLook))
+            controls.lookAt({ .0f, .0f, .0f });
+
+        if (input.has(gl::InputState::ToggleFractal)) {
+            fractalMode = !fractalMode;
+            if (fractalMode)
+                controls.releaseMouse();
+        }
+
+        if (fractalMode) {
+            // przesuwanie widoku fraktala strzałkami/WASD
+            glm::vec2 panDir{ .0f, .0f };
+            if (input.isDown(gl::InputState::Left)) panDir.x -= 1.f;
+            if (input.isDown(gl::InputState::Right)) panDir.x += 1.f;
+            if (input.isDown(gl::InputState::Back)) panDir.y -= 1.f;
+            if (input.isDown(gl::InputState::Forward)) panDir.y += 1.f;
+
+            if (input.hasFocus)
+                fractal->pan(panDir * 0.0006f * frame.timeStep);
+        } else {
+            controls.update(input, frame.timeStep);
+        }
+
+        if (player) {
+            // kamera jest prowadzona przez sterowanie, ale gdyby rozjechała się z nagraniem
+            // (np. po zmianie w FirstPersonControls), wraca na zapisaną pozycję
+            const float tolerance = 1e-4f;
+            if (glm::length(camera.getPosition() - frame.cameraPosition) > tolerance
+                || glm::length(camera.getDirection() - frame.cameraDirection) > tolerance) {
+                controls.setPose(frame.cameraPosition, frame.cameraDirection);
+                driftedFrames++;
+            }
+        }
+
+        if (recorder) {
+            frame.input = input;
+            frame.cameraPosition = camera.getPosition();
+            frame.cameraDirection = camera.getDirection();
+            try {
+                recorder->record(frame);
+            } catch (gl::exception& e) {
+                std::cerr << "Recording failed!\n" << e.what() << "\n";
+                recorder.reset();
+            }
+        }
+
+        // scena jeszcze raz, w małej rozdzielczości - które strony tekstury wirtualnej są potrzebne
+        if (virtualTexture && !fractalMode) {
+            virtualTexture->beginFeedback();
+            vao.bind();
+            prog.bind();
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, indices.data());
+            virtualTexture->endFeedback();
+        }
+        if (virtualTexture)
+            virtualTexture->update();
+
+        // przypisanie świateł do klastrów widoku, równolegle na CPU
+        if (lighting && !fractalMode) {
+            for (std::size_t i = 0; i < lights.size(); i++) {
+                LightOrbit& orbit = lightOrbits[i];
+                orbit.angle += orbit.speed * frame.timeStep / 1e6f;
+                lights[i].position = { orbit.distance * std::cos(orbit.angle), orbit.height, orbit.distance * std::sin(orbit.angle) };
+            }
+            lighting->update(camera, lights);
+        }
+
+        dynamicResolution->begin();
 
         // Nadanie scenie koloru czarnego
         glClearColor(0.2f, 0.2f, 0.2f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, indices.data());
+        if (fractalMode) {
+            fractal->render();
+        } else if (multiView) {
+            viewCameras[0].setPosition(camera.getPosition());
+            viewCameras[0].setDirection(camera.getDirection());
+            *multiViewModel = model.value();
+
+            multiView->setCameras(viewCameras).begin();
+            multiViewVao.bind();
+            multiViewProgram->bind();
+            korwin_tex->bind();
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, indices.data());
+            multiView->end().composite(viewColumns);
+        } else {
+            vao.bind();
+            prog.bind();
+            if (virtualTexture)
+                virtualTexture->bind();
+            else
+                korwin_tex->bind();
+            if (lighting)
+                lighting->bind();
+            glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, indices.data());
+
+            if (particles)
+                particles->update(frame.timeStep / 1e6f).render(camera);
+        }
+        dynamicResolution->end();
+
+        // słupek na klatkę, najnowsza po prawej; linia na wysokości 16.7 ms (60 FPS)
+        if (hud) {
+            frameTimes[frameTimeIndex] = timeStep.asMicroseconds() / 1000.f;
+            frameTimeIndex = (frameTimeIndex + 1) % frameTimes.size();
+
+            const float barWidth = 3.f, pixelsPerMs = 4.f, graphHeight = 33.3f * pixelsPerMs;
+            const glm::vec2 corner{ 10.f, resolution.y - 10.f - graphHeight };
+            const float graphWidth = frameTimes.size() * barWidth;
+
+            hud->begin(glm::ortho(.0f, float(resolution.x), float(resolution.y), .0f));
+            hud->fill(corner, { graphWidth, graphHeight }, { .0f, .0f, .0f, .5f });
+            for (std::size_t i = 0; i < frameTimes.size(); i++) {
+                float ms = frameTimes[(frameTimeIndex + i) % frameTimes.size()];
+                float barHeight = std::min(ms * pixelsPerMs, graphHeight);
+                glm::vec4 color = ms <= 16.7f ? glm::vec4{ .2f, .9f, .3f, .9f } : ms <= 33.3f ? glm::vec4{ .9f, .8f, .2f, .9f } : glm::vec4{ .9f, .2f, .2f, .9f };
+                hud->fill({ corner.x + i * barWidth, corner.y + graphHeight - barHeight }, { barWidth - 1.f, barHeight }, color);
+            }
+            hud->fill({ corner.x, corner.y + graphHeight - 16.7f * pixelsPerMs }, { graphWidth, 1.f }, { 1.f, 1.f, 1.f, .5f });
+            hud->end();
+        }
+
+        if (capture) {
+            try {
+                capture->capture();
+            } catch (gl::exception& e) {
+                std::cerr << "Frame capture failed!\n" << e.what() << "\n";
+                capture.reset();
+            }
+        }
+
+        if (gl::AllocationCounter::isEnabled() && frameAllocations.allocations() > 0 && !fractalMode && !capture
+            && frameArena.frameNumber() > 60 && !allocationReported) {
+            std::cerr << "Frame " << frameArena.frameNumber() << " made " << frameAllocations.allocations() << " heap allocations\n";
+            allocationReported = true;
+        }
+
+        gl::GlDispatch::endFrame();
+        resources.update();
+
+        // przed wymianą buforów - limit klatek czeka w display() i zawyżałby czas CPU
+        if (timings)
+            timings->endFrame();
+
         // Wymiana buforów tylni/przedni
         window.display();
 
         auto stepUs = timeStep.asMicroseconds();
 
-        model = glm::rotate(model.value(), 0.0000012f*stepUs, { .0f, 1.f, .0f });
-        if (stepUs > 0) {
-            std::string title{ titleBase };
-            title += std::to_string(1000000/stepUs);
+        model = glm::rotate(model.value(), 0.0000012f*frame.timeStep, { .0f, 1.f, .0f });
+        // tytuł dwa razy na sekundę - każda zmiana to wywołanie systemu okien
+        if (stepUs > 0 && titleClock.getElapsedTime() >= sf::milliseconds(500)) {
+            titleClock.restart();
+
+            gl::ArenaString title{ titleBase, frameArena.arena() };
+            title += std::to_string(1000000/stepUs).c_str();
             title += " FPS (";
-            title += std::to_string(stepUs);
+            title += std::to_string(stepUs).c_str();
             title += "us/frame)";
-            window.setTitle(title);
+            if (dynamicResolution->isEnabled()) {
+                title += " @ ";
+                title += std::to_string(std::lround(dynamicResolution->scale() * 100)).c_str();
+                title += "%";
+            }
+            window.setTitle(title.c_str());
         }
     }
     // Kasowanie programu i czyszczenie buforów
     glDeleteBuffers(1, &vbo);
+    capture.reset();
+
+    if (recorder)
+        std::cout << "Recorded " << recorder->frameCount() << " frames\n";
+    if (player && driftedFrames > 0)
+        std::cout << "Camera drifted from the recording on " << driftedFrames << " frames\n";
+    if (timings) {
+        timings->finish().printSummary(std::cout);
+        timings.reset();
+    }
+    if (gl::GlDispatch::isCapturing()) {
+        std::cout << "Captured " << gl::GlDispatch::frameCount() << " frames of GL calls\n";
+        gl::GlDispatch::stopCapture();
+    }
+    gl::GlDispatch::printSummary(std::cout);
 
     // Zamknięcie okna renderingu
     window.close();
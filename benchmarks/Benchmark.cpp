@@ -0,0 +1,230 @@
+﻿#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+
+namespace bench
+{
+    namespace
+    {
+        struct Entry {
+            const char* name;
+            BenchmarkFn fn;
+            std::vector<long> scales;
+        };
+
+        struct Result {
+            std::string name;
+            long scale;
+            Context context;
+            std::string error;
+        };
+
+        // function-local so registrations from other translation units can run in any order
+        std::vector<Entry>& registry() {
+            static std::vector<Entry> entries;
+            return entries;
+        }
+
+        std::map<std::string, std::string>& runInfo() {
+            static std::map<std::string, std::string> info;
+            return info;
+        }
+
+        bool isSelected(const std::string& name, const std::vector<const char*>& filters) {
+            if (filters.empty())
+                return true;
+
+            for (const char* filter : filters)
+                if (name.find(filter) != std::string::npos)
+                    return true;
+
+            return false;
+        }
+
+        std::string quoted(const std::string& text) {
+            std::string out = "\"";
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    out += escaped;
+                } else {
+                    out += c;
+                }
+            }
+            return out + "\"";
+        }
+
+        // fixed precision, so that unchanged results diff as unchanged
+        std::string number(double value) {
+            if (!std::isfinite(value))
+                return "null";
+
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.6g", value);
+            return text;
+        }
+
+        void writeJson(std::FILE* out, std::vector<Result>& results) {
+            std::sort(results.begin(), results.end(), [](const Result& a, const Result& b) {
+                return a.name != b.name ? a.name < b.name : a.scale < b.scale;
+            });
+
+            std::fprintf(out, "{\n  \"info\": {");
+            const char* separator = "\n";
+            for (const auto& [key, value] : runInfo()) {
+                std::fprintf(out, "%s    %s: %s", separator, quoted(key).c_str(), quoted(value).c_str());
+                separator = ",\n";
+            }
+            std::fprintf(out, "%s},\n  \"benchmarks\": [", runInfo().empty() ? "" : "\n  ");
+
+            separator = "\n";
+            for (const auto& result : results) {
+                std::fprintf(out, "%s    {\n      \"name\": %s,\n      \"scale\": %ld", separator, quoted(result.name).c_str(), result.scale);
+                separator = ",\n";
+
+                if (!result.error.empty()) {
+                    std::fprintf(out, ",\n      \"error\": %s\n    }", quoted(result.error).c_str());
+                    continue;
+                }
+
+                const auto& samples = result.context.samples();
+                if (!samples.empty()) {
+                    Summary summary = summarize(samples);
+                    std::fprintf(out, ",\n      \"runs\": %zu,\n      \"seconds\": { \"min\": %s, \"median\": %s, \"mean\": %s, \"max\": %s, \"stddev\": %s }",
+                        samples.size(), number(summary.min).c_str(), number(summary.median).c_str(), number(summary.mean).c_str(),
+                        number(summary.max).c_str(), number(summary.stddev).c_str());
+                }
+
+                std::fprintf(out, ",\n      \"counters\": {");
+                const char* counterSeparator = "\n";
+                for (const auto& counter : result.context.counters()) {
+                    std::fprintf(out, "%s        %s: { \"value\": %s, \"unit\": %s }", counterSeparator, quoted(counter.name).c_str(),
+                        number(counter.value).c_str(), quoted(counter.unit).c_str());
+                    counterSeparator = ",\n";
+                }
+                std::fprintf(out, "%s}\n    }", result.context.counters().empty() ? "" : "\n      ");
+            }
+
+            std::fprintf(out, "%s]\n}\n", results.empty() ? "" : "\n  ");
+        }
+    }
+
+    Registration::Registration(const char* name, BenchmarkFn fn) {
+        registry().push_back({ name, fn, { 0 } });
+    }
+
+    Registration::Registration(const char* name, BenchmarkFn fn, std::initializer_list<long> scales) {
+        registry().push_back({ name, fn, scales });
+    }
+
+    Context& Context::counter(const std::string& name, double value, const std::string& unit) {
+        m_counters.push_back({ name, value, unit });
+        return *this;
+    }
+
+    Summary summarize(std::vector<double> samples) {
+        if (samples.empty())
+            return { .0, .0, .0, .0, .0 };
+
+        std::sort(samples.begin(), samples.end());
+
+        std::size_t count = samples.size();
+        double mean = std::accumulate(samples.begin(), samples.end(), .0) / count;
+        double median = count % 2 ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+
+        double squares = .0;
+        for (double sample : samples)
+            squares += (sample - mean) * (sample - mean);
+
+        return { samples.front(), samples.back(), mean, median, count > 1 ? std::sqrt(squares / (count - 1)) : .0 };
+    }
+
+    void setRunInfo(const std::string& key, const std::string& value) {
+        runInfo()[key] = value;
+    }
+
+    std::filesystem::path findAsset(const std::string& relativePath) {
+        for (const char* root : { "basic_shadery", "../basic_shadery", "." }) {
+            std::filesystem::path path = std::filesystem::path{ root } / relativePath;
+            if (std::filesystem::exists(path))
+                return path;
+        }
+
+        throw std::runtime_error{ relativePath + " not found under basic_shadery" };
+    }
+
+    int runBenchmarks(int argc, char** argv) {
+        std::vector<const char*> filters;
+        const char* jsonPath = nullptr;
+
+        for (int i = 1; i < argc; i++) {
+            if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+                jsonPath = argv[++i];
+            else
+                filters.push_back(argv[i]);
+        }
+
+        std::vector<Result> results;
+        int failed = 0;
+
+        for (const auto& entry : registry()) {
+            if (!isSelected(entry.name, filters))
+                continue;
+
+            for (long scale : entry.scales) {
+                Result result{ entry.name, scale, Context{ scale }, {} };
+
+                if (entry.scales.size() > 1 || scale != 0)
+                    std::printf("%s/%ld\n", entry.name, scale);
+                else
+                    std::printf("%s\n", entry.name);
+
+                try {
+                    entry.fn(result.context);
+                } catch (std::exception& e) {
+                    std::printf("  failed: %s\n", e.what());
+                    result.error = e.what();
+                    results.push_back(std::move(result));
+                    failed++;
+                    continue;
+                }
+
+                const auto& samples = result.context.m_samples;
+                if (!samples.empty()) {
+                    Summary summary = summarize(samples);
+                    std::printf("  time: best %.3f ms, median %.3f ms, worst %.3f ms, stddev %.3f ms over %zu runs\n",
+                        summary.min * 1e3, summary.median * 1e3, summary.max * 1e3, summary.stddev * 1e3, samples.size());
+                }
+
+                for (const auto& counter : result.context.counters())
+                    std::printf("  %s: %.6g %s\n", counter.name.c_str(), counter.value, counter.unit.c_str());
+
+                results.push_back(std::move(result));
+            }
+        }
+
+        if (jsonPath) {
+            std::FILE* out = std::fopen(jsonPath, "w");
+            if (!out) {
+                std::printf("Could not open %s\n", jsonPath);
+                return 1;
+            }
+
+            writeJson(out, results);
+            std::fclose(out);
+        }
+
+        return failed == 0 ? 0 : 1;
+    }
+}
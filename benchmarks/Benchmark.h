@@ -0,0 +1,100 @@
+﻿#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace bench
+{
+    // Passed to every benchmark: times the measured code and collects derived counters
+    // (throughput, sizes...) that are printed along with the timings.
+    class Context {
+    public:
+        explicit Context(long scale = 0): m_scale(scale), m_samples(), m_counters() {}
+
+        // problem size of a BENCHMARK_SCALED run, 0 for plain benchmarks
+        long scale() const { return m_scale; }
+
+        // runs fn the given number of times and returns the best wall time in seconds
+        template<typename Fn>
+        double measure(Fn&& fn, int repetitions = 3);
+
+        Context& counter(const std::string& name, double value, const std::string& unit = "");
+
+        struct Counter {
+            std::string name;
+            double value;
+            std::string unit;
+        };
+
+        const std::vector<double>& samples() const { return m_samples; }
+        const std::vector<Counter>& counters() const { return m_counters; }
+
+    private:
+        long m_scale;
+        std::vector<double> m_samples;
+        std::vector<Counter> m_counters;
+
+        friend int runBenchmarks(int argc, char** argv);
+    };
+
+    // of a benchmark's samples, in seconds
+    struct Summary {
+        double min, max;
+        double mean, median;
+        double stddev;
+    };
+
+    Summary summarize(std::vector<double> samples);
+
+    using BenchmarkFn = void (*)(Context&);
+
+    struct Registration {
+        Registration(const char* name, BenchmarkFn fn);
+        // runs once per scale, reported as name/scale
+        Registration(const char* name, BenchmarkFn fn, std::initializer_list<long> scales);
+    };
+
+    // key and value written to the JSON report next to the results, e.g. the GL mode
+    void setRunInfo(const std::string& key, const std::string& value);
+
+    // path of a file under basic_shadery, found from the solution directory or a project
+    // directory; throws std::runtime_error when it is not there
+    std::filesystem::path findAsset(const std::string& relativePath);
+
+    // runs all registered benchmarks, or only those whose names contain one of the arguments.
+    // --json <file> also writes the results to the file as JSON, sorted by name and scale.
+    int runBenchmarks(int argc, char** argv);
+
+    template<typename Fn>
+    double Context::measure(Fn&& fn, int repetitions) {
+        double best = 0.0;
+
+        for (int i = 0; i < repetitions; i++) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            m_samples.push_back(seconds);
+            if (i == 0 || seconds < best)
+                best = seconds;
+        }
+
+        return best;
+    }
+}
+
+#define BENCHMARK(name)                                                     \
+    static void name(bench::Context&);                                      \
+    static const bench::Registration name##Registration{ #name, name };     \
+    static void name(bench::Context& context)
+
+// BENCHMARK_SCALED(uniformSets, 1, 16, 256) runs once per scale, context.scale() is the current one
+#define BENCHMARK_SCALED(name, ...)                                                         \
+    static void name(bench::Context&);                                                      \
+    static const bench::Registration name##Registration{ #name, name, { __VA_ARGS__ } };    \
+    static void name(bench::Context& context)
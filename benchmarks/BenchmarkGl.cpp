@@ -0,0 +1,136 @@
+﻿#include "BenchmarkGl.h"
+
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include <GL/glew.h>
+#include <SFML/Window/Context.hpp>
+
+#include "Benchmark.h"
+
+namespace bench
+{
+    namespace
+    {
+        std::unique_ptr<sf::Context> context;
+
+        template<typename Fn>
+        struct Stub;
+
+        template<typename R, typename... Args>
+        struct Stub<R (GLAPIENTRY*)(Args...)> {
+            static R GLAPIENTRY call(Args...) { return R(); }
+        };
+
+        template<typename Fn>
+        void stub(Fn& pointer) {
+            pointer = &Stub<Fn>::call;
+        }
+
+        GLuint nextName = 1;
+
+        GLuint GLAPIENTRY createShader(GLenum) { return nextName++; }
+        GLuint GLAPIENTRY createProgram() { return nextName++; }
+
+        // everything compiles and links, and the programs have no active variables
+        void GLAPIENTRY getShaderiv(GLuint, GLenum name, GLint* value) {
+            *value = name == GL_COMPILE_STATUS ? GL_TRUE : 0;
+        }
+        void GLAPIENTRY getProgramiv(GLuint, GLenum name, GLint* value) {
+            *value = name == GL_LINK_STATUS || name == GL_VALIDATE_STATUS ? GL_TRUE : 0;
+        }
+
+        // the entry points the wrapped objects load through glew; the GL 1.1 ones are exported
+        // by the system library itself and do nothing without a current context
+        void stubGl() {
+            __glewCreateShader = createShader;
+            __glewCreateProgram = createProgram;
+            __glewGetShaderiv = getShaderiv;
+            __glewGetProgramiv = getProgramiv;
+
+            stub(__glewShaderSource);
+            stub(__glewCompileShader);
+            stub(__glewGetShaderInfoLog);
+            stub(__glewDeleteShader);
+            stub(__glewAttachShader);
+            stub(__glewLinkProgram);
+            stub(__glewGetProgramInfoLog);
+            stub(__glewDeleteProgram);
+            stub(__glewUseProgram);
+            stub(__glewBindFragDataLocation);
+            stub(__glewGetActiveUniform);
+            stub(__glewGetUniformLocation);
+            stub(__glewGetActiveAttrib);
+            stub(__glewGetAttribLocation);
+            stub(__glewGetActiveUniformBlockName);
+            stub(__glewGetActiveUniformBlockiv);
+            stub(__glewUniform1i);
+
+            stub(__glewProgramUniform1f);
+            stub(__glewProgramUniform2f);
+            stub(__glewProgramUniform3f);
+            stub(__glewProgramUniform4f);
+            stub(__glewProgramUniform1i);
+            stub(__glewProgramUniform2i);
+            stub(__glewProgramUniform3i);
+            stub(__glewProgramUniform4i);
+            stub(__glewProgramUniform1ui);
+            stub(__glewProgramUniform2ui);
+            stub(__glewProgramUniform3ui);
+            stub(__glewProgramUniform4ui);
+            stub(__glewProgramUniformMatrix2fv);
+            stub(__glewProgramUniformMatrix2x3fv);
+            stub(__glewProgramUniformMatrix2x4fv);
+            stub(__glewProgramUniformMatrix3fv);
+            stub(__glewProgramUniformMatrix3x2fv);
+            stub(__glewProgramUniformMatrix3x4fv);
+            stub(__glewProgramUniformMatrix4fv);
+            stub(__glewProgramUniformMatrix4x2fv);
+            stub(__glewProgramUniformMatrix4x3fv);
+
+            stub(__glewTextureParameteri);
+            stub(__glewTextureParameteriv);
+            stub(__glewGenerateMipmap);
+        }
+    }
+
+    void initGl(GlMode mode) {
+        if (mode == GlMode::Stub) {
+            stubGl();
+            setRunInfo("gl", "stub");
+            return;
+        }
+
+        context = std::make_unique<sf::Context>();
+
+        glewExperimental = GL_TRUE;
+        GLenum status = glewInit();
+        if (status != GLEW_OK)
+            throw std::runtime_error{ std::string{ "glewInit failed: " } + reinterpret_cast<const char*>(glewGetErrorString(status)) };
+
+        setRunInfo("gl", "context");
+        setRunInfo("renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    }
+
+    bool hasGlContext() {
+        return context != nullptr;
+    }
+
+    bool requireGl() {
+        if (hasGlContext())
+            return true;
+
+        std::printf("  skipped, needs a GL context (--gl)\n");
+        return false;
+    }
+
+    AssetDirectory::AssetDirectory(): m_previous(std::filesystem::current_path()) {
+        std::filesystem::current_path(findAsset("assets").parent_path());
+    }
+
+    AssetDirectory::~AssetDirectory() {
+        std::filesystem::current_path(m_previous);
+    }
+}
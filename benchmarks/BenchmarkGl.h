@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include <filesystem>
+
+namespace bench
+{
+    // What the benchmarks of GL wrapping code (uniforms, shaders, textures) call into.
+    enum class GlMode {
+        // glew's function pointers replaced with no-ops that report success, no context
+        // needed - measures the wrappers alone, the same on every machine
+        Stub,
+        // a hidden context from SFML, e.g. on llvmpipe on a headless machine
+        Context
+    };
+
+    // once before running the benchmarks; throws std::runtime_error when there is no context
+    void initGl(GlMode mode);
+
+    // false against the stubs, for benchmarks that only mean something on a real GPU
+    bool hasGlContext();
+
+    // hasGlContext(), printing that the benchmark is skipped when there is none
+    bool requireGl();
+
+    // makes basic_shadery the working directory while it lives, so the classes that load their
+    // shaders from assets/ find them like in the app
+    class AssetDirectory {
+    public:
+        AssetDirectory();
+
+        AssetDirectory(const AssetDirectory&) = delete;
+        AssetDirectory& operator=(const AssetDirectory&) = delete;
+
+        ~AssetDirectory();
+
+    private:
+        std::filesystem::path m_previous;
+    };
+}
@@ -0,0 +1,95 @@
+﻿#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <SFML/Window.hpp>
+
+#include "Benchmark.h"
+#include "FirstPersonControls.h"
+#include "InputState.h"
+#include "PerspectiveCamera.h"
+#include "Program.h"
+#include "Shader.h"
+#include "Uniform.h"
+
+namespace
+{
+    // updates per run, spread over the context.scale() cameras
+    constexpr int updateCount = 1 << 16;
+
+    glm::vec3 direction(int step) {
+        float angle = step * .001f;
+        return glm::normalize(glm::vec3{ std::sin(angle), .2f, -std::cos(angle) });
+    }
+
+    gl::Program viewProgram() {
+        gl::Shader vertexShader = gl::Shader::fromSource(
+            "#version 330 core\n"
+            "uniform mat4 view;\n"
+            "uniform mat4 projection;\n"
+            "void main() { gl_Position = projection * view * vec4(1.0); }\n",
+            gl::ShaderType::Vertex
+        );
+        gl::Shader fragmentShader = gl::Shader::fromSource(
+            "#version 330 core\n"
+            "out vec4 outColor;\n"
+            "void main() { outColor = vec4(1.0); }\n",
+            gl::ShaderType::Fragment
+        );
+        vertexShader.compile();
+        fragmentShader.compile();
+
+        gl::Program program;
+        program.useShader(vertexShader).useShader(fragmentShader).link();
+        return program;
+    }
+}
+
+// a view and a projection update, what a resize and a look around cost per camera
+BENCHMARK_SCALED(perspectiveCamera, 1, 64, 1024) {
+    std::vector<gl::PerspectiveCamera> cameras(context.scale(), gl::PerspectiveCamera{ glm::radians(60.f), 1300.f / 900.f, .1f, 1000.f });
+
+    double seconds = context.measure([&]() {
+        for (int update = 0; update < updateCount; update++) {
+            auto& camera = cameras[update % cameras.size()];
+            camera.setDirection(direction(update));
+            camera.setFov(glm::radians(50.f + update % 20));
+        }
+    }, 10);
+
+    context
+        .counter("updates", updateCount / seconds, "/s")
+        .counter("per update", seconds / updateCount * 1e9, "ns");
+}
+
+// replayed input moving and turning every camera, the view written to a uniform like in the app
+BENCHMARK_SCALED(firstPersonControls, 1, 64, 1024) {
+    gl::Program program = viewProgram();
+    auto view = program.createUniform<glm::mat4>("view");
+
+    // never opened, the controls only ask it for its size and cursor
+    sf::Window window;
+
+    std::vector<std::unique_ptr<gl::PerspectiveCamera>> cameras;
+    std::vector<std::unique_ptr<gl::FirstPersonControls>> controls;
+    for (long i = 0; i < context.scale(); i++) {
+        cameras.push_back(std::make_unique<gl::PerspectiveCamera>(glm::radians(60.f), 1300.f / 900.f, .1f, 1000.f));
+        controls.push_back(std::make_unique<gl::FirstPersonControls>(*cameras.back(), window));
+        controls.back()->releaseMouse();
+        controls.back()->setViewUniform(view);
+    }
+
+    gl::InputState input;
+    input.keys = gl::InputState::Forward | gl::InputState::Left;
+
+    double seconds = context.measure([&]() {
+        for (int update = 0; update < updateCount; update++) {
+            input.mouseOffset = { update % 7 - 3, update % 5 - 2 };
+            controls[update % controls.size()]->update(input, 16.f);
+        }
+    }, 10);
+
+    context
+        .counter("updates", updateCount / seconds, "/s")
+        .counter("per update", seconds / updateCount * 1e9, "ns");
+}
@@ -0,0 +1,127 @@
+﻿#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "Benchmark.h"
+#include "FrameArena.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    const int frames = 200;
+    const std::size_t draws = 4000;
+
+    struct DrawCommand {
+        std::uint32_t program;
+        std::uint32_t texture;
+        std::uint32_t firstIndex;
+        std::uint32_t indexCount;
+    };
+
+    // what a frame builds and throws away: a command list, the uniform data for it and
+    // a window title; grown element by element, as it would be while walking the scene
+    template<typename Commands, typename Floats, typename String>
+    std::size_t buildFrame(Commands& commands, Floats& uniforms, String& title, int frame) {
+        for (std::size_t i = 0; i < draws; i++) {
+            commands.push_back({ std::uint32_t(i % 7), std::uint32_t(i % 13), std::uint32_t(i * 36), 36 });
+            for (int j = 0; j < 16; j++)
+                uniforms.push_back(float(i + j + frame));
+        }
+
+        title += "Korwinium (OpenGL) - ";
+        title += std::to_string(1000000 / (frame + 1));
+        title += " FPS (";
+        title += std::to_string(frame + 1);
+        title += "us/frame)";
+
+        return commands.size() + uniforms.size() + title.size();
+    }
+}
+
+BENCHMARK(frameHeap) {
+    std::size_t checksum = 0;
+    double seconds = context.measure([&]() {
+        for (int frame = 0; frame < frames; frame++) {
+            std::vector<DrawCommand> commands;
+            std::vector<float> uniforms;
+            std::string title;
+            checksum += buildFrame(commands, uniforms, title, frame);
+        }
+    }, 5);
+
+    gl::AllocationCounter::Scope allocations;
+    std::vector<DrawCommand> commands;
+    std::vector<float> uniforms;
+    std::string title;
+    buildFrame(commands, uniforms, title, 0);
+
+    context.counter("frame", seconds / frames * 1e6, "us");
+    if (gl::AllocationCounter::isEnabled())
+        context.counter("allocations", double(allocations.allocations()), "/frame");
+}
+
+BENCHMARK(frameArena) {
+    gl::FrameArena arena{ 64 << 10 };
+
+    std::size_t checksum = 0;
+    auto frame = [&](int number) {
+        arena.beginFrame();
+        gl::ArenaVector<DrawCommand> commands{ arena.arena() };
+        gl::ArenaVector<float> uniforms{ arena.arena() };
+        gl::ArenaString title{ arena.arena() };
+        checksum += buildFrame(commands, uniforms, title, number);
+    };
+
+    double seconds = context.measure([&]() {
+        for (int number = 0; number < frames; number++)
+            frame(number);
+    }, 5);
+
+    // the arena has grown to fit during the runs above, from now on frames stay off the heap
+    gl::AllocationCounter::Scope allocations;
+    frame(0);
+
+    if (allocations.allocations() > 0)
+        throw std::runtime_error{ "steady-state frame allocated " + std::to_string(allocations.allocations()) + " times" };
+
+    context
+        .counter("frame", seconds / frames * 1e6, "us")
+        .counter("high water", arena.highWater() / 1024.0, "KiB");
+}
+
+BENCHMARK(frameArenaJobs) {
+    gl::ThreadPool pool;
+    gl::FrameArena arena{ 64 << 10, 2, pool.size() + 1 };
+
+    std::atomic<std::size_t> allocations{ 0 };
+    double seconds = context.measure([&]() {
+        for (int frame = 0; frame < frames / 4; frame++) {
+            arena.beginFrame();
+
+            // every job builds its part of the frame in its own thread's arena
+            pool.parallelFor(16, [&](std::size_t begin, std::size_t end) {
+                gl::AllocationCounter::Scope jobAllocations;
+                gl::LinearArena& local = arena.threadArena();
+
+                for (std::size_t part = begin; part < end; part++) {
+                    gl::ArenaVector<DrawCommand> commands{ local };
+                    gl::ArenaVector<float> uniforms{ local };
+                    gl::ArenaString title{ local };
+                    buildFrame(commands, uniforms, title, frame);
+                }
+
+                if (frame == frames / 4 - 1)
+                    allocations += jobAllocations.allocations();
+            });
+        }
+    }, 3);
+
+    context
+        .counter("frame", seconds / (frames / 4) * 1e6, "us")
+        .counter("high water", arena.highWater() / 1024.0, "KiB");
+    if (gl::AllocationCounter::isEnabled())
+        context.counter("allocations", double(allocations.load()), "in the last frame");
+}
@@ -0,0 +1,59 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ImageEncoder.h"
+
+namespace
+{
+    const unsigned width = 1300, height = 900;
+
+    // gradients with a checkerboard on top, roughly as compressible as a rendered frame
+    std::vector<std::uint8_t> frame() {
+        std::vector<std::uint8_t> pixels(std::size_t(width) * height * 4);
+
+        for (unsigned y = 0; y < height; y++) {
+            for (unsigned x = 0; x < width; x++) {
+                std::uint8_t* p = &pixels[(std::size_t(y) * width + x) * 4];
+                p[0] = std::uint8_t(x * 255 / width);
+                p[1] = std::uint8_t(y * 255 / height);
+                p[2] = std::uint8_t(((x / 32 + y / 32) % 2) * 200 + std::sin(x * .1f) * 20.f + 20.f);
+                p[3] = 255;
+            }
+        }
+
+        return pixels;
+    }
+}
+
+BENCHMARK(encodePng) {
+    const auto pixels = frame();
+
+    std::size_t bytes = 0;
+    double seconds = context.measure([&]() { bytes = gl::ImageEncoder::encodePng(pixels.data(), width, height).size(); }, 10);
+
+    context
+        .counter("size", bytes / 1024.0, "KiB")
+        .counter("ratio", double(width) * height * 3 / bytes)
+        .counter("frames", 1.0 / seconds, "/s");
+}
+
+BENCHMARK(encodePpm) {
+    const auto pixels = frame();
+
+    double seconds = context.measure([&]() { gl::ImageEncoder::encodePpm(pixels.data(), width, height); }, 10);
+    context.counter("frames", 1.0 / seconds, "/s");
+}
+
+BENCHMARK(encodeY4m) {
+    const auto pixels = frame();
+
+    std::vector<std::uint8_t> stream;
+    double seconds = context.measure([&]() {
+        stream.clear();
+        gl::ImageEncoder::encodeY4mFrame(pixels.data(), width, height, stream);
+    }, 10);
+
+    context.counter("frames", 1.0 / seconds, "/s");
+}
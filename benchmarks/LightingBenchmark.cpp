@@ -0,0 +1,42 @@
+﻿#include <random>
+#include <vector>
+
+#include "Benchmark.h"
+#include "LightClusters.h"
+#include "PerspectiveCamera.h"
+
+namespace
+{
+    // context.scale() lights scattered over a 60x60 square around the camera, at the radii
+    // the app gives its lights
+    std::vector<gl::PointLight> scatterLights(std::size_t count) {
+        std::mt19937 random{ 2137 };
+        std::uniform_real_distribution<float> position{ -30.f, 30.f }, height{ .0f, 4.f }, radius{ 1.5f, 3.f };
+
+        std::vector<gl::PointLight> lights;
+        for (std::size_t i = 0; i < count; i++)
+            lights.push_back({ { position(random), height(random), position(random) }, radius(random), { 1.f, 1.f, 1.f } });
+
+        return lights;
+    }
+}
+
+// per-frame light assignment: view space transform, per slice gathering and the SSE tests
+// against all 16x9x24 clusters, then joining the lists
+BENCHMARK_SCALED(lightAssignment, 128, 512, 2048) {
+    gl::PerspectiveCamera camera{ 1.f, 16.f / 9.f, .1f, 100.f };
+    camera.setPosition({ .0f, 1.7f, .0f });
+    camera.lookAt({ 10.f, 1.f, -20.f });
+
+    const auto lights = scatterLights(static_cast<std::size_t>(context.scale()));
+    gl::LightClusters clusters;
+    clusters.assign(camera, lights);
+
+    context.measure([&]() {
+        clusters.assign(camera, lights);
+    }, 50);
+
+    context
+        .counter("indices", double(clusters.indices().size()))
+        .counter("lights per cluster", double(clusters.indices().size()) / clusters.clusterCount());
+}
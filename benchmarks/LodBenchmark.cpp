@@ -0,0 +1,42 @@
+﻿#include <cmath>
+#include <cstdint>
+
+#include "Benchmark.h"
+#include "LodMesh.h"
+
+namespace
+{
+    gl::MeshData terrain(int size) {
+        gl::MeshData mesh;
+
+        for (int y = 0; y <= size; y++) {
+            for (int x = 0; x <= size; x++) {
+                glm::vec3 position{ float(x), std::sin(x * 0.05f) * std::cos(y * 0.07f) * 4.f, float(y) };
+                mesh.vertices.push_back({ position, glm::vec3{ .0f, 1.f, .0f }, glm::vec2{ float(x) / size, float(y) / size } });
+            }
+        }
+
+        for (std::uint32_t y = 0; y < std::uint32_t(size); y++) {
+            for (std::uint32_t x = 0; x < std::uint32_t(size); x++) {
+                std::uint32_t a = y * (size + 1) + x;
+                mesh.indices.insert(mesh.indices.end(), { a, a + size + 1, a + size + 2, a, a + size + 2, a + 1 });
+            }
+        }
+
+        return mesh;
+    }
+}
+
+BENCHMARK(buildLodChain) {
+    const gl::MeshData source = terrain(500);
+
+    gl::LodChain chain;
+    double seconds = context.measure([&]() { chain = gl::LodChain::build(source); }, 1);
+
+    context
+        .counter("source triangles", double(source.triangleCount()))
+        .counter("levels", double(chain.levels.size()))
+        .counter("coarsest triangles", double(chain.levels.back().indexCount / 3))
+        .counter("coarsest error", chain.levels.back().error, "units")
+        .counter("throughput", source.triangleCount() / seconds / 1e6, "Mtris/s");
+}
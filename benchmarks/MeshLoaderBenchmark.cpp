@@ -0,0 +1,173 @@
+﻿#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "MeshLoader.h"
+
+namespace
+{
+    // grid resolution of the generated scans, 2 * N * N triangles
+    constexpr int gridSize = 1200;
+
+    float height(int x, int y) {
+        return std::sin(x * 0.05f) * std::cos(y * 0.07f) * 4.f;
+    }
+
+    void append(std::string& out, float value) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    void append(std::string& out, std::uint32_t value) {
+        char buffer[16];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+
+    // heightfield triangle soup shaped like a typical range scan: positions and faces only
+    const std::filesystem::path& generateObj() {
+        static const std::filesystem::path path = std::filesystem::temp_directory_path() / "grafika_bench_scan.obj";
+        if (std::filesystem::exists(path))
+            return path;
+
+        std::string text;
+        text.reserve(std::size_t(gridSize + 1) * (gridSize + 1) * 64);
+
+        for (int y = 0; y <= gridSize; y++) {
+            for (int x = 0; x <= gridSize; x++) {
+                text += "v ";
+                append(text, float(x));
+                text += ' ';
+                append(text, height(x, y));
+                text += ' ';
+                append(text, float(y));
+                text += '\n';
+            }
+        }
+
+        for (int y = 0; y < gridSize; y++) {
+            for (int x = 0; x < gridSize; x++) {
+                std::uint32_t a = y * (gridSize + 1) + x + 1;
+                std::uint32_t quad[4] = { a, a + 1, a + gridSize + 2, a + gridSize + 1 };
+
+                for (int t = 0; t < 2; t++) {
+                    text += "f ";
+                    append(text, quad[0]);
+                    text += ' ';
+                    append(text, quad[t + 1]);
+                    text += ' ';
+                    append(text, quad[t + 2]);
+                    text += '\n';
+                }
+            }
+        }
+
+        std::ofstream{ path, std::ios::binary }.write(text.data(), text.size());
+        return path;
+    }
+
+    const std::filesystem::path& generateGlb() {
+        static const std::filesystem::path path = std::filesystem::temp_directory_path() / "grafika_bench_scan.glb";
+        if (std::filesystem::exists(path))
+            return path;
+
+        std::vector<float> positions;
+        positions.reserve(std::size_t(gridSize + 1) * (gridSize + 1) * 3);
+        for (int y = 0; y <= gridSize; y++) {
+            for (int x = 0; x <= gridSize; x++) {
+                positions.push_back(float(x));
+                positions.push_back(height(x, y));
+                positions.push_back(float(y));
+            }
+        }
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve(std::size_t(gridSize) * gridSize * 6);
+        for (std::uint32_t y = 0; y < gridSize; y++) {
+            for (std::uint32_t x = 0; x < gridSize; x++) {
+                std::uint32_t a = y * (gridSize + 1) + x;
+                std::uint32_t quad[4] = { a, a + 1, a + gridSize + 2, a + gridSize + 1 };
+                indices.insert(indices.end(), { quad[0], quad[1], quad[2], quad[0], quad[2], quad[3] });
+            }
+        }
+
+        std::size_t positionBytes = positions.size() * sizeof(float);
+        std::size_t indexBytes = indices.size() * sizeof(std::uint32_t);
+
+        std::string json = "{\"asset\":{\"version\":\"2.0\"},"
+            "\"buffers\":[{\"byteLength\":" + std::to_string(positionBytes + indexBytes) + "}],"
+            "\"bufferViews\":["
+                "{\"buffer\":0,\"byteOffset\":0,\"byteLength\":" + std::to_string(positionBytes) + ",\"target\":34962},"
+                "{\"buffer\":0,\"byteOffset\":" + std::to_string(positionBytes) + ",\"byteLength\":" + std::to_string(indexBytes) + ",\"target\":34963}],"
+            "\"accessors\":["
+                "{\"bufferView\":0,\"componentType\":5126,\"count\":" + std::to_string(positions.size() / 3) + ",\"type\":\"VEC3\"},"
+                "{\"bufferView\":1,\"componentType\":5125,\"count\":" + std::to_string(indices.size()) + ",\"type\":\"SCALAR\"}],"
+            "\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}]}";
+        json.resize((json.size() + 3) & ~std::size_t(3), ' ');
+
+        std::uint32_t jsonLength = static_cast<std::uint32_t>(json.size());
+        std::uint32_t binLength = static_cast<std::uint32_t>(positionBytes + indexBytes);
+        std::uint32_t header[3] = { 0x46546C67u, 2, 12 + 8 + jsonLength + 8 + binLength };
+        std::uint32_t jsonHeader[2] = { jsonLength, 0x4E4F534Au };
+        std::uint32_t binHeader[2] = { binLength, 0x004E4942u };
+
+        std::ofstream file{ path, std::ios::binary };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(jsonHeader), sizeof(jsonHeader));
+        file.write(json.data(), json.size());
+        file.write(reinterpret_cast<const char*>(binHeader), sizeof(binHeader));
+        file.write(reinterpret_cast<const char*>(positions.data()), positionBytes);
+        file.write(reinterpret_cast<const char*>(indices.data()), indexBytes);
+
+        return path;
+    }
+
+    void reportMesh(bench::Context& context, const std::filesystem::path& path, const gl::MeshData& mesh, double seconds) {
+        double megabytes = std::filesystem::file_size(path) / (1024.0 * 1024.0);
+
+        context
+            .counter("triangles", double(mesh.triangleCount()))
+            .counter("vertices", double(mesh.vertices.size()))
+            .counter("file size", megabytes, "MB")
+            .counter("throughput", mesh.triangleCount() / seconds / 1e6, "Mtris/s")
+            .counter("bandwidth", megabytes / seconds, "MB/s");
+    }
+}
+
+BENCHMARK(loadObjScan) {
+    const auto& path = generateObj();
+    gl::ThreadPool& pool = gl::ThreadPool::shared();
+
+    gl::MeshData mesh;
+    double seconds = context.measure([&]() { mesh = gl::MeshLoader::loadObj(path, pool); });
+
+    reportMesh(context, path, mesh, seconds);
+    context.counter("threads", double(pool.size() + 1));
+}
+
+BENCHMARK(loadObjScanSingleWorker) {
+    const auto& path = generateObj();
+    gl::ThreadPool pool{ 1 };
+
+    gl::MeshData mesh;
+    double seconds = context.measure([&]() { mesh = gl::MeshLoader::loadObj(path, pool); });
+
+    reportMesh(context, path, mesh, seconds);
+    context.counter("threads", double(pool.size() + 1));
+}
+
+BENCHMARK(loadGlbScan) {
+    const auto& path = generateGlb();
+
+    gl::MeshData mesh;
+    double seconds = context.measure([&]() { mesh = gl::MeshLoader::loadGltf(path); });
+
+    reportMesh(context, path, mesh, seconds);
+}
@@ -0,0 +1,72 @@
+﻿#include <algorithm>
+#include <cstdint>
+#include <random>
+
+#include "Benchmark.h"
+#include "MeshOptimizer.h"
+
+namespace
+{
+    // regular grid with its triangles in random order, like a mesh coming out of a converter
+    gl::MeshData shuffledGrid(int size) {
+        gl::MeshData mesh;
+
+        for (int y = 0; y <= size; y++)
+            for (int x = 0; x <= size; x++)
+                mesh.vertices.push_back({ glm::vec3{ float(x), .0f, float(y) }, glm::vec3{ .0f, 1.f, .0f }, glm::vec2{ .0f } });
+
+        std::vector<std::uint32_t> triangles;
+        for (std::uint32_t y = 0; y < std::uint32_t(size); y++) {
+            for (std::uint32_t x = 0; x < std::uint32_t(size); x++) {
+                std::uint32_t a = y * (size + 1) + x;
+                triangles.push_back(a);
+                triangles.push_back(a + size + 1);
+                triangles.push_back(a + size + 2);
+                triangles.push_back(a);
+                triangles.push_back(a + size + 2);
+                triangles.push_back(a + 1);
+            }
+        }
+
+        std::vector<std::size_t> order(triangles.size() / 3);
+        for (std::size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+        std::shuffle(order.begin(), order.end(), std::mt19937{ 1234 });
+
+        for (std::size_t t : order)
+            mesh.indices.insert(mesh.indices.end(), triangles.begin() + t * 3, triangles.begin() + t * 3 + 3);
+
+        return mesh;
+    }
+
+    void runOptimize(bench::Context& context, const gl::MeshOptimizeOptions& options) {
+        const gl::MeshData source = shuffledGrid(500);
+
+        gl::MeshData mesh;
+        gl::MeshOptimizeReport report;
+        double seconds = context.measure([&]() {
+            mesh = source;
+            report = gl::MeshOptimizer::optimize(mesh, options);
+        });
+
+        context
+            .counter("triangles", double(mesh.triangleCount()))
+            .counter("ACMR before", report.before.acmr)
+            .counter("ACMR after", report.after.acmr)
+            .counter("ATVR before", report.before.atvr)
+            .counter("ATVR after", report.after.atvr)
+            .counter("throughput", mesh.triangleCount() / seconds / 1e6, "Mtris/s");
+    }
+}
+
+BENCHMARK(optimizeVertexCache) {
+    runOptimize(context, {});
+}
+
+BENCHMARK(optimizeVertexCacheAndOverdraw) {
+    gl::MeshOptimizeOptions options;
+    options.reduceOverdraw = true;
+    options.viewpoint = glm::vec3{ 250.f, 100.f, -50.f };
+
+    runOptimize(context, options);
+}
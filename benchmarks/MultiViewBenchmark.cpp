@@ -0,0 +1,175 @@
+﻿#include <cmath>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/ext.hpp>
+
+#include "Benchmark.h"
+#include "BenchmarkGl.h"
+#include "MultiView.h"
+#include "PerspectiveCamera.h"
+#include "Program.h"
+#include "ProgramCache.h"
+#include "RenderTarget.h"
+#include "Texture.h"
+#include "Uniform.h"
+#include "VertexArray.h"
+
+namespace
+{
+    constexpr int viewWidth = 320, viewHeight = 180;
+    constexpr int gridSize = 16;
+
+    const float quadVertices[] = {
+        -.4f, -.4f, .0f,   1.f, 1.f, 1.f,   .0f, .0f,
+        .4f, -.4f, .0f,    1.f, 1.f, 1.f,   1.f, .0f,
+        .4f, .4f, .0f,     1.f, 1.f, 1.f,   1.f, 1.f,
+        -.4f, .4f, .0f,    1.f, 1.f, 1.f,   .0f, 1.f
+    };
+    const GLuint quadIndices[] = { 0, 1, 2, 0, 2, 3 };
+
+    // a 16x16 wall of quads, one draw and one model matrix each, and context.scale() cameras
+    // looking at it from around
+    struct Scene {
+        bench::AssetDirectory assets;
+        gl::ProgramCache programs;
+        gl::Texture texture;
+        GLuint vertexBuffer = 0;
+        GLuint indexBuffer = 0;
+        std::vector<glm::mat4> models;
+        std::vector<gl::PerspectiveCamera> cameras;
+
+        explicit Scene(std::size_t viewCount) {
+            texture
+                .bind()
+                .allocate(1, 1, gl::Texture::Format::RGBA8)
+                .setMinFilter(gl::Texture::MinFilter::Nearest);
+
+            glGenBuffers(1, &vertexBuffer);
+            glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+            glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
+            glGenBuffers(1, &indexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+
+            for (int y = 0; y < gridSize; y++)
+                for (int x = 0; x < gridSize; x++)
+                    models.push_back(glm::translate(glm::mat4{ 1.f }, glm::vec3{ x - gridSize / 2.f, y - gridSize / 2.f, .0f }));
+
+            for (std::size_t view = 0; view < viewCount; view++) {
+                float angle = (view + .5f) / viewCount - .5f;
+                gl::PerspectiveCamera camera{ 1.f, float(viewWidth) / viewHeight, .1f, 100.f };
+                camera.setPosition({ 20.f * std::sin(angle), .0f, 20.f * std::cos(angle) });
+                camera.lookAt({ .0f, .0f, .0f });
+                cameras.push_back(camera);
+            }
+        }
+
+        // expects the program bound
+        void bindArray(const gl::VertexArray& array, const gl::Program& program) {
+            array.bind();
+            glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+            array
+                .setAttribute(program.getAttributeLocation("position"), 3, GL_FLOAT, 8 * sizeof(float), 0)
+                .setAttribute(program.getAttributeLocation("color"), 3, GL_FLOAT, 8 * sizeof(float), 3 * sizeof(float))
+                .setAttribute(program.getAttributeLocation("texCoord"), 2, GL_FLOAT, 8 * sizeof(float), 6 * sizeof(float));
+        }
+
+        ~Scene() {
+            glDeleteBuffers(1, &indexBuffer);
+            glDeleteBuffers(1, &vertexBuffer);
+        }
+    };
+
+    // one frame with GL calls counted, to tell how much the CPU submits for it
+    template<typename Fn>
+    double callsPerFrame(Fn&& frame) {
+        bool wasCounting = gl::GlDispatch::isCounting();
+        gl::GlDispatch::setCounting(true);
+        gl::GlDispatch::endFrame();
+        frame();
+        gl::GlDispatch::endFrame();
+        gl::GlDispatch::setCounting(wasCounting);
+
+        return double(gl::GlDispatch::lastFrame().totalCalls());
+    }
+}
+
+// the scene submitted once per view, each view a viewport of a split-screen target
+BENCHMARK_SCALED(viewsRepeated, 1, 2, 4, 8) {
+    if (!bench::requireGl())
+        return;
+
+    Scene scene{ static_cast<std::size_t>(context.scale()) };
+    gl::Program& program = scene.programs.get("assets/shaders/textured.vert.glsl", "assets/shaders/textured.frag.glsl");
+    auto model = program.createUniform<glm::mat4>("model");
+    auto view = program.createUniform<glm::mat4>("view");
+    auto projection = program.createUniform<glm::mat4>("projection");
+    program.createUniform<GLint>("tex1", 0);
+
+    gl::VertexArray array;
+    program.bind();
+    scene.bindArray(array, program);
+
+    GLsizei viewCount = static_cast<GLsizei>(scene.cameras.size());
+    gl::RenderTarget target{ viewWidth * viewCount, viewHeight };
+
+    auto frame = [&]() {
+        target.bind();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        program.bind();
+        array.bind();
+        scene.texture.bind();
+
+        for (GLsizei i = 0; i < viewCount; i++) {
+            glViewport(i * viewWidth, 0, viewWidth, viewHeight);
+            view = scene.cameras[i].getViewMatrix();
+            projection = scene.cameras[i].getProjectionMatrix();
+
+            for (const auto& matrix : scene.models) {
+                model = matrix;
+                glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+            }
+        }
+        glFinish();
+    };
+
+    context.measure(frame, 20);
+    context.counter("GL calls", callsPerFrame(frame), "/frame");
+}
+
+// the same views from a single submission through MultiView's layered target
+BENCHMARK_SCALED(viewsMultiView, 1, 2, 4, 8) {
+    if (!bench::requireGl())
+        return;
+
+    Scene scene{ static_cast<std::size_t>(context.scale()) };
+    gl::Program& program = scene.programs.get("assets/shaders/multiview.vert.glsl", "assets/shaders/multiview.geom.glsl", "assets/shaders/textured.frag.glsl");
+    auto model = program.createUniform<glm::mat4>("model");
+    program.createUniform<GLint>("tex1", 0);
+
+    gl::VertexArray array;
+    program.bind();
+    scene.bindArray(array, program);
+
+    gl::MultiView multiView{ program, scene.cameras.size(), viewWidth, viewHeight, scene.programs };
+
+    auto frame = [&]() {
+        multiView.setCameras(scene.cameras).begin();
+        program.bind();
+        array.bind();
+        scene.texture.bind();
+
+        for (const auto& matrix : scene.models) {
+            model = matrix;
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        }
+
+        multiView.end();
+        glFinish();
+    };
+
+    context.measure(frame, 20);
+    context.counter("GL calls", callsPerFrame(frame), "/frame");
+}
@@ -0,0 +1,99 @@
+﻿#include <cstdint>
+#include <vector>
+
+#include <glm/ext.hpp>
+
+#include "Benchmark.h"
+#include "OcclusionCuller.h"
+
+namespace
+{
+    const std::vector<glm::vec3> boxPositions = {
+        { -1.f, -1.f, -1.f }, { 1.f, -1.f, -1.f }, { 1.f, 1.f, -1.f }, { -1.f, 1.f, -1.f },
+        { -1.f, -1.f, 1.f }, { 1.f, -1.f, 1.f }, { 1.f, 1.f, 1.f }, { -1.f, 1.f, 1.f }
+    };
+
+    const std::vector<std::uint32_t> boxIndices = {
+        0, 2, 1, 0, 3, 2,   4, 5, 6, 4, 6, 7,
+        0, 1, 5, 0, 5, 4,   3, 7, 6, 3, 6, 2,
+        0, 4, 7, 0, 7, 3,   1, 2, 6, 1, 6, 5
+    };
+
+    // street level view over a grid of buildings, with small props scattered between them
+    struct City {
+        glm::mat4 viewProjection;
+        std::vector<glm::mat4> buildings;
+        std::vector<glm::mat4> props;
+
+        City(int blocks) {
+            glm::mat4 projection = glm::perspective(1.f, 16.f / 9.f, .1f, 1000.f);
+            glm::mat4 view = glm::lookAt(glm::vec3{ 2.5f, 1.7f, 2.5f }, glm::vec3{ 60.f, 1.7f, 80.f }, glm::vec3{ .0f, 1.f, .0f });
+            viewProjection = projection * view;
+
+            for (int z = 0; z < blocks; z++) {
+                for (int x = 0; x < blocks; x++) {
+                    glm::vec3 center{ x * 10.f + 5.f + 2.5f, 8.f + (x * 7 + z * 3) % 10, z * 10.f + 5.f + 2.5f };
+                    glm::mat4 model = glm::scale(glm::translate(glm::mat4{ 1.f }, center), glm::vec3{ 3.5f, center.y, 3.5f });
+                    buildings.push_back(model);
+
+                    for (int p = 0; p < 8; p++) {
+                        glm::vec3 position{ x * 10.f + (p % 4) * 2.5f, .5f, z * 10.f + (p / 4) * 9.f };
+                        props.push_back(glm::scale(glm::translate(glm::mat4{ 1.f }, position), glm::vec3{ .5f }));
+                    }
+                }
+            }
+        }
+    };
+
+    void rasterizeCity(bench::Context& context, unsigned width, unsigned height) {
+        const City city{ 24 };
+        gl::OcclusionCuller culler{ width, height };
+
+        double seconds = context.measure([&]() {
+            culler.clear();
+            for (const auto& model : city.buildings)
+                culler.addOccluder(boxPositions, boxIndices, city.viewProjection * model);
+            culler.rasterize();
+        }, 20);
+
+        context
+            .counter("occluder triangles", double(city.buildings.size() * boxIndices.size() / 3))
+            .counter("rasterized triangles", double(culler.triangleCount()))
+            .counter("throughput", city.buildings.size() * boxIndices.size() / 3 / seconds / 1e6, "Mtris/s");
+    }
+}
+
+BENCHMARK(occlusionRasterize256x128) {
+    rasterizeCity(context, 256, 128);
+}
+
+BENCHMARK(occlusionRasterize512x256) {
+    rasterizeCity(context, 512, 256);
+}
+
+BENCHMARK(occlusionTestBounds) {
+    const City city{ 24 };
+    gl::OcclusionCuller culler{ 256, 128 };
+
+    culler.clear();
+    for (const auto& model : city.buildings)
+        culler.addOccluder(boxPositions, boxIndices, city.viewProjection * model);
+    culler.rasterize();
+
+    std::vector<glm::mat4> props;
+    for (const auto& model : city.props)
+        props.push_back(city.viewProjection * model);
+
+    std::size_t hidden = 0;
+    double seconds = context.measure([&]() {
+        hidden = 0;
+        for (const auto& modelViewProjection : props)
+            if (!culler.isVisible(glm::vec3{ -1.f }, glm::vec3{ 1.f }, modelViewProjection))
+                hidden++;
+    }, 20);
+
+    context
+        .counter("objects", double(props.size()))
+        .counter("culled", 100.0 * hidden / props.size(), "%")
+        .counter("tests", props.size() / seconds / 1e6, "M/s");
+}
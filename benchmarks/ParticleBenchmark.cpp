@@ -0,0 +1,68 @@
+﻿#include "GlDispatch.h"
+
+#include "Benchmark.h"
+#include "BenchmarkGl.h"
+#include "ParticleSystem.h"
+#include "PerspectiveCamera.h"
+#include "ProgramCache.h"
+#include "RenderTarget.h"
+
+namespace
+{
+    constexpr float timeStep = 1.f / 60.f;
+
+    // a fountain of context.scale() particles that all stay alive, seen from far enough that
+    // the quads are a few pixels each and the frame is not dominated by fill rate
+    void particleFrames(bench::Context& context, bool isRendered) {
+        if (!bench::requireGl())
+            return;
+
+        bench::AssetDirectory assets;
+        gl::ProgramCache programs;
+        gl::RenderTarget target{ 1280, 720 };
+        gl::PerspectiveCamera camera{ 1.f, 1280.f / 720.f, .1f, 100.f };
+        camera.setPosition({ .0f, 2.f, 12.f });
+        camera.lookAt({ .0f, 2.f, .0f });
+
+        std::size_t count = static_cast<std::size_t>(context.scale());
+        gl::ParticleSystem particles{ count, programs };
+        particles.emitter().lifetime = { 1e6f, 1e6f };
+        particles.emitter().velocitySpread = 3.f;
+        particles
+            .setGravity({ .0f, -.5f, .0f })
+            .setSize(.01f)
+            .emit(count)
+            .update(timeStep);
+
+        target.bind();
+        glFinish();
+
+        double seconds = context.measure([&]() {
+            particles.update(timeStep);
+            if (isRendered) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                particles.render(camera);
+            }
+            glFinish();
+        }, 10);
+
+        // the count of the last updates is in by now
+        particles.update(.0f);
+        glFinish();
+        particles.update(.0f);
+
+        context
+            .counter("alive", double(particles.aliveCount()))
+            .counter("throughput", count / seconds / 1e6, "M particles/s");
+    }
+}
+
+// transform feedback pass alone: advancing, compacting and re-capturing every particle
+BENCHMARK_SCALED(particleUpdate, 65536, 262144, 1048576) {
+    particleFrames(context, false);
+}
+
+// a whole particle frame, the update and the camera-facing quads drawn into 1280x720
+BENCHMARK_SCALED(particleFrame, 65536, 262144, 1048576) {
+    particleFrames(context, true);
+}
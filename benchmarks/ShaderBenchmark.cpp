@@ -0,0 +1,67 @@
+﻿#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Benchmark.h"
+#include "Shader.h"
+
+namespace
+{
+    constexpr long functionsPerFile = 64;
+
+    // main file including context.scale() / 64 libraries of small functions, all of them used
+    std::filesystem::path generateShader(long functions) {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / ("grafika_bench_shader_" + std::to_string(functions));
+        std::filesystem::create_directories(directory);
+
+        std::ofstream main{ directory / "main.frag.glsl" };
+        main << "#version 330 core\n";
+
+        long files = (functions + functionsPerFile - 1) / functionsPerFile;
+        for (long file = 0; file < files; file++) {
+            std::string name = "lib" + std::to_string(file) + ".glsl";
+            main << "#include \"" << name << "\"\n";
+
+            std::ofstream lib{ directory / name };
+            for (long i = file * functionsPerFile; i < functions && i < (file + 1) * functionsPerFile; i++)
+                lib << "float f" << i << "(float x) {\n    return x * " << i + 1 << ".0 + sin(x * 0.5);\n}\n\n";
+        }
+
+        main << "\nout vec4 outColor;\n\nvoid main() {\n    float sum = 0.0;\n";
+        for (long i = 0; i < functions; i++)
+            main << "    sum += f" << i << "(gl_FragCoord.x);\n";
+        main << "    outColor = vec4(sum);\n}\n";
+
+        return directory / "main.frag.glsl";
+    }
+}
+
+// preprocessing the includes, handing the source to GL and compiling it
+BENCHMARK_SCALED(shaderFromFile, 16, 256, 4096) {
+    std::string path = generateShader(context.scale()).string();
+
+    std::size_t sourceBytes = 0;
+    for (const auto& entry : std::filesystem::directory_iterator{ std::filesystem::path{ path }.parent_path() })
+        sourceBytes += entry.file_size();
+
+    double seconds = context.measure([&]() {
+        gl::Shader shader = gl::Shader::fromFile(path.c_str(), gl::ShaderType::Fragment);
+        shader.compile();
+    }, 5);
+
+    context
+        .counter("source", sourceBytes / 1024.0, "KiB")
+        .counter("throughput", sourceBytes / seconds / 1e6, "MB/s");
+}
+
+// one of the app's own shaders, with its include
+BENCHMARK(shaderFromFileAsset) {
+    std::string path = bench::findAsset("assets/shaders/radial.frag.glsl").string();
+
+    double seconds = context.measure([&]() {
+        gl::Shader shader = gl::Shader::fromFile(path.c_str(), gl::ShaderType::Fragment);
+        shader.compile();
+    }, 10);
+
+    context.counter("shaders", 1.0 / seconds, "/s");
+}
@@ -0,0 +1,109 @@
+﻿#include <cstdint>
+#include <vector>
+
+#include <glm/ext.hpp>
+
+#include "Benchmark.h"
+#include "SoftwarePrograms.h"
+
+namespace
+{
+    struct Vertex {
+        glm::vec3 position;
+        glm::vec3 color;
+        glm::vec2 texCoord;
+    };
+
+    // unit cubes with a full texture on every face, laid out as a wall of 24x14 facing the camera at an angle
+    struct Scene {
+        std::vector<Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+        glm::mat4 view, projection;
+
+        Scene(float aspect) {
+            const glm::vec3 corners[8] = {
+                { -.5f, -.5f, -.5f }, { .5f, -.5f, -.5f }, { .5f, .5f, -.5f }, { -.5f, .5f, -.5f },
+                { -.5f, -.5f, .5f }, { .5f, -.5f, .5f }, { .5f, .5f, .5f }, { -.5f, .5f, .5f }
+            };
+            const int faces[6][4] = {
+                { 0, 3, 2, 1 }, { 4, 5, 6, 7 }, { 0, 1, 5, 4 }, { 3, 7, 6, 2 }, { 0, 4, 7, 3 }, { 1, 2, 6, 5 }
+            };
+            const glm::vec2 uvs[4] = { { .0f, .0f }, { 1.f, .0f }, { 1.f, 1.f }, { .0f, 1.f } };
+
+            for (int z = 0; z < 14; z++) {
+                for (int x = 0; x < 24; x++) {
+                    glm::vec3 center{ x * 1.5f - 17.25f, z * 1.5f - 9.75f, -(x + z) * .4f };
+
+                    for (const auto& face : faces) {
+                        auto first = static_cast<std::uint32_t>(vertices.size());
+                        for (int c = 0; c < 4; c++)
+                            vertices.push_back({ center + corners[face[c]], corners[face[c]] + .5f, uvs[c] });
+
+                        indices.insert(indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+                    }
+                }
+            }
+
+            view = glm::lookAt(glm::vec3{ -6.f, 3.f, 24.f }, glm::vec3{ .0f, .0f, -8.f }, glm::vec3{ .0f, 1.f, .0f });
+            projection = glm::perspective(1.f, aspect, .1f, 100.f);
+        }
+    };
+
+    gl::SoftwareTexture checkerboard(int size) {
+        std::vector<unsigned char> pixels;
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) {
+                unsigned char value = ((x / 16 + y / 16) % 2) ? 230 : 40;
+                pixels.insert(pixels.end(), { value, static_cast<unsigned char>(x), static_cast<unsigned char>(y) });
+            }
+        }
+
+        return gl::SoftwareTexture::fromPixels(pixels.data(), size, size, 3);
+    }
+
+    template<typename Program>
+    void renderScene(bench::Context& context, Program program, gl::ThreadPool& pool) {
+        const unsigned width = 1280, height = 720;
+        const Scene scene{ float(width) / height };
+
+        gl::SoftwareTarget target{ width, height };
+        gl::SoftwareRasterizer rasterizer{ pool };
+
+        program.view = scene.view;
+        program.projection = scene.projection;
+
+        double seconds = context.measure([&]() {
+            target.clear(glm::vec4{ .1f, .1f, .1f, 1.f });
+            rasterizer.draw(program, scene.vertices, scene.indices, target);
+        }, 20);
+
+        context
+            .counter("threads", double(pool.size() + 1))
+            .counter("triangles", double(scene.indices.size() / 3))
+            .counter("rasterized", double(rasterizer.triangleCount()))
+            .counter("frame", seconds * 1e3, "ms")
+            .counter("fill rate", width * height / seconds / 1e6, "Mpixels/s");
+    }
+}
+
+BENCHMARK(softwareRasterizerColored) {
+    renderScene(context, gl::SoftwareDefaultProgram{}, gl::ThreadPool::shared());
+}
+
+BENCHMARK(softwareRasterizerTextured) {
+    const gl::SoftwareTexture texture = checkerboard(256);
+
+    gl::SoftwareTexturedProgram program;
+    program.tex1 = &texture;
+    renderScene(context, program, gl::ThreadPool::shared());
+}
+
+// how the same frame scales with the core count, compare against the shared pool above
+BENCHMARK(softwareRasterizerTextured2Threads) {
+    const gl::SoftwareTexture texture = checkerboard(256);
+    gl::ThreadPool pool{ 1 };
+
+    gl::SoftwareTexturedProgram program;
+    program.tex1 = &texture;
+    renderScene(context, program, pool);
+}
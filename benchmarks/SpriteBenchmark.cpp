@@ -0,0 +1,89 @@
+﻿#include <array>
+#include <random>
+#include <vector>
+
+#include "GlDispatch.h"
+#include <glm/ext.hpp>
+
+#include "Benchmark.h"
+#include "BenchmarkGl.h"
+#include "ProgramCache.h"
+#include "RenderTarget.h"
+#include "SpriteBatch.h"
+#include "Texture.h"
+
+namespace
+{
+    constexpr int width = 1280, height = 720;
+
+    struct Sprite {
+        glm::vec2 position;
+        glm::vec4 color;
+        int texture;
+    };
+
+    // small sprites all over the screen, the texture changing every runLength sprites
+    std::vector<Sprite> scatterSprites(std::size_t count, int textureCount, std::size_t runLength) {
+        std::mt19937 random{ 2137 };
+        std::uniform_real_distribution<float> x{ .0f, width - 4.f }, y{ .0f, height - 4.f }, channel{ .5f, 1.f };
+        std::uniform_int_distribution<int> texture{ 0, textureCount - 1 };
+
+        std::vector<Sprite> sprites;
+        int current = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            if (i % runLength == 0)
+                current = texture(random);
+            sprites.push_back({ { x(random), y(random) }, { channel(random), channel(random), channel(random), 1.f }, current });
+        }
+
+        return sprites;
+    }
+
+    // a frame of context.scale() 4x4 sprites over 8 small textures, batched and drawn into 1280x720
+    void spriteFrames(bench::Context& context, gl::SpriteBatch::Order order, std::size_t runLength) {
+        if (!bench::requireGl())
+            return;
+
+        bench::AssetDirectory assets;
+        gl::ProgramCache programs;
+        gl::RenderTarget target{ width, height };
+        gl::SpriteBatch batch{ programs };
+
+        std::array<gl::Texture, 8> textures;
+        for (auto& texture : textures) {
+            texture
+                .bind()
+                .allocate(16, 16, gl::Texture::Format::RGBA8)
+                .setMinFilter(gl::Texture::MinFilter::Linear);
+        }
+
+        const auto sprites = scatterSprites(static_cast<std::size_t>(context.scale()), static_cast<int>(textures.size()), runLength);
+        const glm::mat4 projection = glm::ortho(.0f, float(width), float(height), .0f);
+
+        target.bind();
+        glFinish();
+
+        double seconds = context.measure([&]() {
+            glClear(GL_COLOR_BUFFER_BIT);
+            batch.begin(projection, order);
+            for (const auto& sprite : sprites)
+                batch.draw(textures[sprite.texture], sprite.position, { 4.f, 4.f }, { .0f, .0f, 1.f, 1.f }, sprite.color);
+            batch.end();
+            glFinish();
+        }, 10);
+
+        context
+            .counter("draw calls", double(batch.drawCount()))
+            .counter("throughput", sprites.size() / (seconds * 1e3), "sprites/ms");
+    }
+}
+
+// sprites in submission order, every run of 64 sprites with one texture is a draw
+BENCHMARK_SCALED(spriteBatch, 10000, 100000, 500000) {
+    spriteFrames(context, gl::SpriteBatch::Order::Submission, 64);
+}
+
+// a random texture per sprite, sorted so that every texture is one draw per chunk
+BENCHMARK_SCALED(spriteBatchSorted, 10000, 100000, 500000) {
+    spriteFrames(context, gl::SpriteBatch::Order::Texture, 1);
+}
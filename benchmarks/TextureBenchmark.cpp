@@ -0,0 +1,67 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ImageEncoder.h"
+#include "Texture.h"
+
+namespace
+{
+    // size x size RGB PNG of smooth gradients with some noise, written once per size
+    std::filesystem::path generatePng(unsigned size) {
+        std::filesystem::path path = std::filesystem::temp_directory_path() / ("grafika_bench_texture_" + std::to_string(size) + ".png");
+        if (std::filesystem::exists(path))
+            return path;
+
+        std::vector<std::uint8_t> pixels(std::size_t(size) * size * 4);
+        std::uint32_t noise = 12345;
+
+        for (unsigned y = 0; y < size; y++) {
+            for (unsigned x = 0; x < size; x++) {
+                noise = noise * 1664525u + 1013904223u;
+                std::uint8_t* p = &pixels[(std::size_t(y) * size + x) * 4];
+                p[0] = std::uint8_t(x * 255 / size);
+                p[1] = std::uint8_t(y * 255 / size);
+                p[2] = std::uint8_t(std::sin((x + y) * .05f) * 60.f + 120.f + (noise >> 28));
+                p[3] = 255;
+            }
+        }
+
+        auto png = gl::ImageEncoder::encodePng(pixels.data(), size, size);
+        std::ofstream{ path, std::ios::binary }.write(reinterpret_cast<const char*>(png.data()), png.size());
+        return path;
+    }
+
+    // loadImage into one texture over and over, the decoded copy freed in between
+    void loadImages(bench::Context& context, const std::filesystem::path& path, int repetitions) {
+        std::string filename = path.string();
+        gl::Texture texture;
+
+        std::size_t decodedBytes = 0;
+        double pixels = 0;
+        double seconds = context.measure([&]() {
+            texture.loadImage(filename.c_str());
+            decodedBytes = std::size_t(texture.getWidth()) * texture.getHeight() * texture.getChannels();
+            pixels = double(texture.getWidth()) * texture.getHeight();
+            texture.releaseImage();
+        }, repetitions);
+
+        context
+            .counter("pixels", pixels / seconds / 1e6, "Mpix/s")
+            .counter("decoded", decodedBytes / seconds / 1e6, "MB/s")
+            .counter("compressed", std::filesystem::file_size(path) / seconds / 1e6, "MB/s");
+    }
+}
+
+// the app's texture, a photo
+BENCHMARK(loadJpeg) {
+    loadImages(context, bench::findAsset("assets/textures/korwinium.jpg"), 10);
+}
+
+BENCHMARK_SCALED(loadPng, 256, 1024, 2048) {
+    loadImages(context, generatePng(static_cast<unsigned>(context.scale())), context.scale() > 1024 ? 5 : 10);
+}
@@ -0,0 +1,89 @@
+﻿#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Program.h"
+#include "Shader.h"
+#include "Uniform.h"
+
+namespace
+{
+    // uniform sets per run, spread over the context.scale() elements of the array
+    constexpr int setCount = 1 << 16;
+
+    // sums every element of `uniform <type> values[scale]`, so that the whole array stays active
+    gl::Program arrayProgram(const char* type, const char* element, long scale) {
+        std::string count = std::to_string(scale);
+
+        gl::Shader vertexShader = gl::Shader::fromSource(
+            "#version 330 core\n"
+            "void main() { gl_Position = vec4(0.0); }\n",
+            gl::ShaderType::Vertex
+        );
+        gl::Shader fragmentShader = gl::Shader::fromSource(
+            "#version 330 core\n"
+            "uniform " + std::string{ type } + " values[" + count + "];\n"
+            "out vec4 outColor;\n"
+            "void main() {\n"
+            "    float sum = 0.0;\n"
+            "    for (int i = 0; i < " + count + "; i++)\n"
+            "        sum += " + element + ";\n"
+            "    outColor = vec4(sum);\n"
+            "}\n",
+            gl::ShaderType::Fragment
+        );
+        vertexShader.compile();
+        fragmentShader.compile();
+
+        gl::Program program;
+        program.useShader(vertexShader).useShader(fragmentShader).link();
+        return program;
+    }
+
+    template<typename T>
+    void uniformSets(bench::Context& context, const char* type, const char* element) {
+        long scale = context.scale();
+        gl::Program program = arrayProgram(type, element, scale);
+
+        std::vector<std::string> names;
+        for (long i = 0; i < scale; i++)
+            names.push_back("values[" + std::to_string(i) + "]");
+
+        std::vector<gl::Uniform<T>> uniforms;
+        for (const auto& name : names)
+            uniforms.push_back(program.createUniform<T>(name.c_str()));
+
+        double seconds = context.measure([&]() {
+            for (int set = 0; set < setCount; set++)
+                uniforms[set % scale] = T(static_cast<float>(set));
+        }, 10);
+
+        context
+            .counter("sets", setCount / seconds, "/s")
+            .counter("per set", seconds / setCount * 1e9, "ns");
+    }
+}
+
+BENCHMARK_SCALED(uniformFloat, 1, 8, 32) {
+    uniformSets<GLfloat>(context, "float", "values[i]");
+}
+
+BENCHMARK_SCALED(uniformVec3, 1, 8, 32) {
+    uniformSets<glm::vec3>(context, "vec3", "values[i].x");
+}
+
+BENCHMARK_SCALED(uniformVec4, 1, 8, 32) {
+    uniformSets<glm::vec4>(context, "vec4", "values[i].x");
+}
+
+BENCHMARK_SCALED(uniformInt, 1, 8, 32) {
+    uniformSets<GLint>(context, "int", "float(values[i])");
+}
+
+BENCHMARK_SCALED(uniformMat3, 1, 8, 32) {
+    uniformSets<glm::mat3>(context, "mat3", "values[i][0][0]");
+}
+
+BENCHMARK_SCALED(uniformMat4, 1, 8, 32) {
+    uniformSets<glm::mat4>(context, "mat4", "values[i][0][0]");
+}
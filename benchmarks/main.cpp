@@ -0,0 +1,29 @@
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+#include "Benchmark.h"
+#include "BenchmarkGl.h"
+
+int main(int argc, char** argv) {
+    // --gl runs the GL wrapping benchmarks in a real context instead of against stubs
+    bench::GlMode mode = bench::GlMode::Stub;
+    std::vector<char*> args{ argv[0] };
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--gl") == 0)
+            mode = bench::GlMode::Context;
+        else
+            args.push_back(argv[i]);
+    }
+
+    try {
+        bench::initGl(mode);
+    } catch (std::exception& e) {
+        std::printf("%s\n", e.what());
+        return 1;
+    }
+
+    return bench::runBenchmarks(static_cast<int>(args.size()), args.data());
+}
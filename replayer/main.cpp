@@ -0,0 +1,91 @@
+#include <iostream>
+#include <string>
+
+#include "GlReplayer.h"
+#include <SFML/Window.hpp>
+
+#include "FrameTimingLog.h"
+#include "exceptions.h"
+
+// Replays a capture made with basic_shadery --gl-capture and reports the frame times,
+// which then cover only what the driver and the GPU do with the recorded calls.
+int main(int argc, char** argv) {
+    std::string capturePath, timingsPath;
+    int loops = 1;
+    bool vsync = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--loops" && hasValue)
+            loops = std::stoi(argv[++i]);
+        else if (arg == "--timings" && hasValue)
+            timingsPath = argv[++i];
+        else if (arg == "--vsync")
+            vsync = true;
+        else if (capturePath.empty() && arg.rfind("--", 0) != 0)
+            capturePath = arg;
+        else {
+            capturePath.clear();
+            break;
+        }
+    }
+
+    if (capturePath.empty()) {
+        std::cerr << "Usage: " << argv[0] << " capture.glc [--loops n] [--timings file.csv] [--vsync]\n";
+        return -1;
+    }
+
+    sf::ContextSettings settings;
+    settings.depthBits = 24;
+    settings.stencilBits = 8;
+
+    // resized to the captured viewport once the capture is read
+    sf::Window window(sf::VideoMode(1300, 900, 32), "GL replay", sf::Style::Titlebar | sf::Style::Close, settings);
+    window.setVerticalSyncEnabled(vsync);
+
+    glewExperimental = GL_TRUE;
+    if (glewInit() != GLEW_OK) {
+        std::cerr << "GLEW Initalization failed\n";
+        return -1;
+    }
+
+    try {
+        gl::GlReplayer replayer{ capturePath };
+        if (replayer.width() > 0 && replayer.height() > 0)
+            window.setSize({ static_cast<unsigned int>(replayer.width()), static_cast<unsigned int>(replayer.height()) });
+
+        gl::FrameTimingLog timings{ timingsPath };
+
+        bool running = true;
+        for (int loop = 0; loop < loops && running; loop++) {
+            while (running && !replayer.isAtEnd()) {
+                sf::Event event;
+                while (window.pollEvent(event)) {
+                    if (event.type == sf::Event::Closed)
+                        running = false;
+                }
+
+                timings.beginFrame(.0f);
+                bool isFrame = replayer.replayFrame();
+                window.display();
+                timings.endFrame();
+
+                if (!isFrame)
+                    break;
+            }
+
+            std::cout << "Loop " << loop + 1 << ": " << replayer.frameNumber() << " frames\n";
+            replayer.rewind();
+        }
+
+        timings.finish().printSummary(std::cout);
+    } catch (gl::exception& e) {
+        std::cerr << "Replay failed!\n" << e.what() << "\n";
+        return -1;
+    }
+
+    window.close();
+    return 0;
+}
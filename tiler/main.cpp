@@ -0,0 +1,45 @@
+#include <iostream>
+#include <string>
+
+#include "VirtualTextureFile.h"
+#include "exceptions.h"
+
+// Cuts an image into a virtual texture file for basic_shadery --virtual-texture.
+int main(int argc, char** argv) {
+    std::string imagePath, outputPath;
+    std::uint32_t pageSize = 128, border = 4;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--page-size" && hasValue)
+            pageSize = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--border" && hasValue)
+            border = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        else if (imagePath.empty() && arg.rfind("--", 0) != 0)
+            imagePath = arg;
+        else if (outputPath.empty() && arg.rfind("--", 0) != 0)
+            outputPath = arg;
+        else {
+            outputPath.clear();
+            break;
+        }
+    }
+
+    if (outputPath.empty()) {
+        std::cerr << "Usage: " << argv[0] << " image output.vt [--page-size n] [--border n]\n";
+        return -1;
+    }
+
+    try {
+        auto layout = gl::VirtualTextureTiler::build(imagePath.c_str(), outputPath, pageSize, border);
+        std::cout << layout.width << "x" << layout.height << ": " << layout.pageCount() << " pages in " << layout.levels.size() << " levels, "
+            << (layout.fileSize() >> 20) << " MB\n";
+    } catch (gl::exception& e) {
+        std::cerr << "Tiling failed!\n" << e.what() << "\n";
+        return -1;
+    }
+
+    return 0;
+}